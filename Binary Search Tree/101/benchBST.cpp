@@ -0,0 +1,199 @@
+/***********************************************************************
+ * Header:
+ *    Bench
+ * Summary:
+ *    Driver to time the BST. It has its own main(), so it is not part
+ *    of the project; build it on its own, with optimization:
+ *        g++ -std=c++14 -O2 -pthread benchBST.cpp
+ *    Name sections to run only those:
+ *        ./a.out depth
+ *    Add -DBST_ORDER_STATISTICS to time split() at O(log n) rather
+ *    than O(n)
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "bst.h"         // for BST
+#include <algorithm>     // for std::shuffle
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**********************************************************************
+ * MILLISECONDS SINCE
+ ***********************************************************************/
+double msSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// what the timed loops add up, printed so none of them is optimized away
+long long sink = 0;
+
+/**********************************************************************
+ * KEYS
+ * 0 .. num-1 ascending, descending or shuffled
+ ***********************************************************************/
+enum Order { ASCENDING, DESCENDING, SHUFFLED };
+
+std::vector<int> keys(int num, Order order)
+{
+   std::vector<int> v;
+   v.reserve(num);
+   for (int i = 0; i < num; i++)
+      v.push_back(order == DESCENDING ? num - 1 - i : i);
+   if (order == SHUFFLED)
+      std::shuffle(v.begin(), v.end(), std::mt19937(42));
+   return v;
+}
+
+/**********************************************************************
+ * DEPTH
+ * Insert 10K to 10M keys in each order, one insert() at a time, and
+ * report the height against the red-black bound of 2 log(n+1), the
+ * insert time and a find of every key in random order
+ ***********************************************************************/
+void benchDepth()
+{
+   const char* names[] = { "ascending", "descending", "shuffled" };
+   printf("BST insert order against height, times in ns per operation\n");
+   printf("%10s %-10s %7s %7s %8s %8s\n", "elements", "order", "height", "bound", "insert", "find");
+   for (int num = 10000; num <= 10000000; num *= 10)
+   {
+      std::vector<int> probes = keys(num, SHUFFLED);
+      for (Order order : { ASCENDING, DESCENDING, SHUFFLED })
+      {
+         std::vector<int> values = keys(num, order);
+         custom::BST<int> bst;
+         auto start = std::chrono::steady_clock::now();
+         for (int v : values)
+            bst.insert(v);
+         double nsInsert = msSince(start) * 1e6 / num;
+
+         start = std::chrono::steady_clock::now();
+         for (int v : probes)
+            sink += *bst.find(v);
+         double nsFind = msSince(start) * 1e6 / num;
+
+         printf("%10d %-10s %7zu %7.0f %8.1f %8.1f\n", num, names[order], bst.height(),
+                std::floor(2.0 * std::log2(num + 1.0)), nsInsert, nsFind);
+      }
+   }
+}
+
+/**********************************************************************
+ * MERGE
+ * unite(), intersect() and subtract() of a 1M tree with 1K and with
+ * 1M others, half of them in the big tree, serial, forked, and one
+ * element at a time as before. Then split() the big tree in the
+ * middle and join() it back. Trees are copied before the clock starts
+ ***********************************************************************/
+void benchMerge()
+{
+   const int NUM = 1000000;
+   std::vector<int> big;
+   for (int i = 0; i < NUM; i++)
+      big.push_back(2 * i);
+   custom::BST<int> bst;
+   bst.assign(big.begin(), big.end());
+
+   printf("BST set algebra, %d x m, ms\n", NUM);
+   printf("%8s %-10s %10s %10s %10s\n", "m", "operation", "serial", "forked", "one by one");
+   for (int num : { 1000, 1000000 })
+   {
+      // spread over the big tree's range, every other one in it
+      std::vector<int> small;
+      for (int i = 0; i < num; i++)
+         small.push_back(static_cast<int>(static_cast<long long>(i) * 2 * NUM / num) + i % 2);
+      custom::BST<int> bstSmall;
+      bstSmall.assign(small.begin(), small.end());
+
+      const char* names[] = { "unite", "intersect", "subtract" };
+      for (int op = 0; op < 3; op++)
+      {
+         double ms[2];
+         for (bool isParallel : { false, true })
+         {
+            custom::BST<int> lhs(bst);
+            custom::BST<int> rhs(bstSmall);
+            auto start = std::chrono::steady_clock::now();
+            if (op == 0)
+               lhs.unite(std::move(rhs), isParallel);
+            else if (op == 1)
+               lhs.intersect(std::move(rhs), isParallel);
+            else
+               lhs.subtract(std::move(rhs), isParallel);
+            ms[isParallel] = msSince(start);
+            sink += lhs.size();
+         }
+
+         custom::BST<int> lhs(bst);
+         auto start = std::chrono::steady_clock::now();
+         if (op == 0)
+            for (int v : small)
+               lhs.insert(v, true /*keepUnique*/);
+         else if (op == 1)
+         {
+            custom::BST<int> both;
+            for (int v : small)
+               if (lhs.find(v) != lhs.end())
+                  both.insert(v);
+            lhs.swap(both);
+         }
+         else
+            for (int v : small)
+            {
+               auto it = lhs.find(v);
+               if (it != lhs.end())
+                  lhs.erase(it);
+            }
+         double msNaive = msSince(start);
+         sink += lhs.size();
+         printf("%8d %-10s %10.2f %10.2f %10.2f\n", num, names[op], ms[0], ms[1], msNaive);
+      }
+   }
+
+   custom::BST<int> lhs(bst);
+   auto start = std::chrono::steady_clock::now();
+   custom::BST<int> rhs = lhs.split(NUM);
+   double msSplit = msSince(start);
+   start = std::chrono::steady_clock::now();
+   lhs.join(std::move(rhs));
+   double msJoin = msSince(start);
+   sink += lhs.size();
+   printf("split in the middle %.3f ms, join back %.3f ms\n", msSplit, msJoin);
+}
+
+/**********************************************************************
+ * MAIN
+ * Every section, or just the ones named on the command line
+ ***********************************************************************/
+int main(int argc, const char* argv[])
+{
+   struct Section
+   {
+      const char* name;
+      void (*bench)();
+   } sections[] =
+   {
+      { "depth",         benchDepth         },
+      { "merge",         benchMerge         },
+   };
+
+   for (const Section& section : sections)
+   {
+      bool isNamed = argc == 1;
+      for (int i = 1; i < argc; i++)
+         isNamed = isNamed || strcmp(argv[i], section.name) == 0;
+      if (isNamed)
+      {
+         section.bench();
+         printf("\n");
+      }
+   }
+   printf("(%lld)\n", sink);
+   return 0;
+}
@@ -12,6 +12,10 @@
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
 
+#ifndef BST_ORDER_STATISTICS
+#define BST_ORDER_STATISTICS   // so the unit tests can check select and rank
+#endif
+
 #include "testBST.h"        // for the BST unit tests
 #include "testSpy.h"        // for the spy unit tests
 int Spy::counters[] = {};
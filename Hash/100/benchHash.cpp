@@ -0,0 +1,508 @@
+/***********************************************************************
+ * Header:
+ *    Bench
+ * Summary:
+ *    Driver to time the hash sets. It has its own main(), so it is not
+ *    part of the project; build it on its own, with optimization:
+ *        g++ -std=c++14 -O2 -pthread benchHash.cpp
+ *    Add -U__SSE2__ to time flat_hash_set's portable group match
+ *    instead of the SSE2 one. Name sections to run only those:
+ *        ./a.out growth flat
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "hash.h"        // for unordered_set
+#include "flat_hash_set.h" // for flat_hash_set
+#include "unordered_map.h" // for unordered_map
+#include "concurrent_unordered_set.h" // for concurrent_unordered_set
+#include "split_ordered_set.h" // for split_ordered_set
+#include "cuckoo_hash_set.h" // for cuckoo_hash_set
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**********************************************************************
+ * MILLISECONDS SINCE
+ ***********************************************************************/
+double msSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// what the timed loops add up, printed so none of them is optimized away
+size_t sink = 0;
+
+/**********************************************************************
+ * KEYS
+ * num pseudo-random 64-bit keys. Different seeds give independent
+ * streams, so, all but certainly, disjoint sets: hits and misses
+ ***********************************************************************/
+std::vector<size_t> keys(size_t num, uint64_t seed)
+{
+   std::vector<size_t> v;
+   v.reserve(num);
+   std::mt19937_64 random(seed);
+   for (size_t i = 0; i < num; i++)
+      v.push_back(static_cast<size_t>(random()));
+   return v;
+}
+
+/**********************************************************************
+ * TIME SET
+ * Nanoseconds per insert, per find that hits and per find that
+ * misses, for any set with insert() and find()
+ ***********************************************************************/
+struct Times
+{
+   double nsInsert;
+   double nsHit;
+   double nsMiss;
+};
+
+template <class Set>
+Times timeSet(Set& s, const std::vector<size_t>& present, const std::vector<size_t>& absent)
+{
+   Times times;
+   auto start = std::chrono::steady_clock::now();
+   for (size_t k : present)
+      s.insert(k);
+   times.nsInsert = msSince(start) * 1e6 / present.size();
+
+   start = std::chrono::steady_clock::now();
+   for (size_t k : present)
+      sink += s.find(k) != s.end();
+   times.nsHit = msSince(start) * 1e6 / present.size();
+
+   start = std::chrono::steady_clock::now();
+   for (size_t k : absent)
+      sink += s.find(k) != s.end();
+   times.nsMiss = msSince(start) * 1e6 / absent.size();
+   return times;
+}
+
+/**********************************************************************
+ * GROWTH
+ * unordered_set from 1K to 10M elements, each from empty so every
+ * growth is paid for, beside std::unordered_set
+ ***********************************************************************/
+void benchGrowth()
+{
+   printf("unordered_set growing from empty, ns per operation\n");
+   printf("%10s %10s %8s %8s %8s %10s %10s %10s\n", "elements", "buckets", "insert", "hit", "miss",
+          "std insert", "std hit", "std miss");
+   for (size_t num = 1000; num <= 10000000; num *= 10)
+   {
+      std::vector<size_t> present = keys(num, 1);
+      std::vector<size_t> absent = keys(num, 2);
+      custom::unordered_set<size_t> us;
+      Times times = timeSet(us, present, absent);
+      std::unordered_set<size_t> usStd;
+      Times timesStd = timeSet(usStd, present, absent);
+      printf("%10zu %10zu %8.1f %8.1f %8.1f %10.1f %10.1f %10.1f\n", num, us.bucket_count(),
+             times.nsInsert, times.nsHit, times.nsMiss, timesStd.nsInsert, timesStd.nsHit, timesStd.nsMiss);
+   }
+}
+
+/**********************************************************************
+ * TIME ERASE
+ * Nanoseconds per erase of a present key
+ ***********************************************************************/
+template <class Set>
+double timeErase(Set& s, const std::vector<size_t>& present)
+{
+   auto start = std::chrono::steady_clock::now();
+   for (size_t k : present)
+      s.erase(k);
+   sink += s.size();
+   return msSince(start) * 1e6 / present.size();
+}
+
+/**********************************************************************
+ * FLAT
+ * flat_hash_set, probing sixteen control bytes at a time, against
+ * the chained unordered_set and std::unordered_set
+ ***********************************************************************/
+template <class Set>
+void timeFlat(const char* name, const std::vector<size_t>& present, const std::vector<size_t>& absent)
+{
+   Set s;
+   Times times = timeSet(s, present, absent);
+   double nsErase = timeErase(s, present);
+   printf("%-20s %8.1f %8.1f %8.1f %8.1f\n", name, times.nsInsert, times.nsHit, times.nsMiss, nsErase);
+}
+
+void benchFlat()
+{
+   const size_t NUM = 1000000;
+   std::vector<size_t> present = keys(NUM, 3);
+   std::vector<size_t> absent = keys(NUM, 4);
+#ifdef FLAT_HASH_SET_SSE2
+   const char* probe = "SSE2";
+#else
+   const char* probe = "portable";
+#endif
+   printf("flat_hash_set (%s group match) vs chaining, %zu keys, ns per operation\n", probe, NUM);
+   printf("%-20s %8s %8s %8s %8s\n", "set", "insert", "hit", "miss", "erase");
+   timeFlat<custom::flat_hash_set<size_t>>("flat_hash_set", present, absent);
+   timeFlat<custom::unordered_set<size_t>>("unordered_set", present, absent);
+   timeFlat<std::unordered_set<size_t>>("std::unordered_set", present, absent);
+}
+
+/**********************************************************************
+ * MAP
+ * unordered_map point lookups against an ordered map. custom::map
+ * lives in the Map lab, whose pair.h clashes with this one, so
+ * std::map stands in for it here; benchMap.cpp times the BST one
+ ***********************************************************************/
+template <class Map>
+void timeMap(const char* name, const std::vector<size_t>& present, const std::vector<size_t>& absent)
+{
+   Map m;
+   auto start = std::chrono::steady_clock::now();
+   for (size_t k : present)
+      m[k] = k;
+   double nsInsert = msSince(start) * 1e6 / present.size();
+
+   start = std::chrono::steady_clock::now();
+   for (size_t k : present)
+      sink += m.find(k)->second;
+   double nsHit = msSince(start) * 1e6 / present.size();
+
+   start = std::chrono::steady_clock::now();
+   for (size_t k : absent)
+      sink += m.find(k) != m.end();
+   double nsMiss = msSince(start) * 1e6 / absent.size();
+   printf("%-20s %8.1f %8.1f %8.1f\n", name, nsInsert, nsHit, nsMiss);
+}
+
+void benchMap()
+{
+   const size_t NUM = 1000000;
+   std::vector<size_t> present = keys(NUM, 5);
+   std::vector<size_t> absent = keys(NUM, 6);
+   printf("unordered_map vs an ordered map, %zu keys, ns per operation\n", NUM);
+   printf("%-20s %8s %8s %8s\n", "map", "m[k] = v", "hit", "miss");
+   timeMap<custom::unordered_map<size_t, size_t>>("unordered_map", present, absent);
+   timeMap<std::unordered_map<size_t, size_t>>("std::unordered_map", present, absent);
+   timeMap<std::map<size_t, size_t>>("std::map", present, absent);
+}
+
+/**********************************************************************
+ * LOCKED SET
+ * What we had: one unordered_set behind one mutex
+ ***********************************************************************/
+class LockedSet
+{
+public:
+   bool insert(size_t t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return s.insert(t).second;
+   }
+   size_t erase(size_t t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return s.erase(t) != s.end() ? 1 : 0;
+   }
+   bool contains(size_t t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return s.contains(t);
+   }
+private:
+   custom::unordered_set<size_t> s;
+   std::mutex mutex;
+};
+
+/**********************************************************************
+ * MIX
+ * numThreads threads each run numOps operations on the keys:
+ * percentRead contains(), the rest split between insert() and
+ * erase(). Half the keys are in the set to start with. Returns
+ * millions of operations per second
+ ***********************************************************************/
+template <class Set>
+double mix(Set& s, unsigned numThreads, size_t numOps, const std::vector<size_t>& keys, int percentRead)
+{
+   for (size_t i = 0; i < keys.size(); i += 2)
+      s.insert(keys[i]);
+
+   std::atomic<size_t> numTrue(0);
+   auto start = std::chrono::steady_clock::now();
+   std::vector<std::thread> threads;
+   for (unsigned t = 0; t < numThreads; t++)
+      threads.push_back(std::thread([&s, &numTrue, &keys, t, numOps, percentRead]()
+      {
+         uint64_t state = t * 0x9E3779B97F4A7C15ull + 1;
+         size_t num = 0;
+         for (size_t i = 0; i < numOps; i++)
+         {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            size_t key = keys[state % keys.size()];
+            int percent = static_cast<int>((state >> 40) % 100);
+            if (percent < percentRead)
+               num += s.contains(key);
+            else if (percent % 2)
+               num += s.insert(key);
+            else
+               num += s.erase(key);
+         }
+         numTrue += num;
+      }));
+   for (auto& thread : threads)
+      thread.join();
+   double seconds = msSince(start) / 1e3;
+   sink += numTrue;
+   return numThreads * static_cast<double>(numOps) / seconds / 1e6;
+}
+
+// 1, 2, 4, ... threads, up to at least 64
+std::vector<unsigned> threadCounts()
+{
+   std::vector<unsigned> counts;
+   unsigned maxThreads = std::max(64u, 2 * std::thread::hardware_concurrency());
+   for (unsigned num = 1; num <= maxThreads; num *= 2)
+      counts.push_back(num);
+   return counts;
+}
+
+/**********************************************************************
+ * SHARDED
+ * concurrent_unordered_set against the one-mutex set as threads
+ * are added, read-heavy and write-heavy
+ ***********************************************************************/
+void benchSharded()
+{
+   const size_t NUM_KEYS = 1000000;
+   const size_t NUM_OPS = 200000;
+   std::vector<size_t> all = keys(NUM_KEYS, 7);
+   printf("concurrent_unordered_set vs one mutex, %zu keys, %zu ops per thread (%u cores), Mops/s\n",
+          NUM_KEYS, NUM_OPS, std::thread::hardware_concurrency());
+   printf("%8s %6s %10s %10s\n", "threads", "read%", "locked", "sharded");
+   for (int percentRead : { 90, 50 })
+      for (unsigned numThreads : threadCounts())
+      {
+         LockedSet locked;
+         custom::concurrent_unordered_set<size_t> sharded;
+         double mopsLocked = mix(locked, numThreads, NUM_OPS, all, percentRead);
+         double mopsSharded = mix(sharded, numThreads, NUM_OPS, all, percentRead);
+         printf("%8u %6d %10.2f %10.2f\n", numThreads, percentRead, mopsLocked, mopsSharded);
+      }
+}
+
+/**********************************************************************
+ * SPLIT-ORDERED
+ * The lock-free split_ordered_set on the same mixes, growing from
+ * empty during the preload, against the one-mutex set
+ ***********************************************************************/
+void benchSplitOrdered()
+{
+   const size_t NUM_KEYS = 1000000;
+   const size_t NUM_OPS = 200000;
+   std::vector<size_t> all = keys(NUM_KEYS, 8);
+   printf("split_ordered_set vs one mutex, %zu keys, %zu ops per thread (%u cores), Mops/s\n",
+          NUM_KEYS, NUM_OPS, std::thread::hardware_concurrency());
+   printf("%8s %6s %10s %10s\n", "threads", "read%", "locked", "lock-free");
+   for (int percentRead : { 90, 50 })
+      for (unsigned numThreads : threadCounts())
+      {
+         LockedSet locked;
+         custom::split_ordered_set<size_t> lockFree;
+         double mopsLocked = mix(locked, numThreads, NUM_OPS, all, percentRead);
+         double mopsLockFree = mix(lockFree, numThreads, NUM_OPS, all, percentRead);
+         printf("%8u %6d %10.2f %10.2f\n", numThreads, percentRead, mopsLocked, mopsLockFree);
+      }
+}
+
+/**********************************************************************
+ * BATCH
+ * contains_batch() handed B keys at a time against contains() one
+ * key at a time, on a set too big for the cache. Half the probes hit
+ ***********************************************************************/
+void benchBatch()
+{
+   const size_t NUM = 4000000;
+   std::vector<size_t> present = keys(NUM, 9);
+   std::vector<size_t> probes = keys(NUM, 10);
+   for (size_t i = 0; i < NUM; i += 2)
+      probes[i] = present[(i * 7919) % NUM];
+   custom::unordered_set<size_t> us;
+   us.reserve(NUM);
+   for (size_t k : present)
+      us.insert(k);
+
+   printf("contains_batch vs contains, %zu elements, %zu probes, ns per probe\n", NUM, NUM);
+   auto start = std::chrono::steady_clock::now();
+   for (size_t k : probes)
+      sink += us.contains(k);
+   printf("%10s %8.1f\n", "scalar", msSince(start) * 1e6 / NUM);
+
+   bool found[64];
+   for (size_t num = 8; num <= 64; num *= 2)
+   {
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i + num <= NUM; i += num)
+      {
+         us.contains_batch(probes.data() + i, num, found);
+         for (size_t j = 0; j < num; j++)
+            sink += found[j];
+      }
+      printf("%7s %2zu %8.1f\n", "batch", num, msSince(start) * 1e6 / NUM);
+   }
+}
+
+/**********************************************************************
+ * FILTER
+ * A lookup mix that is 95% misses, with the front filter off and
+ * at two false-positive rates, for a set in cache and one out of it
+ ***********************************************************************/
+void benchFilter()
+{
+   printf("front filter, 95%% misses, ns per find\n");
+   printf("%10s %10s %10s %10s\n", "elements", "off", "rate 1%", "rate 0.1%");
+   for (size_t num : { size_t(100000), size_t(4000000) })
+   {
+      std::vector<size_t> present = keys(num, 11);
+      std::vector<size_t> probes = keys(num, 12);
+      for (size_t i = 0; i < num; i += 20)
+         probes[i] = present[i];
+
+      printf("%10zu", num);
+      for (double rate : { 0.0, 0.01, 0.001 })
+      {
+         custom::unordered_set<size_t> us;
+         us.front_filter(rate);
+         for (size_t k : present)
+            us.insert(k);
+         auto start = std::chrono::steady_clock::now();
+         for (size_t k : probes)
+            sink += us.find(k) != us.end();
+         printf(" %10.1f", msSince(start) * 1e6 / num);
+      }
+      printf("\n");
+   }
+}
+
+/**********************************************************************
+ * PERCENTILES
+ * Time each find on its own and print the 50th, 99th and 99.9th
+ * percentile and the slowest, in ns. Each time includes one read of
+ * the clock, which the "clock only" row measures on its own
+ ***********************************************************************/
+template <class Set>
+void percentiles(const char* name, Set& s, const std::vector<size_t>& probes)
+{
+   std::vector<double> ns;
+   ns.reserve(probes.size());
+   for (size_t k : probes)
+   {
+      auto start = std::chrono::steady_clock::now();
+      sink += s.find(k) != s.end();
+      ns.push_back(msSince(start) * 1e6);
+   }
+   std::sort(ns.begin(), ns.end());
+   printf("%-26s %8.0f %8.0f %8.0f %10.0f\n", name, ns[ns.size() / 2], ns[ns.size() * 99 / 100],
+          ns[ns.size() * 999 / 1000], ns.back());
+}
+
+/**********************************************************************
+ * CUCKOO
+ * The load factor cuckoo_hash_set reaches before each doubling, then
+ * find latency percentiles against the chained sets
+ ***********************************************************************/
+void benchCuckoo()
+{
+   const size_t NUM = 1000000;
+   std::vector<size_t> present = keys(NUM, 13);
+   std::vector<size_t> absent = keys(NUM, 14);
+
+   printf("cuckoo_hash_set growing from empty to %zu keys\n", NUM);
+   printf("%10s %10s %12s\n", "buckets", "elements", "load factor");
+   custom::cuckoo_hash_set<size_t> cs;
+   for (size_t k : present)
+   {
+      size_t numBuckets = cs.bucket_count();
+      float load = cs.load_factor();
+      cs.insert(k);
+      if (cs.bucket_count() != numBuckets && numBuckets >= 1024)
+         printf("%10zu %10zu %12.3f\n", numBuckets, cs.size() - 1, load);
+   }
+   printf("%10zu %10zu %12.3f   final, %zu in the stash\n\n",
+          cs.bucket_count(), cs.size(), cs.load_factor(), cs.stash_size());
+
+   custom::unordered_set<size_t> us;
+   std::unordered_set<size_t> usStd;
+   for (size_t k : present)
+   {
+      us.insert(k);
+      usStd.insert(k);
+   }
+
+   printf("find latency, %zu elements, ns\n", NUM);
+   printf("%-26s %8s %8s %8s %10s\n", "set", "p50", "p99", "p99.9", "max");
+   std::vector<double> ns;
+   for (size_t i = 0; i < NUM; i++)
+   {
+      auto start = std::chrono::steady_clock::now();
+      ns.push_back(msSince(start) * 1e6);
+   }
+   std::sort(ns.begin(), ns.end());
+   printf("%-26s %8.0f %8.0f %8.0f %10.0f\n", "clock only", ns[NUM / 2], ns[NUM * 99 / 100],
+          ns[NUM * 999 / 1000], ns.back());
+   percentiles("cuckoo_hash_set hit", cs, present);
+   percentiles("unordered_set hit", us, present);
+   percentiles("std::unordered_set hit", usStd, present);
+   percentiles("cuckoo_hash_set miss", cs, absent);
+   percentiles("unordered_set miss", us, absent);
+   percentiles("std::unordered_set miss", usStd, absent);
+}
+
+/**********************************************************************
+ * MAIN
+ * Every section, or just the ones named on the command line
+ ***********************************************************************/
+int main(int argc, const char* argv[])
+{
+   struct Section
+   {
+      const char* name;
+      void (*bench)();
+   } sections[] =
+   {
+      { "growth",        benchGrowth        },
+      { "flat",          benchFlat          },
+      { "map",           benchMap           },
+      { "sharded",       benchSharded       },
+      { "splitordered",  benchSplitOrdered  },
+      { "batch",         benchBatch         },
+      { "filter",        benchFilter        },
+      { "cuckoo",        benchCuckoo        },
+   };
+
+   for (const Section& section : sections)
+   {
+      bool isNamed = argc == 1;
+      for (int i = 1; i < argc; i++)
+         isNamed = isNamed || strcmp(argv[i], section.name) == 0;
+      if (isNamed)
+      {
+         section.bench();
+         printf("\n");
+      }
+   }
+   printf("(%zu)\n", sink);
+   return 0;
+}
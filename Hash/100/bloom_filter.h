@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Header:
+ *    BLOOM FILTER
+ * Summary:
+ *    A blocked Bloom filter: "definitely absent" in one cache line
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        bloom_filter          : A split-block Bloom filter
+ *
+ *    The bits are split into 512-bit blocks, each one cache line of eight
+ *    64-bit lanes. A key's hash picks one block, and then one bit in every
+ *    lane of it, each lane using its own odd multiplier. Setting or testing
+ *    a key touches a single cache line, and the eight lanes are independent,
+ *    so the compiler is free to do them all at once with SIMD.
+ *
+ *    There are no false negatives. The false-positive rate is set when the
+ *    filter is sized; it only holds while at most capacity() keys are in it.
+ *    Keys cannot be taken out again: rebuild the filter instead.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for memset, memcpy
+#include <cmath>      // for std::log, std::pow
+#include <new>        // for ::operator new
+#include <utility>    // for std::swap
+#include <functional> // for std::hash
+
+class TestBloomFilter;      // forward declaration for unit tests
+
+namespace custom
+{
+	/************************************************
+	 * BLOOM FILTER
+	 * A set that may answer "maybe" for a key it does
+	 * not hold, but never "no" for one it does
+	 ************************************************/
+	template <typename T, typename Hash = std::hash<T>>
+	class bloom_filter
+	{
+		friend class ::TestBloomFilter;   // give unit tests access to the privates
+	public:
+		//
+		// Construct
+		//
+		bloom_filter(const Hash& hash = Hash()) :
+			pRaw(nullptr), pBlocks(nullptr), numBlocks(0), numCapacity(0), rate(1.0), hasher(hash) {}
+		bloom_filter(size_t capacity, double falsePositiveRate, const Hash& hash = Hash()) :
+			bloom_filter(hash)
+		{
+			resize(capacity, falsePositiveRate);
+		}
+		bloom_filter(const bloom_filter& rhs) : bloom_filter(rhs.hasher)
+		{
+			*this = rhs;
+		}
+		bloom_filter(bloom_filter&& rhs) : bloom_filter(rhs.hasher)
+		{
+			swap(rhs);
+		}
+		~bloom_filter()
+		{
+			::operator delete(pRaw);
+		}
+
+		//
+		// Assign
+		//
+		bloom_filter& operator=(const bloom_filter& rhs);
+		bloom_filter& operator=(bloom_filter&& rhs)
+		{
+			swap(rhs);
+			return *this;
+		}
+		void swap(bloom_filter& rhs)
+		{
+			std::swap(pRaw, rhs.pRaw);
+			std::swap(pBlocks, rhs.pBlocks);
+			std::swap(numBlocks, rhs.numBlocks);
+			std::swap(numCapacity, rhs.numCapacity);
+			std::swap(rate, rhs.rate);
+			std::swap(hasher, rhs.hasher);
+		}
+
+		// Size for capacity keys at the given false-positive rate. Everything
+		// in the filter is forgotten
+		void resize(size_t capacity, double falsePositiveRate);
+
+		//
+		// Insert and query by key
+		//
+		void insert(const T& t)
+		{
+			insert_hash(hasher(t));
+		}
+		bool contains(const T& t) const
+		{
+			return contains_hash(hasher(t));
+		}
+
+		//
+		// Insert and query by an already computed hash, so a
+		// container in front of which the filter sits hashes once
+		//
+		void insert_hash(size_t hash)
+		{
+			if (numBlocks == 0)
+				return;
+			uint64_t h = mix(hash);
+			uint64_t* pBlock = pBlocks + blockOf(h) * LANES;
+			uint32_t salt = static_cast<uint32_t>(h);
+			for (int i = 0; i < LANES; i++)
+				pBlock[i] |= mask(salt, i);
+		}
+		bool contains_hash(size_t hash) const
+		{
+			// an unsized filter knows nothing, so everything is a maybe
+			if (numBlocks == 0)
+				return true;
+			uint64_t h = mix(hash);
+			const uint64_t* pBlock = pBlocks + blockOf(h) * LANES;
+			uint32_t salt = static_cast<uint32_t>(h);
+			uint64_t missing = 0;
+			for (int i = 0; i < LANES; i++)
+				missing |= ~pBlock[i] & mask(salt, i);
+			return missing == 0;
+		}
+
+		//
+		// Remove
+		//
+		void clear()
+		{
+			if (pBlocks)
+				memset(pBlocks, 0, numBlocks * BLOCK_BYTES);
+		}
+
+		//
+		// Status
+		//
+		size_t capacity() const { return numCapacity; }
+		double false_positive_rate() const { return rate; }
+		size_t bit_count() const { return numBlocks * LANES * 64; }
+		size_t block_count() const { return numBlocks; }
+
+	private:
+		static const int LANES = 8;                    // 64-bit words per block
+		static const size_t BLOCK_BYTES = LANES * sizeof(uint64_t);
+
+		static uint64_t mix(uint64_t x)
+		{
+			// splitmix64 finalizer: an identity std::hash still spreads
+			x ^= x >> 30;
+			x *= 0xBF58476D1CE4E5B9ull;
+			x ^= x >> 27;
+			x *= 0x94D049BB133111EBull;
+			x ^= x >> 31;
+			return x;
+		}
+
+		// the high half picks the block without a division
+		size_t blockOf(uint64_t h) const
+		{
+			return static_cast<size_t>(((h >> 32) * numBlocks) >> 32);
+		}
+
+		// one bit in lane i, from the low half of the hash and that lane's multiplier
+		static uint64_t mask(uint32_t salt, int i)
+		{
+			static const uint32_t SALTS[LANES] =
+			{
+				0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+				0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+			};
+			return uint64_t(1) << ((salt * SALTS[i]) >> 26);
+		}
+
+		static uint64_t bitsPerKey(double falsePositiveRate);
+
+		void*     pRaw;        // what ::operator new gave us
+		uint64_t* pBlocks;     // the first cache-line aligned block inside pRaw
+		size_t numBlocks;
+		size_t numCapacity;
+		double rate;
+		Hash hasher;
+	};
+
+	/*****************************************
+	 * BLOOM FILTER :: ASSIGN
+	 ****************************************/
+	template <typename T, typename Hash>
+	bloom_filter <T, Hash> & bloom_filter <T, Hash> ::operator=(const bloom_filter& rhs)
+	{
+		if (this != &rhs)
+		{
+			bloom_filter copy(rhs.hasher);
+			copy.resize(rhs.numCapacity, rhs.rate);
+			if (rhs.numBlocks)
+				memcpy(copy.pBlocks, rhs.pBlocks, rhs.numBlocks * BLOCK_BYTES);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	/*****************************************
+	 * BLOOM FILTER :: BITS PER KEY
+	 * A classic filter setting k = 8 bits per key has
+	 * rate p = (1 - e^(-8n/m))^8, so m/n = -8 / ln(1 - p^(1/8)).
+	 * Confining each key to one block makes some blocks
+	 * fuller than average, which a tenth more bits repays
+	 ****************************************/
+	template <typename T, typename Hash>
+	uint64_t bloom_filter <T, Hash> ::bitsPerKey(double falsePositiveRate)
+	{
+		if (!(falsePositiveRate > 1e-9))
+			falsePositiveRate = 1e-9;
+		if (falsePositiveRate >= 1.0)
+			return 0;
+		double bits = -LANES / std::log(1.0 - std::pow(falsePositiveRate, 1.0 / LANES));
+		return static_cast<uint64_t>(std::ceil(bits * 1.1));
+	}
+
+	/*****************************************
+	 * BLOOM FILTER :: RESIZE
+	 ****************************************/
+	template <typename T, typename Hash>
+	void bloom_filter <T, Hash> ::resize(size_t capacity, double falsePositiveRate)
+	{
+		uint64_t numBits = static_cast<uint64_t>(capacity) * bitsPerKey(falsePositiveRate);
+		size_t numBlocksNew = static_cast<size_t>((numBits + LANES * 64 - 1) / (LANES * 64));
+		if (capacity > 0 && numBlocksNew == 0)
+			numBlocksNew = 1;
+
+		void* pRawNew = nullptr;
+		uint64_t* pBlocksNew = nullptr;
+		if (numBlocksNew)
+		{
+			// one spare block's worth of room to slide up to a cache line
+			pRawNew = ::operator new((numBlocksNew + 1) * BLOCK_BYTES);
+			uintptr_t address = reinterpret_cast<uintptr_t>(pRawNew);
+			address = (address + BLOCK_BYTES - 1) & ~static_cast<uintptr_t>(BLOCK_BYTES - 1);
+			pBlocksNew = reinterpret_cast<uint64_t*>(address);
+			memset(pBlocksNew, 0, numBlocksNew * BLOCK_BYTES);
+		}
+
+		::operator delete(pRaw);
+		pRaw = pRawNew;
+		pBlocks = pBlocksNew;
+		numBlocks = numBlocksNew;
+		numCapacity = capacity;
+		rate = falsePositiveRate;
+	}
+}
@@ -0,0 +1,290 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT UNORDERED SET
+ * Summary:
+ *    A hash set many threads can share without one global lock
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        concurrent_unordered_set : A set split into independently locked shards
+ *
+ *    The high bits of the (mixed) hash pick one of NumShards shards. Each
+ *    shard is an ordinary unordered_set behind its own reader-writer lock,
+ *    padded out to a cache line so two shards never share one. Lookups
+ *    take the lock shared, so readers of one shard run side by side and
+ *    writers only wait on the shard they touch. The batched operations
+ *    sort their keys by shard first and then lock each shard once.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // for unordered_set, what each shard holds
+#include <cstdint>    // for uint64_t
+#include <mutex>      // for std::unique_lock
+#include <shared_mutex> // for std::shared_timed_mutex, std::shared_lock
+#include <vector>     // for the batch scratch space
+#include <functional> // for std::hash, std::equal_to
+
+class TestConcurrentHashSet;    // forward declaration for unit tests
+
+namespace custom
+{
+	/************************************************
+	 * CONCURRENT UNORDERED SET
+	 * A set of unique elements that is safe to read and
+	 * write from many threads at once. NumShards must be
+	 * a power of two
+	 ************************************************/
+	template <typename T,
+	          typename Hash = std::hash<T>,
+	          typename KeyEqual = std::equal_to<T>,
+	          size_t NumShards = 64>
+	class concurrent_unordered_set
+	{
+		friend class ::TestConcurrentHashSet;   // give unit tests access to the privates
+
+		static_assert(NumShards > 0 && (NumShards & (NumShards - 1)) == 0,
+		              "NumShards must be a power of two");
+	public:
+		//
+		// Construct
+		//
+		concurrent_unordered_set(const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			hasher(hash)
+		{
+			for (size_t i = 0; i < NumShards; i++)
+				shards[i].set = Set(DEFAULT_BUCKETS, hash, eq);
+		}
+		concurrent_unordered_set(const concurrent_unordered_set&) = delete;
+		concurrent_unordered_set& operator=(const concurrent_unordered_set&) = delete;
+
+		//
+		// Access
+		//
+		bool contains(const T& t) const
+		{
+			const Shard& shard = shards[shardOf(t)];
+			std::shared_lock<Mutex> lock(shard.mutex);
+			return shard.set.find(t) != shard.set.end();
+		}
+		size_t count(const T& t) const
+		{
+			return contains(t) ? 1 : 0;
+		}
+
+		//
+		// Insert
+		//
+		bool insert(const T& t)
+		{
+			Shard& shard = shards[shardOf(t)];
+			std::unique_lock<Mutex> lock(shard.mutex);
+			return shard.set.insert(t).second;
+		}
+
+		//
+		// Remove
+		//
+		size_t erase(const T& t)
+		{
+			Shard& shard = shards[shardOf(t)];
+			std::unique_lock<Mutex> lock(shard.mutex);
+			size_t numBefore = shard.set.size();
+			shard.set.erase(t);
+			return numBefore - shard.set.size();
+		}
+		void clear();
+
+		//
+		// Batch: each shard is locked once no matter how many keys land there
+		//
+		size_t insert_batch(const T* keys, size_t num);
+		size_t erase_batch(const T* keys, size_t num);
+		void contains_batch(const T* keys, size_t num, bool* found) const;
+
+		//
+		// Status: a snapshot, since other threads keep working
+		//
+		size_t size() const;
+		bool empty() const
+		{
+			return size() == 0;
+		}
+		size_t shard_count() const
+		{
+			return NumShards;
+		}
+
+	private:
+		typedef std::shared_timed_mutex Mutex;
+		typedef unordered_set<T, Hash, KeyEqual, true> Set;
+
+		static const size_t CACHE_LINE = 64;
+		static const size_t DEFAULT_BUCKETS = 5;
+
+		/************************************************
+		 * SHARD
+		 * One lock and the elements it guards, on a cache
+		 * line of their own so shards never false-share
+		 ************************************************/
+		struct alignas(CACHE_LINE) Shard
+		{
+			mutable Mutex mutex;
+			mutable Set set;      // find() is not const, but a shared lock only reads
+		};
+
+		// the top bits of a Fibonacci-mixed hash, so an identity hash still spreads
+		size_t shardOf(const T& t) const
+		{
+			uint64_t h = static_cast<uint64_t>(hasher(t)) * 0x9E3779B97F4A7C15ull;
+			return NumShards == 1 ? 0 : static_cast<size_t>(h >> (64 - SHARD_BITS));
+		}
+
+		static const int SHARD_BITS = NumShards <= 1 ? 0 :
+			1 + (NumShards > 2) + (NumShards > 4) + (NumShards > 8) + (NumShards > 16) +
+			(NumShards > 32) + (NumShards > 64) + (NumShards > 128) + (NumShards > 256) +
+			(NumShards > 512) + (NumShards > 1024) + (NumShards > 2048) + (NumShards > 4096);
+
+		void groupByShard(const T* keys, size_t num, std::vector<size_t>& order,
+		                  size_t* start) const;
+
+		Shard shards[NumShards];
+		Hash hasher;
+	};
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: GROUP BY SHARD
+	 * Counting sort of the key indices by shard. Afterwards
+	 * the keys of shard s are order[start[s]] up to
+	 * order[start[s + 1]], in their original order
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	void concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::groupByShard(
+		const T* keys, size_t num, std::vector<size_t>& order, size_t* start) const
+	{
+		std::vector<size_t> shardIndex(num);
+		for (size_t s = 0; s <= NumShards; s++)
+			start[s] = 0;
+		for (size_t i = 0; i < num; i++)
+		{
+			shardIndex[i] = shardOf(keys[i]);
+			start[shardIndex[i] + 1]++;
+		}
+		for (size_t s = 0; s < NumShards; s++)
+			start[s + 1] += start[s];
+
+		order.resize(num);
+		std::vector<size_t> next(start, start + NumShards);
+		for (size_t i = 0; i < num; i++)
+			order[next[shardIndex[i]]++] = i;
+	}
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: INSERT BATCH
+	 * Returns how many of the keys were new
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	size_t concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::insert_batch(const T* keys, size_t num)
+	{
+		std::vector<size_t> order;
+		size_t start[NumShards + 1];
+		groupByShard(keys, num, order, start);
+
+		size_t numInserted = 0;
+		for (size_t s = 0; s < NumShards; s++)
+		{
+			if (start[s] == start[s + 1])
+				continue;
+			std::unique_lock<Mutex> lock(shards[s].mutex);
+			for (size_t i = start[s]; i < start[s + 1]; i++)
+				if (shards[s].set.insert(keys[order[i]]).second)
+					numInserted++;
+		}
+		return numInserted;
+	}
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: ERASE BATCH
+	 * Returns how many of the keys were removed
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	size_t concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::erase_batch(const T* keys, size_t num)
+	{
+		std::vector<size_t> order;
+		size_t start[NumShards + 1];
+		groupByShard(keys, num, order, start);
+
+		size_t numErased = 0;
+		for (size_t s = 0; s < NumShards; s++)
+		{
+			if (start[s] == start[s + 1])
+				continue;
+			std::unique_lock<Mutex> lock(shards[s].mutex);
+			size_t numBefore = shards[s].set.size();
+			for (size_t i = start[s]; i < start[s + 1]; i++)
+				shards[s].set.erase(keys[order[i]]);
+			numErased += numBefore - shards[s].set.size();
+		}
+		return numErased;
+	}
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: CONTAINS BATCH
+	 * found[i] is set to whether keys[i] is present
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	void concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::contains_batch(
+		const T* keys, size_t num, bool* found) const
+	{
+		std::vector<size_t> order;
+		size_t start[NumShards + 1];
+		groupByShard(keys, num, order, start);
+
+		for (size_t s = 0; s < NumShards; s++)
+		{
+			if (start[s] == start[s + 1])
+				continue;
+			const Shard& shard = shards[s];
+			std::shared_lock<Mutex> lock(shard.mutex);
+			for (size_t i = start[s]; i < start[s + 1]; i++)
+				found[order[i]] = shard.set.find(keys[order[i]]) != shard.set.end();
+		}
+	}
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: SIZE
+	 * Each shard is counted under its own lock, so the
+	 * total may mix moments when writers are busy
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	size_t concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::size() const
+	{
+		size_t num = 0;
+		for (size_t s = 0; s < NumShards; s++)
+		{
+			std::shared_lock<Mutex> lock(shards[s].mutex);
+			num += shards[s].set.size();
+		}
+		return num;
+	}
+
+	/*****************************************
+	 * CONCURRENT UNORDERED SET :: CLEAR
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual, size_t NumShards>
+	void concurrent_unordered_set <T, Hash, KeyEqual, NumShards> ::clear()
+	{
+		for (size_t s = 0; s < NumShards; s++)
+		{
+			std::unique_lock<Mutex> lock(shards[s].mutex);
+			shards[s].set.clear();
+		}
+	}
+}
@@ -0,0 +1,709 @@
+/***********************************************************************
+ * Header:
+ *    CUCKOO HASH SET
+ * Summary:
+ *    A hash set whose lookups never look in more than two buckets
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        cuckoo_hash_set           : A 4-way set-associative cuckoo set
+ *        cuckoo_hash_set::iterator : An interator through the slots
+ *
+ *    Every element lives in one of two buckets, picked by two hashes, and
+ *    every bucket has four slots with a one-byte tag each. A lookup checks
+ *    at most those eight slots, comparing tags before calling Eq. Buckets
+ *    sit on a power-of-two stride in a cache-line aligned array, so one
+ *    never straddles two lines: a find touches at most two cache lines
+ *    whenever a bucket fits in one (4 + 4 * sizeof(T) <= 64).
+ *
+ *    When both buckets are full, insert searches breadth first for the
+ *    shortest chain of elements that can each move to their other bucket,
+ *    ending at a free slot, and then shifts that chain along. If no chain
+ *    is found within MAX_BFS buckets the element goes in a small stash,
+ *    which find only checks when it is not empty. A full stash doubles the
+ *    bucket array, unless the array is still half empty: only a hash that
+ *    sends many keys to the same two buckets gets there, and doubling
+ *    would not separate them.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for custom::pair returned by insert
+#include <cassert>
+#include <cstdint>    // for uint8_t, uint64_t
+#include <new>        // for placement new
+#include <utility>    // for std::move, std::swap
+#include <vector>     // for the stash and the search queue
+#include <functional> // for std::hash, std::equal_to
+#include <initializer_list>
+
+class TestCuckooHashSet;    // forward declaration for unit tests
+
+namespace custom
+{
+	/************************************************
+	 * CUCKOO HASH SET
+	 * A set of unique elements, each in one of its two
+	 * candidate buckets or, rarely, in the stash
+	 ************************************************/
+	template <typename T, typename Hash = std::hash<T>, typename Eq = std::equal_to<T>>
+	class cuckoo_hash_set
+	{
+		friend class ::TestCuckooHashSet;   // give unit tests access to the privates
+	public:
+		//
+		// Construct
+		//
+		cuckoo_hash_set(const Hash& hash = Hash(), const Eq& eq = Eq()) :
+			pRaw(nullptr), pBuckets(nullptr), numBuckets(0), numElements(0), hasher(hash), equal(eq)
+		{
+		}
+		cuckoo_hash_set(const cuckoo_hash_set& rhs);
+		cuckoo_hash_set(cuckoo_hash_set&& rhs) noexcept : cuckoo_hash_set(rhs.hasher, rhs.equal)
+		{
+			swap(rhs);
+		}
+		template <class Iterator>
+		cuckoo_hash_set(Iterator first, Iterator last) : cuckoo_hash_set()
+		{
+			for (; first != last; ++first)
+				insert(*first);
+		}
+		cuckoo_hash_set(const std::initializer_list<T>& il) : cuckoo_hash_set()
+		{
+			reserve(il.size());
+			for (const T& t : il)
+				insert(t);
+		}
+		~cuckoo_hash_set()
+		{
+			destroy();
+		}
+
+		//
+		// Assign
+		//
+		cuckoo_hash_set& operator=(const cuckoo_hash_set& rhs)
+		{
+			if (this != &rhs)
+			{
+				cuckoo_hash_set tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+		cuckoo_hash_set& operator=(cuckoo_hash_set&& rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				clear();
+				swap(rhs);
+			}
+			return *this;
+		}
+		void swap(cuckoo_hash_set& rhs) noexcept
+		{
+			std::swap(pRaw, rhs.pRaw);
+			std::swap(pBuckets, rhs.pBuckets);
+			std::swap(numBuckets, rhs.numBuckets);
+			std::swap(numElements, rhs.numElements);
+			stash.swap(rhs.stash);
+			std::swap(hasher, rhs.hasher);
+			std::swap(equal, rhs.equal);
+		}
+
+		//
+		// Iterator
+		//
+		class iterator;
+		iterator begin() const
+		{
+			return iterator(this, 0);
+		}
+		iterator end() const
+		{
+			return iterator(this, numPositions());
+		}
+
+		//
+		// Access
+		//
+		iterator find(const T& t) const
+		{
+			return iterator(this, findPosition(t, hashOf(t)));
+		}
+		bool contains(const T& t) const
+		{
+			return findPosition(t, hashOf(t)) != numPositions();
+		}
+		size_t count(const T& t) const
+		{
+			return contains(t) ? 1 : 0;
+		}
+
+		//
+		// Insert
+		//
+		custom::pair<iterator, bool> insert(const T& t)
+		{
+			return emplaceUnique(t);
+		}
+		custom::pair<iterator, bool> insert(T&& t)
+		{
+			return emplaceUnique(std::move(t));
+		}
+		void insert(const std::initializer_list<T>& il)
+		{
+			for (const T& t : il)
+				insert(t);
+		}
+
+		//
+		// Remove. Returns how many were removed, 0 or 1
+		//
+		void clear() noexcept;
+		size_t erase(const T& t);
+
+		//
+		// Hash policy
+		//
+		float load_factor() const noexcept
+		{
+			return numBuckets ? static_cast<float>(numElements) / static_cast<float>(numBuckets * SLOTS) : 0.0f;
+		}
+		void reserve(size_t num);
+
+		//
+		// Status
+		//
+		size_t size()         const noexcept { return numElements; }
+		bool   empty()        const noexcept { return numElements == 0; }
+		size_t bucket_count() const noexcept { return numBuckets; }
+		size_t stash_size()   const noexcept { return stash.size(); }
+
+	private:
+		static const int SLOTS = 4;             // ways per bucket
+		static const size_t CACHE_LINE = 64;
+		static const size_t MIN_BUCKETS = 4;
+		static const size_t MAX_STASH = 8;
+		static const size_t MAX_BFS = 512;      // buckets the search for a free slot may visit
+		static const int MAX_DEPTH = 5;         // longest chain of moves
+
+		/************************************************
+		 * BUCKET
+		 * Four tags, 0 meaning empty, then room for four
+		 * elements. Only the slots with a tag are constructed
+		 ************************************************/
+		struct Bucket
+		{
+			uint8_t tags[SLOTS];
+			alignas(T) unsigned char storage[SLOTS * sizeof(T)];
+
+			T& slot(int i) { return reinterpret_cast<T*>(storage)[i]; }
+			const T& slot(int i) const { return reinterpret_cast<const T*>(storage)[i]; }
+			int freeSlot() const
+			{
+				for (int i = 0; i < SLOTS; i++)
+					if (tags[i] == 0)
+						return i;
+				return -1;
+			}
+		};
+
+		/************************************************
+		 * STEP
+		 * One bucket reached by the breadth-first search:
+		 * the element in slot of the parent's bucket would
+		 * move here
+		 ************************************************/
+		struct Step
+		{
+			size_t bucket;
+			int slot;
+			int parent;
+			int depth;
+		};
+
+		// buckets are spaced a power of two apart, up to a cache line,
+		// so with an aligned array none of them crosses a line
+		static size_t stride()
+		{
+			size_t s = 1;
+			while (s < sizeof(Bucket))
+				s <<= 1;
+			return s <= CACHE_LINE ? s : (sizeof(Bucket) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+		}
+		Bucket& bucketAt(size_t i) const
+		{
+			return *reinterpret_cast<Bucket*>(pBuckets + i * stride());
+		}
+
+		static uint64_t mix(uint64_t x)
+		{
+			// splitmix64 finalizer: an identity std::hash still spreads
+			x ^= x >> 30;
+			x *= 0xBF58476D1CE4E5B9ull;
+			x ^= x >> 27;
+			x *= 0x94D049BB133111EBull;
+			x ^= x >> 31;
+			return x;
+		}
+		uint64_t hashOf(const T& t) const
+		{
+			return mix(static_cast<uint64_t>(hasher(t)));
+		}
+
+		// the two hash functions, and a tag that is never 0
+		size_t first(uint64_t h) const { return static_cast<size_t>(h) & (numBuckets - 1); }
+		size_t second(uint64_t h) const
+		{
+			size_t i = static_cast<size_t>(mix(h ^ 0x9E3779B97F4A7C15ull)) & (numBuckets - 1);
+			return i != first(h) ? i : first(h) ^ 1;
+		}
+		static uint8_t tagOf(uint64_t h)
+		{
+			uint8_t tag = static_cast<uint8_t>(h >> 56);
+			return tag ? tag : 1;
+		}
+		size_t otherBucket(uint64_t h, size_t i) const
+		{
+			return i == first(h) ? second(h) : first(h);
+		}
+
+		// a position is bucket * SLOTS + slot, or past all the slots for the stash
+		size_t numSlots() const { return numBuckets * SLOTS; }
+		size_t numPositions() const { return numSlots() + stash.size(); }
+		bool occupied(size_t pos) const
+		{
+			return pos >= numSlots() || bucketAt(pos / SLOTS).tags[pos % SLOTS] != 0;
+		}
+		const T& at(size_t pos) const
+		{
+			return pos < numSlots() ? bucketAt(pos / SLOTS).slot(static_cast<int>(pos % SLOTS)) : stash[pos - numSlots()];
+		}
+
+		size_t findPosition(const T& t, uint64_t h) const;
+		template <class U>
+		custom::pair<iterator, bool> emplaceUnique(U&& t);
+		template <class U>
+		size_t insertNew(U&& t, uint64_t h);
+		int makeRoom(uint64_t h, size_t& bucket);
+		void moveSlot(size_t from, int slotFrom, size_t to, int slotTo);
+		void unstash();
+		void resize(size_t numBucketsNew);
+		void destroy() noexcept;
+
+		void* pRaw;              // what ::operator new gave us
+		char* pBuckets;          // the first cache-line aligned byte inside pRaw
+		size_t numBuckets;       // a power of two, or 0 before the first insert
+		size_t numElements;      // in the buckets and the stash together
+		std::vector<T> stash;    // elements no cuckoo chain could place
+		Hash hasher;
+		Eq equal;
+	};
+
+
+	/************************************************
+	 * CUCKOO HASH SET ITERATOR
+	 * Walks the slots, skipping the empty ones, then
+	 * the stash
+	 ************************************************/
+	template <typename T, typename Hash, typename Eq>
+	class cuckoo_hash_set <T, Hash, Eq> ::iterator
+	{
+		friend class ::TestCuckooHashSet;   // give unit tests access to the privates
+		friend class cuckoo_hash_set <T, Hash, Eq>;
+	public:
+		//
+		// Construct
+		//
+		iterator() : pSet(nullptr), pos(0) {}
+		iterator(const cuckoo_hash_set* pSet, size_t pos) : pSet(pSet), pos(pos)
+		{
+			skipEmpty();
+		}
+
+		//
+		// Compare
+		//
+		bool operator == (const iterator& rhs) const { return pos == rhs.pos; }
+		bool operator != (const iterator& rhs) const { return pos != rhs.pos; }
+
+		//
+		// Access. The element cannot change or it would be in the wrong bucket
+		//
+		const T& operator * () const { return pSet->at(pos); }
+		const T* operator -> () const { return &pSet->at(pos); }
+
+		//
+		// Arithmetic
+		//
+		iterator& operator ++ ()
+		{
+			if (pos < pSet->numPositions())
+			{
+				++pos;
+				skipEmpty();
+			}
+			return *this;
+		}
+		iterator operator ++ (int)
+		{
+			iterator tmp = *this;
+			++(*this);
+			return tmp;
+		}
+
+	private:
+		void skipEmpty()
+		{
+			while (pos < pSet->numPositions() && !pSet->occupied(pos))
+				++pos;
+		}
+
+		const cuckoo_hash_set* pSet;
+		size_t pos;
+	};
+
+
+	/*****************************************
+	 * CUCKOO HASH SET :: COPY CONSTRUCTOR
+	 * Same buckets, so every element is copied
+	 * straight into the slot it had
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	cuckoo_hash_set <T, Hash, Eq> ::cuckoo_hash_set(const cuckoo_hash_set& rhs) :
+		cuckoo_hash_set(rhs.hasher, rhs.equal)
+	{
+		if (rhs.numElements == 0)
+			return;
+		resize(rhs.numBuckets);
+		try
+		{
+			for (size_t b = 0; b < numBuckets; b++)
+				for (int i = 0; i < SLOTS; i++)
+					if (rhs.bucketAt(b).tags[i])
+					{
+						new (&bucketAt(b).slot(i)) T(rhs.bucketAt(b).slot(i));
+						bucketAt(b).tags[i] = rhs.bucketAt(b).tags[i];
+						numElements++;
+					}
+			stash = rhs.stash;
+			numElements += stash.size();
+		}
+		catch (...)
+		{
+			destroy();
+			throw;
+		}
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: FIND POSITION
+	 * Two buckets, tags first, then the stash if it
+	 * has anything in it. numPositions() if absent
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	size_t cuckoo_hash_set <T, Hash, Eq> ::findPosition(const T& t, uint64_t h) const
+	{
+		if (numBuckets == 0)
+			return numPositions();
+
+		uint8_t tag = tagOf(h);
+		size_t candidates[2] = { first(h), second(h) };
+		for (size_t b : candidates)
+		{
+			const Bucket& bucket = bucketAt(b);
+			for (int i = 0; i < SLOTS; i++)
+				if (bucket.tags[i] == tag && equal(bucket.slot(i), t))
+					return b * SLOTS + i;
+		}
+
+		for (size_t i = 0; i < stash.size(); i++)
+			if (equal(stash[i], t))
+				return numSlots() + i;
+		return numPositions();
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: EMPLACE UNIQUE
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	template <class U>
+	custom::pair<typename cuckoo_hash_set <T, Hash, Eq> ::iterator, bool> cuckoo_hash_set <T, Hash, Eq> ::emplaceUnique(U&& t)
+	{
+		uint64_t h = hashOf(t);
+		size_t pos = findPosition(t, h);
+		if (pos != numPositions())
+			return { iterator(this, pos), false };
+
+		if (numBuckets == 0)
+			resize(MIN_BUCKETS);
+		pos = insertNew(std::forward<U>(t), h);
+		return { iterator(this, pos), true };
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: INSERT NEW
+	 * Place t, known to be absent: a free slot in
+	 * either bucket, a cuckoo chain, the stash, or
+	 * failing all of those, twice the buckets
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	template <class U>
+	size_t cuckoo_hash_set <T, Hash, Eq> ::insertNew(U&& t, uint64_t h)
+	{
+		for (;;)
+		{
+			size_t b;
+			int i = makeRoom(h, b);
+			if (i >= 0)
+			{
+				new (&bucketAt(b).slot(i)) T(std::forward<U>(t));
+				bucketAt(b).tags[i] = tagOf(h);
+				numElements++;
+				return b * SLOTS + i;
+			}
+			// a half-empty table that still cannot place t has a bad hash,
+			// and doubling would not help: let the stash take it
+			if (stash.size() < MAX_STASH || load_factor() < 0.5f)
+			{
+				stash.push_back(std::forward<U>(t));
+				numElements++;
+				return numPositions() - 1;
+			}
+			resize(numBuckets * 2);
+		}
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: MAKE ROOM
+	 * Free a slot in one of h's two buckets and return
+	 * it, or -1. Breadth first, so the chain of moves
+	 * is the shortest there is. A bucket already on the
+	 * path is never queued again, so no element is
+	 * moved twice
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	int cuckoo_hash_set <T, Hash, Eq> ::makeRoom(uint64_t h, size_t& bucket)
+	{
+		std::vector<Step> queue;
+		queue.push_back({ first(h), -1, -1, 0 });
+		queue.push_back({ second(h), -1, -1, 0 });
+		for (const Step& step : queue)
+		{
+			int i = bucketAt(step.bucket).freeSlot();
+			if (i >= 0)
+			{
+				bucket = step.bucket;
+				return i;
+			}
+		}
+
+		for (size_t q = 0; q < queue.size(); q++)
+		{
+			if (queue[q].depth >= MAX_DEPTH)
+				continue;
+			for (int i = 0; i < SLOTS; i++)
+			{
+				size_t from = queue[q].bucket;
+				size_t to = otherBucket(hashOf(bucketAt(from).slot(i)), from);
+
+				bool onPath = false;
+				for (int p = static_cast<int>(q); p >= 0 && !onPath; p = queue[p].parent)
+					onPath = queue[p].bucket == to;
+				if (onPath)
+					continue;
+
+				int slotFree = bucketAt(to).freeSlot();
+				if (slotFree >= 0)
+				{
+					// shift the chain along, starting at the free end
+					moveSlot(from, i, to, slotFree);
+					int slotVacated = i;
+					for (int p = static_cast<int>(q); queue[p].parent >= 0; p = queue[p].parent)
+					{
+						moveSlot(queue[queue[p].parent].bucket, queue[p].slot, queue[p].bucket, slotVacated);
+						slotVacated = queue[p].slot;
+						bucket = queue[queue[p].parent].bucket;
+					}
+					if (queue[q].parent < 0)
+						bucket = from;
+					return slotVacated;
+				}
+
+				if (queue.size() < MAX_BFS)
+					queue.push_back({ to, i, static_cast<int>(q), queue[q].depth + 1 });
+			}
+		}
+		return -1;
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: MOVE SLOT
+	 * Move one element to an empty slot; its tag goes too
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::moveSlot(size_t from, int slotFrom, size_t to, int slotTo)
+	{
+		Bucket& bucketFrom = bucketAt(from);
+		Bucket& bucketTo = bucketAt(to);
+		assert(bucketTo.tags[slotTo] == 0);
+		new (&bucketTo.slot(slotTo)) T(std::move(bucketFrom.slot(slotFrom)));
+		bucketTo.tags[slotTo] = bucketFrom.tags[slotFrom];
+		bucketFrom.slot(slotFrom).~T();
+		bucketFrom.tags[slotFrom] = 0;
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: ERASE
+	 * A freed slot may be just what a stashed element
+	 * was waiting for
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	size_t cuckoo_hash_set <T, Hash, Eq> ::erase(const T& t)
+	{
+		size_t pos = findPosition(t, hashOf(t));
+		if (pos == numPositions())
+			return 0;
+
+		if (pos < numSlots())
+		{
+			Bucket& bucket = bucketAt(pos / SLOTS);
+			bucket.slot(static_cast<int>(pos % SLOTS)).~T();
+			bucket.tags[pos % SLOTS] = 0;
+			numElements--;
+			unstash();
+		}
+		else
+		{
+			stash.erase(stash.begin() + (pos - numSlots()));
+			numElements--;
+		}
+		return 1;
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: UNSTASH
+	 * Move back any stashed element that now has a
+	 * free slot in one of its buckets
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::unstash()
+	{
+		for (size_t s = 0; s < stash.size(); )
+		{
+			uint64_t h = hashOf(stash[s]);
+			size_t candidates[2] = { first(h), second(h) };
+			bool moved = false;
+			for (size_t b : candidates)
+			{
+				int i = bucketAt(b).freeSlot();
+				if (i >= 0 && !moved)
+				{
+					new (&bucketAt(b).slot(i)) T(std::move(stash[s]));
+					bucketAt(b).tags[i] = tagOf(h);
+					stash.erase(stash.begin() + s);
+					moved = true;
+				}
+			}
+			if (!moved)
+				s++;
+		}
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: RESERVE
+	 * Enough buckets to hold num at about 90% full
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::reserve(size_t num)
+	{
+		size_t numBucketsNew = MIN_BUCKETS;
+		while (numBucketsNew * SLOTS * 9 / 10 < num)
+			numBucketsNew *= 2;
+		if (numBucketsNew > numBuckets)
+			resize(numBucketsNew);
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: RESIZE
+	 * A new aligned bucket array, into which every
+	 * element is moved and placed afresh
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::resize(size_t numBucketsNew)
+	{
+		cuckoo_hash_set other(hasher, equal);
+		other.pRaw = ::operator new(numBucketsNew * stride() + CACHE_LINE);
+		uintptr_t address = reinterpret_cast<uintptr_t>(other.pRaw);
+		address = (address + CACHE_LINE - 1) & ~static_cast<uintptr_t>(CACHE_LINE - 1);
+		other.pBuckets = reinterpret_cast<char*>(address);
+		other.numBuckets = numBucketsNew;
+		for (size_t b = 0; b < numBucketsNew; b++)
+			for (int i = 0; i < SLOTS; i++)
+				other.bucketAt(b).tags[i] = 0;
+
+		for (size_t b = 0; b < numBuckets; b++)
+			for (int i = 0; i < SLOTS; i++)
+				if (bucketAt(b).tags[i])
+				{
+					T& t = bucketAt(b).slot(i);
+					other.insertNew(std::move(t), hashOf(t));
+				}
+		for (T& t : stash)
+			other.insertNew(std::move(t), hashOf(t));
+
+		// what is left here are moved-from shells
+		swap(other);
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: CLEAR
+	 * Destroy the elements but keep the buckets
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::clear() noexcept
+	{
+		for (size_t b = 0; b < numBuckets; b++)
+			for (int i = 0; i < SLOTS; i++)
+				if (bucketAt(b).tags[i])
+				{
+					bucketAt(b).slot(i).~T();
+					bucketAt(b).tags[i] = 0;
+				}
+		stash.clear();
+		numElements = 0;
+	}
+
+	/*****************************************
+	 * CUCKOO HASH SET :: DESTROY
+	 * Clear, then give the bucket array back
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void cuckoo_hash_set <T, Hash, Eq> ::destroy() noexcept
+	{
+		clear();
+		::operator delete(pRaw);
+		pRaw = nullptr;
+		pBuckets = nullptr;
+		numBuckets = 0;
+	}
+
+	/*****************************************
+	 * SWAP
+	 * Stand-alone cuckoo hash set swap
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void swap(cuckoo_hash_set<T, Hash, Eq>& lhs, cuckoo_hash_set<T, Hash, Eq>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
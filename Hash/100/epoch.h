@@ -0,0 +1,289 @@
+/***********************************************************************
+ * Header:
+ *    EPOCH
+ * Summary:
+ *    Epoch-based memory reclamation for our lock-free containers
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        epoch          : The process-wide reclamation domain
+ *        epoch::guard   : Pins the calling thread for the life of the guard
+ *
+ *    A lock-free container cannot delete a node the moment it is unlinked
+ *    because another thread may still be reading it. Instead the node is
+ *    retired: it sits in a per-thread limbo list until every thread that
+ *    could have seen it has moved on. Every access to shared nodes must
+ *    happen while an epoch::guard is alive.
+ *
+ *    The global epoch only advances when every pinned thread has observed
+ *    the current one, so anything retired two epochs ago is unreachable.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t and uintptr_t
+#include <new>         // for ::operator new
+
+class TestLockFreeList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+	/**************************************************
+	 * EPOCH
+	 * Every thread that touches a lock-free container
+	 * gets one Record, linked into a list that is only
+	 * ever pushed onto.
+	 **************************************************/
+	class epoch
+	{
+		friend class ::TestLockFreeList; // give unit tests access to the privates
+	public:
+		class guard;
+
+		// Hand a node to the reclaimer. The caller must hold a guard
+		template <class T>
+		static void retire(T* p) {
+			retire(p, [](void* pVoid) { delete static_cast<T*>(pVoid); });
+		}
+
+		static void retire(void* p, void (*pDeleter)(void*)) {
+			Record* pRecord = self();
+			assert(pRecord->nesting > 0); // retire outside of a guard
+
+			// tag with the epoch read after the node was unlinked: only
+			// threads pinned at or before it can still hold a reference
+			uint64_t e = globalEpoch().load();
+			Limbo& limbo = pRecord->limbo[e % 3];
+			assert(limbo.pHead == nullptr || limbo.e == e);
+			limbo.e = e;
+			limbo.pHead = new Retired{ p, pDeleter, limbo.pHead };
+			numRetired().fetch_add(1, std::memory_order_relaxed);
+
+			// every so often see whether the slow threads have caught up
+			if (++pRecord->numSinceAdvance >= ADVANCE_EVERY) {
+				pRecord->numSinceAdvance = 0;
+				tryAdvance();
+			}
+		}
+
+		// Try to move the global epoch forward and free what became safe.
+		// Containers call this from their destructors; tests call it directly
+		static void collect();
+
+		// Number of nodes retired but not yet freed
+		static uint64_t pending() {
+			return numRetired().load() - numFreed().load();
+		}
+
+	private:
+		static const int ADVANCE_EVERY = 64;
+
+		struct Retired
+		{
+			void* p;
+			void (*pDeleter)(void*);
+			Retired* pNext;
+		};
+
+		// nodes retired during epoch e
+		struct Limbo
+		{
+			uint64_t e = 0;
+			Retired* pHead = nullptr;
+		};
+
+		// one per thread, each on its own cache lines. Records are recycled,
+		// never freed while running. The state is (epoch << 1) | 1 when
+		// pinned and 0 when not
+		struct alignas(64) Record
+		{
+			// Plain new only honors alignas(64) from C++17 on, so a record
+			// lines itself up by hand. The word just before it remembers
+			// where the allocation really starts
+			static void* operator new(size_t size)
+			{
+				char* pRaw = static_cast<char*>(::operator new(size + 64 + sizeof(void*)));
+				uintptr_t aligned = (reinterpret_cast<uintptr_t>(pRaw + sizeof(void*)) + 63) & ~uintptr_t(63);
+				void** p = reinterpret_cast<void**>(aligned);
+				p[-1] = pRaw;
+				return p;
+			}
+			static void operator delete(void* p)
+			{
+				if (p)
+					::operator delete(static_cast<void**>(p)[-1]);
+			}
+
+			std::atomic<uint64_t> state{ 0 };
+			std::atomic<bool> inUse{ true };
+			Record* pNext = nullptr;
+			int nesting = 0;
+			int numSinceAdvance = 0;
+			Limbo limbo[3];
+		};
+
+		// the records of every thread that ever pinned
+		struct Registry
+		{
+			std::atomic<Record*> pHead{ nullptr };
+			~Registry()
+			{
+				// the process is ending: nobody can be reading anything
+				Record* p = pHead.load();
+				while (p)
+				{
+					Record* pNext = p->pNext;
+					for (Limbo& limbo : p->limbo)
+						freeLimbo(limbo);
+					delete p;
+					p = pNext;
+				}
+			}
+		};
+
+		// gives a Record back to the pool when a thread exits
+		struct Handle
+		{
+			Record* pRecord = nullptr;
+			~Handle()
+			{
+				if (pRecord)
+					pRecord->inUse.store(false);
+			}
+		};
+
+		static std::atomic<uint64_t>& globalEpoch() {
+			static std::atomic<uint64_t> e{ 2 };
+			return e;
+		}
+
+		static std::atomic<uint64_t>& numRetired() {
+			static std::atomic<uint64_t> num{ 0 };
+			return num;
+		}
+
+		static std::atomic<uint64_t>& numFreed() {
+			static std::atomic<uint64_t> num{ 0 };
+			return num;
+		}
+
+		static Registry& registry() {
+			static Registry r;
+			return r;
+		}
+
+		// The calling thread's record, claimed on first use
+		static Record* self() {
+			thread_local Handle handle;
+			if (handle.pRecord == nullptr)
+				handle.pRecord = acquire();
+			return handle.pRecord;
+		}
+
+		// Reuse the record of a thread that exited, or push a new one
+		static Record* acquire() {
+			Registry& r = registry();
+			for (Record* p = r.pHead.load(); p; p = p->pNext) {
+				bool expected = false;
+				if (!p->inUse.load() && p->inUse.compare_exchange_strong(expected, true))
+					return p;
+			}
+			Record* pNew = new Record;
+			pNew->pNext = r.pHead.load();
+			while (!r.pHead.compare_exchange_weak(pNew->pNext, pNew))
+				;
+			return pNew;
+		}
+
+		static void pin(Record* pRecord) {
+			if (pRecord->nesting++ > 0)
+				return;
+			// announce first, then read the epoch: a seq_cst store followed
+			// by a seq_cst load keeps tryAdvance from missing us
+			uint64_t e = globalEpoch().load();
+			pRecord->state.store((e << 1) | 1);
+			uint64_t eNow = globalEpoch().load();
+			if (eNow != e)
+			{
+				e = eNow;
+				pRecord->state.store((e << 1) | 1);
+			}
+			reclaim(pRecord, e);
+		}
+
+		static void unpin(Record* pRecord) {
+			assert(pRecord->nesting > 0);
+			if (--pRecord->nesting == 0)
+				pRecord->state.store(0);
+		}
+
+		// Advance the global epoch if every pinned thread is in it
+		static void tryAdvance() {
+			uint64_t e = globalEpoch().load();
+			for (Record* p = registry().pHead.load(); p; p = p->pNext) {
+				uint64_t s = p->state.load();
+				if ((s & 1) && (s >> 1) != e)
+					return;
+			}
+			globalEpoch().compare_exchange_strong(e, e + 1);
+		}
+
+		// Free this thread's nodes retired two or more epochs before e
+		static void reclaim(Record* pRecord, uint64_t e) {
+			for (Limbo& limbo : pRecord->limbo)
+				if (limbo.pHead && limbo.e + 2 <= e)
+					freeLimbo(limbo);
+		}
+
+		static void freeLimbo(Limbo& limbo) {
+			uint64_t num = 0;
+			while (limbo.pHead) {
+				Retired* pRetired = limbo.pHead;
+				limbo.pHead = pRetired->pNext;
+				pRetired->pDeleter(pRetired->p);
+				delete pRetired;
+				++num;
+			}
+			numFreed().fetch_add(num, std::memory_order_relaxed);
+		}
+	};
+
+	/**************************************************
+	 * EPOCH GUARD
+	 * Pin the calling thread. Guards nest.
+	 **************************************************/
+	class epoch::guard
+	{
+	public:
+		guard() : pRecord(epoch::self()) { epoch::pin(pRecord); }
+		~guard() { epoch::unpin(pRecord); }
+		guard(const guard&) = delete;
+		guard& operator=(const guard&) = delete;
+
+	private:
+		epoch::Record* pRecord;
+	};
+
+	/**************************************************
+	 * EPOCH :: COLLECT
+	 * Pinning frees what the last advance made safe
+	 **************************************************/
+	inline void epoch::collect()
+	{
+		guard g;
+		tryAdvance();
+		reclaim(self(), globalEpoch().load());
+	}
+
+}; // namespace custom
@@ -0,0 +1,633 @@
+/***********************************************************************
+ * Header:
+ *    FLAT HASH SET
+ * Summary:
+ *    An open-addressing hash set with the elements stored in one array
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        flat_hash_set           : A SwissTable style hash set
+ *        flat_hash_set::iterator : An interator through the slots
+ *
+ *    Every slot has a one-byte control code: EMPTY, DELETED, or the low
+ *    seven bits of the element's hash (H2). The slots are split into
+ *    groups of sixteen. A lookup hashes once, picks a starting group
+ *    from the remaining bits (H1), and compares H2 against all sixteen
+ *    control bytes at once, only calling Eq on the slots that match.
+ *    A group containing an EMPTY byte ends the search.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for custom::pair returned by insert
+#include <cassert>
+#include <cstdint>    // for uint8_t, uint32_t
+#include <cstring>    // for memset, memcpy
+#include <new>        // for placement new
+#include <utility>    // for std::move, std::swap
+#include <functional> // for std::hash, std::equal_to
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_SET_SSE2
+#include <emmintrin.h> // for _mm_cmpeq_epi8 and friends
+#endif
+
+class TestFlatHashSet;      // forward declaration for unit tests
+
+namespace custom
+{
+	/************************************************
+	 * FLAT HASH SET
+	 * A set of unique elements kept in a flat array of
+	 * slots, probed a group of sixteen at a time
+	 ************************************************/
+	template <typename T, typename Hash = std::hash<T>, typename Eq = std::equal_to<T>>
+	class flat_hash_set
+	{
+		friend class ::TestFlatHashSet;   // give unit tests access to the privates
+	public:
+		//
+		// Construct
+		//
+		flat_hash_set(const Hash& hash = Hash(), const Eq& eq = Eq()) :
+			pCtrl(nullptr), pSlots(nullptr), numCapacity(0), numElements(0), numDeleted(0),
+			hasher(hash), equal(eq)
+		{
+		}
+		flat_hash_set(const flat_hash_set& rhs);
+		flat_hash_set(flat_hash_set&& rhs) noexcept : flat_hash_set(rhs.hasher, rhs.equal)
+		{
+			swap(rhs);
+		}
+		template <class Iterator>
+		flat_hash_set(Iterator first, Iterator last) : flat_hash_set()
+		{
+			for (; first != last; ++first)
+				insert(*first);
+		}
+		flat_hash_set(const std::initializer_list<T>& il) : flat_hash_set()
+		{
+			reserve(il.size());
+			for (const T& t : il)
+				insert(t);
+		}
+		~flat_hash_set()
+		{
+			destroy();
+		}
+
+		//
+		// Assign
+		//
+		flat_hash_set& operator=(const flat_hash_set& rhs)
+		{
+			if (this != &rhs)
+			{
+				flat_hash_set tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+		flat_hash_set& operator=(flat_hash_set&& rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				clear();
+				swap(rhs);
+			}
+			return *this;
+		}
+		flat_hash_set& operator=(const std::initializer_list<T>& il)
+		{
+			clear();
+			insert(il);
+			return *this;
+		}
+		void swap(flat_hash_set& rhs) noexcept
+		{
+			std::swap(pCtrl, rhs.pCtrl);
+			std::swap(pSlots, rhs.pSlots);
+			std::swap(numCapacity, rhs.numCapacity);
+			std::swap(numElements, rhs.numElements);
+			std::swap(numDeleted, rhs.numDeleted);
+			std::swap(hasher, rhs.hasher);
+			std::swap(equal, rhs.equal);
+		}
+
+		//
+		// Iterator
+		//
+		class iterator;
+		iterator begin() const
+		{
+			return iterator(pCtrl, pSlots, pCtrl + numCapacity);
+		}
+		iterator end() const
+		{
+			return iterator(pCtrl + numCapacity, pSlots + numCapacity, pCtrl + numCapacity);
+		}
+
+		//
+		// Access
+		//
+		iterator find(const T& t) const
+		{
+			size_t i = findIndex(t, hashOf(t));
+			return i == NOT_FOUND ? end() : iteratorAt(i);
+		}
+
+		//
+		// Insert
+		//
+		custom::pair<iterator, bool> insert(const T& t)
+		{
+			return emplaceUnique(t);
+		}
+		custom::pair<iterator, bool> insert(T&& t)
+		{
+			return emplaceUnique(std::move(t));
+		}
+		void insert(const std::initializer_list<T>& il)
+		{
+			for (const T& t : il)
+				insert(t);
+		}
+
+		//
+		// Remove
+		//
+		void clear() noexcept;
+		iterator erase(const T& t)
+		{
+			size_t i = findIndex(t, hashOf(t));
+			if (i == NOT_FOUND)
+				return end();
+			eraseAt(i);
+			return iteratorAt(i);
+		}
+		iterator erase(iterator it)
+		{
+			size_t i = it.pSlot - pSlots;
+			eraseAt(i);
+			return iteratorAt(i);
+		}
+
+		//
+		// Hash policy
+		//
+		float load_factor() const noexcept
+		{
+			return numCapacity ? static_cast<float>(numElements) / static_cast<float>(numCapacity) : 0.0f;
+		}
+		float max_load_factor() const noexcept
+		{
+			return 7.0f / 8.0f;
+		}
+		void rehash(size_t numSlotsMin);
+		void reserve(size_t num)
+		{
+			rehash(slotsFor(num));
+		}
+
+		//
+		// Status
+		//
+		size_t size()         const noexcept { return numElements; }
+		bool   empty()        const noexcept { return numElements == 0; }
+		size_t bucket_count() const noexcept { return numCapacity; }
+
+	private:
+
+		// control bytes. Full slots hold H2, which is 0..127
+		static const int8_t EMPTY = -128;   // 0b10000000
+		static const int8_t DELETED = -2;   // 0b11111110
+		static const size_t GROUP_WIDTH = 16;
+		static const size_t NOT_FOUND = static_cast<size_t>(-1);
+
+		/************************************************
+		 * GROUP
+		 * Sixteen control bytes compared in parallel. Each
+		 * match returns a bitmask with bit i set for byte i
+		 ************************************************/
+		class Group
+		{
+		public:
+			explicit Group(const int8_t* p)
+			{
+#ifdef FLAT_HASH_SET_SSE2
+				ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+#else
+				memcpy(ctrl, p, GROUP_WIDTH);
+#endif
+			}
+
+			// slots whose H2 equals h2
+			uint32_t match(int8_t h2) const
+			{
+#ifdef FLAT_HASH_SET_SSE2
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+				uint32_t mask = 0;
+				for (size_t i = 0; i < GROUP_WIDTH; i++)
+					mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+				return mask;
+#endif
+			}
+
+			// slots that end a probe
+			uint32_t matchEmpty() const
+			{
+				return match(EMPTY);
+			}
+
+			// slots an insert may use: the high bit is set only for EMPTY and DELETED
+			uint32_t matchEmptyOrDeleted() const
+			{
+#ifdef FLAT_HASH_SET_SSE2
+				return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+				uint32_t mask = 0;
+				for (size_t i = 0; i < GROUP_WIDTH; i++)
+					mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+				return mask;
+#endif
+			}
+
+		private:
+#ifdef FLAT_HASH_SET_SSE2
+			__m128i ctrl;
+#else
+			int8_t ctrl[GROUP_WIDTH];
+#endif
+		};
+
+		// the index of the lowest set bit of a non-zero mask
+		static size_t lowestBit(uint32_t mask)
+		{
+			assert(mask != 0);
+#if defined(__GNUC__)
+			return static_cast<size_t>(__builtin_ctz(mask));
+#else
+			size_t i = 0;
+			while ((mask & 1) == 0)
+			{
+				mask >>= 1;
+				i++;
+			}
+			return i;
+#endif
+		}
+
+		// mix the user's hash so identity hashes of small integers
+		// still spread over both H1 and H2
+		size_t hashOf(const T& t) const
+		{
+			uint64_t h = static_cast<uint64_t>(hasher(t)) * 0x9E3779B97F4A7C15ull;
+			return static_cast<size_t>(h ^ (h >> 32));
+		}
+		static size_t H1(size_t hash) { return hash >> 7; }
+		static int8_t H2(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+
+		size_t numGroups() const { return numCapacity / GROUP_WIDTH; }
+		size_t growthLimit() const { return numCapacity - numCapacity / 8; }
+		static size_t slotsFor(size_t num) { return num + (num + 6) / 7; }
+
+		iterator iteratorAt(size_t i) const
+		{
+			return iterator(pCtrl + i, pSlots + i, pCtrl + numCapacity);
+		}
+
+		size_t findIndex(const T& t, size_t hash) const;
+		size_t findInsertIndex(size_t hash) const;
+		template <class U>
+		custom::pair<iterator, bool> emplaceUnique(U&& t);
+		void eraseAt(size_t i);
+		void resize(size_t numCapacityNew);
+		void destroy() noexcept;
+
+		int8_t* pCtrl;           // one control byte per slot
+		T* pSlots;               // the elements, in the same block as pCtrl
+		size_t numCapacity;      // number of slots, a power of two and a multiple of 16
+		size_t numElements;      // number of full slots
+		size_t numDeleted;       // number of tombstones
+		Hash hasher;
+		Eq equal;
+	};
+
+
+	/************************************************
+	 * FLAT HASH SET ITERATOR
+	 * Walks the slots, skipping the ones that are not full
+	 ************************************************/
+	template <typename T, typename Hash, typename Eq>
+	class flat_hash_set <T, Hash, Eq> ::iterator
+	{
+		friend class ::TestFlatHashSet;   // give unit tests access to the privates
+		friend class flat_hash_set <T, Hash, Eq>;
+	public:
+		//
+		// Construct
+		//
+		iterator() : pCtrl(nullptr), pSlot(nullptr), pCtrlEnd(nullptr) {}
+		iterator(int8_t* pCtrl, T* pSlot, int8_t* pCtrlEnd) : pCtrl(pCtrl), pSlot(pSlot), pCtrlEnd(pCtrlEnd)
+		{
+			skipEmpty();
+		}
+
+		//
+		// Compare
+		//
+		bool operator == (const iterator& rhs) const { return pSlot == rhs.pSlot; }
+		bool operator != (const iterator& rhs) const { return pSlot != rhs.pSlot; }
+
+		//
+		// Access. The element cannot change or it would be in the wrong slot
+		//
+		const T& operator * () const { return *pSlot; }
+		const T* operator -> () const { return pSlot; }
+
+		//
+		// Arithmetic
+		//
+		iterator& operator ++ ()
+		{
+			if (pCtrl != pCtrlEnd)
+			{
+				++pCtrl;
+				++pSlot;
+				skipEmpty();
+			}
+			return *this;
+		}
+		iterator operator ++ (int)
+		{
+			iterator tmp = *this;
+			++(*this);
+			return tmp;
+		}
+
+	private:
+		void skipEmpty()
+		{
+			while (pCtrl != pCtrlEnd && *pCtrl < 0)
+			{
+				++pCtrl;
+				++pSlot;
+			}
+		}
+
+		int8_t* pCtrl;
+		T* pSlot;
+		int8_t* pCtrlEnd;
+	};
+
+
+	/*****************************************
+	 * FLAT HASH SET :: COPY CONSTRUCTOR
+	 * Same capacity and the same layout, so every
+	 * element is copied straight into its slot. The
+	 * tombstones come too: an element that probed past
+	 * one would be lost behind an EMPTY byte without it
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	flat_hash_set <T, Hash, Eq> ::flat_hash_set(const flat_hash_set& rhs) :
+		flat_hash_set(rhs.hasher, rhs.equal)
+	{
+		if (rhs.numElements == 0)
+			return;
+		resize(rhs.numCapacity);
+		try
+		{
+			for (size_t i = 0; i < numCapacity; i++)
+				if (rhs.pCtrl[i] >= 0)
+				{
+					new (pSlots + i) T(rhs.pSlots[i]);
+					pCtrl[i] = rhs.pCtrl[i];
+					numElements++;
+				}
+				else
+					pCtrl[i] = rhs.pCtrl[i];
+			numDeleted = rhs.numDeleted;
+		}
+		catch (...)
+		{
+			destroy();
+			throw;
+		}
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: FIND INDEX
+	 * Probe group by group. Only slots whose control
+	 * byte equals H2 are compared with Eq
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	size_t flat_hash_set <T, Hash, Eq> ::findIndex(const T& t, size_t hash) const
+	{
+		if (numCapacity == 0)
+			return NOT_FOUND;
+
+		int8_t h2 = H2(hash);
+		size_t maskGroups = numGroups() - 1;
+		size_t iGroup = H1(hash) & maskGroups;
+		for (size_t step = 1; step <= numGroups(); step++)
+		{
+			size_t iFirst = iGroup * GROUP_WIDTH;
+			Group g(pCtrl + iFirst);
+			for (uint32_t match = g.match(h2); match; match &= match - 1)
+			{
+				size_t i = iFirst + lowestBit(match);
+				if (equal(pSlots[i], t))
+					return i;
+			}
+			if (g.matchEmpty())
+				return NOT_FOUND;
+
+			// triangular probing visits every group exactly once
+			iGroup = (iGroup + step) & maskGroups;
+		}
+		return NOT_FOUND;
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: FIND INSERT INDEX
+	 * The first EMPTY or DELETED slot on the probe
+	 * sequence. There is always one below the growth limit
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	size_t flat_hash_set <T, Hash, Eq> ::findInsertIndex(size_t hash) const
+	{
+		size_t maskGroups = numGroups() - 1;
+		size_t iGroup = H1(hash) & maskGroups;
+		for (size_t step = 1; ; step++)
+		{
+			assert(step <= numGroups());
+			Group g(pCtrl + iGroup * GROUP_WIDTH);
+			uint32_t mask = g.matchEmptyOrDeleted();
+			if (mask)
+				return iGroup * GROUP_WIDTH + lowestBit(mask);
+			iGroup = (iGroup + step) & maskGroups;
+		}
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: EMPLACE UNIQUE
+	 * Insert t unless an equal element is present
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	template <class U>
+	custom::pair<typename flat_hash_set <T, Hash, Eq> ::iterator, bool>
+		flat_hash_set <T, Hash, Eq> ::emplaceUnique(U&& t)
+	{
+		size_t hash = hashOf(t);
+		size_t i = findIndex(t, hash);
+		if (i != NOT_FOUND)
+			return custom::pair<iterator, bool>(iteratorAt(i), false);
+
+		// make room before picking the slot: a resize moves everything
+		if (numCapacity == 0)
+			resize(GROUP_WIDTH);
+		else if (numElements + numDeleted + 1 > growthLimit())
+		{
+			// mostly tombstones: rebuild at the same size, else double
+			if (numElements + 1 <= growthLimit() / 2)
+				resize(numCapacity);
+			else
+				resize(numCapacity * 2);
+		}
+
+		i = findInsertIndex(hash);
+		new (pSlots + i) T(std::forward<U>(t));
+		if (pCtrl[i] == DELETED)
+			numDeleted--;
+		pCtrl[i] = H2(hash);
+		numElements++;
+		return custom::pair<iterator, bool>(iteratorAt(i), true);
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: ERASE AT
+	 * A slot can go back to EMPTY only if its group
+	 * already has an EMPTY: then no probe ever passed
+	 * through this group, because inserts stop at the
+	 * first group with room. Otherwise leave a tombstone
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void flat_hash_set <T, Hash, Eq> ::eraseAt(size_t i)
+	{
+		assert(i < numCapacity && pCtrl[i] >= 0);
+		pSlots[i].~T();
+		numElements--;
+
+		Group g(pCtrl + (i / GROUP_WIDTH) * GROUP_WIDTH);
+		if (g.matchEmpty())
+			pCtrl[i] = EMPTY;
+		else
+		{
+			pCtrl[i] = DELETED;
+			numDeleted++;
+		}
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: REHASH
+	 * Grow to at least numSlotsMin slots, never below
+	 * what the current elements need
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void flat_hash_set <T, Hash, Eq> ::rehash(size_t numSlotsMin)
+	{
+		if (numSlotsMin < slotsFor(numElements + 1))
+			numSlotsMin = slotsFor(numElements + 1);
+		size_t numCapacityNew = GROUP_WIDTH;
+		while (numCapacityNew < numSlotsMin)
+			numCapacityNew *= 2;
+		if (numCapacityNew != numCapacity)
+			resize(numCapacityNew);
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: RESIZE
+	 * Move every element into a fresh table of
+	 * numCapacityNew slots. Tombstones are dropped
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void flat_hash_set <T, Hash, Eq> ::resize(size_t numCapacityNew)
+	{
+		assert(numCapacityNew >= GROUP_WIDTH && (numCapacityNew & (numCapacityNew - 1)) == 0);
+
+		// one block: the control bytes, then the slots at T's alignment
+		size_t sizeCtrl = (numCapacityNew + alignof(T) - 1) / alignof(T) * alignof(T);
+		char* pBlock = static_cast<char*>(::operator new(sizeCtrl + numCapacityNew * sizeof(T)));
+
+		int8_t* pCtrlOld = pCtrl;
+		T* pSlotsOld = pSlots;
+		size_t numCapacityOld = numCapacity;
+
+		pCtrl = reinterpret_cast<int8_t*>(pBlock);
+		pSlots = reinterpret_cast<T*>(pBlock + sizeCtrl);
+		numCapacity = numCapacityNew;
+		numDeleted = 0;
+		memset(pCtrl, EMPTY, numCapacity);
+
+		for (size_t i = 0; i < numCapacityOld; i++)
+			if (pCtrlOld[i] >= 0)
+			{
+				size_t hash = hashOf(pSlotsOld[i]);
+				size_t iNew = findInsertIndex(hash);
+				new (pSlots + iNew) T(std::move(pSlotsOld[i]));
+				pCtrl[iNew] = H2(hash);
+				pSlotsOld[i].~T();
+			}
+
+		::operator delete(pCtrlOld);
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: CLEAR
+	 * Destroy the elements but keep the slots
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void flat_hash_set <T, Hash, Eq> ::clear() noexcept
+	{
+		for (size_t i = 0; i < numCapacity; i++)
+			if (pCtrl[i] >= 0)
+				pSlots[i].~T();
+		if (numCapacity)
+			memset(pCtrl, EMPTY, numCapacity);
+		numElements = 0;
+		numDeleted = 0;
+	}
+
+	/*****************************************
+	 * FLAT HASH SET :: DESTROY
+	 * Destroy the elements and free the block
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void flat_hash_set <T, Hash, Eq> ::destroy() noexcept
+	{
+		clear();
+		::operator delete(pCtrl);
+		pCtrl = nullptr;
+		pSlots = nullptr;
+		numCapacity = 0;
+	}
+
+	/*****************************************
+	 * SWAP
+	 * Stand-alone flat hash set swap
+	 ****************************************/
+	template <typename T, typename Hash, typename Eq>
+	void swap(flat_hash_set<T, Hash, Eq>& lhs, flat_hash_set<T, Hash, Eq>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
@@ -11,8 +11,9 @@
  *    |_____|  '.____.'   '.____.'  /_/
  *
  *    This will contain the class definition of:
+ *        hash_table              : The bucket engine shared by the hashes
+ *        hash_table::iterator    : An interator through hash
  *        unordered_set           : A class that represents a hash
- *        unordered_set::iterator : An interator through hash
  * Author
  *    <your names here>
  ************************************************************************/
@@ -20,46 +21,161 @@
 #pragma once
 
 #include "list.h"     // because this->buckets[0] is a list
+#include "pair.h"     // for custom::pair returned by insert
+#include "bloom_filter.h" // for the optional front filter
 #include <memory>     // for std::allocator
 #include <functional> // for std::hash
 #include <cmath>      // for std::ceil
+#include <algorithm>  // for std::min and std::max
+#include <stdexcept>  // for std::out_of_range
+#include <new>        // for ::operator new and placement new
+#include <initializer_list>
 
+// a hint to start pulling p into cache; it never faults
+#if defined(__GNUC__)
+#define HASH_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // for _mm_prefetch
+#define HASH_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#else
+#define HASH_PREFETCH(p) ((void)(p))
+#endif
+
+// statement only runs when HASH_TABLE_STATS is defined; otherwise nothing is compiled
+#ifdef HASH_TABLE_STATS
+#include "hash_stats.h" // for hash_table_stats
+#include <chrono>     // for timing rehashes
+#define HASH_TABLE_COUNT(statement) statement
+#else
+#define HASH_TABLE_COUNT(statement) ((void)0)
+#endif
 
 class TestHash;             // forward declaration for Hash unit tests
+class TestUnorderedMap;     // forward declaration for unordered_map unit tests
 
 namespace custom
 {
 	/************************************************
-	 * UNORDERED SET
-	 * A set implemented as a hash
+	 * HASHED ENTRY
+	 * An element stored next to its full hash, so a
+	 * rehash never calls Hash again and a lookup turns
+	 * away most mismatches with one integer compare
 	 ************************************************/
 	template <typename T>
-	class unordered_set
+	struct hashed_entry
 	{
-		friend class ::TestHash;   // give unit tests access to the privates
-		friend void swap<>(unordered_set<T>& lhs, unordered_set<T>& rhs);
+		T value;
+		size_t hash;
+	};
+
+	/************************************************
+	 * BUCKET ENTRY
+	 * What the bucket lists hold: the bare element, or
+	 * a hashed_entry when the set caches hash codes
+	 ************************************************/
+	template <typename T, bool CacheHash>
+	struct bucket_entry
+	{
+		typedef T type;
+		static T& value(T& e) { return e; }
+		static const T& value(const T& e) { return e; }
+		static const T& make(const T& t, size_t) { return t; }
+		static bool sameHash(const T&, size_t) { return true; }
+		static T&& make(T&& t, size_t) { return std::move(t); }
+		template <class Hash, class KeyOf>
+		static size_t hash(const T& e, const Hash& hasher, KeyOf keyOf) { return hasher(keyOf(e)); }
+	};
+
+	template <typename T>
+	struct bucket_entry <T, true>
+	{
+		typedef hashed_entry<T> type;
+		static T& value(type& e) { return e.value; }
+		static const T& value(const type& e) { return e.value; }
+		static type make(const T& t, size_t hash) { return type{ t, hash }; }
+		static bool sameHash(const type& e, size_t hash) { return e.hash == hash; }
+		static type make(T&& t, size_t hash) { return type{ std::move(t), hash }; }
+		template <class Hash, class KeyOf>
+		static size_t hash(const type& e, const Hash&, KeyOf) { return e.hash; }
+	};
+
+	/************************************************
+	 * IDENTITY KEY
+	 * A set element is its own key
+	 ************************************************/
+	template <typename T>
+	struct identity_key
+	{
+		const T& operator()(const T& t) const { return t; }
+	};
+
+	/************************************************
+	 * HASH TABLE
+	 * Separate chaining over an array of lists. Buckets
+	 * hold Values, and KeyOf pulls out the Key that Hash
+	 * and KeyEqual work on. The bucket array grows
+	 * whenever an insert would push the load factor past
+	 * max_load_factor(), either all at once or, in
+	 * incremental mode, a few buckets per operation.
+	 * With CacheHash each element keeps its hash beside it.
+	 * An optional Bloom filter in front of the buckets
+	 * turns most lookups of absent keys away early
+	 ************************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	class hash_table
+	{
+		friend class ::TestHash;           // give unit tests access to the privates
+		friend class ::TestUnorderedMap;
+	protected:
+		typedef bucket_entry<Value, CacheHash> EntryTraits;
+		typedef typename EntryTraits::type Entry;   // what a bucket holds
 	public:
 		//
 		// Construct
 		//
-		unordered_set() : buckets(), numElements(0)
+		hash_table() : buckets(newBuckets(DEFAULT_BUCKETS)), numBuckets(DEFAULT_BUCKETS),
+			numElements(0), maxLoadFactor(1.0f), bucketsOld(nullptr), numBucketsOld(0), rehashIndex(0),
+			bucketsNext(nullptr), numBucketsNext(0), numBucketsBuilt(0),
+			incremental(false), filterRate(0.0), numFilterStale(0), hasher(), equal()
 		{
 			// Do nothing
 		}
-		unordered_set(unordered_set& rhs) : buckets(), numElements(rhs.numElements)
+		explicit hash_table(size_t numBuckets, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			buckets(nullptr), numBuckets(numBuckets ? numBuckets : 1),
+			numElements(0), maxLoadFactor(1.0f), bucketsOld(nullptr), numBucketsOld(0), rehashIndex(0),
+			bucketsNext(nullptr), numBucketsNext(0), numBucketsBuilt(0),
+			incremental(false), filterRate(0.0), numFilterStale(0), hasher(hash), equal(eq)
+		{
+			buckets = newBuckets(this->numBuckets);
+		}
+		hash_table(const hash_table& rhs) : buckets(newBuckets(rhs.numBuckets)),
+			numBuckets(rhs.numBuckets), numElements(rhs.numElements), maxLoadFactor(rhs.maxLoadFactor),
+			bucketsOld(nullptr), numBucketsOld(rhs.numBucketsOld), rehashIndex(rhs.rehashIndex),
+			bucketsNext(nullptr), numBucketsNext(0), numBucketsBuilt(0),
+			incremental(rhs.incremental), filter(rhs.filter), filterRate(rhs.filterRate),
+			numFilterStale(rhs.numFilterStale), hasher(rhs.hasher), equal(rhs.equal)
 		{
 			// Copy each bucket
-			for (size_t i = 0; i < 10; ++i)
+			for (size_t i = 0; i < numBuckets; ++i)
 				buckets[i] = rhs.buckets[i];
+
+			// and whatever rhs has not migrated yet. A next array rhs is
+			// still building holds nothing, so it is not copied
+			if (rhs.bucketsOld)
+			{
+				bucketsOld = allocBuckets(numBucketsOld);
+				buildBuckets(bucketsOld, rehashIndex, numBucketsOld);
+				for (size_t i = rehashIndex; i < numBucketsOld; ++i)
+					bucketsOld[i] = rhs.bucketsOld[i];
+			}
 		}
-		unordered_set(unordered_set&& rhs) : buckets(), numElements(std::move(rhs.numElements))
+		hash_table(hash_table&& rhs) : hash_table()
 		{
-			// Copy each bucket
-			for (size_t i = 0; i < 10; ++i)
-				buckets[i] = std::move(rhs.buckets[i]);
+			// rhs is left with our empty default buckets
+			swap(rhs);
 		}
 		template <class Iterator>
-		unordered_set(Iterator first, Iterator last) : buckets(), numElements(0)
+		hash_table(Iterator first, Iterator last) : hash_table()
 		{
 			// Iterate over each item and insert them
 			Iterator current = Iterator(first);
@@ -69,40 +185,65 @@ namespace custom
 				++current;
 			}
 		}
+		hash_table(const std::initializer_list<Value>& il) : hash_table()
+		{
+			insert(il);
+		}
+		~hash_table()
+		{
+			freeBuckets(buckets, 0, numBuckets);
+			freeBuckets(bucketsOld, rehashIndex, numBucketsOld);
+			freeBuckets(bucketsNext, 0, numBucketsBuilt);
+		}
 
 
 		//
 		// Assign
 		//
-		unordered_set& operator=(unordered_set& rhs)
+		hash_table& operator=(const hash_table& rhs)
 		{
-			if (this != &rhs)
+			if (this != &rhs && (rehashing() || rhs.rehashing()))
 			{
-				// Clear the current contents
-				clear();
+				// one side is mid-rehash: take a plain copy instead
+				hash_table copy(rhs);
+				swap(copy);
+			}
+			else if (this != &rhs)
+			{
+				// Only reallocate when the bucket counts differ
+				if (numBuckets != rhs.numBuckets)
+				{
+					custom::list<Entry>* bucketsNew = newBuckets(rhs.numBuckets);
+					freeBuckets(buckets, 0, numBuckets);
+					buckets = bucketsNew;
+					numBuckets = rhs.numBuckets;
+				}
 
-				// Copy elements
+				// Copy elements, reusing the nodes already in each bucket
 				numElements = rhs.numElements;
-				for (size_t i = 0; i < 10; ++i) {
+				maxLoadFactor = rhs.maxLoadFactor;
+				incremental = rhs.incremental;
+				filter = rhs.filter;
+				filterRate = rhs.filterRate;
+				numFilterStale = rhs.numFilterStale;
+				hasher = rhs.hasher;
+				equal = rhs.equal;
+				for (size_t i = 0; i < numBuckets; ++i) {
 					buckets[i] = rhs.buckets[i];
 				}
 			}
 			return *this;
 		}
-		unordered_set& operator=(unordered_set&& rhs)
+		hash_table& operator=(hash_table&& rhs)
 		{
 			if (this != &rhs)
 			{
 				clear();
-				numElements = rhs.numElements;
-				for (size_t i = 0; i < 10; ++i) {
-					buckets[i] = std::move(rhs.buckets[i]);
-				}
-				rhs.numElements = 0;
+				swap(rhs);
 			}
 			return *this;
 		}
-		unordered_set& operator=(const std::initializer_list<T>& il)
+		hash_table& operator=(const std::initializer_list<Value>& il)
 		{
 			clear();
 			for (const auto& item : il) {
@@ -110,12 +251,24 @@ namespace custom
 			}
 			return *this;
 		}
-		void swap(unordered_set& rhs)
+		void swap(hash_table& rhs)
 		{
+			std::swap(buckets, rhs.buckets);
+			std::swap(numBuckets, rhs.numBuckets);
 			std::swap(numElements, rhs.numElements);
-			for (size_t i = 0; i < 10; ++i) {
-				buckets[i].swap(rhs.buckets[i]);
-			}
+			std::swap(maxLoadFactor, rhs.maxLoadFactor);
+			std::swap(bucketsOld, rhs.bucketsOld);
+			std::swap(numBucketsOld, rhs.numBucketsOld);
+			std::swap(rehashIndex, rhs.rehashIndex);
+			std::swap(bucketsNext, rhs.bucketsNext);
+			std::swap(numBucketsNext, rhs.numBucketsNext);
+			std::swap(numBucketsBuilt, rhs.numBucketsBuilt);
+			std::swap(incremental, rhs.incremental);
+			filter.swap(rhs.filter);
+			std::swap(filterRate, rhs.filterRate);
+			std::swap(numFilterStale, rhs.numFilterStale);
+			std::swap(hasher, rhs.hasher);
+			std::swap(equal, rhs.equal);
 		}
 
 		// 
@@ -125,11 +278,14 @@ namespace custom
 		class local_iterator;
 		iterator begin()
 		{
+			// A walk must see every element, so settle any rehash first
+			finishRehash();
+
 			// Find the first non-empty bucket
-			for (size_t i = 0; i < 10; ++i) {
+			for (size_t i = 0; i < numBuckets; ++i) {
 				if (!buckets[i].empty()) {
 					// Create and return an iterator pointing to the beginning of the first non-empty bucket
-					return iterator(&buckets[i], &buckets[i] + 1, buckets[i].begin());
+					return iterator(buckets + i, buckets + numBuckets, buckets[i].begin());
 				}
 			}
 			// If no non-empty buckets were found, return end()
@@ -137,20 +293,21 @@ namespace custom
 		}
 		iterator end()
 		{
-			// Return an iterator that represents the end of the unordered_set
-		 // Use nullptr for buckets and end of list iterator for list
-			return iterator(nullptr, nullptr, typename custom::list<T>::iterator());
+			// One past the last bucket, with the end of a list
+			return iterator(buckets + numBuckets, buckets + numBuckets, typename custom::list<Entry>::iterator());
 		}
 		local_iterator begin(size_t iBucket)
 		{
-			if (iBucket >= 10) {
+			finishRehash();
+			if (iBucket >= numBuckets) {
 				throw std::out_of_range("Bucket index out of range");
 			}
 			return local_iterator(buckets[iBucket].begin());
 		}
 		local_iterator end(size_t iBucket)
 		{
-			if (iBucket >= 10) {
+			finishRehash();
+			if (iBucket >= numBuckets) {
 				throw std::out_of_range("Bucket index out of range");
 			}
 			return local_iterator(buckets[iBucket].end());
@@ -159,57 +316,71 @@ namespace custom
 		//
 		// Access
 		//
-		size_t bucket(const T& t)
+		size_t bucket(const Key& k) const
 		{
 			// Hash the element and return the appropriate bucket index
-			std::hash<T> hashFn;
-			return hashFn(t) % 10;
+			return hasher(k) % numBuckets;
 		}
 
-		iterator find(const T& t)
+		iterator find(const Key& k)
 		{
-			size_t bucketIndex = bucket(t);
-			auto it = buckets[bucketIndex].begin();
-			auto endIt = buckets[bucketIndex].end();
+			return findHashed(k, hasher(k));
+		}
+		size_t count(const Key& k)
+		{
+			return find(k) == end() ? 0 : 1;
+		}
+		bool contains(const Key& k)
+		{
+			return find(k) != end();
+		}
 
-			while (it != endIt) {
-				if (*it == t) {
-					return iterator(&buckets[bucketIndex], &buckets[bucketIndex] + 1, it);
-				}
-				++it;
-			}
+		// With a transparent Hash and KeyEqual any key type they accept
+		// is looked up as-is, so no Key is ever built just to search
+		template <class K2, class H = Hash, class E = KeyEqual,
+		          class = typename H::is_transparent, class = typename E::is_transparent>
+		iterator find(const K2& k)
+		{
+			return findHashed(k, hasher(k));
+		}
+		template <class K2, class H = Hash, class E = KeyEqual,
+		          class = typename H::is_transparent, class = typename E::is_transparent>
+		size_t count(const K2& k)
+		{
+			return find(k) == end() ? 0 : 1;
+		}
+		template <class K2, class H = Hash, class E = KeyEqual,
+		          class = typename H::is_transparent, class = typename E::is_transparent>
+		bool contains(const K2& k)
+		{
+			return find(k) != end();
+		}
 
-			return end();
+		// Look up num keys at once: out[i] is find(keys[i]). The keys are
+		// handled a window at a time so the cache misses overlap
+		void find_batch(const Key* keys, size_t num, iterator* out)
+		{
+			lookupBatch(keys, num, [out](size_t i, const iterator& it) { out[i] = it; });
+		}
+		void contains_batch(const Key* keys, size_t num, bool* out)
+		{
+			iterator itEnd = end();
+			lookupBatch(keys, num, [out, itEnd](size_t i, const iterator& it) { out[i] = it != itEnd; });
 		}
 
 		//   
 		// Insert
 		//
-		custom::pair<iterator, bool> insert(const T& t)
+		custom::pair<iterator, bool> insert(const Value& v)
 		{
-			size_t bucketIndex = bucket(t);
-			auto& bucketList = buckets[bucketIndex];
-
-			// Check if the element already exists
-			for (auto it = bucketList.begin(); it != bucketList.end(); ++it)
-			{
-				if (*it == t)
-				{
-					return { iterator(&buckets[bucketIndex], &buckets[bucketIndex] + 1, it), false };
-				}
-			}
-
-			// Insert the new element
-			bucketList.push_back(t);
-			++numElements;
-
-			// Return the iterator to the newly inserted element
-			auto it = bucketList.end();
-			--it;  // Move to the last element which is the newly inserted one
-			return { iterator(&buckets[bucketIndex], &buckets[bucketIndex] + 1, it), true };
+			return insertUnique(v);
+		}
+		custom::pair<iterator, bool> insert(Value&& v)
+		{
+			return insertUnique(std::move(v));
 		}
 
-		void insert(const std::initializer_list<T>& il)
+		void insert(const std::initializer_list<Value>& il)
 		{
 			for (const auto& item : il) {
 				insert(item);
@@ -222,30 +393,123 @@ namespace custom
 		//
 		void clear() noexcept
 		{
-			for (auto& bucket : buckets) {
-				bucket.clear();
+			for (size_t i = 0; i < numBuckets; ++i) {
+				buckets[i].clear();
 			}
+			freeBuckets(bucketsOld, rehashIndex, numBucketsOld);
+			bucketsOld = nullptr;
+			numBucketsOld = 0;
+			rehashIndex = 0;
+			freeBuckets(bucketsNext, 0, numBucketsBuilt);
+			bucketsNext = nullptr;
+			numBucketsNext = 0;
+			numBucketsBuilt = 0;
 			numElements = 0;
+			filter.clear();
+			numFilterStale = 0;
 		}
-		iterator erase(const T& t)
+		iterator erase(const Key& k)
 		{
-			size_t bucketIndex = bucket(t);
+			size_t hash = hasher(k);
+			settle(hash);
+			size_t bucketIndex = hash % numBuckets;
 			auto& bucketList = buckets[bucketIndex];
 
-			auto it = bucketList.begin();
-			auto endIt = bucketList.end();
+			auto it = locate(k, hash, bucketIndex);
+			if (it == bucketList.end())
+				return end();
 
-			while (it != endIt) {
-				if (*it == t) {
-					it = bucketList.erase(it);
-					--numElements;
-					return iterator(&buckets[bucketIndex], &buckets[bucketIndex] + 1, it);
-				}
-				++it;
+			it = bucketList.erase(it);
+			--numElements;
+
+			// the filter cannot forget k; rebuild once the stale hashes pile up
+			if (filterRate > 0.0 && ++numFilterStale > numElements)
+				rebuildFilter();
+			return iterator(buckets + bucketIndex, buckets + numBuckets, it);
+		}
+
+		//
+		// Hash policy
+		//
+		float load_factor() const noexcept
+		{
+			return static_cast<float>(numElements) / static_cast<float>(numBuckets);
+		}
+		float max_load_factor() const noexcept
+		{
+			return maxLoadFactor;
+		}
+		void max_load_factor(float m)
+		{
+			if (!(m > 0.0f)) {
+				throw std::out_of_range("max_load_factor must be positive");
 			}
+			maxLoadFactor = m;
+			if (load_factor() > maxLoadFactor)
+				rehash(minBuckets(numElements));
+		}
+		void rehash(size_t numBucketsMin);
+		void reserve(size_t num)
+		{
+			rehash(minBuckets(num));
+		}
 
-			return end();
+		// Incremental mode: growth builds the new bucket array and then
+		// moves the old buckets, a few on every find, insert and erase, so
+		// no single call pays for the whole rehash. Turning it off finishes
+		// any rehash in progress
+		void incremental_rehash(bool on)
+		{
+			if (!on)
+				finishRehash();
+			incremental = on;
+		}
+		bool incremental_rehash() const
+		{
+			return incremental;
+		}
+		bool rehashing() const
+		{
+			return bucketsOld != nullptr || bucketsNext != nullptr;
+		}
+
+		// Front filter: a Bloom filter of every element's hash, checked
+		// before the buckets, so a lookup of an absent key usually ends
+		// after one cache line. It is resized whenever the buckets grow;
+		// mid-rehash it fills up as the old buckets migrate, since every
+		// lookup settles its own bucket first. A rate of 0 turns it off
+		void front_filter(double falsePositiveRate)
+		{
+			if (falsePositiveRate > 0.0)
+			{
+				filterRate = falsePositiveRate;
+				rebuildFilter();
+			}
+			else
+			{
+				filterRate = 0.0;
+				filter = bloom_filter<Key, Hash>();
+			}
+		}
+		double front_filter() const
+		{
+			return filterRate;
+		}
+
+#ifdef HASH_TABLE_STATS
+		//
+		// Stats: the counters so far, plus a fresh bucket-length histogram
+		//
+		hash_table_stats stats() const;
+		void reset_stats()
+		{
+			counters.reset();
+		}
+		void dump_stats(std::ostream& out) const
+		{
+			stats().write_json(out);
 		}
+#endif // HASH_TABLE_STATS
 
 		//
 		// Status
@@ -260,46 +524,516 @@ namespace custom
 		}
 		size_t bucket_count() const
 		{
-			return buckets->size();
+			return numBuckets;
 		}
 		size_t bucket_size(size_t i) const
 		{
-			if (i >= 10) {
+			if (i >= numBuckets) {
 				throw std::out_of_range("Bucket index out of range");
 			}
-			return buckets[i].size();
+			size_t num = buckets[i].size();
+
+			// mid-rehash, some of bucket i may still be in the old array
+			if (bucketsOld)
+				for (size_t j = rehashIndex; j < numBucketsOld; ++j)
+					for (auto it = bucketsOld[j].begin(); it != bucketsOld[j].end(); ++it)
+						if (EntryTraits::hash(*it, hasher, KeyOf()) % numBuckets == i)
+							num++;
+			return num;
+		}
+
+	protected:
+
+		size_t hashOf(const Key& k) const
+		{
+			return hasher(k);
+		}
+
+		// the element with key k, whose hash is already known, or end()
+		template <class K2>
+		iterator findHashed(const K2& k, size_t hash)
+		{
+			// settle first: inserts must keep the rehash moving even when the
+			// filter answers, and afterwards the filter is complete for hash
+			settle(hash);
+			if (filterRate > 0.0 && !filter.contains_hash(hash))
+			{
+				HASH_TABLE_COUNT(counters.filterReject());
+				return end();
+			}
+			size_t bucketIndex = hash % numBuckets;
+			auto it = locate(k, hash, bucketIndex);
+			if (it == buckets[bucketIndex].end())
+				return end();
+			return iterator(buckets + bucketIndex, buckets + numBuckets, it);
+		}
+
+		// add v, whose key is known to be absent, growing first if needed
+		template <class U>
+		iterator append(U&& v, size_t hash);
+
+		// how many keys a batched lookup has in flight
+		static const size_t BATCH_WINDOW = 16;
+
+		template <class Store>
+		void lookupBatch(const Key* keys, size_t num, Store store);
+
+		template <class U>
+		custom::pair<iterator, bool> insertUnique(U&& v)
+		{
+			size_t hash = hasher(KeyOf()(v));
+
+			// Check if the element already exists
+			iterator it = findHashed(KeyOf()(v), hash);
+			if (it != end())
+				return { it, false };
+
+			return { append(std::forward<U>(v), hash), true };
 		}
 
 	private:
 
-		custom::list<T> buckets[10];   // exactly 10 buckets
-		int numElements;                // number of elements in the Hash
+		// the element with key k in bucket bucketIndex, or that bucket's end()
+		template <class K2>
+		typename custom::list<Entry>::iterator locate(const K2& k, size_t hash, size_t bucketIndex)
+		{
+			auto it = buckets[bucketIndex].begin();
+			auto endIt = buckets[bucketIndex].end();
+			HASH_TABLE_COUNT(size_t numProbes = 0);
+			while (it != endIt && !matches(*it, k, hash))
+			{
+				HASH_TABLE_COUNT(numProbes++);
+				++it;
+			}
+			HASH_TABLE_COUNT(counters.lookup(numProbes + (it != endIt ? 1 : 0)));
+			return it;
+		}
+
+		static const size_t DEFAULT_BUCKETS = 10;
+
+		// old buckets an operation migrates while incrementally rehashing
+		static const size_t REHASH_STEP = 4;
+
+		// buckets of the next array an operation builds while incrementally
+		// rehashing. An array no bigger than this takes over at once
+		static const size_t BUILD_STEP = 1024;
+
+		// A bucket array is raw memory until its buckets are built, so a
+		// big one can be built a step at a time. Only buckets in
+		// [first, last) are built, or destroyed when the array is freed
+		static custom::list<Entry>* allocBuckets(size_t num)
+		{
+			return static_cast<custom::list<Entry>*>(::operator new(num * sizeof(custom::list<Entry>)));
+		}
+		static void buildBuckets(custom::list<Entry>* p, size_t first, size_t last) noexcept
+		{
+			for (size_t i = first; i < last; ++i)
+				new (static_cast<void*>(p + i)) custom::list<Entry>;
+		}
+		static custom::list<Entry>* newBuckets(size_t num)
+		{
+			custom::list<Entry>* p = allocBuckets(num);
+			buildBuckets(p, 0, num);
+			return p;
+		}
+		static void freeBuckets(custom::list<Entry>* p, size_t first, size_t last) noexcept
+		{
+			typedef custom::list<Entry> Bucket;
+			if (!p)
+				return;
+			for (size_t i = first; i < last; ++i)
+				p[i].~Bucket();
+			::operator delete(p);
+		}
+
+		void startRehash(size_t numBucketsNew);
+		void buildStep(size_t num);
+		void rehashStep(size_t num);
+		void migrate(size_t iOld);
+		void resizeFilter();
+		void rebuildFilter();
+
+		// Before touching hash's bucket: take a step, and make sure
+		// nothing with this hash is left behind in the old array
+		void settle(size_t hash)
+		{
+			if (bucketsNext)
+				buildStep(BUILD_STEP);
+			if (bucketsOld)
+			{
+				rehashStep(REHASH_STEP);
+				if (bucketsOld && hash % numBucketsOld >= rehashIndex)
+					migrate(hash % numBucketsOld);
+			}
+		}
+		void finishRehash()
+		{
+			if (bucketsNext)
+				buildStep(numBucketsNext);
+			if (bucketsOld)
+				rehashStep(numBucketsOld);
+		}
+
+		// fewest buckets that hold num elements under the max load factor
+		size_t minBuckets(size_t num) const
+		{
+			return static_cast<size_t>(std::ceil(static_cast<float>(num) / maxLoadFactor));
+		}
+		static size_t nextPrime(size_t n);
+
+		// a cached hash that differs settles it without calling KeyEqual
+		template <class K2>
+		bool matches(const Entry& e, const K2& k, size_t hash) const
+		{
+			if (!EntryTraits::sameHash(e, hash))
+				return false;
+			HASH_TABLE_COUNT(counters.equal());
+			return equal(KeyOf()(EntryTraits::value(e)), k);
+		}
+
+#ifdef HASH_TABLE_STATS
+		static double secondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+#endif // HASH_TABLE_STATS
+
+		custom::list<Entry>* buckets;       // the array of buckets
+		size_t numBuckets;              // number of buckets in the array
+		size_t numElements;             // number of elements in the Hash
+		float maxLoadFactor;            // average bucket length that triggers growth
+		custom::list<Entry>* bucketsOld;    // mid-rehash: buckets not yet migrated
+		size_t numBucketsOld;           // number of buckets in the old array
+		size_t rehashIndex;             // old buckets below this are migrated and destroyed
+		custom::list<Entry>* bucketsNext;   // being built: the array that takes over next
+		size_t numBucketsNext;          // number of buckets in the next array
+		size_t numBucketsBuilt;         // next buckets below this are built
+		bool incremental;               // grow with startRehash() instead of rehash()
+		bloom_filter<Key, Hash> filter; // the hash of every element, when filterRate > 0
+		double filterRate;              // the front filter's false-positive rate, 0 if off
+		size_t numFilterStale;          // erased elements the filter still remembers
+#ifdef HASH_TABLE_STATS
+		mutable hash_table_counters counters;  // matches() is const, yet counts
+#endif // HASH_TABLE_STATS
+		Hash hasher;
+		KeyEqual equal;
 	};
 
 
+	/*****************************************
+	 * HASH TABLE :: APPEND
+	 * Grow first so the new element lands in its final
+	 * bucket, then put it at the end of that bucket
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	template <class U>
+	typename hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::iterator hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::append(U&& v, size_t hash)
+	{
+		// while the next array is being built, the current one runs over
+		if (!bucketsNext && static_cast<float>(numElements + 1) > maxLoadFactor * static_cast<float>(numBuckets))
+		{
+			size_t numBucketsMin = std::max(numBuckets * 2, minBuckets(numElements + 1));
+			if (incremental)
+				startRehash(nextPrime(numBucketsMin));
+			else
+				rehash(numBucketsMin);
+		}
+
+		if (filterRate > 0.0)
+		{
+			// a raised max_load_factor can outgrow the filter without a rehash.
+			// Not so the few inserts while the next array is built: the
+			// filter starts over when it takes over
+			if (!bucketsNext && numElements + 1 > filter.capacity())
+				rebuildFilter();
+			filter.insert_hash(hash);
+		}
+
+		size_t bucketIndex = hash % numBuckets;
+		auto& bucketList = buckets[bucketIndex];
+		bucketList.push_back(EntryTraits::make(std::forward<U>(v), hash));
+		++numElements;
+
+		// the newly inserted element is the last in its bucket
+		return iterator(buckets + bucketIndex, buckets + numBuckets, bucketList.rbegin());
+	}
+
+	/*****************************************
+	 * HASH TABLE :: LOOKUP BATCH
+	 * For each window of keys: hash them all and prefetch
+	 * their buckets, then prefetch the first node of each
+	 * bucket, then walk the buckets. By the time a walk
+	 * starts, its memory is already on the way
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	template <class Store>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::lookupBatch(const Key* keys, size_t num, Store store)
+	{
+		size_t hashes[BATCH_WINDOW];
+		for (size_t base = 0; base < num; base += BATCH_WINDOW)
+		{
+			size_t numWindow = num - base < BATCH_WINDOW ? num - base : BATCH_WINDOW;
+
+			for (size_t i = 0; i < numWindow; i++)
+			{
+				hashes[i] = hasher(keys[base + i]);
+				HASH_PREFETCH(buckets + hashes[i] % numBuckets);
+			}
+
+			for (size_t i = 0; i < numWindow; i++)
+			{
+				custom::list<Entry>& bucket = buckets[hashes[i] % numBuckets];
+				if (!bucket.empty())
+					HASH_PREFETCH(&bucket.front());
+			}
+
+			for (size_t i = 0; i < numWindow; i++)
+				store(base + i, findHashed(keys[base + i], hashes[i]));
+		}
+	}
+
+	/*****************************************
+	 * HASH TABLE :: REHASH
+	 * Move every node into a new bucket array of at
+	 * least numBucketsMin buckets. The nodes are
+	 * spliced across, so nothing is copied or allocated
+	 * except the array itself. Cached hashes are reused
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::rehash(size_t numBucketsMin)
+	{
+		finishRehash();
+		size_t numBucketsNew = nextPrime(std::max(numBucketsMin, minBuckets(numElements)));
+		if (numBucketsNew == numBuckets)
+			return;
+		HASH_TABLE_COUNT(counters.numRehashes++);
+		HASH_TABLE_COUNT(auto start = std::chrono::steady_clock::now());
+
+		custom::list<Entry>* bucketsNew = newBuckets(numBucketsNew);
+		for (size_t i = 0; i < numBuckets; ++i)
+		{
+			while (!buckets[i].empty())
+			{
+				auto it = buckets[i].begin();
+				custom::list<Entry>& bucketNew = bucketsNew[EntryTraits::hash(*it, hasher, KeyOf()) % numBucketsNew];
+				bucketNew.splice(bucketNew.end(), buckets[i], it);
+			}
+		}
+
+		freeBuckets(buckets, 0, numBuckets);
+		buckets = bucketsNew;
+		numBuckets = numBucketsNew;
+		HASH_TABLE_COUNT(counters.rehashSeconds += secondsSince(start));
+		if (filterRate > 0.0)
+			rebuildFilter();
+	}
+
+	/*****************************************
+	 * HASH TABLE :: START REHASH
+	 * Redis style, in two phases. First the next array
+	 * is built a few buckets per operation, so no one
+	 * call faults in all of a big array's pages. Then
+	 * the current array becomes the old one and new
+	 * elements go straight into the next one. The old
+	 * elements follow a few buckets at a time, and so
+	 * do their hashes into the front filter
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::startRehash(size_t numBucketsNew)
+	{
+		// growing faster than we migrate: the last rehash must end first
+		finishRehash();
+
+		HASH_TABLE_COUNT(counters.numRehashes++);
+		bucketsNext = allocBuckets(numBucketsNew);
+		numBucketsNext = numBucketsNew;
+		numBucketsBuilt = 0;
+		buildStep(BUILD_STEP);
+	}
+
+	/*****************************************
+	 * HASH TABLE :: BUILD STEP
+	 * Build the next num buckets of the next array. Once
+	 * the last is built, it takes over and migration
+	 * begins
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::buildStep(size_t num)
+	{
+		HASH_TABLE_COUNT(auto start = std::chrono::steady_clock::now());
+		size_t numBuilt = std::min(numBucketsNext, numBucketsBuilt + num);
+		buildBuckets(bucketsNext, numBucketsBuilt, numBuilt);
+		numBucketsBuilt = numBuilt;
+		HASH_TABLE_COUNT(counters.rehashSeconds += secondsSince(start));
+		if (numBucketsBuilt < numBucketsNext)
+			return;
+
+		bucketsOld = buckets;
+		numBucketsOld = numBuckets;
+		rehashIndex = 0;
+		buckets = bucketsNext;
+		numBuckets = numBucketsNext;
+		bucketsNext = nullptr;
+		numBucketsNext = 0;
+		numBucketsBuilt = 0;
+
+		// start the filter empty: migrate() adds each element as it moves
+		if (filterRate > 0.0)
+			resizeFilter();
+	}
+
+	/*****************************************
+	 * HASH TABLE :: REHASH STEP
+	 * Migrate the next num old buckets, destroying each
+	 * one as it empties, and free the old array once
+	 * the last one is gone
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::rehashStep(size_t num)
+	{
+		typedef custom::list<Entry> Bucket;
+		HASH_TABLE_COUNT(auto start = std::chrono::steady_clock::now());
+		for (; num > 0 && rehashIndex < numBucketsOld; --num)
+		{
+			migrate(rehashIndex);
+			bucketsOld[rehashIndex++].~Bucket();
+		}
+		HASH_TABLE_COUNT(counters.rehashSeconds += secondsSince(start));
+
+		if (rehashIndex == numBucketsOld)
+		{
+			freeBuckets(bucketsOld, rehashIndex, numBucketsOld);
+			bucketsOld = nullptr;
+			numBucketsOld = 0;
+			rehashIndex = 0;
+		}
+	}
+
+	/*****************************************
+	 * HASH TABLE :: MIGRATE
+	 * Splice every node of one old bucket into the
+	 * new array, adding its hash to the front filter.
+	 * An already empty bucket costs nothing
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::migrate(size_t iOld)
+	{
+		custom::list<Entry>& bucketOld = bucketsOld[iOld];
+		while (!bucketOld.empty())
+		{
+			auto it = bucketOld.begin();
+			size_t hash = EntryTraits::hash(*it, hasher, KeyOf());
+			if (filterRate > 0.0)
+				filter.insert_hash(hash);
+			custom::list<Entry>& bucketNew = buckets[hash % numBuckets];
+			bucketNew.splice(bucketNew.end(), bucketOld, it);
+		}
+	}
+
+	/*****************************************
+	 * HASH TABLE :: RESIZE FILTER
+	 * Size an empty filter for as many elements as the
+	 * buckets hold before they next grow
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::resizeFilter()
+	{
+		size_t numCapacity = static_cast<size_t>(maxLoadFactor * static_cast<float>(numBuckets));
+		filter.resize(std::max(numCapacity, numElements + 1), filterRate);
+		numFilterStale = 0;
+	}
+
+	/*****************************************
+	 * HASH TABLE :: REBUILD FILTER
+	 * Resize the filter and add every element, including
+	 * any not yet migrated out of the old array
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	void hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::rebuildFilter()
+	{
+		resizeFilter();
+
+		for (size_t i = 0; i < numBuckets; ++i)
+			for (auto it = buckets[i].begin(); it != buckets[i].end(); ++it)
+				filter.insert_hash(EntryTraits::hash(*it, hasher, KeyOf()));
+		if (bucketsOld)
+			for (size_t i = rehashIndex; i < numBucketsOld; ++i)
+				for (auto it = bucketsOld[i].begin(); it != bucketsOld[i].end(); ++it)
+					filter.insert_hash(EntryTraits::hash(*it, hasher, KeyOf()));
+	}
+
+#ifdef HASH_TABLE_STATS
+	/*****************************************
+	 * HASH TABLE :: STATS
+	 * Every list is a bucket some lookup may walk, so
+	 * mid-rehash the old array's lists count too
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	hash_table_stats hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::stats() const
+	{
+		hash_table_stats snapshot = counters.snapshot();
+		auto tally = [&snapshot](size_t length)
+		{
+			if (length >= snapshot.bucketLengths.size())
+				snapshot.bucketLengths.resize(length + 1, 0);
+			snapshot.bucketLengths[length]++;
+		};
+		for (size_t i = 0; i < numBuckets; ++i)
+			tally(buckets[i].size());
+		for (size_t i = rehashIndex; bucketsOld && i < numBucketsOld; ++i)
+			tally(bucketsOld[i].size());
+		return snapshot;
+	}
+#endif // HASH_TABLE_STATS
+
+	/*****************************************
+	 * HASH TABLE :: NEXT PRIME
+	 * The smallest prime >= n. Prime bucket counts
+	 * keep "hash % numBuckets" from clustering when
+	 * the hashes share a common factor
+	 ****************************************/
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	size_t hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::nextPrime(size_t n)
+	{
+		if (n <= 2)
+			return 2;
+		if (n % 2 == 0)
+			n++;
+		for (;; n += 2)
+		{
+			bool isPrime = true;
+			for (size_t d = 3; d * d <= n && isPrime; d += 2)
+				isPrime = (n % d != 0);
+			if (isPrime)
+				return n;
+		}
+	}
+
+
 	/************************************************
-	 * UNORDERED SET ITERATOR
-	 * Iterator for an unordered set
+	 * HASH TABLE ITERATOR
+	 * Iterator for an unordered set or map
 	 ************************************************/
-	template <typename T>
-	class unordered_set <T> ::iterator
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	class hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::iterator
 	{
 		friend class ::TestHash;   // give unit tests access to the privates
-		template <class TT>
-		friend class custom::unordered_set;
+		friend class ::TestUnorderedMap;
+		template <class VV, class KK, class KO, class HH, class EE, bool CC>
+		friend class custom::hash_table;
 	public:
 		// 
 		// Construct
 		//
 		iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList() {}
 		iterator(
-			typename custom::list<T>* pBucket,
-			typename custom::list<T>* pBucketEnd,
-			typename custom::list<T>::iterator itList)
+			typename custom::list<Entry>* pBucket,
+			typename custom::list<Entry>* pBucketEnd,
+			typename custom::list<Entry>::iterator itList)
 			: pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList)
 		{
 			// Move to the next valid element if current element is end of the bucket
-			if (itList == pBucket->end())
+			if (pBucket != pBucketEnd && itList == pBucket->end())
 			{
 				++(*this);
 			}
@@ -336,9 +1070,13 @@ namespace custom
 		// 
 		// Access
 		//
-		T& operator * ()
+		Value& operator * ()
 		{
-			return *itList;
+			return EntryTraits::value(*itList);
+		}
+		Value* operator -> ()
+		{
+			return &EntryTraits::value(*itList);
 		}
 
 		//
@@ -346,6 +1084,10 @@ namespace custom
 		//
 		iterator& operator ++ ()
 		{
+			// Incrementing end() leaves it at end()
+			if (pBucket == pBucketEnd)
+				return *this;
+
 			// Move to the next item in the current bucket
 			++itList;
 
@@ -371,30 +1113,31 @@ namespace custom
 		}
 
 	private:
-		custom::list<T>* pBucket;
-		custom::list<T>* pBucketEnd;
-		typename list<T>::iterator itList;
+		custom::list<Entry>* pBucket;
+		custom::list<Entry>* pBucketEnd;
+		typename list<Entry>::iterator itList;
 	};
 
 
 	/************************************************
-	 * UNORDERED SET LOCAL ITERATOR
-	 * Iterator for a single bucket in an unordered set
+	 * HASH TABLE LOCAL ITERATOR
+	 * Iterator for a single bucket
 	 ************************************************/
-	template <typename T>
-	class unordered_set <T> ::local_iterator
+	template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual, bool CacheHash>
+	class hash_table <Value, Key, KeyOf, Hash, KeyEqual, CacheHash> ::local_iterator
 	{
 		friend class ::TestHash;   // give unit tests access to the privates
+		friend class ::TestUnorderedMap;
 
-		template <class TT>
-		friend class custom::unordered_set;
+		template <class VV, class KK, class KO, class HH, class EE, bool CC>
+		friend class custom::hash_table;
 	public:
 		// 
 		// Construct
 		//
 		local_iterator() : itList() {}
 
-		local_iterator(const typename custom::list<T>::iterator& itList)
+		local_iterator(const typename custom::list<Entry>::iterator& itList)
 			: itList(itList) {}
 
 		local_iterator(const local_iterator& rhs)
@@ -429,9 +1172,9 @@ namespace custom
 		// 
 		// Access
 		//
-		T& operator*()
+		Value& operator*()
 		{
-			return *itList;
+			return EntryTraits::value(*itList);
 		}
 
 		// 
@@ -451,19 +1194,46 @@ namespace custom
 		}
 
 	private:
-		typename list<T>::iterator itList;
+		typename list<Entry>::iterator itList;
+	};
+
+	/************************************************
+	 * UNORDERED SET
+	 * A set implemented as a hash: a hash_table whose
+	 * elements are their own keys
+	 ************************************************/
+	template <typename T,
+	          typename Hash = std::hash<T>,
+	          typename KeyEqual = std::equal_to<T>,
+	          bool CacheHash = false>
+	class unordered_set : public hash_table<T, T, identity_key<T>, Hash, KeyEqual, CacheHash>
+	{
+		friend class ::TestHash;   // give unit tests access to the privates
+		typedef hash_table<T, T, identity_key<T>, Hash, KeyEqual, CacheHash> Base;
+	public:
+		//
+		// Construct
+		//
+		unordered_set() : Base() {}
+		explicit unordered_set(size_t numBuckets, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			Base(numBuckets, hash, eq) {}
+		template <class Iterator>
+		unordered_set(Iterator first, Iterator last) : Base(first, last) {}
+		unordered_set(const std::initializer_list<T>& il) : Base(il) {}
+
+		//
+		// Assign
+		//
+		using Base::operator=;
 	};
 
 	/*****************************************
 	 * SWAP
 	 * Stand-alone unordered set swap
 	 ****************************************/
-	template <typename T>
-	void swap(unordered_set<T>& lhs, unordered_set<T>& rhs)
+	template <typename T, typename Hash, typename KeyEqual, bool CacheHash>
+	void swap(unordered_set<T, Hash, KeyEqual, CacheHash>& lhs, unordered_set<T, Hash, KeyEqual, CacheHash>& rhs)
 	{
-		// Swap the buckets between lhs and rhs
-		using std::swap;
-		swap(lhs.buckets, rhs.buckets);
-		swap(lhs.numElements, rhs.numElements);
+		lhs.swap(rhs);
 	}
-}
\ No newline at end of file
+}
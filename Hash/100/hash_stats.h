@@ -0,0 +1,133 @@
+/***********************************************************************
+ * Header:
+ *    HASH STATS
+ * Summary:
+ *    What a hash_table records about itself when HASH_TABLE_STATS is on
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        hash_table_stats      : Counters plus a bucket-length histogram
+ *        hash_table_counters   : What a hash_table updates as it works
+ *
+ *    Define HASH_TABLE_STATS before including hash.h to have every
+ *    hash_table keep these counters. Without it, hash.h never includes
+ *    this file and the counting code compiles to nothing.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <atomic>     // for the lookup counters
+#include <vector>     // for the histogram
+#include <iostream>   // for std::ostream
+
+namespace custom
+{
+	/************************************************
+	 * HASH TABLE STATS
+	 * A lookup is one walk of one bucket: find, the
+	 * duplicate check inside insert, and erase. Its
+	 * probe length is how many nodes the walk visited
+	 ************************************************/
+	struct hash_table_stats
+	{
+		size_t numLookups = 0;        // bucket walks
+		size_t numProbes = 0;         // nodes visited over all of them
+		size_t maxProbe = 0;          // the longest single walk
+		size_t numEquals = 0;         // calls to KeyEqual
+		size_t numFilterRejects = 0;  // lookups the front filter answered alone
+		size_t numRehashes = 0;       // bucket arrays replaced, full or incremental
+		double rehashSeconds = 0.0;   // time spent moving nodes between arrays
+
+		// bucketLengths[n] is how many buckets hold n elements. Only
+		// filled in by hash_table::stats(), from the buckets as they are
+		std::vector<size_t> bucketLengths;
+
+		double average_probe() const
+		{
+			return numLookups ? static_cast<double>(numProbes) / numLookups : 0.0;
+		}
+
+		// one JSON object, for whatever collects these
+		void write_json(std::ostream& out) const
+		{
+			out << "{\"lookups\":" << numLookups
+			    << ",\"probes\":" << numProbes
+			    << ",\"average_probe\":" << average_probe()
+			    << ",\"max_probe\":" << maxProbe
+			    << ",\"equals\":" << numEquals
+			    << ",\"filter_rejects\":" << numFilterRejects
+			    << ",\"rehashes\":" << numRehashes
+			    << ",\"rehash_seconds\":" << rehashSeconds
+			    << ",\"bucket_lengths\":[";
+			for (size_t i = 0; i < bucketLengths.size(); i++)
+				out << (i ? "," : "") << bucketLengths[i];
+			out << "]}";
+		}
+	};
+
+	/************************************************
+	 * HASH TABLE COUNTERS
+	 * Lookups may run side by side under a reader lock,
+	 * as in concurrent_unordered_set, so their counters
+	 * are relaxed atomics. Rehashes only ever happen
+	 * under a writer, so theirs are plain
+	 ************************************************/
+	struct hash_table_counters
+	{
+		std::atomic<size_t> numLookups{ 0 };
+		std::atomic<size_t> numProbes{ 0 };
+		std::atomic<size_t> maxProbe{ 0 };
+		std::atomic<size_t> numEquals{ 0 };
+		std::atomic<size_t> numFilterRejects{ 0 };
+		size_t numRehashes = 0;
+		double rehashSeconds = 0.0;
+
+		void lookup(size_t probes)
+		{
+			numLookups.fetch_add(1, std::memory_order_relaxed);
+			numProbes.fetch_add(probes, std::memory_order_relaxed);
+			size_t most = maxProbe.load(std::memory_order_relaxed);
+			while (probes > most && !maxProbe.compare_exchange_weak(most, probes, std::memory_order_relaxed))
+				;
+		}
+		void equal()
+		{
+			numEquals.fetch_add(1, std::memory_order_relaxed);
+		}
+		void filterReject()
+		{
+			numFilterRejects.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void reset()
+		{
+			numLookups = 0;
+			numProbes = 0;
+			maxProbe = 0;
+			numEquals = 0;
+			numFilterRejects = 0;
+			numRehashes = 0;
+			rehashSeconds = 0.0;
+		}
+		hash_table_stats snapshot() const
+		{
+			hash_table_stats st;
+			st.numLookups = numLookups.load(std::memory_order_relaxed);
+			st.numProbes = numProbes.load(std::memory_order_relaxed);
+			st.maxProbe = maxProbe.load(std::memory_order_relaxed);
+			st.numEquals = numEquals.load(std::memory_order_relaxed);
+			st.numFilterRejects = numFilterRejects.load(std::memory_order_relaxed);
+			st.numRehashes = numRehashes;
+			st.rehashSeconds = rehashSeconds;
+			return st;
+		}
+	};
+}
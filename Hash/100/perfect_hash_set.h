@@ -0,0 +1,451 @@
+/***********************************************************************
+ * Header:
+ *    PERFECT HASH SET
+ * Summary:
+ *    An immutable set with a minimal perfect hash: one probe per lookup
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        perfect_hash_set     : A CHD (hash, displace, compress) key set
+ *
+ *    The n keys are spread over about n / lambda small buckets by one hash.
+ *    Biggest bucket first, each bucket is given a displacement index k that
+ *    places all of its keys into free slots of an n-slot array:
+ *
+ *        slot = (f1 + d0 * f2 + d1) % n      where d0 = k / n, d1 = k % n
+ *
+ *    A lookup hashes the key once, reads its bucket's k, computes the slot
+ *    and compares against the one key stored there. The k values are
+ *    bit-packed at the width of the largest, so the index costs about
+ *    width / lambda bits per key on top of the keys themselves.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for memcpy
+#include <vector>     // for the flat key array and the packed displacements
+#include <string>     // for file names
+#include <fstream>    // for save() and load()
+#include <iostream>   // for std::istream, std::ostream
+#include <stdexcept>  // for std::runtime_error
+#include <functional> // for std::hash, std::equal_to
+#include <algorithm>  // for std::sort
+#include <type_traits> // for std::is_trivially_copyable
+#include <limits>     // for std::numeric_limits
+#include <initializer_list>
+
+class TestPerfectHashSet;      // forward declaration for unit tests
+
+namespace custom
+{
+	/************************************************
+	 * PERFECT HASH SET
+	 * Built once from a range of keys, then only
+	 * queried. Duplicates in the input are dropped
+	 ************************************************/
+	template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+	class perfect_hash_set
+	{
+		friend class ::TestPerfectHashSet;   // give unit tests access to the privates
+	public:
+		typedef const T* iterator;
+
+		// average keys per bucket: larger is smaller but slower to build
+		static const size_t DEFAULT_LAMBDA = 5;
+
+		//
+		// Construct
+		//
+		perfect_hash_set(const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			numBuckets(0), seed(0), width(0), hasher(hash), equal(eq) {}
+		template <class Iterator>
+		perfect_hash_set(Iterator first, Iterator last, size_t lambda = DEFAULT_LAMBDA,
+		                 const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			perfect_hash_set(hash, eq)
+		{
+			build(std::vector<T>(first, last), lambda);
+		}
+		perfect_hash_set(const std::initializer_list<T>& il) : perfect_hash_set()
+		{
+			build(std::vector<T>(il.begin(), il.end()), DEFAULT_LAMBDA);
+		}
+
+		//
+		// Iterator: the keys in slot order
+		//
+		iterator begin() const { return keys.data(); }
+		iterator end()   const { return keys.data() + keys.size(); }
+
+		//
+		// Access
+		//
+
+		// The slot of k in [0, size()), or size() if k is absent. Distinct
+		// keys get distinct slots, so this can index a parallel array
+		size_t index(const T& k) const
+		{
+			if (keys.empty())
+				return 0;
+			size_t slot = slotOf(hashOf(k));
+			return equal(keys[slot], k) ? slot : keys.size();
+		}
+		iterator find(const T& k) const
+		{
+			return begin() + index(k);
+		}
+		bool contains(const T& k) const
+		{
+			return index(k) != keys.size();
+		}
+		size_t count(const T& k) const
+		{
+			return contains(k) ? 1 : 0;
+		}
+
+		//
+		// Status
+		//
+		size_t size() const { return keys.size(); }
+		bool empty() const { return keys.empty(); }
+		size_t bucket_count() const { return numBuckets; }
+
+		// what the hash costs beyond the keys themselves
+		double bits_per_key() const
+		{
+			return keys.empty() ? 0.0 : 64.0 * packed.size() / keys.size();
+		}
+
+		//
+		// Serialize: only for keys that can be copied byte for byte
+		//
+		void save(std::ostream& out) const;
+		void load(std::istream& in);
+		void save(const std::string& fileName) const
+		{
+			std::ofstream fout(fileName.c_str(), std::ios::binary);
+			if (!fout)
+				throw std::runtime_error("perfect_hash_set: cannot write " + fileName);
+			save(fout);
+		}
+		void load(const std::string& fileName)
+		{
+			std::ifstream fin(fileName.c_str(), std::ios::binary);
+			if (!fin)
+				throw std::runtime_error("perfect_hash_set: cannot read " + fileName);
+			load(fin);
+		}
+
+	private:
+		// give up on a seed after this many d0 values for one bucket
+		static const uint64_t MAX_D0 = 1024;
+		static const int MAX_SEEDS = 64;
+		static const uint32_t MAGIC = 0x31534850;   // "PHS1"
+
+		void build(std::vector<T> input, size_t lambda);
+		bool tryBuild(const std::vector<T>& input, std::vector<size_t>& order, size_t lambda);
+
+		static uint64_t mix(uint64_t x)
+		{
+			// splitmix64 finalizer
+			x ^= x >> 30;
+			x *= 0xBF58476D1CE4E5B9ull;
+			x ^= x >> 27;
+			x *= 0x94D049BB133111EBull;
+			x ^= x >> 31;
+			return x;
+		}
+		uint64_t hashOf(const T& k) const
+		{
+			return mix(static_cast<uint64_t>(hasher(k)) ^ seed);
+		}
+
+		// the three hashes CHD needs, all from the one 64-bit hash
+		size_t bucketOf(uint64_t h) const { return static_cast<size_t>(h % numBuckets); }
+		uint64_t f1(uint64_t h) const { return mix(h ^ 0x9E3779B97F4A7C15ull) % keys.size(); }
+		uint64_t f2(uint64_t h) const
+		{
+			return keys.size() == 1 ? 0 : 1 + mix(h ^ 0xC2B2AE3D27D4EB4Full) % (keys.size() - 1);
+		}
+		size_t place(uint64_t h, uint64_t k) const
+		{
+			uint64_t m = keys.size();
+			uint64_t d0 = (k / m) % m;
+			uint64_t d1 = k % m;
+			return static_cast<size_t>((f1(h) + d0 * f2(h) % m + d1) % m);
+		}
+		size_t slotOf(uint64_t h) const
+		{
+			return place(h, displacement(bucketOf(h)));
+		}
+
+		// the packed displacement index of bucket i
+		uint64_t displacement(size_t i) const;
+		static void pack(const std::vector<uint64_t>& values, int width, std::vector<uint64_t>& packed);
+
+		std::vector<T> keys;            // slot i holds the only key that hashes there
+		std::vector<uint64_t> packed;   // numBuckets displacement indices, width bits each
+		size_t numBuckets;
+		uint64_t seed;
+		int width;
+		Hash hasher;
+		KeyEqual equal;
+	};
+
+	/*****************************************
+	 * PERFECT HASH SET :: BUILD
+	 * Try seeds until every bucket can be placed. A new
+	 * seed is only needed when two different keys share
+	 * a 64-bit hash or a bucket cannot be placed at all
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void perfect_hash_set <T, Hash, KeyEqual> ::build(std::vector<T> input, size_t lambda)
+	{
+		if (lambda == 0)
+			lambda = 1;
+		std::vector<size_t> order;
+		for (int attempt = 0; attempt < MAX_SEEDS; attempt++)
+		{
+			seed = mix(static_cast<uint64_t>(attempt) + 0x9E3779B97F4A7C15ull);
+			if (tryBuild(input, order, lambda))
+				return;
+		}
+		throw std::runtime_error("perfect_hash_set: no perfect hash found");
+	}
+
+	/*****************************************
+	 * PERFECT HASH SET :: TRY BUILD
+	 * One attempt with the current seed
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	bool perfect_hash_set <T, Hash, KeyEqual> ::tryBuild(const std::vector<T>& input,
+		std::vector<size_t>& order, size_t lambda)
+	{
+		// hash everything and sort by hash: equal keys end up side by side
+		std::vector<uint64_t> hashes(input.size());
+		for (size_t i = 0; i < input.size(); i++)
+			hashes[i] = hashOf(input[i]);
+		order.resize(input.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(),
+			[&hashes](size_t a, size_t b) { return hashes[a] < hashes[b]; });
+
+		// drop duplicates; two different keys with one hash need a new seed
+		std::vector<size_t> unique;
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			if (!unique.empty() && hashes[unique.back()] == hashes[order[i]])
+			{
+				if (equal(input[unique.back()], input[order[i]]))
+					continue;
+				return false;
+			}
+			unique.push_back(order[i]);
+		}
+
+		size_t m = unique.size();
+		keys.clear();
+		packed.clear();
+		width = 0;
+		numBuckets = m == 0 ? 0 : (m + lambda - 1) / lambda;
+		if (m == 0)
+			return true;
+
+		// placement needs keys.size() == m before any key is in its slot
+		keys.assign(m, input[unique[0]]);
+
+		// group the keys by bucket, biggest bucket first
+		std::vector<size_t> start(numBuckets + 1, 0);
+		for (size_t i : unique)
+			start[bucketOf(hashes[i]) + 1]++;
+		for (size_t b = 0; b < numBuckets; b++)
+			start[b + 1] += start[b];
+		std::vector<size_t> members(m);
+		std::vector<size_t> next(start.begin(), start.end() - 1);
+		for (size_t i : unique)
+			members[next[bucketOf(hashes[i])]++] = i;
+		std::vector<size_t> bucketOrder(numBuckets);
+		for (size_t b = 0; b < numBuckets; b++)
+			bucketOrder[b] = b;
+		std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&start](size_t a, size_t b)
+		{
+			return start[a + 1] - start[a] > start[b + 1] - start[b];
+		});
+
+		// place each bucket at the first displacement that fits
+		std::vector<bool> taken(m, false);
+		std::vector<uint64_t> displacements(numBuckets, 0);
+		std::vector<size_t> slots;
+		uint64_t maxK = 0;
+		for (size_t b : bucketOrder)
+		{
+			size_t begin = start[b];
+			size_t num = start[b + 1] - begin;
+			if (num == 0)
+				continue;
+
+			// d0 fixes where the keys sit relative to each other, d1 slides them
+			bool placed = false;
+			for (uint64_t d0 = 0; d0 < MAX_D0 && !placed; d0++)
+			{
+				slots.clear();
+				bool distinct = true;
+				for (size_t j = 0; j < num && distinct; j++)
+				{
+					size_t slot = place(hashes[members[begin + j]], d0 * m);
+					distinct = std::find(slots.begin(), slots.end(), slot) == slots.end();
+					slots.push_back(slot);
+				}
+				if (!distinct)
+					continue;
+
+				for (uint64_t d1 = 0; d1 < m && !placed; d1++)
+				{
+					bool fits = true;
+					for (size_t j = 0; j < num && fits; j++)
+						fits = !taken[(slots[j] + d1) % m];
+					if (!fits)
+						continue;
+
+					for (size_t j = 0; j < num; j++)
+					{
+						size_t slot = static_cast<size_t>((slots[j] + d1) % m);
+						taken[slot] = true;
+						keys[slot] = input[members[begin + j]];
+					}
+					displacements[b] = d0 * m + d1;
+					maxK = std::max(maxK, displacements[b]);
+					placed = true;
+				}
+			}
+			if (!placed)
+				return false;
+		}
+
+		while (width < 64 && (maxK >> width) != 0)
+			width++;
+		pack(displacements, width, packed);
+		return true;
+	}
+
+	/*****************************************
+	 * PERFECT HASH SET :: PACK
+	 * Store each value in width bits, back to back
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void perfect_hash_set <T, Hash, KeyEqual> ::pack(const std::vector<uint64_t>& values, int width,
+		std::vector<uint64_t>& packed)
+	{
+		packed.assign((values.size() * width + 63) / 64, 0);
+		for (size_t i = 0; width > 0 && i < values.size(); i++)
+		{
+			uint64_t bit = static_cast<uint64_t>(i) * width;
+			size_t word = static_cast<size_t>(bit / 64);
+			int offset = static_cast<int>(bit % 64);
+			packed[word] |= values[i] << offset;
+			if (offset + width > 64)
+				packed[word + 1] |= values[i] >> (64 - offset);
+		}
+	}
+
+	/*****************************************
+	 * PERFECT HASH SET :: DISPLACEMENT
+	 * Read back what pack() wrote
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	uint64_t perfect_hash_set <T, Hash, KeyEqual> ::displacement(size_t i) const
+	{
+		if (width == 0)
+			return 0;
+		uint64_t bit = static_cast<uint64_t>(i) * width;
+		size_t word = static_cast<size_t>(bit / 64);
+		int offset = static_cast<int>(bit % 64);
+		uint64_t value = packed[word] >> offset;
+		if (offset + width > 64)
+			value |= packed[word + 1] << (64 - offset);
+		return width == 64 ? value : value & ((uint64_t(1) << width) - 1);
+	}
+
+	/*****************************************
+	 * PERFECT HASH SET :: SAVE
+	 * magic, sizes, seed, width, packed words, keys
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void perfect_hash_set <T, Hash, KeyEqual> ::save(std::ostream& out) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "perfect_hash_set can only save keys that are trivially copyable");
+		uint64_t header[6] = { MAGIC, keys.size(), numBuckets, seed,
+		                       static_cast<uint64_t>(width), packed.size() };
+		out.write(reinterpret_cast<const char*>(header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(uint64_t));
+		out.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(T));
+		if (!out)
+			throw std::runtime_error("perfect_hash_set: write failed");
+	}
+
+	/*****************************************
+	 * PERFECT HASH SET :: LOAD
+	 * The Hash must be the one the set was built with.
+	 * The header is checked before anything is allocated,
+	 * so a corrupt file cannot ask for a huge vector or
+	 * leave a set that divides by zero or reads past the
+	 * packed displacements
+	 ****************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void perfect_hash_set <T, Hash, KeyEqual> ::load(std::istream& in)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "perfect_hash_set can only load keys that are trivially copyable");
+		uint64_t header[6];
+		in.read(reinterpret_cast<char*>(header), sizeof(header));
+		if (!in || header[0] != MAGIC || header[4] > 64)
+			throw std::runtime_error("perfect_hash_set: not a saved perfect_hash_set");
+
+		// build() never makes more buckets than keys, nor none for some keys
+		uint64_t numKeys = header[1];
+		uint64_t numBucketsNew = header[2];
+		uint64_t numWords = header[5];
+		const uint64_t MAX_BYTES = std::numeric_limits<std::streamsize>::max();
+		if (numKeys > MAX_BYTES / sizeof(T) || numBucketsNew > numKeys ||
+		    (numKeys > 0 && numBucketsNew == 0) || numWords > MAX_BYTES / sizeof(uint64_t))
+			throw std::runtime_error("perfect_hash_set: corrupt header");
+		uint64_t numWordsMin = numBucketsNew / 64 * header[4] + (numBucketsNew % 64 * header[4] + 63) / 64;
+		if (numWords < numWordsMin)
+			throw std::runtime_error("perfect_hash_set: corrupt header");
+
+		// where the stream knows its length, it must hold what the header says
+		std::streampos here = in.tellg();
+		if (here != std::streampos(-1))
+		{
+			in.seekg(0, std::ios::end);
+			std::streamoff numLeft = in.tellg() - here;
+			in.seekg(here);
+			if (!in || static_cast<uint64_t>(numLeft) / sizeof(T) < numKeys ||
+			    (static_cast<uint64_t>(numLeft) - numKeys * sizeof(T)) / sizeof(uint64_t) < numWords)
+				throw std::runtime_error("perfect_hash_set: file is truncated");
+		}
+
+		std::vector<uint64_t> packedNew(static_cast<size_t>(header[5]));
+		std::vector<T> keysNew(static_cast<size_t>(header[1]));
+		in.read(reinterpret_cast<char*>(packedNew.data()), packedNew.size() * sizeof(uint64_t));
+		in.read(reinterpret_cast<char*>(keysNew.data()), keysNew.size() * sizeof(T));
+		if (!in)
+			throw std::runtime_error("perfect_hash_set: file is truncated");
+
+		keys.swap(keysNew);
+		packed.swap(packedNew);
+		numBuckets = static_cast<size_t>(header[2]);
+		seed = header[3];
+		width = static_cast<int>(header[4]);
+	}
+}
@@ -0,0 +1,429 @@
+/***********************************************************************
+ * Header:
+ *    SPLIT-ORDERED SET
+ * Summary:
+ *    A lock-free hash set that grows without ever moving an element
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        split_ordered_set    : A Shalev-Shavit split-ordered hash set
+ *
+ *    Every element lives in one Harris-Michael lock-free list, sorted by
+ *    the bit-reversal of its hash. In that order the elements of bucket b
+ *    (the low bits of the hash) sit next to each other, and when the table
+ *    doubles, bucket b splits into b and b + n without anything moving.
+ *    A bucket is just a pointer to a dummy node in the list marking where
+ *    the bucket starts. Dummy nodes are added the first time a bucket is
+ *    used, starting from the dummy of its parent bucket, so growth is
+ *    nothing more than doubling a counter. Unlinked nodes are handed to
+ *    custom::epoch so readers never touch freed memory.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <atomic>      // for std::atomic
+#include <cstdint>     // for uint64_t, uintptr_t
+#include <functional>  // for std::hash, std::equal_to
+#include "epoch.h"     // for epoch::guard and epoch::retire
+
+class TestSplitOrderedSet;    // forward declaration for unit tests
+
+namespace custom
+{
+
+	/**************************************************
+	 * SPLIT-ORDERED SET
+	 * An unordered set of unique elements. insert, erase
+	 * and contains are lock-free, and so is growth
+	 **************************************************/
+	template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+	class split_ordered_set
+	{
+		friend class ::TestSplitOrderedSet; // give unit tests access to the privates
+	public:
+
+		split_ordered_set(const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual());
+		split_ordered_set(const split_ordered_set&) = delete;
+		split_ordered_set& operator=(const split_ordered_set&) = delete;
+
+		// Destructor. No other thread may be using the set any more
+		~split_ordered_set();
+
+		// Add t if it is not already there. Returns false on a duplicate
+		bool insert(const T& t);
+
+		// Remove t. Returns false if it was not there
+		bool erase(const T& t);
+
+		// Is t in the set? Only ever writes to add a missing dummy node
+		bool contains(const T& t) const;
+
+		// A snapshot; exact only when no other thread is writing
+		size_t size() const { return numElements.load(std::memory_order_relaxed); }
+		bool empty() const { return size() == 0; }
+		size_t bucket_count() const { return numBuckets.load(std::memory_order_relaxed); }
+
+		// Visit every element. Only meaningful when quiescent
+		template <class Function>
+		void for_each(Function f) const {
+			epoch::guard g;
+			for (Node* p = pointer(pHead->pNext.load()); p; p = pointer(p->pNext.load())) {
+				if (!p->isDummy() && !isMarked(p->pNext.load())) {
+					f(static_cast<Element*>(p)->data);
+				}
+			}
+		}
+
+	private:
+		// the low bit of pNext marks the owning node as logically deleted
+		static const uintptr_t MARK = 1;
+
+		// grow once the average bucket holds this many elements
+		static const size_t MAX_LOAD = 2;
+
+		// segment 0 holds bucket 0, segment s > 0 holds buckets [2^(s-1), 2^s)
+		static const int NUM_SEGMENTS = 64;
+
+		// a dummy node marks the start of a bucket; its key is even
+		class Node
+		{
+		public:
+			Node(uint64_t key) : key(key), pNext(0) {}
+			bool isDummy() const { return (key & 1) == 0; }
+			uint64_t key;                  // the split-order key
+			std::atomic<uintptr_t> pNext;
+		};
+
+		// an element node; its key is odd
+		class Element : public Node
+		{
+		public:
+			Element(uint64_t key, const T& data) : Node(key), data(data) {}
+			T data;
+		};
+
+		// where a key belongs: *pPrev held pCurr, the first node after it
+		struct Position
+		{
+			std::atomic<uintptr_t>* pPrev;
+			Node* pCurr;
+		};
+
+		static bool isMarked(uintptr_t p) { return (p & MARK) != 0; }
+		static Node* pointer(uintptr_t p) { return reinterpret_cast<Node*>(p & ~MARK); }
+
+		static uint64_t reverse(uint64_t x);
+		static uint64_t elementKey(uint64_t hash) { return reverse(hash | (uint64_t(1) << 63)); }
+		static uint64_t dummyKey(size_t bucket) { return reverse(bucket); }
+
+		// the bucket with its top bit cleared, which it split from
+		static size_t parentOf(size_t bucket);
+		static int segmentOf(size_t bucket);
+		static size_t segmentStart(int segment) { return segment == 0 ? 0 : size_t(1) << (segment - 1); }
+		static size_t segmentSize(int segment) { return segment == 0 ? 1 : size_t(1) << (segment - 1); }
+
+		std::atomic<Node*>& slot(size_t bucket) const;
+		Node* getBucket(size_t bucket) const;
+		void initializeBucket(size_t bucket) const;
+
+		bool find(Node* pStart, uint64_t key, const T* pT, Position& pos) const;
+		static void destroy(Node* p);
+
+		mutable std::atomic<std::atomic<Node*>*> segments[NUM_SEGMENTS];
+		Node* pHead;                        // the dummy of bucket 0, never removed
+		std::atomic<size_t> numBuckets;     // always a power of two
+		std::atomic<size_t> numElements;
+		Hash hasher;
+		KeyEqual equal;
+	};
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: CONSTRUCTOR
+	 * Only bucket 0 exists at first
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	split_ordered_set <T, Hash, KeyEqual> ::split_ordered_set(const Hash& hash, const KeyEqual& eq) :
+		pHead(new Node(dummyKey(0))), numBuckets(2), numElements(0), hasher(hash), equal(eq)
+	{
+		for (int s = 0; s < NUM_SEGMENTS; s++)
+			segments[s].store(nullptr, std::memory_order_relaxed);
+		slot(0).store(pHead);
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: DESTRUCTOR
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	split_ordered_set <T, Hash, KeyEqual> ::~split_ordered_set()
+	{
+		Node* p = pHead;
+		while (p) {
+			Node* pNext = pointer(p->pNext.load());
+			destroy(p);
+			p = pNext;
+		}
+		for (int s = 0; s < NUM_SEGMENTS; s++)
+			delete[] segments[s].load();
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: INSERT
+	 * Add to the list after the bucket's dummy, then
+	 * double the bucket count if the load got too high.
+	 * Doubling is one CAS: the new buckets fill in lazily
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	bool split_ordered_set <T, Hash, KeyEqual> ::insert(const T& t)
+	{
+		epoch::guard g;
+		uint64_t hash = static_cast<uint64_t>(hasher(t));
+		size_t buckets = numBuckets.load();
+		Node* pBucket = getBucket(static_cast<size_t>(hash & (buckets - 1)));
+		Element* pNew = new Element(elementKey(hash), t);
+		while (true) {
+			Position pos;
+			if (find(pBucket, pNew->key, &t, pos)) {
+				delete pNew;
+				return false;
+			}
+			pNew->pNext.store(reinterpret_cast<uintptr_t>(pos.pCurr), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+			if (pos.pPrev->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pNew))) {
+				break;
+			}
+		}
+
+		size_t num = numElements.fetch_add(1) + 1;
+		if (num > MAX_LOAD * buckets && buckets < segmentStart(NUM_SEGMENTS - 1))
+			numBuckets.compare_exchange_strong(buckets, buckets * 2);
+		return true;
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: ERASE
+	 * Mark, then unlink: exactly as the lock-free list
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	bool split_ordered_set <T, Hash, KeyEqual> ::erase(const T& t)
+	{
+		epoch::guard g;
+		uint64_t hash = static_cast<uint64_t>(hasher(t));
+		Node* pBucket = getBucket(static_cast<size_t>(hash & (numBuckets.load() - 1)));
+		uint64_t key = elementKey(hash);
+		while (true) {
+			Position pos;
+			if (!find(pBucket, key, &t, pos)) {
+				return false;
+			}
+
+			// logical delete: whoever sets the mark owns the erase
+			uintptr_t next = pos.pCurr->pNext.load();
+			if (isMarked(next)) {
+				continue;
+			}
+			if (!pos.pCurr->pNext.compare_exchange_strong(next, next | MARK)) {
+				continue;
+			}
+			numElements.fetch_sub(1, std::memory_order_relaxed);
+
+			// physical delete: if we lose the race, find() cleans up
+			uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+			if (pos.pPrev->compare_exchange_strong(expected, next)) {
+				epoch::retire(static_cast<Element*>(pos.pCurr));
+			}
+			else {
+				find(pBucket, key, &t, pos);
+			}
+			return true;
+		}
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: CONTAINS
+	 * Walk from the bucket's dummy. Never waits on anyone
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	bool split_ordered_set <T, Hash, KeyEqual> ::contains(const T& t) const
+	{
+		epoch::guard g;
+		uint64_t hash = static_cast<uint64_t>(hasher(t));
+		Node* p = getBucket(static_cast<size_t>(hash & (numBuckets.load() - 1)));
+		uint64_t key = elementKey(hash);
+		while (p && p->key <= key) {
+			if (p->key == key && equal(static_cast<Element*>(p)->data, t))
+				return !isMarked(p->pNext.load());
+			p = pointer(p->pNext.load());
+		}
+		return false;
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: FIND
+	 * Michael's search from pStart: stop at the node equal
+	 * to (key, *pT), or at the first node past key. Marked
+	 * nodes along the way are unlinked and retired. A null
+	 * pT looks for a dummy node
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	bool split_ordered_set <T, Hash, KeyEqual> ::find(Node* pStart, uint64_t key, const T* pT, Position& pos) const
+	{
+	retry:
+		pos.pPrev = &pStart->pNext;
+		pos.pCurr = pointer(pos.pPrev->load());
+		while (true) {
+			if (pos.pCurr == nullptr) {
+				return false;
+			}
+			uintptr_t next = pos.pCurr->pNext.load();
+			if (pos.pPrev->load() != reinterpret_cast<uintptr_t>(pos.pCurr)) {
+				goto retry;
+			}
+			if (!isMarked(next)) {
+				if (pos.pCurr->key > key) {
+					return false;
+				}
+				// hashes can collide, so one key may be shared by several elements
+				if (pos.pCurr->key == key &&
+				    (pT == nullptr || equal(static_cast<Element*>(pos.pCurr)->data, *pT))) {
+					return true;
+				}
+				pos.pPrev = &pos.pCurr->pNext;
+			}
+			else {
+				uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+				if (!pos.pPrev->compare_exchange_strong(expected, next & ~MARK)) {
+					goto retry;
+				}
+				// dummy nodes are never marked
+				epoch::retire(static_cast<Element*>(pos.pCurr));
+			}
+			pos.pCurr = pointer(next);
+		}
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: GET BUCKET
+	 * The dummy node of a bucket, made on first use
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	typename split_ordered_set <T, Hash, KeyEqual> ::Node* split_ordered_set <T, Hash, KeyEqual> ::getBucket(size_t bucket) const
+	{
+		std::atomic<Node*>& s = slot(bucket);
+		if (s.load() == nullptr)
+			initializeBucket(bucket);
+		return s.load();
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: INITIALIZE BUCKET
+	 * Add the bucket's dummy to the list, searching from
+	 * the parent bucket it split from. If another thread
+	 * got there first, use its dummy instead
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void split_ordered_set <T, Hash, KeyEqual> ::initializeBucket(size_t bucket) const
+	{
+		Node* pParent = getBucket(parentOf(bucket));
+		Node* pDummy = new Node(dummyKey(bucket));
+		while (true) {
+			Position pos;
+			if (find(pParent, pDummy->key, nullptr, pos)) {
+				delete pDummy;
+				pDummy = pos.pCurr;
+				break;
+			}
+			pDummy->pNext.store(reinterpret_cast<uintptr_t>(pos.pCurr), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+			if (pos.pPrev->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pDummy))) {
+				break;
+			}
+		}
+		slot(bucket).store(pDummy);
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: SLOT
+	 * Where a bucket's dummy pointer lives. A missing
+	 * segment is allocated and raced in with a CAS
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	std::atomic<typename split_ordered_set <T, Hash, KeyEqual> ::Node*>& split_ordered_set <T, Hash, KeyEqual> ::slot(size_t bucket) const
+	{
+		int s = segmentOf(bucket);
+		std::atomic<Node*>* pSegment = segments[s].load();
+		if (pSegment == nullptr) {
+			size_t num = segmentSize(s);
+			std::atomic<Node*>* pNew = new std::atomic<Node*>[num];
+			for (size_t i = 0; i < num; i++)
+				pNew[i].store(nullptr, std::memory_order_relaxed);
+			if (segments[s].compare_exchange_strong(pSegment, pNew))
+				pSegment = pNew;
+			else
+				delete[] pNew;
+		}
+		return pSegment[bucket - segmentStart(s)];
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: PARENT OF
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	size_t split_ordered_set <T, Hash, KeyEqual> ::parentOf(size_t bucket)
+	{
+		assert(bucket > 0);
+		size_t top = size_t(1) << (segmentOf(bucket) - 1);
+		return bucket & ~top;
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: SEGMENT OF
+	 * One more than the index of the top set bit
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	int split_ordered_set <T, Hash, KeyEqual> ::segmentOf(size_t bucket)
+	{
+		int s = 0;
+		while (bucket) {
+			bucket >>= 1;
+			s++;
+		}
+		return s;
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: REVERSE
+	 * Mirror the 64 bits of x
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	uint64_t split_ordered_set <T, Hash, KeyEqual> ::reverse(uint64_t x)
+	{
+		x = ((x >> 1)  & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+		x = ((x >> 2)  & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+		x = ((x >> 4)  & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+		x = ((x >> 8)  & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+		x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+		return (x >> 32) | (x << 32);
+	}
+
+	/**************************************************
+	 * SPLIT-ORDERED SET :: DESTROY
+	 * Free a node as whichever kind it is
+	 **************************************************/
+	template <typename T, typename Hash, typename KeyEqual>
+	void split_ordered_set <T, Hash, KeyEqual> ::destroy(Node* p)
+	{
+		if (p->isDummy())
+			delete p;
+		else
+			delete static_cast<Element*>(p);
+	}
+
+}; // namespace custom
@@ -0,0 +1,204 @@
+/***********************************************************************
+ * Header:
+ *    TEST BLOOM FILTER
+ * Summary:
+ *    Unit tests for bloom_filter
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bloom_filter.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+class TestBloomFilter : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sized();
+      test_construct_blocksAligned();
+      test_constructCopy_standard();
+
+      // Access
+      test_contains_noFalseNegatives();
+      test_contains_rateHeld();
+      test_contains_strings();
+      test_containsHash_oneBitPerLane();
+
+      // Remove
+      test_clear_standard();
+      test_resize_forgets();
+
+      report("BloomFilter");
+   }
+
+   typedef custom::bloom_filter<int> Filter;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an unsized filter has no bits, so it cannot rule anything out
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Filter f;
+      // verify
+      assertUnit(f.bit_count() == 0);
+      assertUnit(f.capacity() == 0);
+      assertUnit(f.contains(42));
+   }  // teardown
+
+   // the bits grow with the capacity and shrink with the rate
+   void test_construct_sized()
+   {  // setup
+      // exercise
+      Filter loose(1000, 0.1);
+      Filter tight(1000, 0.001);
+      // verify
+      assertUnit(loose.capacity() == 1000);
+      assertUnit(loose.false_positive_rate() == 0.1);
+      assertUnit(loose.bit_count() % 512 == 0);
+      assertUnit(loose.bit_count() >= 1000 * 4);
+      assertUnit(tight.bit_count() > loose.bit_count());
+      assertUnit(tight.bit_count() <= 1000 * 20);
+   }  // teardown
+
+   void test_construct_blocksAligned()
+   {  // setup
+      // exercise
+      Filter f(100, 0.01);
+      // verify
+      assertUnit(reinterpret_cast<uintptr_t>(f.pBlocks) % 64 == 0);
+      assertUnit(f.block_count() >= 1);
+   }  // teardown
+
+   void test_constructCopy_standard()
+   {  // setup
+      Filter f(100, 0.01);
+      for (int i = 0; i < 100; i++)
+         f.insert(i);
+      // exercise
+      Filter copy(f);
+      f.clear();
+      // verify
+      assertUnit(copy.capacity() == 100);
+      assertUnit(copy.pBlocks != f.pBlocks);
+      for (int i = 0; i < 100; i++)
+         assertUnit(copy.contains(i));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   void test_contains_noFalseNegatives()
+   {  // setup
+      Filter f(10000, 0.01);
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         f.insert(i * 3);
+      // verify
+      for (int i = 0; i < 10000; i++)
+         assertUnit(f.contains(i * 3));
+   }  // teardown
+
+   // filled to capacity, the measured rate stays near the one asked for
+   void test_contains_rateHeld()
+   {  // setup
+      Filter f(20000, 0.01);
+      for (int i = 0; i < 20000; i++)
+         f.insert(i);
+      // exercise
+      int numFalse = 0;
+      for (int i = 20000; i < 120000; i++)
+         if (f.contains(i))
+            numFalse++;
+      // verify
+      assertUnit(numFalse < 1500);     // 1.5% against 1% asked
+   }  // teardown
+
+   void test_contains_strings()
+   {  // setup
+      custom::bloom_filter<std::string> f(10, 0.01);
+      // exercise
+      f.insert("apple");
+      f.insert("banana");
+      // verify
+      assertUnit(f.contains("apple"));
+      assertUnit(f.contains("banana"));
+   }  // teardown
+
+   // a key sets exactly one bit in each of the eight lanes of one block
+   void test_containsHash_oneBitPerLane()
+   {  // setup
+      Filter f(1000, 0.01);
+      // exercise
+      f.insert_hash(12345);
+      // verify
+      int numBlocksUsed = 0;
+      for (size_t b = 0; b < f.block_count(); b++)
+      {
+         int numBits = 0;
+         for (int i = 0; i < 8; i++)
+         {
+            uint64_t w = f.pBlocks[b * 8 + i];
+            int numLane = 0;
+            for (; w; w &= w - 1)
+               numLane++;
+            assertUnit(numLane <= 1);
+            numBits += numLane;
+         }
+         if (numBits)
+         {
+            numBlocksUsed++;
+            assertUnit(numBits == 8);
+         }
+      }
+      assertUnit(numBlocksUsed == 1);
+      assertUnit(f.contains_hash(12345));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   void test_clear_standard()
+   {  // setup
+      Filter f(100, 0.01);
+      for (int i = 0; i < 100; i++)
+         f.insert(i);
+      // exercise
+      f.clear();
+      // verify
+      assertUnit(f.capacity() == 100);
+      for (int i = 0; i < 100; i++)
+         assertUnit(!f.contains(i));
+   }  // teardown
+
+   void test_resize_forgets()
+   {  // setup
+      Filter f(100, 0.01);
+      f.insert(7);
+      // exercise
+      f.resize(1000, 0.05);
+      // verify
+      assertUnit(f.capacity() == 1000);
+      assertUnit(f.false_positive_rate() == 0.05);
+      assertUnit(!f.contains(7));
+   }  // teardown
+};
+
+#endif // DEBUG
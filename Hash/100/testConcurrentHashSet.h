@@ -0,0 +1,300 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT HASH SET
+ * Summary:
+ *    Unit tests for concurrent_unordered_set
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_unordered_set.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+class TestConcurrentHashSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_shard_cacheLineAligned();
+
+      // Access
+      test_contains_missing();
+      test_insert_contains();
+      test_insert_duplicate();
+      test_erase_standard();
+      test_erase_missing();
+      test_clear_standard();
+
+      // Shards
+      test_shardOf_spreadsIdentityHash();
+      test_shardOf_singleShard();
+
+      // Batch
+      test_insertBatch_countsNew();
+      test_containsBatch_standard();
+      test_eraseBatch_standard();
+
+      // Threads
+      test_threads_disjointInserts();
+      test_threads_readersAndWriters();
+
+      report("ConcurrentHashSet");
+   }
+
+   typedef custom::concurrent_unordered_set<int> Set;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Set s;
+      // verify
+      assertUnit(s.shard_count() == 64);
+      assertUnit(s.size() == 0);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // every shard starts on its own cache line
+   void test_shard_cacheLineAligned()
+   {  // setup
+      Set s;
+      // exercise
+      // verify
+      assertUnit(alignof(Set::Shard) == 64);
+      assertUnit(sizeof(Set::Shard) % 64 == 0);
+      assertUnit((char*)&s.shards[1] - (char*)&s.shards[0] >= 64);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   void test_contains_missing()
+   {  // setup
+      Set s;
+      // exercise
+      // verify
+      assertUnit(!s.contains(42));
+      assertUnit(s.count(42) == 0);
+   }  // teardown
+
+   void test_insert_contains()
+   {  // setup
+      Set s;
+      // exercise
+      bool inserted = s.insert(42);
+      // verify
+      assertUnit(inserted);
+      assertUnit(s.contains(42));
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_insert_duplicate()
+   {  // setup
+      Set s;
+      s.insert(42);
+      // exercise
+      bool inserted = s.insert(42);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_erase_standard()
+   {  // setup
+      Set s;
+      s.insert(42);
+      s.insert(7);
+      // exercise
+      size_t num = s.erase(42);
+      // verify
+      assertUnit(num == 1);
+      assertUnit(!s.contains(42));
+      assertUnit(s.contains(7));
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_erase_missing()
+   {  // setup
+      Set s;
+      s.insert(7);
+      // exercise
+      size_t num = s.erase(42);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_clear_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(!s.contains(50));
+   }  // teardown
+
+   /***************************************
+    * SHARDS
+    ***************************************/
+
+   // std::hash<int> may be the identity, yet consecutive keys still spread
+   void test_shardOf_spreadsIdentityHash()
+   {  // setup
+      Set s;
+      std::vector<bool> used(64, false);
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         used[s.shardOf(i)] = true;
+      // verify
+      size_t numUsed = 0;
+      for (bool b : used)
+         numUsed += b ? 1 : 0;
+      assertUnit(numUsed == 64);
+   }  // teardown
+
+   void test_shardOf_singleShard()
+   {  // setup
+      custom::concurrent_unordered_set<int, std::hash<int>, std::equal_to<int>, 1> s;
+      // exercise
+      s.insert(1);
+      s.insert(2);
+      // verify
+      assertUnit(s.shardOf(1) == 0);
+      assertUnit(s.shardOf(123456) == 0);
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   /***************************************
+    * BATCH
+    ***************************************/
+
+   // duplicates inside the batch and against the set are not counted
+   void test_insertBatch_countsNew()
+   {  // setup
+      Set s;
+      s.insert(3);
+      int keys[] = { 1, 2, 3, 2, 4, 1000, 77 };
+      // exercise
+      size_t num = s.insert_batch(keys, 7);
+      // verify
+      assertUnit(num == 5);
+      assertUnit(s.size() == 6);
+      for (int k : keys)
+         assertUnit(s.contains(k));
+   }  // teardown
+
+   // the answers come back in the order of the keys
+   void test_containsBatch_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i += 2)
+         s.insert(i);
+      std::vector<int> keys;
+      for (int i = 0; i < 100; i++)
+         keys.push_back(i);
+      bool found[100];
+      // exercise
+      s.contains_batch(keys.data(), keys.size(), found);
+      // verify
+      for (int i = 0; i < 100; i++)
+         assertUnit(found[i] == (i % 2 == 0));
+   }  // teardown
+
+   void test_eraseBatch_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 10; i++)
+         s.insert(i);
+      int keys[] = { 0, 5, 9, 42, 5 };
+      // exercise
+      size_t num = s.erase_batch(keys, 5);
+      // verify
+      assertUnit(num == 3);
+      assertUnit(s.size() == 7);
+      assertUnit(!s.contains(0));
+      assertUnit(!s.contains(5));
+      assertUnit(!s.contains(9));
+      assertUnit(s.contains(4));
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // each thread adds its own range; nothing is lost
+   void test_threads_disjointInserts()
+   {  // setup
+      Set s;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < 8; t++)
+         threads.push_back(std::thread([&s, t]()
+         {
+            for (int i = 0; i < 1000; i++)
+               s.insert(t * 1000 + i);
+         }));
+      for (std::thread& th : threads)
+         th.join();
+      // verify
+      assertUnit(s.size() == 8000);
+      for (int i = 0; i < 8000; i += 97)
+         assertUnit(s.contains(i));
+   }  // teardown
+
+   // readers always see the stable keys while writers churn others
+   void test_threads_readersAndWriters()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 1000; i++)
+         s.insert(i);
+      std::vector<std::thread> threads;
+      std::vector<int> misses(4, 0);
+      // exercise
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, t]()
+         {
+            for (int round = 0; round < 20; round++)
+            {
+               for (int i = 0; i < 100; i++)
+                  s.insert(10000 + t * 100 + i);
+               for (int i = 0; i < 100; i++)
+                  s.erase(10000 + t * 100 + i);
+            }
+         }));
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, &misses, t]()
+         {
+            for (int round = 0; round < 20; round++)
+               for (int i = 0; i < 1000; i++)
+                  if (!s.contains(i))
+                     misses[t]++;
+         }));
+      for (std::thread& th : threads)
+         th.join();
+      // verify
+      for (int m : misses)
+         assertUnit(m == 0);
+      assertUnit(s.size() == 1000);
+   }  // teardown
+};
+
+#endif // DEBUG
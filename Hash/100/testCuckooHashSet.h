@@ -0,0 +1,365 @@
+/***********************************************************************
+ * Header:
+ *    TEST CUCKOO HASH SET
+ * Summary:
+ *    Unit tests for cuckoo_hash_set
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "cuckoo_hash_set.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************
+ * ZERO HASH
+ * Every key wants the same two buckets, so the
+ * stash has to take the rest
+ ***********************************************/
+struct ZeroHash
+{
+   size_t operator()(int) const noexcept { return 0; }
+};
+
+class TestCuckooHashSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializerList();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Layout
+      test_bucket_neverStraddlesLine();
+
+      // Access
+      test_find_empty();
+      test_find_onlyTwoBuckets();
+      test_insert_duplicate();
+      test_insert_manyAllFound();
+      test_insert_cuckooChain();
+      test_insert_highLoadBeforeGrowth();
+      test_insert_strings();
+
+      // Stash
+      test_stash_sameBuckets();
+      test_erase_unstashes();
+
+      // Remove
+      test_erase_standard();
+      test_erase_missing();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_visitsAll();
+
+      report("CuckooHashSet");
+   }
+
+   typedef custom::cuckoo_hash_set<int> Set;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing is allocated until the first insert
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Set s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 0);
+      assertUnit(s.pRaw == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      Set s{ 3, 1, 4, 1, 5 };
+      // verify
+      assertUnit(s.size() == 4);
+      assertUnit(s.contains(3));
+      assertUnit(s.contains(1));
+      assertUnit(s.contains(4));
+      assertUnit(s.contains(5));
+   }  // teardown
+
+   void test_constructCopy_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      // exercise
+      Set copy(s);
+      s.clear();
+      // verify
+      assertUnit(copy.size() == 100);
+      assertUnit(copy.bucket_count() == s.bucket_count());
+      for (int i = 0; i < 100; i++)
+         assertUnit(copy.contains(i));
+   }  // teardown
+
+   void test_constructMove_standard()
+   {  // setup
+      Set s{ 1, 2, 3 };
+      // exercise
+      Set moved(std::move(s));
+      // verify
+      assertUnit(moved.size() == 3);
+      assertUnit(moved.contains(2));
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 0);
+   }  // teardown
+
+   /***************************************
+    * LAYOUT
+    ***************************************/
+
+   // the array starts on a cache line and each bucket stays inside one
+   void test_bucket_neverStraddlesLine()
+   {  // setup
+      Set s;
+      // exercise
+      s.reserve(1000);
+      // verify
+      assertUnit(reinterpret_cast<uintptr_t>(s.pBuckets) % 64 == 0);
+      assertUnit(Set::stride() == 32);
+      for (size_t b = 0; b < s.bucket_count(); b++)
+      {
+         uintptr_t start = reinterpret_cast<uintptr_t>(&s.bucketAt(b));
+         uintptr_t last = start + sizeof(Set::Bucket) - 1;
+         assertUnit(start / 64 == last / 64);
+      }
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   void test_find_empty()
+   {  // setup
+      Set s;
+      // exercise
+      Set::iterator it = s.find(42);
+      // verify
+      assertUnit(it == s.end());
+      assertUnit(!s.contains(42));
+      assertUnit(s.count(42) == 0);
+   }  // teardown
+
+   // every element sits in one of the two buckets its hash names
+   void test_find_onlyTwoBuckets()
+   {  // setup
+      Set s;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         s.insert(i * 31);
+      // verify
+      for (int i = 0; i < 1000; i++)
+      {
+         uint64_t h = s.hashOf(i * 31);
+         size_t pos = s.findPosition(i * 31, h);
+         assertUnit(pos < s.numPositions());
+         if (pos < s.numSlots())
+            assertUnit(pos / 4 == s.first(h) || pos / 4 == s.second(h));
+      }
+   }  // teardown
+
+   void test_insert_duplicate()
+   {  // setup
+      Set s;
+      s.insert(7);
+      // exercise
+      custom::pair<Set::iterator, bool> result = s.insert(7);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 7);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_insert_manyAllFound()
+   {  // setup
+      Set s;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.size() == 20000);
+      for (int i = 0; i < 20000; i++)
+         assertUnit(s.contains(i));
+      for (int i = 20000; i < 21000; i++)
+         assertUnit(!s.contains(i));
+   }  // teardown
+
+   // with both buckets full, insert moves others aside rather than grow
+   void test_insert_cuckooChain()
+   {  // setup
+      Set s;
+      s.reserve(100);
+      size_t numBuckets = s.bucket_count();
+      int k = 0;
+      for (; s.load_factor() < 0.7f; k++)
+         s.insert(k);
+      // exercise: find a key whose two buckets are both full
+      int key = k;
+      for (;; key++)
+      {
+         uint64_t h = s.hashOf(key);
+         if (s.bucketAt(s.first(h)).freeSlot() < 0 && s.bucketAt(s.second(h)).freeSlot() < 0)
+            break;
+      }
+      s.insert(key);
+      // verify
+      assertUnit(s.bucket_count() == numBuckets);
+      assertUnit(s.stash_size() == 0);
+      assertUnit(s.contains(key));
+      for (int i = 0; i < k; i++)
+         assertUnit(s.contains(i));
+   }  // teardown
+
+   // four ways and two choices fill well past 90% before growing
+   void test_insert_highLoadBeforeGrowth()
+   {  // setup
+      Set s;
+      s.reserve(10000);
+      size_t numBuckets = s.bucket_count();
+      float loadMax = 0.0f;
+      // exercise
+      for (int i = 0; s.bucket_count() == numBuckets; i++)
+      {
+         loadMax = s.load_factor();
+         s.insert(i * 7919);
+      }
+      // verify
+      assertUnit(loadMax > 0.9f);
+   }  // teardown
+
+   void test_insert_strings()
+   {  // setup
+      custom::cuckoo_hash_set<std::string> s;
+      // exercise
+      for (int i = 0; i < 200; i++)
+         s.insert(std::to_string(i));
+      // verify
+      assertUnit(s.size() == 200);
+      assertUnit(s.contains("0"));
+      assertUnit(s.contains("199"));
+      assertUnit(!s.contains("200"));
+   }  // teardown
+
+   /***************************************
+    * STASH
+    ***************************************/
+
+   // eight slots in two buckets, and the rest overflow into the stash
+   void test_stash_sameBuckets()
+   {  // setup
+      custom::cuckoo_hash_set<int, ZeroHash> s;
+      // exercise
+      for (int i = 0; i < 20; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.size() == 20);
+      assertUnit(s.stash_size() == 12);
+      for (int i = 0; i < 20; i++)
+         assertUnit(s.contains(i));
+      assertUnit(!s.contains(20));
+   }  // teardown
+
+   // a slot freed in a stashed element's bucket takes it back
+   void test_erase_unstashes()
+   {  // setup
+      custom::cuckoo_hash_set<int, ZeroHash> s;
+      for (int i = 0; i < 10; i++)
+         s.insert(i);
+      size_t numStash = s.stash_size();
+      int inBucket = *s.begin();
+      // exercise
+      size_t num = s.erase(inBucket);
+      // verify
+      assertUnit(num == 1);
+      assertUnit(s.stash_size() == numStash - 1);
+      assertUnit(s.size() == 9);
+      for (int i = 0; i < 10; i++)
+         assertUnit(s.contains(i) == (i != inBucket));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   void test_erase_standard()
+   {  // setup
+      Set s{ 1, 2, 3 };
+      // exercise
+      size_t num = s.erase(2);
+      // verify
+      assertUnit(num == 1);
+      assertUnit(s.size() == 2);
+      assertUnit(!s.contains(2));
+      assertUnit(s.contains(1));
+      assertUnit(s.contains(3));
+   }  // teardown
+
+   void test_erase_missing()
+   {  // setup
+      Set s{ 1, 2, 3 };
+      // exercise
+      size_t num = s.erase(4);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(s.size() == 3);
+   }  // teardown
+
+   // the buckets stay for the next inserts
+   void test_clear_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      size_t numBuckets = s.bucket_count();
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == numBuckets);
+      assertUnit(!s.contains(50));
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // buckets and stash together, each element once
+   void test_iterator_visitsAll()
+   {  // setup
+      custom::cuckoo_hash_set<int, ZeroHash> s;
+      for (int i = 0; i < 12; i++)
+         s.insert(i);
+      std::vector<int> seen(12, 0);
+      // exercise
+      for (custom::cuckoo_hash_set<int, ZeroHash>::iterator it = s.begin(); it != s.end(); ++it)
+         seen[*it]++;
+      // verify
+      for (int n : seen)
+         assertUnit(n == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,626 @@
+/***********************************************************************
+ * Header:
+ *    TEST FLAT HASH SET
+ * Summary:
+ *    Unit tests for flat_hash_set
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "flat_hash_set.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+
+#undef assertValid
+#define assertValid(x) assertValidParameters(x, __LINE__, __FUNCTION__)
+
+/***********************************************
+ * COLLIDING HASH
+ * Every key lands in the same group so the tests
+ * can force long probes and tombstones
+ ***********************************************/
+struct CollidingHash
+{
+   size_t operator()(int) const noexcept { return 0; }
+};
+
+class TestFlatHashSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit_standard();
+      test_constructCopy_standard();
+      test_constructCopy_afterErase();
+      test_constructMove_standard();
+
+      // Assign
+      test_assign_standardToEmpty();
+      test_swap_standardEmpty();
+
+      // Iterator
+      test_iterator_empty();
+      test_iterator_visitsEach();
+
+      // Access
+      test_find_empty();
+      test_find_standard();
+      test_find_missing();
+
+      // Insert
+      test_insert_empty();
+      test_insert_duplicate();
+      test_insert_growsTable();
+      test_insert_move();
+      test_insert_string();
+
+      // Remove
+      test_erase_missing();
+      test_erase_standard();
+      test_erase_emptyGroupLeavesEmpty();
+      test_erase_fullGroupLeavesTombstone();
+      test_erase_tombstoneKeepsProbe();
+      test_erase_tombstonesReused();
+      test_erase_iterator();
+      test_clear_standard();
+
+      // Hash policy
+      test_reserve_noRehash();
+      test_rehash_standard();
+      test_random_matchesStd();
+
+      report("FlatHashSet");
+   }
+
+   typedef custom::flat_hash_set<int> FlatSet;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing is allocated until the first insert
+   void test_construct_default()
+   {  // setup
+      // exercise
+      FlatSet s;
+      // verify
+      assertUnit(s.pCtrl == nullptr);
+      assertUnit(s.pSlots == nullptr);
+      assertUnit(s.numCapacity == 0);
+      assertUnit(s.numElements == 0);
+      assertUnit(s.empty());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // build the standard fixture from an initializer list
+   void test_constructInit_standard()
+   {  // setup
+      // exercise
+      FlatSet s{ 31, 67, 59, 49 };
+      // verify
+      assertStandardFixture(s);
+   }  // teardown
+
+   // the copy has its own slots in the same layout
+   void test_constructCopy_standard()
+   {  // setup
+      FlatSet sSrc;
+      setupStandardFixture(sSrc);
+      // exercise
+      FlatSet sDes(sSrc);
+      // verify
+      assertUnit(sDes.pSlots != sSrc.pSlots);
+      assertUnit(sDes.numCapacity == sSrc.numCapacity);
+      assertStandardFixture(sDes);
+      assertStandardFixture(sSrc);
+   }  // teardown
+
+   // tombstones are copied, so elements that probed past them are still found
+   void test_constructCopy_afterErase()
+   {  // setup
+      custom::flat_hash_set<int, CollidingHash> sSrc;
+      sSrc.reserve(28);
+      for (int i = 0; i < 20; i++)
+         sSrc.insert(i);
+      for (int i = 0; i < 16; i += 2)
+         sSrc.erase(i);
+      custom::flat_hash_set<int, CollidingHash> sAssign;
+      // exercise
+      custom::flat_hash_set<int, CollidingHash> sDes(sSrc);
+      sAssign = sSrc;
+      // verify
+      assertUnit(sDes.numDeleted == sSrc.numDeleted);
+      bool isFound = true;
+      for (int i = 0; i < 20; i++)
+      {
+         bool isErased = (i < 16 && i % 2 == 0);
+         isFound = isFound && (sDes.find(i) != sDes.end()) != isErased;
+         isFound = isFound && (sAssign.find(i) != sAssign.end()) != isErased;
+      }
+      assertUnit(isFound);
+      bool isNoDuplicate = true;
+      for (int i = 1; i < 20; i += 2)
+      {
+         isNoDuplicate = isNoDuplicate && !sDes.insert(i).second;
+         isNoDuplicate = isNoDuplicate && !sAssign.insert(i).second;
+      }
+      assertUnit(isNoDuplicate);
+      assertUnit(sDes.size() == 12);
+      assertUnit(sAssign.size() == 12);
+      assertValid(sDes);
+   }  // teardown
+
+   // move steals the block
+   void test_constructMove_standard()
+   {  // setup
+      FlatSet sSrc;
+      setupStandardFixture(sSrc);
+      int8_t* pCtrl = sSrc.pCtrl;
+      // exercise
+      FlatSet sDes(std::move(sSrc));
+      // verify
+      assertUnit(sDes.pCtrl == pCtrl);
+      assertUnit(sSrc.pCtrl == nullptr);
+      assertUnit(sSrc.empty());
+      assertStandardFixture(sDes);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // copy-assign onto an empty set
+   void test_assign_standardToEmpty()
+   {  // setup
+      FlatSet sSrc;
+      FlatSet sDes;
+      setupStandardFixture(sSrc);
+      // exercise
+      sDes = sSrc;
+      // verify
+      assertStandardFixture(sDes);
+      assertStandardFixture(sSrc);
+   }  // teardown
+
+   // swap exchanges the blocks
+   void test_swap_standardEmpty()
+   {  // setup
+      FlatSet s1;
+      FlatSet s2;
+      setupStandardFixture(s1);
+      // exercise
+      s1.swap(s2);
+      // verify
+      assertUnit(s1.empty());
+      assertUnit(s1.pCtrl == nullptr);
+      assertStandardFixture(s2);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // an empty set begins at its end
+   void test_iterator_empty()
+   {  // setup
+      FlatSet s;
+      s.insert(5);
+      s.erase(5);
+      // exercise
+      FlatSet::iterator it = s.begin();
+      // verify
+      assertUnit(it == s.end());
+      assertUnit(s.numCapacity == 16);
+   }  // teardown
+
+   // every element is visited exactly once
+   void test_iterator_visitsEach()
+   {  // setup
+      FlatSet s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i * 3);
+      std::vector<int> v;
+      // exercise
+      for (FlatSet::iterator it = s.begin(); it != s.end(); it++)
+         v.push_back(*it);
+      // verify
+      std::sort(v.begin(), v.end());
+      assertUnit(v.size() == 100);
+      bool allThere = true;
+      for (int i = 0; i < (int)v.size(); i++)
+         allThere = allThere && v[i] == i * 3;
+      assertUnit(allThere);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find in an empty set does not touch the slots
+   void test_find_empty()
+   {  // setup
+      FlatSet s;
+      // exercise
+      FlatSet::iterator it = s.find(31);
+      // verify
+      assertUnit(it == s.end());
+   }  // teardown
+
+   // find each of the standard elements
+   void test_find_standard()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      FlatSet::iterator it31 = s.find(31);
+      FlatSet::iterator it49 = s.find(49);
+      // verify
+      assertUnit(it31 != s.end() && *it31 == 31);
+      assertUnit(it49 != s.end() && *it49 == 49);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // find an element that is not there
+   void test_find_missing()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      FlatSet::iterator it = s.find(32);
+      // verify
+      assertUnit(it == s.end());
+      assertStandardFixture(s);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first insert allocates one group
+   void test_insert_empty()
+   {  // setup
+      FlatSet s;
+      // exercise
+      auto p = s.insert(58);
+      // verify
+      assertUnit(p.second);
+      assertUnit(*p.first == 58);
+      assertUnit(s.numCapacity == 16);
+      assertUnit(s.size() == 1);
+      assertValid(s);
+   }  // teardown
+
+   // a duplicate is not inserted
+   void test_insert_duplicate()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      auto p = s.insert(67);
+      // verify
+      assertUnit(!p.second);
+      assertUnit(*p.first == 67);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // the table doubles when it passes 7/8 full
+   void test_insert_growsTable()
+   {  // setup
+      FlatSet s;
+      for (int i = 0; i < 14; i++)
+         s.insert(i);
+      assertUnit(s.numCapacity == 16);
+      // exercise
+      s.insert(14);
+      // verify
+      assertUnit(s.numCapacity == 32);
+      assertUnit(s.size() == 15);
+      assertUnit(s.load_factor() <= s.max_load_factor());
+      for (int i = 0; i <= 14; i++)
+         assertUnit(s.find(i) != s.end());
+      assertValid(s);
+   }  // teardown
+
+   // an rvalue is moved into its slot
+   void test_insert_move()
+   {  // setup
+      custom::flat_hash_set<std::string> s;
+      std::string str("a string long enough to live on the heap");
+      // exercise
+      auto p = s.insert(std::move(str));
+      // verify
+      assertUnit(p.second);
+      assertUnit(str.empty());
+      assertUnit(*p.first == std::string("a string long enough to live on the heap"));
+   }  // teardown
+
+   // non-trivial elements survive growth
+   void test_insert_string()
+   {  // setup
+      custom::flat_hash_set<std::string> s;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         s.insert(std::to_string(i));
+      // verify
+      assertUnit(s.size() == 1000);
+      size_t numFound = 0;
+      for (int i = 0; i < 1000; i++)
+         if (s.find(std::to_string(i)) != s.end())
+            numFound++;
+      assertUnit(numFound == 1000);
+      assertUnit(s.find(std::string("1000")) == s.end());
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase something that is not there
+   void test_erase_missing()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      FlatSet::iterator it = s.erase(32);
+      // verify
+      assertUnit(it == s.end());
+      assertStandardFixture(s);
+   }  // teardown
+
+   // erase from the standard fixture
+   void test_erase_standard()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      s.erase(59);
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(s.find(59) == s.end());
+      assertUnit(s.find(31) != s.end());
+      assertUnit(s.find(67) != s.end());
+      assertUnit(s.find(49) != s.end());
+      assertValid(s);
+   }  // teardown
+
+   // no probe can have passed a group with an empty slot
+   void test_erase_emptyGroupLeavesEmpty()
+   {  // setup
+      custom::flat_hash_set<int, CollidingHash> s;
+      s.insert(1);
+      s.insert(2);
+      // exercise
+      s.erase(1);
+      // verify
+      assertUnit(s.numDeleted == 0);
+      assertUnit(s.find(2) != s.end());
+      assertValid(s);
+   }  // teardown
+
+   // a full group needs a tombstone so later probes keep going
+   void test_erase_fullGroupLeavesTombstone()
+   {  // setup
+      custom::flat_hash_set<int, CollidingHash> s;
+      s.reserve(28);                 // 32 slots, two groups
+      for (int i = 0; i < 20; i++)   // fills the first group, spills into the second
+         s.insert(i);
+      assertUnit(s.numCapacity == 32);
+      // exercise
+      s.erase(0);
+      // verify
+      assertUnit(s.numDeleted == 1);
+      assertUnit(s.size() == 19);
+      assertValid(s);
+   }  // teardown
+
+   // keys past a tombstone are still found
+   void test_erase_tombstoneKeepsProbe()
+   {  // setup
+      custom::flat_hash_set<int, CollidingHash> s;
+      s.reserve(28);
+      for (int i = 0; i < 20; i++)
+         s.insert(i);
+      // exercise
+      for (int i = 0; i < 16; i += 2)
+         s.erase(i);
+      // verify
+      size_t numFound = 0;
+      for (int i = 0; i < 20; i++)
+         if (s.find(i) != s.end())
+            numFound++;
+      assertUnit(numFound == 12);
+      assertUnit(s.find(19) != s.end());
+      assertUnit(s.find(0) == s.end());
+      assertValid(s);
+   }  // teardown
+
+   // inserts fill tombstones instead of growing
+   void test_erase_tombstonesReused()
+   {  // setup
+      custom::flat_hash_set<int, CollidingHash> s;
+      s.reserve(28);
+      for (int i = 0; i < 20; i++)
+         s.insert(i);
+      for (int i = 0; i < 16; i += 2)
+         s.erase(i);
+      size_t numDeleted = s.numDeleted;
+      // exercise
+      s.insert(100);
+      // verify
+      assertUnit(numDeleted > 0);
+      assertUnit(s.numDeleted == numDeleted - 1);
+      assertUnit(s.numCapacity == 32);
+      assertUnit(s.find(100) != s.end());
+      assertValid(s);
+   }  // teardown
+
+   // erasing through an iterator returns the next element
+   void test_erase_iterator()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      size_t numVisited = 0;
+      // exercise
+      for (FlatSet::iterator it = s.begin(); it != s.end(); )
+      {
+         it = s.erase(it);
+         numVisited++;
+      }
+      // verify
+      assertUnit(numVisited == 4);
+      assertUnit(s.empty());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // clear keeps the slots
+   void test_clear_standard()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      size_t numCapacity = s.numCapacity;
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.numCapacity == numCapacity);
+      assertUnit(s.find(31) == s.end());
+      assertValid(s);
+   }  // teardown
+
+   /***************************************
+    * HASH POLICY
+    ***************************************/
+
+   // after reserve the inserts never move the block
+   void test_reserve_noRehash()
+   {  // setup
+      FlatSet s;
+      s.reserve(1000);
+      int8_t* pCtrl = s.pCtrl;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.pCtrl == pCtrl);
+      assertUnit(s.size() == 1000);
+      assertValid(s);
+   }  // teardown
+
+   // rehash grows to a power of two and keeps everything
+   void test_rehash_standard()
+   {  // setup
+      FlatSet s;
+      setupStandardFixture(s);
+      // exercise
+      s.rehash(100);
+      // verify
+      assertUnit(s.numCapacity == 128);
+      assertStandardFixture(s);
+   }  // teardown
+
+   // a random mix of inserts and erases agrees with std::unordered_set
+   void test_random_matchesStd()
+   {  // setup
+      FlatSet s;
+      std::unordered_set<int> expected;
+      unsigned int seed = 12345;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         int key = (seed >> 8) % 2000;
+         if ((seed >> 4) & 1)
+         {
+            s.insert(key);
+            expected.insert(key);
+         }
+         else
+         {
+            s.erase(key);
+            expected.erase(key);
+         }
+      }
+      // verify
+      assertUnit(s.size() == expected.size());
+      bool same = true;
+      for (int key = 0; key < 2000; key++)
+         same = same && ((s.find(key) != s.end()) == (expected.count(key) == 1));
+      assertUnit(same);
+      assertValid(s);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *    { 31, 67, 59, 49 }
+    *************************************************************/
+   void setupStandardFixture(FlatSet& s)
+   {
+      s.insert(31);
+      s.insert(67);
+      s.insert(59);
+      s.insert(49);
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE
+    *    { 31, 67, 59, 49 }
+    *************************************************************/
+   void assertStandardFixtureParameters(const FlatSet& s, int line, const char* function)
+   {
+      assertIndirect(s.numElements == 4);
+      assertIndirect(s.find(31) != s.end());
+      assertIndirect(s.find(67) != s.end());
+      assertIndirect(s.find(59) != s.end());
+      assertIndirect(s.find(49) != s.end());
+      assertValidParameters(s, line, function);
+   }
+
+   /*************************************************************
+    * VERIFY VALID
+    * The control bytes agree with the counts, every full slot
+    * holds the H2 of its element, and every element is found
+    * from its own hash
+    *************************************************************/
+   template <class T, class H, class E>
+   void assertValidParameters(const custom::flat_hash_set<T, H, E>& s, int line, const char* function)
+   {
+      typedef custom::flat_hash_set<T, H, E> Set;
+      assertIndirect(s.numCapacity == 0 || (s.numCapacity & (s.numCapacity - 1)) == 0);
+      assertIndirect(s.numElements + s.numDeleted <= s.growthLimit() || s.numCapacity == 0);
+      size_t numFull = 0;
+      size_t numDeleted = 0;
+      bool h2Match = true;
+      bool allFound = true;
+      for (size_t i = 0; i < s.numCapacity; i++)
+      {
+         if (s.pCtrl[i] == Set::DELETED)
+            numDeleted++;
+         else if (s.pCtrl[i] >= 0)
+         {
+            numFull++;
+            h2Match = h2Match && s.pCtrl[i] == Set::H2(s.hashOf(s.pSlots[i]));
+            allFound = allFound && s.find(s.pSlots[i]).pSlot == s.pSlots + i;
+         }
+      }
+      assertIndirect(numFull == s.numElements);
+      assertIndirect(numDeleted == s.numDeleted);
+      assertIndirect(h2Match);
+      assertIndirect(allFound);
+   }
+};
+
+#endif // DEBUG
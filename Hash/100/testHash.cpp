@@ -12,10 +12,21 @@
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
 
+#ifndef HASH_TABLE_STATS
+#define HASH_TABLE_STATS   // so the unit tests can check hash_table_stats
+#endif
+
 #include "testSpy.h"       // for the pair unit tests
 #include "testPair.h"       // for the pair unit tests
 #include "testHash.h"       // for the hash unit tests
 #include "testList.h"       // for the list unit tests
+#include "testFlatHashSet.h" // for the flat hash set unit tests
+#include "testUnorderedMap.h" // for the unordered map unit tests
+#include "testConcurrentHashSet.h" // for the concurrent hash set unit tests
+#include "testSplitOrderedSet.h" // for the split-ordered set unit tests
+#include "testPerfectHashSet.h" // for the perfect hash set unit tests
+#include "testBloomFilter.h" // for the bloom filter unit tests
+#include "testCuckooHashSet.h" // for the cuckoo hash set unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +41,13 @@ int main()
    TestPair().run();
    TestList().run();
    TestHash().run();
+   TestFlatHashSet().run();
+   TestUnorderedMap().run();
+   TestConcurrentHashSet().run();
+   TestSplitOrderedSet().run();
+   TestPerfectHashSet().run();
+   TestBloomFilter().run();
+   TestCuckooHashSet().run();
 #endif // DEBUG
    
    // driver
@@ -19,12 +19,16 @@
 #include <unordered_set>
 #include <functional>
 #include <vector>
+#include <string>
+#include <cctype>
+#include <sstream>
 
 using std::cout;
 using std::endl;
 
-// Keep our hash simple without any fancy stuff
-#ifndef __APPLE__
+// Keep our hash simple without any fancy stuff. libstdc++ already
+// hashes integers to themselves and would reject a second definition
+#if !defined(__APPLE__) && !defined(__GLIBCXX__)
 namespace std
 {
    template <> struct hash<std::size_t>
@@ -38,6 +42,79 @@ namespace std
 }
 #endif // __APPLE__
 
+/***********************************************
+ * CASE-INSENSITIVE HASH and EQUAL
+ * Lets "Apple" and "aPPLE" be the same key
+ ***********************************************/
+struct CaseInsensitiveHash
+{
+   size_t operator()(const std::string& s) const
+   {
+      size_t h = 0;
+      for (char c : s)
+         h = h * 31 + (size_t)std::tolower((unsigned char)c);
+      return h;
+   }
+};
+struct CaseInsensitiveEqual
+{
+   bool operator()(const std::string& lhs, const std::string& rhs) const
+   {
+      if (lhs.size() != rhs.size())
+         return false;
+      for (size_t i = 0; i < lhs.size(); i++)
+         if (std::tolower((unsigned char)lhs[i]) != std::tolower((unsigned char)rhs[i]))
+            return false;
+      return true;
+   }
+};
+
+/***********************************************
+ * COUNTING HASH and EQUAL
+ * How often does the set call each of them?
+ * Every key is its own hash, like std::hash<size_t>
+ ***********************************************/
+struct CountingHash
+{
+   static int count;
+   size_t operator()(std::size_t i) const { count++; return i; }
+};
+int CountingHash::count = 0;
+
+struct CountingEqual
+{
+   static int count;
+   bool operator()(std::size_t lhs, std::size_t rhs) const { count++; return lhs == rhs; }
+};
+int CountingEqual::count = 0;
+
+/***********************************************
+ * STRING HASH and EQUAL (transparent)
+ * Hash a std::string and a const char* the same
+ * way, and count the calls that needed a string
+ ***********************************************/
+struct StringHash
+{
+   using is_transparent = void;
+   static int numString;
+   size_t operator()(const char* s) const
+   {
+      size_t h = 0;
+      for (; *s; s++)
+         h = h * 31 + (unsigned char)*s;
+      return h;
+   }
+   size_t operator()(const std::string& s) const { numString++; return (*this)(s.c_str()); }
+};
+int StringHash::numString = 0;
+
+struct StringEqual
+{
+   using is_transparent = void;
+   bool operator()(const std::string& lhs, const std::string& rhs) const { return lhs == rhs; }
+   bool operator()(const std::string& lhs, const char* rhs) const { return lhs == rhs; }
+};
+
 class TestHash : public UnitTest
 {
 
@@ -119,6 +196,69 @@ public:
       test_bucketSize_standardOne();
       test_bucketSize_standardTwo();
 
+      // Hash policy
+      test_bucketCount_standard();
+      test_loadFactor_standard();
+      test_insert_growsPastLoadFactor();
+      test_insert_manyAllFound();
+      test_rehash_standard();
+      test_rehash_neverBelowLoadFactor();
+      test_reserve_empty();
+      test_maxLoadFactor_lowered();
+
+      // Hash and KeyEqual
+      test_customHash_caseInsensitive();
+      test_cacheHash_storesHash();
+      test_cacheHash_rehashSkipsHash();
+      test_cacheHash_fewerEquals();
+      test_cacheHash_erase();
+      test_transparent_findCharPointer();
+      test_transparent_countContains();
+      test_contains_standard();
+
+      // Batch
+      test_findBatch_empty();
+      test_findBatch_standard();
+      test_findBatch_spansWindows();
+      test_findBatch_hashesOnce();
+      test_containsBatch_standard();
+
+      // Incremental rehash
+      test_incremental_offByDefault();
+      test_incremental_growKeepsOldArray();
+      test_incremental_stepIsBounded();
+      test_incremental_findMigratesItsBucket();
+      test_incremental_eraseDuringRehash();
+      test_incremental_beginFinishes();
+      test_incremental_turnOffFinishes();
+      test_incremental_copyDuringRehash();
+      test_incremental_clearDuringRehash();
+      test_incremental_manyInserts();
+      test_incremental_buildNextInSteps();
+      test_incremental_clearWhileBuilding();
+
+      // Front filter
+      test_frontFilter_offByDefault();
+      test_frontFilter_missesSkipBuckets();
+      test_frontFilter_growsWithBuckets();
+      test_frontFilter_eraseRebuilds();
+      test_frontFilter_incremental();
+      test_frontFilter_incrementalDrains();
+      test_frontFilter_copy();
+      test_frontFilter_turnOff();
+
+#ifdef HASH_TABLE_STATS
+      // Stats
+      test_stats_fresh();
+      test_stats_findCountsProbes();
+      test_stats_bucketHistogram();
+      test_stats_rehashCounted();
+      test_stats_incrementalRehashCounted();
+      test_stats_filterRejects();
+      test_stats_reset();
+      test_dumpStats_json();
+#endif // HASH_TABLE_STATS
+
       report("Hash");
    }
 
@@ -131,6 +271,7 @@ public:
    {  // setup
       custom::unordered_set<std::size_t> us;
       std::allocator<custom::unordered_set<std::size_t>> alloc;
+      alloc.destroy(&us);   // free the buckets the constructor above made
       us.numElements = 99;
       // exercise
       alloc.construct(&us);
@@ -154,6 +295,7 @@ public:
       std::vector<std::size_t> v{59, 67, 31, 49};
       custom::unordered_set<std::size_t> us;
       std::allocator<custom::unordered_set<std::size_t>> alloc;
+      alloc.destroy(&us);   // free the buckets the constructor above made
       us.numElements = 99;
       // exercise
       alloc.construct(&us, v.begin(), v.end());
@@ -187,6 +329,7 @@ public:
       custom::unordered_set<std::size_t> usSrc;
       custom::unordered_set<std::size_t> usDes;
       std::allocator<custom::unordered_set<std::size_t>> alloc;
+      alloc.destroy(&usDes);   // free the buckets the constructor above made
       usDes.numElements = 99;
       // exercise
       alloc.construct(&usDes, usSrc);
@@ -2295,6 +2438,915 @@ public:
    }
 
 
+   /***************************************
+    * HASH POLICY
+    ***************************************/
+
+   // the real number of buckets, not the size of the first one
+   void test_bucketCount_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      size_t num = us.bucket_count();
+      // verify
+      assertUnit(num == 10);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // four elements in ten buckets
+   void test_loadFactor_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      float lf = us.load_factor();
+      // verify
+      assertUnit(lf > 0.39f && lf < 0.41f);
+      assertUnit(us.max_load_factor() == 1.0f);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // the eleventh element does not fit in ten buckets
+   void test_insert_growsPastLoadFactor()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 10; i++)
+         us.insert(i * 10);
+      assertUnit(us.bucket_count() == 10);
+      assertUnit(us.bucket_size(0) == 10);
+      // exercise
+      us.insert(100);
+      // verify
+      assertUnit(us.bucket_count() == 23);    // first prime >= 20
+      assertUnit(us.size() == 11);
+      assertUnit(us.load_factor() <= us.max_load_factor());
+      for (std::size_t i = 0; i <= 10; i++)
+      {
+         auto it = us.find(i * 10);
+         assertUnit(it != us.end());
+         if (it != us.end())
+            assertUnit(*it == i * 10);
+      }
+   }  // teardown
+
+   // many elements stay findable and each is visited once
+   void test_insert_manyAllFound()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 10000; i++)
+         us.insert(i * 7);
+      // verify
+      assertUnit(us.size() == 10000);
+      assertUnit(us.load_factor() <= us.max_load_factor());
+      size_t numFound = 0;
+      for (std::size_t i = 0; i < 10000; i++)
+         if (us.find(i * 7) != us.end())
+            numFound++;
+      assertUnit(numFound == 10000);
+      size_t numVisited = 0;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         numVisited++;
+      assertUnit(numVisited == 10000);
+      size_t numInBuckets = 0;
+      for (size_t i = 0; i < us.bucket_count(); i++)
+         numInBuckets += us.bucket_size(i);
+      assertUnit(numInBuckets == 10000);
+   }  // teardown
+
+   // rehash moves every element to its new bucket
+   void test_rehash_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.rehash(50);
+      // verify
+      //      h[31] --> 31
+      //      h[49] --> 49
+      //      h[8]  --> 59
+      //      h[16] --> 67
+      assertUnit(us.bucket_count() == 53);
+      assertUnit(us.numElements == 4);
+      assertUnit(us.bucket_size(31) == 1);
+      assertUnit(us.bucket_size(49) == 1);
+      assertUnit(us.bucket_size(59 % 53) == 1);
+      assertUnit(us.bucket_size(67 % 53) == 1);
+      assertUnit(us.find(31) != us.end());
+      assertUnit(us.find(49) != us.end());
+      assertUnit(us.find(59) != us.end());
+      assertUnit(us.find(67) != us.end());
+   }  // teardown
+
+   // rehash cannot shrink below what the load factor allows
+   void test_rehash_neverBelowLoadFactor()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.rehash(1);
+      // verify
+      assertUnit(us.bucket_count() == 5);     // first prime >= 4
+      assertUnit(us.size() == 4);
+      assertUnit(us.load_factor() <= us.max_load_factor());
+      assertUnit(us.find(31) != us.end());
+      assertUnit(us.find(67) != us.end());
+   }  // teardown
+
+   // reserve makes room so the inserts never rehash
+   void test_reserve_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      us.reserve(1000);
+      custom::list<std::size_t>* bucketsBefore = us.buckets;
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.bucket_count() >= 1000);
+      assertUnit(us.buckets == bucketsBefore);
+      assertUnit(us.size() == 1000);
+   }  // teardown
+
+   // lowering the max load factor grows the table right away
+   void test_maxLoadFactor_lowered()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.max_load_factor(0.25f);
+      // verify
+      assertUnit(us.max_load_factor() == 0.25f);
+      assertUnit(us.bucket_count() >= 16);
+      assertUnit(us.load_factor() <= 0.25f);
+      assertUnit(us.size() == 4);
+      assertUnit(us.find(59) != us.end());
+      assertUnit(us.find(49) != us.end());
+   }  // teardown
+
+
+   /***************************************
+    * HASH and KEY EQUAL
+    ***************************************/
+
+   // a custom Hash and KeyEqual decide what counts as a duplicate
+   void test_customHash_caseInsensitive()
+   {  // setup
+      custom::unordered_set<std::string, CaseInsensitiveHash, CaseInsensitiveEqual> us;
+      us.insert(std::string("Apple"));
+      // exercise
+      auto p = us.insert(std::string("aPPLE"));
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(*p.first == std::string("Apple"));
+      assertUnit(us.size() == 1);
+      assertUnit(us.find(std::string("APPLE")) != us.end());
+      assertUnit(us.find(std::string("Apples")) == us.end());
+   }  // teardown
+
+   // each entry keeps the full hash beside the element
+   void test_cacheHash_storesHash()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>, true> us;
+      // exercise
+      us.insert(59);
+      us.insert(49);
+      // verify
+      //      h[9] --> 59/59 49/49
+      assertUnit(us.buckets[9].size() == 2);
+      if (us.buckets[9].size() == 2)
+      {
+         assertUnit(us.buckets[9].front().value == 59);
+         assertUnit(us.buckets[9].front().hash == 59);
+         assertUnit(us.buckets[9].back().value == 49);
+         assertUnit(us.buckets[9].back().hash == 49);
+      }
+      assertUnit(*us.find(49) == 49);
+   }  // teardown
+
+   // rehash moves entries using the cached hash
+   void test_cacheHash_rehashSkipsHash()
+   {  // setup
+      custom::unordered_set<std::size_t, CountingHash, std::equal_to<std::size_t>, true> usCached;
+      custom::unordered_set<std::size_t, CountingHash, std::equal_to<std::size_t>, false> usPlain;
+      for (std::size_t i = 0; i < 8; i++)
+      {
+         usCached.insert(i);
+         usPlain.insert(i);
+      }
+      // exercise
+      CountingHash::count = 0;
+      usCached.rehash(100);
+      int numCached = CountingHash::count;
+      CountingHash::count = 0;
+      usPlain.rehash(100);
+      int numPlain = CountingHash::count;
+      // verify
+      assertUnit(numCached == 0);
+      assertUnit(numPlain == 8);
+      assertUnit(usCached.find(7) != usCached.end());
+      assertUnit(usPlain.find(7) != usPlain.end());
+   }  // teardown
+
+   // a lookup only calls KeyEqual when the hashes agree
+   void test_cacheHash_fewerEquals()
+   {  // setup
+      //      h[0] --> 0 10 20
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, CountingEqual, true> usCached;
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, CountingEqual, false> usPlain;
+      for (std::size_t i = 0; i <= 20; i += 10)
+      {
+         usCached.insert(i);
+         usPlain.insert(i);
+      }
+      // exercise
+      CountingEqual::count = 0;
+      bool foundCached = usCached.find(20) != usCached.end();
+      int numCached = CountingEqual::count;
+      CountingEqual::count = 0;
+      bool foundPlain = usPlain.find(20) != usPlain.end();
+      int numPlain = CountingEqual::count;
+      // verify
+      assertUnit(foundCached);
+      assertUnit(foundPlain);
+      assertUnit(numCached == 1);
+      assertUnit(numPlain == 3);
+   }  // teardown
+
+   // erase finds the right entry when hashes are cached
+   void test_cacheHash_erase()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>, true> us;
+      us.insert(59);
+      us.insert(49);
+      us.insert(31);
+      // exercise
+      us.erase(59);
+      // verify
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(59) == us.end());
+      assertUnit(us.find(49) != us.end());
+      assertUnit(us.find(31) != us.end());
+      assertUnit(us.bucket_size(9) == 1);
+   }  // teardown
+
+   // a transparent Hash and KeyEqual look up a const char* without a string
+   void test_transparent_findCharPointer()
+   {  // setup
+      custom::unordered_set<std::string, StringHash, StringEqual> us;
+      us.insert(std::string("apple"));
+      us.insert(std::string("pear"));
+      StringHash::numString = 0;
+      // exercise
+      auto it = us.find("pear");
+      // verify
+      assertUnit(it != us.end());
+      assertUnit(*it == std::string("pear"));
+      assertUnit(us.find("plum") == us.end());
+      assertUnit(StringHash::numString == 0);
+   }  // teardown
+
+   // count and contains take the same shortcut
+   void test_transparent_countContains()
+   {  // setup
+      custom::unordered_set<std::string, StringHash, StringEqual, true> us;
+      us.insert(std::string("apple"));
+      StringHash::numString = 0;
+      // exercise
+      size_t numApple = us.count("apple");
+      bool hasPlum = us.contains("plum");
+      // verify
+      assertUnit(numApple == 1);
+      assertUnit(hasPlum == false);
+      assertUnit(StringHash::numString == 0);
+   }  // teardown
+
+   // contains with the set's own key type
+   void test_contains_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.insert(59);
+      us.insert(31);
+      // exercise
+      // verify
+      assertUnit(us.contains(59));
+      assertUnit(!us.contains(49));
+      assertUnit(us.count(31) == 1);
+      assertUnit(us.count(49) == 0);
+   }  // teardown
+
+   /***************************************
+    * BATCH
+    ***************************************/
+
+   // no keys, nothing written
+   void test_findBatch_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::unordered_set<std::size_t>::iterator out[1];
+      out[0] = us.begin();
+      // exercise
+      us.find_batch(nullptr, 0, out);
+      // verify
+      assertUnit(out[0] == us.begin());
+      assertStandardFixture(us);
+   }  // teardown
+
+   // each answer matches the scalar find, in key order
+   void test_findBatch_standard()
+   {  // setup
+      //      h[1] --> 31 
+      //      h[7] --> 67
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t keys[] = { 49, 50, 31, 67, 99, 59 };
+      custom::unordered_set<std::size_t>::iterator out[6];
+      // exercise
+      us.find_batch(keys, 6, out);
+      // verify
+      for (int i = 0; i < 6; i++)
+         assertUnit(out[i] == us.find(keys[i]));
+      assertUnit(out[0] != us.end() && *out[0] == 49);
+      assertUnit(out[1] == us.end());
+      assertUnit(out[4] == us.end());
+      assertStandardFixture(us);
+   }  // teardown
+
+   // more keys than one window holds
+   void test_findBatch_spansWindows()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i += 2)
+         us.insert(i);
+      std::size_t keys[37];
+      for (std::size_t i = 0; i < 37; i++)
+         keys[i] = i * 3;
+      custom::unordered_set<std::size_t>::iterator out[37];
+      // exercise
+      us.find_batch(keys, 37, out);
+      // verify
+      for (std::size_t i = 0; i < 37; i++)
+      {
+         assertUnit(out[i] == us.find(keys[i]));
+         assertUnit((out[i] != us.end()) == (keys[i] % 2 == 0 && keys[i] < 100));
+      }
+   }  // teardown
+
+   // every key is hashed exactly once
+   void test_findBatch_hashesOnce()
+   {  // setup
+      custom::unordered_set<std::size_t, CountingHash> us;
+      for (std::size_t i = 0; i < 20; i++)
+         us.insert(i);
+      std::size_t keys[20];
+      for (std::size_t i = 0; i < 20; i++)
+         keys[i] = 19 - i;
+      custom::unordered_set<std::size_t, CountingHash>::iterator out[20];
+      CountingHash::count = 0;
+      // exercise
+      us.find_batch(keys, 20, out);
+      // verify
+      assertUnit(CountingHash::count == 20);
+      for (std::size_t i = 0; i < 20; i++)
+         assertUnit(out[i] != us.end() && *out[i] == 19 - i);
+   }  // teardown
+
+   void test_containsBatch_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t keys[] = { 31, 32, 67, 68, 59, 49, 9 };
+      bool out[7];
+      // exercise
+      us.contains_batch(keys, 7, out);
+      // verify
+      assertUnit(out[0] == true);
+      assertUnit(out[1] == false);
+      assertUnit(out[2] == true);
+      assertUnit(out[3] == false);
+      assertUnit(out[4] == true);
+      assertUnit(out[5] == true);
+      assertUnit(out[6] == false);
+      assertStandardFixture(us);
+   }  // teardown
+
+   /***************************************
+    * INCREMENTAL REHASH
+    ***************************************/
+
+   // without asking, growth is still one full rehash
+   void test_incremental_offByDefault()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.incremental_rehash() == false);
+      assertUnit(!us.rehashing());
+      assertUnit(us.bucketsOld == nullptr);
+      assertUnit(us.numBuckets == 23);
+   }  // teardown
+
+   // the insert that grows only swaps in the new array
+   void test_incremental_growKeepsOldArray()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 10; i++)
+         us.insert(i);
+      // exercise
+      us.insert(10);
+      // verify
+      assertUnit(us.rehashing());
+      assertUnit(us.numBucketsOld == 10);
+      assertUnit(us.numBuckets == 23);
+      assertUnit(us.rehashIndex == 0);
+      assertUnit(us.numElements == 11);
+      assertUnit(us.buckets[10].size() == 1);      // only the new element
+      assertUnit(us.bucketsOld[3].size() == 1);
+   }  // teardown
+
+   // each operation moves REHASH_STEP old buckets and no more
+   void test_incremental_stepIsBounded()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      bool found = us.find(1) != us.end();
+      // verify
+      assertUnit(found);
+      assertUnit(us.rehashing());
+      assertUnit(us.rehashIndex == 4);
+      for (std::size_t i = 0; i < 4; i++)
+         assertUnit(us.buckets[i].size() == 1);    // moved, and the old ones destroyed
+      assertUnit(us.bucketsOld[4].size() == 1);
+   }  // teardown
+
+   // a key in an old bucket not yet reached is moved before the lookup
+   void test_incremental_findMigratesItsBucket()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      auto it = us.find(8);
+      // verify
+      assertUnit(it != us.end());
+      assertUnit(*it == 8);
+      assertUnit(it.pBucket == us.buckets + 8);
+      assertUnit(us.bucketsOld[8].empty());
+      assertUnit(us.bucketsOld[5].size() == 1);
+   }  // teardown
+
+   void test_incremental_eraseDuringRehash()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      us.erase(9);
+      // verify
+      assertUnit(us.numElements == 10);
+      assertUnit(us.find(9) == us.end());
+      for (std::size_t i = 0; i < 11; i++)
+         if (i != 9)
+            assertUnit(us.find(i) != us.end());
+   }  // teardown
+
+   // iterating has to see the old array too, so it finishes the rehash
+   void test_incremental_beginFinishes()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      size_t num = 0;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         num++;
+      // verify
+      assertUnit(num == 11);
+      assertUnit(!us.rehashing());
+      assertUnit(us.bucketsOld == nullptr);
+      assertUnit(us.bucket_size(5) == 1);
+   }  // teardown
+
+   void test_incremental_turnOffFinishes()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      us.incremental_rehash(false);
+      // verify
+      assertUnit(!us.rehashing());
+      assertUnit(us.numBuckets == 23);
+      for (std::size_t i = 0; i < 11; i++)
+         assertUnit(us.buckets[i].size() == 1);
+   }  // teardown
+
+   // a copy taken mid-rehash holds both halves
+   void test_incremental_copyDuringRehash()
+   {  // setup
+      custom::unordered_set<std::size_t> usSrc;
+      usSrc.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         usSrc.insert(i);
+      // exercise
+      custom::unordered_set<std::size_t> usDes(usSrc);
+      custom::unordered_set<std::size_t> usAssign;
+      usAssign = usSrc;
+      // verify
+      assertUnit(usDes.rehashing());
+      assertUnit(usDes.bucketsOld != usSrc.bucketsOld);
+      assertUnit(usDes.size() == 11);
+      assertUnit(usAssign.size() == 11);
+      for (std::size_t i = 0; i < 11; i++)
+      {
+         assertUnit(usDes.find(i) != usDes.end());
+         assertUnit(usAssign.find(i) != usAssign.end());
+      }
+   }  // teardown
+
+   void test_incremental_clearDuringRehash()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.empty());
+      assertUnit(!us.rehashing());
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   // back-to-back growths never lose anything
+   void test_incremental_manyInserts()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i * 7);
+      // verify
+      assertUnit(us.size() == 1000);
+      for (std::size_t i = 0; i < 1000; i++)
+         assertUnit(us.find(i * 7) != us.end());
+      assertUnit(us.find(3) == us.end());
+   }  // teardown
+
+   // a next array bigger than BUILD_STEP is built over several operations
+   // before it takes over, and the current one keeps everything meanwhile
+   void test_incremental_buildNextInSteps()
+   {  // setup
+      custom::unordered_set<std::size_t> us(2000);
+      us.incremental_rehash(true);
+      std::size_t numBuckets = us.bucket_count();
+      for (std::size_t i = 0; i < numBuckets; i++)
+         us.insert(i);
+      // exercise
+      us.insert(numBuckets);
+      // verify
+      assertUnit(us.rehashing());
+      assertUnit(us.bucketsOld == nullptr);
+      assertUnit(us.bucketsNext != nullptr);
+      assertUnit(us.numBucketsBuilt == 1024);
+      assertUnit(us.numBuckets == numBuckets);
+      assertUnit(us.size() == numBuckets + 1);
+      // exercise
+      bool isFound = true;
+      for (std::size_t i = 0; i <= numBuckets; i++)
+         isFound = isFound && us.find(i) != us.end();
+      // verify
+      assertUnit(isFound);
+      assertUnit(us.bucketsNext == nullptr);
+      assertUnit(us.numBuckets > 2 * numBuckets);
+      assertUnit(us.size() == numBuckets + 1);
+   }  // teardown
+
+   // clear() drops a half-built next array
+   void test_incremental_clearWhileBuilding()
+   {  // setup
+      custom::unordered_set<std::size_t> us(2000);
+      us.incremental_rehash(true);
+      std::size_t numBuckets = us.bucket_count();
+      for (std::size_t i = 0; i <= numBuckets; i++)
+         us.insert(i);
+      assertUnit(us.bucketsNext != nullptr);
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.empty());
+      assertUnit(!us.rehashing());
+      assertUnit(us.bucketsNext == nullptr);
+      assertUnit(us.numBucketsBuilt == 0);
+      us.insert(7);
+      assertUnit(us.find(7) != us.end());
+   }  // teardown
+
+   /***************************************
+    * FRONT FILTER
+    ***************************************/
+
+   void test_frontFilter_offByDefault()
+   {  // setup
+      // exercise
+      custom::unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.front_filter() == 0.0);
+      assertUnit(us.filter.bit_count() == 0);
+   }  // teardown
+
+   // absent keys that share buckets with present ones mostly never reach KeyEqual
+   void test_frontFilter_missesSkipBuckets()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, CountingEqual> usFiltered;
+      custom::unordered_set<std::size_t, std::hash<std::size_t>, CountingEqual> usPlain;
+      usFiltered.front_filter(0.01);
+      for (std::size_t i = 0; i < 1000; i++)
+      {
+         usFiltered.insert(i * 2);
+         usPlain.insert(i * 2);
+      }
+      // exercise
+      CountingEqual::count = 0;
+      int numFound = 0;
+      for (std::size_t i = 0; i < 1000; i++)
+         numFound += usFiltered.find(i * 2 + 1) != usFiltered.end() ? 1 : 0;
+      int numFiltered = CountingEqual::count;
+      CountingEqual::count = 0;
+      for (std::size_t i = 0; i < 1000; i++)
+         numFound += usPlain.find(i * 2 + 1) != usPlain.end() ? 1 : 0;
+      int numPlain = CountingEqual::count;
+      // verify
+      assertUnit(numFound == 0);
+      assertUnit(numFiltered * 10 < numPlain);
+   }  // teardown
+
+   // every growth resizes the filter and nothing present is ever turned away
+   void test_frontFilter_growsWithBuckets()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.front_filter(0.01);
+      // exercise
+      for (std::size_t i = 0; i < 5000; i++)
+         us.insert(i * 7);
+      // verify
+      assertUnit(us.filter.capacity() >= us.size());
+      for (std::size_t i = 0; i < 5000; i++)
+         assertUnit(us.find(i * 7) != us.end());
+   }  // teardown
+
+   // once more is stale than live, the filter starts over
+   void test_frontFilter_eraseRebuilds()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.front_filter(0.01);
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      // exercise
+      for (std::size_t i = 0; i < 60; i++)
+         us.erase(i);
+      // verify
+      assertUnit(us.size() == 40);
+      assertUnit(us.numFilterStale < 40);
+      for (std::size_t i = 0; i < 60; i++)
+         assertUnit(us.find(i) == us.end());
+      for (std::size_t i = 60; i < 100; i++)
+         assertUnit(us.find(i) != us.end());
+   }  // teardown
+
+   // elements still waiting in the old array are found through the filter too
+   void test_frontFilter_incremental()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      us.front_filter(0.01);
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i * 3);
+      // verify
+      for (std::size_t i = 0; i < 1000; i++)
+         assertUnit(us.find(i * 3) != us.end());
+      assertUnit(us.find(1) == us.end());
+   }  // teardown
+
+   // inserts the filter turns away still migrate, so each rehash ends before the next growth
+   void test_frontFilter_incrementalDrains()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      us.front_filter(0.01);
+      int numGrowths = 0;
+      bool drained = true;
+      // exercise
+      for (std::size_t i = 0; i < 5000; i++)
+      {
+         std::size_t numBucketsBefore = us.bucket_count();
+         bool wasMigrating = us.bucketsOld != nullptr;   // building the next array is fine
+         us.insert(i * 5);
+         if (us.bucket_count() != numBucketsBefore)
+         {
+            numGrowths++;
+            drained = drained && !wasMigrating;
+         }
+      }
+      // verify
+      assertUnit(numGrowths > 5);
+      assertUnit(drained);
+      assertUnit(us.size() == 5000);
+      for (std::size_t i = 0; i < 5000; i++)
+         assertUnit(us.find(i * 5) != us.end());
+   }  // teardown
+
+   void test_frontFilter_copy()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.front_filter(0.05);
+      for (std::size_t i = 0; i < 50; i++)
+         us.insert(i);
+      // exercise
+      custom::unordered_set<std::size_t> usCopy(us);
+      // verify
+      assertUnit(usCopy.front_filter() == 0.05);
+      assertUnit(usCopy.filter.bit_count() == us.filter.bit_count());
+      for (std::size_t i = 0; i < 50; i++)
+         assertUnit(usCopy.find(i) != usCopy.end());
+   }  // teardown
+
+   void test_frontFilter_turnOff()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.front_filter(0.01);
+      us.insert(26);
+      // exercise
+      us.front_filter(0.0);
+      us.insert(27);
+      // verify
+      assertUnit(us.front_filter() == 0.0);
+      assertUnit(us.filter.bit_count() == 0);
+      assertUnit(us.find(26) != us.end());
+      assertUnit(us.find(27) != us.end());
+   }  // teardown
+
+#ifdef HASH_TABLE_STATS
+   /***************************************
+    * STATS
+    ***************************************/
+
+   void test_stats_fresh()
+   {  // setup
+      // exercise
+      custom::unordered_set<std::size_t> us;
+      custom::hash_table_stats st = us.stats();
+      // verify
+      assertUnit(st.numLookups == 0);
+      assertUnit(st.numProbes == 0);
+      assertUnit(st.maxProbe == 0);
+      assertUnit(st.numEquals == 0);
+      assertUnit(st.numRehashes == 0);
+      assertUnit(st.average_probe() == 0.0);
+      assertUnit(st.bucketLengths.size() == 1);
+      assertUnit(st.bucketLengths[0] == 10);
+   }  // teardown
+
+   // a hit counts the nodes up to and including it; a miss counts the whole bucket
+   void test_stats_findCountsProbes()
+   {  // setup
+      //      h[9] --> 9 19 29
+      custom::unordered_set<std::size_t, CountingHash> us;
+      us.insert(9);
+      us.insert(19);
+      us.insert(29);
+      us.reset_stats();
+      // exercise
+      us.find(29);
+      us.find(39);
+      us.find(5);
+      // verify
+      custom::hash_table_stats st = us.stats();
+      assertUnit(st.numLookups == 3);
+      assertUnit(st.numProbes == 6);
+      assertUnit(st.maxProbe == 3);
+      assertUnit(st.average_probe() == 2.0);
+      assertUnit(st.numEquals == 6);
+   }  // teardown
+
+   void test_stats_bucketHistogram()
+   {  // setup
+      custom::unordered_set<std::size_t, CountingHash> us;
+      us.insert(9);
+      us.insert(19);
+      us.insert(29);
+      us.insert(1);
+      // exercise
+      custom::hash_table_stats st = us.stats();
+      // verify
+      assertUnit(st.bucketLengths.size() == 4);
+      assertUnit(st.bucketLengths[0] == 8);
+      assertUnit(st.bucketLengths[1] == 1);
+      assertUnit(st.bucketLengths[2] == 0);
+      assertUnit(st.bucketLengths[3] == 1);
+   }  // teardown
+
+   void test_stats_rehashCounted()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // verify
+      custom::hash_table_stats st = us.stats();
+      assertUnit(st.numRehashes == 1);
+      assertUnit(st.rehashSeconds >= 0.0);
+      size_t numBuckets = 0;
+      for (size_t n : st.bucketLengths)
+         numBuckets += n;
+      assertUnit(numBuckets == us.bucket_count());
+   }  // teardown
+
+   // mid-rehash, the old array's buckets are still in the histogram
+   void test_stats_incrementalRehashCounted()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.incremental_rehash(true);
+      // exercise
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.rehashing());
+      custom::hash_table_stats st = us.stats();
+      assertUnit(st.numRehashes == 1);
+      size_t numBuckets = 0;
+      size_t numElements = 0;
+      for (size_t n = 0; n < st.bucketLengths.size(); n++)
+      {
+         numBuckets += st.bucketLengths[n];
+         numElements += n * st.bucketLengths[n];
+      }
+      assertUnit(numBuckets == us.bucket_count() + us.numBucketsOld - us.rehashIndex);
+      assertUnit(numElements == 11);
+   }  // teardown
+
+   void test_stats_filterRejects()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.front_filter(0.01);
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i * 2);
+      us.reset_stats();
+      // exercise
+      for (std::size_t i = 0; i < 100; i++)
+         us.find(i * 2 + 1);
+      // verify
+      custom::hash_table_stats st = us.stats();
+      assertUnit(st.numFilterRejects > 80);
+      assertUnit(st.numFilterRejects + st.numLookups == 100);
+   }  // teardown
+
+   void test_stats_reset()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 20; i++)
+         us.insert(i);
+      // exercise
+      us.reset_stats();
+      // verify
+      custom::hash_table_stats st = us.stats();
+      assertUnit(st.numLookups == 0);
+      assertUnit(st.numRehashes == 0);
+      assertUnit(st.bucketLengths.size() > 1);   // the buckets are still there
+   }  // teardown
+
+   void test_dumpStats_json()
+   {  // setup
+      custom::unordered_set<std::size_t, CountingHash> us;
+      us.insert(9);
+      us.insert(19);
+      us.reset_stats();
+      us.find(19);
+      std::ostringstream out;
+      // exercise
+      us.dump_stats(out);
+      // verify
+      assertUnit(out.str() ==
+         "{\"lookups\":1,\"probes\":2,\"average_probe\":2,\"max_probe\":2,\"equals\":2,"
+         "\"filter_rejects\":0,\"rehashes\":0,\"rehash_seconds\":0,"
+         "\"bucket_lengths\":[9,0,1]}");
+   }  // teardown
+#endif // HASH_TABLE_STATS
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      h[0] -->  
@@ -0,0 +1,339 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERFECT HASH SET
+ * Summary:
+ *    Unit tests for perfect_hash_set
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "perfect_hash_set.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdio>     // for std::remove
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for std::memcpy
+#include <sstream>
+#include <string>
+#include <vector>
+
+class TestPerfectHashSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_one();
+      test_construct_range();
+      test_construct_duplicates();
+      test_construct_strings();
+
+      // Access
+      test_index_minimalAndDistinct();
+      test_find_missing();
+      test_contains_large();
+
+      // Size
+      test_bitsPerKey_small();
+
+      // Serialize
+      test_save_loadStream();
+      test_save_loadFile();
+      test_load_badMagic();
+      test_load_truncated();
+      test_load_noBuckets();
+      test_load_shortPacked();
+      test_load_hugeKeyCount();
+
+      report("PerfectHashSet");
+   }
+
+   typedef custom::perfect_hash_set<int> Set;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Set s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.size() == 0);
+      assertUnit(!s.contains(0));
+      assertUnit(s.find(0) == s.end());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   void test_construct_one()
+   {  // setup
+      // exercise
+      Set s{ 42 };
+      // verify
+      assertUnit(s.size() == 1);
+      assertUnit(s.contains(42));
+      assertUnit(!s.contains(41));
+      assertUnit(s.index(42) == 0);
+   }  // teardown
+
+   void test_construct_range()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 100; i++)
+         v.push_back(i * 7);
+      // exercise
+      Set s(v.begin(), v.end());
+      // verify
+      assertUnit(s.size() == 100);
+      assertUnit(s.bucket_count() == 20);
+      for (int i = 0; i < 700; i++)
+         assertUnit(s.contains(i) == (i % 7 == 0));
+   }  // teardown
+
+   // the same key twice is kept once
+   void test_construct_duplicates()
+   {  // setup
+      std::vector<int> v = { 5, 3, 5, 9, 3, 5 };
+      // exercise
+      Set s(v.begin(), v.end());
+      // verify
+      assertUnit(s.size() == 3);
+      assertUnit(s.contains(3));
+      assertUnit(s.contains(5));
+      assertUnit(s.contains(9));
+   }  // teardown
+
+   void test_construct_strings()
+   {  // setup
+      std::vector<std::string> v = { "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta" };
+      // exercise
+      custom::perfect_hash_set<std::string> s(v.begin(), v.end());
+      // verify
+      assertUnit(s.size() == 7);
+      for (const std::string& str : v)
+         assertUnit(*s.find(str) == str);
+      assertUnit(!s.contains("theta"));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // n keys take exactly the slots 0 .. n-1, one each
+   void test_index_minimalAndDistinct()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i * i);
+      // exercise
+      Set s(v.begin(), v.end());
+      // verify
+      std::vector<bool> used(1000, false);
+      for (int k : v)
+      {
+         size_t i = s.index(k);
+         assertUnit(i < 1000);
+         assertUnit(!used[i]);
+         used[i] = true;
+         assertUnit(s.begin()[i] == k);
+      }
+   }  // teardown
+
+   void test_find_missing()
+   {  // setup
+      Set s{ 1, 2, 3 };
+      // exercise
+      Set::iterator it = s.find(4);
+      // verify
+      assertUnit(it == s.end());
+      assertUnit(s.index(4) == 3);
+      assertUnit(s.count(4) == 0);
+      assertUnit(s.count(2) == 1);
+   }  // teardown
+
+   void test_contains_large()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 50000; i++)
+         v.push_back(i * 2 + 1);
+      // exercise
+      Set s(v.begin(), v.end());
+      // verify
+      assertUnit(s.size() == 50000);
+      for (int i = 0; i < 100000; i++)
+         assertUnit(s.contains(i) == (i % 2 == 1));
+   }  // teardown
+
+   /***************************************
+    * SIZE
+    ***************************************/
+
+   // the displacement index is a few bits per key, well under a pointer
+   void test_bitsPerKey_small()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 50000; i++)
+         v.push_back(i);
+      // exercise
+      Set s(v.begin(), v.end());
+      // verify
+      assertUnit(s.bits_per_key() > 0.0);
+      assertUnit(s.bits_per_key() < 6.0);
+   }  // teardown
+
+   /***************************************
+    * SERIALIZE
+    ***************************************/
+
+   void test_save_loadStream()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 500; i++)
+         v.push_back(i * 13);
+      Set s(v.begin(), v.end());
+      std::stringstream ss;
+      // exercise
+      s.save(ss);
+      Set copy;
+      copy.load(ss);
+      // verify
+      assertUnit(copy.size() == 500);
+      for (int k : v)
+         assertUnit(copy.index(k) == s.index(k));
+      assertUnit(!copy.contains(1));
+   }  // teardown
+
+   void test_save_loadFile()
+   {  // setup
+      Set s{ 10, 20, 30, 40, 50 };
+      std::string fileName = "testPerfectHashSet.bin";
+      // exercise
+      s.save(fileName);
+      Set copy;
+      copy.load(fileName);
+      std::remove(fileName.c_str());
+      // verify
+      assertUnit(copy.size() == 5);
+      assertUnit(copy.contains(30));
+      assertUnit(!copy.contains(35));
+   }  // teardown
+
+   void test_load_badMagic()
+   {  // setup
+      std::stringstream ss(std::string(64, 'x'));
+      Set s{ 1 };
+      bool thrown = false;
+      // exercise
+      try
+      {
+         s.load(ss);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(s.contains(1));     // left as it was
+   }  // teardown
+
+   void test_load_truncated()
+   {  // setup
+      Set s{ 1, 2, 3, 4, 5, 6 };
+      std::stringstream full;
+      s.save(full);
+      std::string bytes = full.str();
+      std::stringstream ss(bytes.substr(0, bytes.size() - 4));
+      Set copy;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         copy.load(ss);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(copy.empty());
+   }  // teardown
+   // a saved set with word i of its header replaced by value
+   static std::string withHeader(const Set& s, int i, uint64_t value)
+   {
+      std::stringstream full;
+      s.save(full);
+      std::string bytes = full.str();
+      std::memcpy(&bytes[i * sizeof(uint64_t)], &value, sizeof(value));
+      return bytes;
+   }
+
+   // load() throws and leaves the set alone
+   static bool loadThrows(Set& s, const std::string& bytes)
+   {
+      std::stringstream ss(bytes);
+      try
+      {
+         s.load(ss);
+      }
+      catch (const std::runtime_error&)
+      {
+         return true;
+      }
+      return false;
+   }
+
+   // keys and no buckets would divide by zero in every lookup
+   void test_load_noBuckets()
+   {  // setup
+      Set s{ 1, 2, 3, 4, 5, 6 };
+      Set copy{ 7 };
+      // exercise
+      bool thrown = loadThrows(copy, withHeader(s, 2, 0));
+      // verify
+      assertUnit(thrown);
+      assertUnit(copy.size() == 1);
+      assertUnit(copy.contains(7));
+   }  // teardown
+
+   // fewer packed words than the buckets need would read past the end
+   void test_load_shortPacked()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 500; i++)
+         v.push_back(i * 13);
+      Set s(v.begin(), v.end());
+      Set copy{ 7 };
+      // exercise
+      bool thrown = loadThrows(copy, withHeader(s, 5, 1));
+      // verify
+      assertUnit(thrown);
+      assertUnit(copy.contains(7));
+   }  // teardown
+
+   // a key count the file cannot hold is refused before anything is allocated
+   void test_load_hugeKeyCount()
+   {  // setup
+      Set s{ 1, 2, 3, 4, 5, 6 };
+      Set copy{ 7 };
+      // exercise
+      bool thrownHuge = loadThrows(copy, withHeader(s, 1, uint64_t(1) << 62));
+      bool thrownLong = loadThrows(copy, withHeader(s, 1, 1000));
+      // verify
+      assertUnit(thrownHuge);
+      assertUnit(thrownLong);
+      assertUnit(copy.contains(7));
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,400 @@
+/***********************************************************************
+ * Header:
+ *    TEST SPLIT-ORDERED SET
+ * Summary:
+ *    Unit tests for split_ordered_set
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "split_ordered_set.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#undef assertSplitOrder
+#define assertSplitOrder(x) assertSplitOrderParameters(x, __LINE__, __FUNCTION__)
+
+/***********************************************
+ * SAME HASH
+ * Every key has the same hash, so they all share
+ * one split-order key and one bucket
+ ***********************************************/
+struct SameHash
+{
+   size_t operator()(int) const noexcept { return 6; }
+};
+
+class TestSplitOrderedSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Keys
+      test_reverse_standard();
+      test_keys_dummyEvenElementOdd();
+      test_parentOf_standard();
+
+      // Insert
+      test_insert_empty();
+      test_insert_duplicate();
+      test_insert_listStaysSplitOrdered();
+      test_insert_growsWithoutMoving();
+      test_insert_sameHash();
+
+      // Remove
+      test_erase_standard();
+      test_erase_missing();
+      test_erase_sameHashMiddle();
+
+      // Buckets
+      test_bucket_dummyMadeLazily();
+
+      // Concurrency
+      test_stress_disjointKeys();
+      test_stress_readersDuringGrowth();
+      test_stress_eraseRetires();
+
+      report("SplitOrderedSet");
+   }
+
+   typedef custom::split_ordered_set<int> Set;
+   typedef Set::Node Node;
+   typedef Set::Element Element;
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // only bucket 0 has a dummy node
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Set s;
+      // verify
+      assertUnit(s.size() == 0);
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 2);
+      assertUnit(s.pHead != nullptr);
+      assertUnit(s.pHead->key == 0);
+      assertUnit(s.pHead->pNext.load() == 0);
+      assertUnit(s.slot(0).load() == s.pHead);
+      assertUnit(s.segments[1].load() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * KEYS
+    ***************************************/
+
+   void test_reverse_standard()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(Set::reverse(0) == 0);
+      assertUnit(Set::reverse(1) == 0x8000000000000000ull);
+      assertUnit(Set::reverse(0x8000000000000000ull) == 1);
+      assertUnit(Set::reverse(6) == 0x6000000000000000ull);
+      assertUnit(Set::reverse(Set::reverse(0x123456789ABCDEFull)) == 0x123456789ABCDEFull);
+   }  // teardown
+
+   // a bucket's dummy sorts just before the elements that hash into it
+   void test_keys_dummyEvenElementOdd()
+   {  // setup
+      // exercise
+      uint64_t dummy1 = Set::dummyKey(1);
+      uint64_t dummy3 = Set::dummyKey(3);
+      uint64_t element5 = Set::elementKey(5);   // bucket 1 of 4
+      // verify
+      assertUnit((dummy1 & 1) == 0);
+      assertUnit((element5 & 1) == 1);
+      assertUnit(dummy1 < element5);
+      assertUnit(element5 < dummy3);
+   }  // teardown
+
+   void test_parentOf_standard()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(Set::parentOf(1) == 0);
+      assertUnit(Set::parentOf(2) == 0);
+      assertUnit(Set::parentOf(3) == 1);
+      assertUnit(Set::parentOf(6) == 2);
+      assertUnit(Set::parentOf(13) == 5);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   void test_insert_empty()
+   {  // setup
+      Set s;
+      // exercise
+      bool inserted = s.insert(26);
+      // verify
+      assertUnit(inserted);
+      assertUnit(s.size() == 1);
+      assertUnit(s.contains(26));
+      assertUnit(!s.contains(27));
+      assertSplitOrder(s);
+   }  // teardown
+
+   void test_insert_duplicate()
+   {  // setup
+      Set s;
+      s.insert(26);
+      // exercise
+      bool inserted = s.insert(26);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_insert_listStaysSplitOrdered()
+   {  // setup
+      Set s;
+      // exercise
+      for (int i = 0; i < 50; i++)
+         s.insert((i * 37) % 101);
+      // verify
+      assertUnit(s.size() == 50);
+      for (int i = 0; i < 50; i++)
+         assertUnit(s.contains((i * 37) % 101));
+      assertSplitOrder(s);
+   }  // teardown
+
+   // doubling the buckets leaves every element node where it was
+   void test_insert_growsWithoutMoving()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 4; i++)
+         s.insert(i);
+      std::vector<Node*> before;
+      for (Node* p = Set::pointer(s.pHead->pNext.load()); p; p = Set::pointer(p->pNext.load()))
+         if (!p->isDummy())
+            before.push_back(p);
+      // exercise
+      for (int i = 4; i < 100; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.bucket_count() == 64);
+      size_t numFound = 0;
+      for (Node* p = Set::pointer(s.pHead->pNext.load()); p; p = Set::pointer(p->pNext.load()))
+         for (Node* pOld : before)
+            if (p == pOld)
+               numFound++;
+      assertUnit(numFound == before.size());
+      assertSplitOrder(s);
+   }  // teardown
+
+   // elements with one hash share a key and are told apart by KeyEqual
+   void test_insert_sameHash()
+   {  // setup
+      custom::split_ordered_set<int, SameHash> s;
+      // exercise
+      s.insert(1);
+      s.insert(2);
+      s.insert(3);
+      bool inserted = s.insert(2);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(s.size() == 3);
+      assertUnit(s.contains(1));
+      assertUnit(s.contains(2));
+      assertUnit(s.contains(3));
+      assertUnit(!s.contains(4));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   void test_erase_standard()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 20; i++)
+         s.insert(i);
+      // exercise
+      bool erased = s.erase(7);
+      // verify
+      assertUnit(erased);
+      assertUnit(s.size() == 19);
+      assertUnit(!s.contains(7));
+      assertUnit(s.contains(6));
+      assertUnit(s.contains(8));
+      assertSplitOrder(s);
+   }  // teardown
+
+   void test_erase_missing()
+   {  // setup
+      Set s;
+      s.insert(1);
+      // exercise
+      bool erased = s.erase(2);
+      // verify
+      assertUnit(!erased);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   void test_erase_sameHashMiddle()
+   {  // setup
+      custom::split_ordered_set<int, SameHash> s;
+      s.insert(1);
+      s.insert(2);
+      s.insert(3);
+      // exercise
+      bool erased = s.erase(2);
+      // verify
+      assertUnit(erased);
+      assertUnit(s.size() == 2);
+      assertUnit(s.contains(1));
+      assertUnit(!s.contains(2));
+      assertUnit(s.contains(3));
+   }  // teardown
+
+   /***************************************
+    * BUCKETS
+    ***************************************/
+
+   // growth only bumps the count; a dummy appears when its bucket is used
+   void test_bucket_dummyMadeLazily()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i * 64);                    // every one lands in bucket 0
+      assertUnit(s.bucket_count() == 64);
+      assertUnit(s.segments[6].load() == nullptr);
+      // exercise
+      bool found = s.contains(37);           // bucket 37, parent 5, parent 1
+      // verify
+      assertUnit(!found);
+      assertUnit(s.slot(37).load() != nullptr);
+      assertUnit(s.slot(5).load() != nullptr);
+      assertUnit(s.slot(1).load() != nullptr);
+      assertUnit(s.slot(36).load() == nullptr);
+      assertUnit(s.slot(37).load()->key == Set::dummyKey(37));
+      assertSplitOrder(s);
+   }  // teardown
+
+   /***************************************
+    * CONCURRENCY
+    ***************************************/
+
+   // every thread adds its own range while the table grows underneath
+   void test_stress_disjointKeys()
+   {  // setup
+      Set s;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < 8; t++)
+         threads.push_back(std::thread([&s, t]()
+         {
+            for (int i = 0; i < 2000; i++)
+               s.insert(t * 2000 + i);
+         }));
+      for (std::thread& th : threads)
+         th.join();
+      // verify
+      assertUnit(s.size() == 16000);
+      size_t num = 0;
+      s.for_each([&num](int) { num++; });
+      assertUnit(num == 16000);
+      for (int i = 0; i < 16000; i += 101)
+         assertUnit(s.contains(i));
+      assertSplitOrder(s);
+   }  // teardown
+
+   // keys present from the start are always found, even mid-growth
+   void test_stress_readersDuringGrowth()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 100; i++)
+         s.insert(i);
+      std::atomic<int> numMisses(0);
+      std::atomic<bool> done(false);
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, &numMisses, &done]()
+         {
+            while (!done.load())
+               for (int i = 0; i < 100; i++)
+                  if (!s.contains(i))
+                     numMisses++;
+         }));
+      std::thread writer([&s, &done]()
+      {
+         for (int i = 100; i < 20000; i++)
+            s.insert(i);
+         done.store(true);
+      });
+      writer.join();
+      for (std::thread& th : threads)
+         th.join();
+      // verify
+      assertUnit(numMisses.load() == 0);
+      assertUnit(s.size() == 20000);
+      assertUnit(s.bucket_count() >= 8192);
+   }  // teardown
+
+   // erased nodes go to the epoch reclaimer and are eventually freed
+   void test_stress_eraseRetires()
+   {  // setup
+      Set s;
+      for (int i = 0; i < 4000; i++)
+         s.insert(i);
+      std::vector<std::thread> threads;
+      std::atomic<int> numErased(0);
+      // exercise
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, &numErased]()
+         {
+            for (int i = 0; i < 4000; i++)
+               if (s.erase(i))
+                  numErased++;
+         }));
+      for (std::thread& th : threads)
+         th.join();
+      for (int i = 0; i < 4; i++)
+         custom::epoch::collect();
+      // verify
+      assertUnit(numErased.load() == 4000);
+      assertUnit(s.empty());
+      assertUnit(!s.contains(0));
+      assertUnit(custom::epoch::pending() < 4000);
+      assertSplitOrder(s);
+   }  // teardown
+
+   /*************************************************************
+    * ASSERT SPLIT ORDER
+    * The keys never decrease, and every dummy is the one
+    * its bucket slot points at
+    *************************************************************/
+   template <class S>
+   void assertSplitOrderParameters(const S& s, int line, const char* function)
+   {
+      typedef typename S::Node N;
+      const N* pPrev = s.pHead;
+      for (const N* p = S::pointer(s.pHead->pNext.load()); p; p = S::pointer(p->pNext.load()))
+      {
+         assertIndirect(pPrev->key <= p->key);
+         if (p->isDummy())
+            assertIndirect(pPrev->key < p->key);
+         pPrev = p;
+      }
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,328 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNORDERED MAP
+ * Summary:
+ *    Unit tests for unordered_map
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unordered_map.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <string>
+#include <stdexcept>
+
+class TestUnorderedMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit_standard();
+      test_constructCopy_standard();
+
+      // Access
+      test_squareBracket_missingInserts();
+      test_squareBracket_existingReads();
+      test_at_missingThrows();
+      test_find_standard();
+      test_find_missing();
+      test_find_transparent();
+
+      // Insert
+      test_tryEmplace_new();
+      test_tryEmplace_existingUntouched();
+      test_insertOrAssign_new();
+      test_insertOrAssign_existing();
+      test_insert_growsBuckets();
+
+      // Remove
+      test_erase_standard();
+      test_erase_missing();
+
+      // Bucket
+      test_bucket_matchesFind();
+
+      report("UnorderedMap");
+   }
+
+   typedef custom::unordered_map<int, std::string> Map;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty map has the default buckets
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Map m;
+      // verify
+      assertUnit(m.numElements == 0);
+      assertUnit(m.numBuckets == 10);
+      assertUnit(m.empty());
+      assertUnit(m.begin() == m.end());
+   }  // teardown
+
+   // build the standard fixture from an initializer list
+   void test_constructInit_standard()
+   {  // setup
+      // exercise
+      Map m{ {31, "thirty-one"}, {67, "sixty-seven"}, {59, "fifty-nine"} };
+      // verify
+      assertStandardFixture(m);
+   }  // teardown
+
+   // the copy has its own buckets
+   void test_constructCopy_standard()
+   {  // setup
+      Map mSrc;
+      setupStandardFixture(mSrc);
+      // exercise
+      Map mDes(mSrc);
+      mDes[31] = "changed";
+      // verify
+      assertUnit(mDes.buckets != mSrc.buckets);
+      assertUnit(mDes.at(31) == "changed");
+      assertStandardFixture(mSrc);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // [] on a missing key adds a default value
+   void test_squareBracket_missingInserts()
+   {  // setup
+      Map m;
+      // exercise
+      std::string& s = m[7];
+      // verify
+      assertUnit(s.empty());
+      assertUnit(m.size() == 1);
+      assertUnit(m.count(7) == 1);
+   }  // teardown
+
+   // [] on a present key reads it back without adding
+   void test_squareBracket_existingReads()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      std::string s = m[67];
+      // verify
+      assertUnit(s == "sixty-seven");
+      assertStandardFixture(m);
+   }  // teardown
+
+   // at() never inserts
+   void test_at_missingThrows()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         m.at(42);
+      }
+      catch (const std::out_of_range&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertStandardFixture(m);
+   }  // teardown
+
+   void test_find_standard()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      Map::iterator it = m.find(59);
+      // verify
+      assertUnit(it != m.end());
+      if (it != m.end())
+      {
+         assertUnit(it->first == 59);
+         assertUnit(it->second == "fifty-nine");
+      }
+      assertStandardFixture(m);
+   }  // teardown
+
+   void test_find_missing()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      Map::iterator it = m.find(42);
+      // verify
+      assertUnit(it == m.end());
+      assertStandardFixture(m);
+   }  // teardown
+
+   // a map keyed on std::string is searched with a const char*
+   void test_find_transparent()
+   {  // setup
+      custom::unordered_map<std::string, int, StringHash, StringEqual> m;
+      m["apple"] = 1;
+      m["pear"] = 2;
+      StringHash::numString = 0;
+      // exercise
+      auto it = m.find("pear");
+      // verify
+      assertUnit(it != m.end());
+      if (it != m.end())
+         assertUnit(it->second == 2);
+      assertUnit(m.contains("apple"));
+      assertUnit(m.count("plum") == 0);
+      assertUnit(StringHash::numString == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // try_emplace builds the value from its arguments
+   void test_tryEmplace_new()
+   {  // setup
+      Map m;
+      // exercise
+      custom::pair<Map::iterator, bool> p = m.try_emplace(5, 3, 'x');
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(p.first->first == 5);
+      assertUnit(p.first->second == "xxx");
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   // try_emplace on a present key leaves the value alone
+   void test_tryEmplace_existingUntouched()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      custom::pair<Map::iterator, bool> p = m.try_emplace(31, "other");
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(p.first->second == "thirty-one");
+      assertStandardFixture(m);
+   }  // teardown
+
+   void test_insertOrAssign_new()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      custom::pair<Map::iterator, bool> p = m.insert_or_assign(42, std::string("forty-two"));
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(p.first->second == "forty-two");
+      assertUnit(m.size() == 4);
+   }  // teardown
+
+   // insert_or_assign overwrites in place
+   void test_insertOrAssign_existing()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      custom::pair<Map::iterator, bool> p = m.insert_or_assign(67, "67");
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(m.size() == 3);
+      assertUnit(m.at(67) == "67");
+   }  // teardown
+
+   // the map grows its buckets just like the set
+   void test_insert_growsBuckets()
+   {  // setup
+      Map m;
+      // exercise
+      for (int i = 0; i < 11; i++)
+         m[i] = std::to_string(i);
+      // verify
+      assertUnit(m.numBuckets == 23);
+      assertUnit(m.size() == 11);
+      for (int i = 0; i < 11; i++)
+         assertUnit(m.at(i) == std::to_string(i));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   void test_erase_standard()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      m.erase(67);
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m.find(67) == m.end());
+      assertUnit(m.at(31) == "thirty-one");
+      assertUnit(m.at(59) == "fifty-nine");
+   }  // teardown
+
+   void test_erase_missing()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      Map::iterator it = m.erase(42);
+      // verify
+      assertUnit(it == m.end());
+      assertStandardFixture(m);
+   }  // teardown
+
+   /***************************************
+    * BUCKET
+    ***************************************/
+
+   // each key is found in the bucket bucket() names
+   void test_bucket_matchesFind()
+   {  // setup
+      Map m;
+      setupStandardFixture(m);
+      // exercise
+      size_t i = m.bucket(59);
+      // verify
+      assertUnit(i == m.hasher(59) % m.bucket_count());
+      assertUnit(m.bucket_size(i) == 1);
+      assertUnit((*m.begin(i)).first == 59);
+   }  // teardown
+
+   /****************************************************************
+    * Setup Standard Fixture
+    *   31 -> thirty-one
+    *   67 -> sixty-seven
+    *   59 -> fifty-nine
+    ****************************************************************/
+   void setupStandardFixture(Map& m)
+   {
+      m.insert(Map::value_type(31, std::string("thirty-one")));
+      m.insert(Map::value_type(67, std::string("sixty-seven")));
+      m.insert(Map::value_type(59, std::string("fifty-nine")));
+   }
+
+   void assertStandardFixtureParameters(Map& m, int line, const char* function)
+   {
+      assertIndirect(m.size() == 3);
+      assertIndirect(m.find(31) != m.end() && m.find(31)->second == "thirty-one");
+      assertIndirect(m.find(67) != m.end() && m.find(67)->second == "sixty-seven");
+      assertIndirect(m.find(59) != m.end() && m.find(59)->second == "fifty-nine");
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,141 @@
+/***********************************************************************
+ * Header:
+ *    UNORDERED MAP
+ * Summary:
+ *    Our custom implementation of std::unordered_map
+ *
+ *    This will contain the class definition of:
+ *        unordered_map           : A key-value hash on the hash_table engine
+ *        unordered_map::iterator : An iterator through the map
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // for hash_table, the bucket engine
+#include "pair.h"     // for custom::pair, what the buckets hold
+#include <stdexcept>  // for std::out_of_range
+#include <utility>    // for std::forward
+
+class TestUnorderedMap;     // forward declaration for unordered_map unit tests
+
+namespace custom
+{
+	/************************************************
+	 * SELECT FIRST
+	 * A map element is keyed by the first of its pair
+	 ************************************************/
+	template <typename K, typename V>
+	struct select_first
+	{
+		const K& operator()(const custom::pair<K, V>& p) const { return p.first; }
+	};
+
+	/************************************************
+	 * UNORDERED MAP
+	 * A map implemented as a hash. Each bucket holds
+	 * key-value pairs, and only the key is hashed and
+	 * compared. Every lookup that might insert hashes
+	 * the key once and walks one bucket once
+	 ************************************************/
+	template <typename K,
+	          typename V,
+	          typename Hash = std::hash<K>,
+	          typename KeyEqual = std::equal_to<K>,
+	          bool CacheHash = false>
+	class unordered_map : public hash_table<custom::pair<K, V>, K, select_first<K, V>, Hash, KeyEqual, CacheHash>
+	{
+		friend class ::TestUnorderedMap;   // give unit tests access to the privates
+		typedef hash_table<custom::pair<K, V>, K, select_first<K, V>, Hash, KeyEqual, CacheHash> Base;
+	public:
+		typedef custom::pair<K, V> value_type;
+		typedef typename Base::iterator iterator;
+
+		//
+		// Construct
+		//
+		unordered_map() : Base() {}
+		explicit unordered_map(size_t numBuckets, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual()) :
+			Base(numBuckets, hash, eq) {}
+		template <class Iterator>
+		unordered_map(Iterator first, Iterator last) : Base(first, last) {}
+		unordered_map(const std::initializer_list<value_type>& il) : Base(il) {}
+
+		//
+		// Assign
+		//
+		using Base::operator=;
+
+		//
+		// Access
+		//
+		V& operator [] (const K& k)
+		{
+			return try_emplace(k).first->second;
+		}
+		V& at(const K& k)
+		{
+			iterator it = this->find(k);
+			if (it == this->end())
+				throw std::out_of_range("unordered_map::at: key not found");
+			return it->second;
+		}
+
+		//
+		// Insert
+		//
+		template <class... Args>
+		custom::pair<iterator, bool> try_emplace(const K& k, Args&&... args);
+		template <class M>
+		custom::pair<iterator, bool> insert_or_assign(const K& k, M&& obj);
+	};
+
+	/*****************************************
+	 * UNORDERED MAP :: TRY EMPLACE
+	 * Build the value from args only when k is absent.
+	 * An existing element is left untouched
+	 ****************************************/
+	template <typename K, typename V, typename Hash, typename KeyEqual, bool CacheHash>
+	template <class... Args>
+	custom::pair<typename unordered_map <K, V, Hash, KeyEqual, CacheHash> ::iterator, bool>
+		unordered_map <K, V, Hash, KeyEqual, CacheHash> ::try_emplace(const K& k, Args&&... args)
+	{
+		size_t hash = this->hashOf(k);
+		iterator it = this->findHashed(k, hash);
+		if (it != this->end())
+			return { it, false };
+
+		return { this->append(value_type(k, V(std::forward<Args>(args)...)), hash), true };
+	}
+
+	/*****************************************
+	 * UNORDERED MAP :: INSERT OR ASSIGN
+	 * Overwrite the value at k, or add it when absent
+	 ****************************************/
+	template <typename K, typename V, typename Hash, typename KeyEqual, bool CacheHash>
+	template <class M>
+	custom::pair<typename unordered_map <K, V, Hash, KeyEqual, CacheHash> ::iterator, bool>
+		unordered_map <K, V, Hash, KeyEqual, CacheHash> ::insert_or_assign(const K& k, M&& obj)
+	{
+		size_t hash = this->hashOf(k);
+		iterator it = this->findHashed(k, hash);
+		if (it != this->end())
+		{
+			it->second = std::forward<M>(obj);
+			return { it, false };
+		}
+
+		return { this->append(value_type(k, V(std::forward<M>(obj))), hash), true };
+	}
+
+	/*****************************************
+	 * SWAP
+	 * Stand-alone unordered map swap
+	 ****************************************/
+	template <typename K, typename V, typename Hash, typename KeyEqual, bool CacheHash>
+	void swap(unordered_map<K, V, Hash, KeyEqual, CacheHash>& lhs, unordered_map<K, V, Hash, KeyEqual, CacheHash>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
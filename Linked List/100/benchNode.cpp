@@ -0,0 +1,193 @@
+/***********************************************************************
+ * Header:
+ *    Bench
+ * Summary:
+ *    Driver to time walking a chain of nodes. It has its own main(),
+ *    so it is not part of the project; build it on its own, with
+ *    optimization:
+ *        g++ -std=c++14 -O2 benchNode.cpp
+ *    Name sections to run only those:
+ *        ./a.out walk
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "node.h"        // for Node, copy(), insert() and clear()
+#include <algorithm>     // for std::shuffle
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**********************************************************************
+ * MILLISECONDS SINCE
+ ***********************************************************************/
+double msSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// what the timed loops add up, printed so none of them is optimized away
+long long sink = 0;
+
+/**********************************************************************
+ * ONE BY ONE
+ * 0 .. num-1 built with insert(), one new per node, in order
+ ***********************************************************************/
+Node<int>* oneByOne(int num)
+{
+   Node<int>* pHead = nullptr;
+   Node<int>* pTail = nullptr;
+   for (int i = 0; i < num; i++)
+   {
+      pTail = insert(pTail, i, true /*after*/);
+      if (pHead == nullptr)
+         pHead = pTail;
+   }
+   return pHead;
+}
+
+/**********************************************************************
+ * SCATTERED
+ * 0 .. num-1, one new per node, but linked in shuffled address order
+ * the way a long-lived list ends up after much inserting and erasing
+ ***********************************************************************/
+Node<int>* scattered(int num)
+{
+   std::vector<Node<int>*> nodes;
+   nodes.reserve(num);
+   for (int i = 0; i < num; i++)
+      nodes.push_back(new Node<int>(0));
+   std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+   for (int i = 0; i < num; i++)
+   {
+      nodes[i]->data = i;
+      nodes[i]->pPrev = i > 0 ? nodes[i - 1] : nullptr;
+      nodes[i]->pNext = i + 1 < num ? nodes[i + 1] : nullptr;
+   }
+   return num ? nodes[0] : nullptr;
+}
+
+/**********************************************************************
+ * TIME WALK
+ * Sum the chain passes times; ns per node
+ ***********************************************************************/
+double timeWalk(const Node<int>* pHead, int num, int passes)
+{
+   auto start = std::chrono::steady_clock::now();
+   for (int pass = 0; pass < passes; pass++)
+      for (const Node<int>* p = pHead; p; p = p->pNext)
+         sink += p->data;
+   return msSince(start) * 1e6 / (static_cast<double>(num) * passes);
+}
+
+/**********************************************************************
+ * WALK
+ * A chain of 1K to 10M ints, every node allocated alone in order, the
+ * same nodes shuffled in memory, and copy() of the shuffled chain into
+ * one slab, against a std::vector. Each is walked about 10M nodes' worth
+ ***********************************************************************/
+void benchWalk()
+{
+   printf("Walking a chain of ints, ns per node\n");
+   printf("%10s %12s %12s %12s %12s\n", "nodes", "one by one", "scattered", "slab copy", "array");
+   for (int num = 1000; num <= 10000000; num *= 10)
+   {
+      int passes = std::max(1, 10000000 / num);
+
+      Node<int>* pOneByOne = oneByOne(num);
+      double nsOneByOne = timeWalk(pOneByOne, num, passes);
+      clear(pOneByOne);
+
+      Node<int>* pScattered = scattered(num);
+      double nsScattered = timeWalk(pScattered, num, passes);
+      Node<int>* pSlab = copy(pScattered);
+      clear(pScattered);
+      double nsSlab = timeWalk(pSlab, num, passes);
+      clear(pSlab);
+
+      std::vector<int> array;
+      for (int i = 0; i < num; i++)
+         array.push_back(i);
+      auto start = std::chrono::steady_clock::now();
+      for (int pass = 0; pass < passes; pass++)
+         for (int v : array)
+            sink += v;
+      double nsArray = msSince(start) * 1e6 / (static_cast<double>(num) * passes);
+
+      printf("%10d %12.2f %12.2f %12.2f %12.2f\n", num, nsOneByOne, nsScattered, nsSlab, nsArray);
+   }
+}
+
+/**********************************************************************
+ * COPY
+ * copy() into one slab against building the same chain with one
+ * insert() per node, and clear() of each
+ ***********************************************************************/
+void benchCopy()
+{
+   printf("Copying a chain of ints, ms\n");
+   printf("%10s %12s %12s %12s %12s\n", "nodes", "slab copy", "one by one", "slab clear", "1by1 clear");
+   for (int num = 1000; num <= 10000000; num *= 10)
+   {
+      Node<int>* pSource = oneByOne(num);
+
+      auto start = std::chrono::steady_clock::now();
+      Node<int>* pSlab = copy(pSource);
+      double msSlab = msSince(start);
+
+      start = std::chrono::steady_clock::now();
+      Node<int>* pOneByOne = nullptr;
+      Node<int>* pTail = nullptr;
+      for (const Node<int>* p = pSource; p; p = p->pNext)
+      {
+         pTail = insert(pTail, p->data, true /*after*/);
+         if (pOneByOne == nullptr)
+            pOneByOne = pTail;
+      }
+      double msOneByOne = msSince(start);
+      sink += pSlab->data + pOneByOne->data;
+
+      start = std::chrono::steady_clock::now();
+      clear(pSlab);
+      double msSlabClear = msSince(start);
+      start = std::chrono::steady_clock::now();
+      clear(pOneByOne);
+      double msOneByOneClear = msSince(start);
+      clear(pSource);
+
+      printf("%10d %12.3f %12.3f %12.3f %12.3f\n", num, msSlab, msOneByOne, msSlabClear, msOneByOneClear);
+   }
+}
+
+/**********************************************************************
+ * MAIN
+ * Every section, or just the ones named on the command line
+ ***********************************************************************/
+int main(int argc, const char* argv[])
+{
+   struct Section
+   {
+      const char* name;
+      void (*bench)();
+   } sections[] =
+   {
+      { "walk",          benchWalk          },
+      { "copy",          benchCopy          },
+   };
+
+   for (const Section& section : sections)
+   {
+      bool isNamed = argc == 1;
+      for (int i = 1; i < argc; i++)
+         isNamed = isNamed || strcmp(argv[i], section.name) == 0;
+      if (isNamed)
+      {
+         section.bench();
+         printf("\n");
+      }
+   }
+   printf("(%lld)\n", sink);
+   return 0;
+}
@@ -21,7 +21,10 @@
 #pragma once
 
 #include <cassert>     // for ASSERT
+#include <cstddef>     // for std::max_align_t
 #include <iostream>    // for NULL
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::swap
 
 /*************************************************
  * NODE
@@ -29,6 +32,11 @@
  * of the setters, there is no point in making them
  * private.  This is the case because only the
  * List class can make validation decisions
+ *
+ * Every node carries a small header just in front
+ * of it so that "delete p" works the same whether
+ * the node came from "new Node" or from a slab that
+ * copy() carved many nodes out of at once.
  *************************************************/
 template <class T>
 class Node
@@ -39,19 +47,24 @@ public:
    // Construct
    //
 
-   Node()
+   Node() : data(), pNext(nullptr), pPrev(nullptr)
    {
-      pPrev = pNext = this;
    }
-   Node(const T &  data)
+   Node(const T &  data) : data(data), pNext(nullptr), pPrev(nullptr)
    {
-      pPrev = pNext = this;
    }
-   Node(      T && data)
+   Node(      T && data) : data(std::move(data)), pNext(nullptr), pPrev(nullptr)
    {
-      pPrev = pNext = this;
    }
 
+   //
+   // Allocate
+   //
+
+   static void * operator new(size_t size);
+   static void operator delete(void * p);
+   static Node <T> * cloneSlab(const Node <T> * pSource, size_t num);
+
    //
    // Member variables
    //
@@ -59,12 +72,124 @@ public:
    T data;                 // user data
    Node <T> * pNext;       // pointer to next node
    Node <T> * pPrev;       // pointer to previous node
+
+private:
+   struct Slab;
+   struct Header;
 };
 
+/*************************************************
+ * NODE :: SLAB
+ * The control block at the start of a slab. The
+ * slab is freed when the last of its nodes is
+ *************************************************/
+template <class T>
+struct alignas(alignof(Node <T>)) Node <T> ::Slab
+{
+   size_t numLive;         // nodes in this slab not yet deleted
+};
+
+/*************************************************
+ * NODE :: HEADER
+ * Sits immediately before every node. pSlab is
+ * nullptr for a node that was allocated alone
+ *************************************************/
+template <class T>
+struct alignas(alignof(Node <T>)) Node <T> ::Header
+{
+   Slab * pSlab;
+};
+
+/***********************************************
+ * NODE :: OPERATOR NEW
+ * A lone node: one block holding a header and the node
+ **********************************************/
+template <class T>
+void * Node <T> :: operator new(size_t size)
+{
+   static_assert(alignof(Node <T>) <= alignof(std::max_align_t),
+                 "over-aligned nodes are not supported");
+   Header * pHeader = static_cast<Header *>(::operator new(sizeof(Header) + size));
+   pHeader->pSlab = nullptr;
+   return pHeader + 1;
+}
+
+/***********************************************
+ * NODE :: OPERATOR DELETE
+ * Free a lone node now, or give a slab node back
+ * to its slab and free the slab with its last node
+ **********************************************/
+template <class T>
+void Node <T> :: operator delete(void * p)
+{
+   if (nullptr == p)
+      return;
+   Header * pHeader = static_cast<Header *>(p) - 1;
+   if (nullptr == pHeader->pSlab)
+      ::operator delete(pHeader);
+   else if (--pHeader->pSlab->numLive == 0)
+      ::operator delete(pHeader->pSlab);
+}
+
+/***********************************************
+ * NODE :: CLONE SLAB
+ * Copy num nodes starting at pSource into a single
+ * allocation, laid out in traversal order. The clones
+ * are linked to each other and to nothing else
+ *   INPUT  : the first node to copy and how many
+ *   OUTPUT : the first clone
+ *   COST   : O(n) with one allocation
+ **********************************************/
+template <class T>
+Node <T> * Node <T> ::cloneSlab(const Node <T> * pSource, size_t num)
+{
+   assert(num > 0);
+   const size_t sizeCell = sizeof(Header) + sizeof(Node <T>);
+   char * pBlock = static_cast<char *>(::operator new(sizeof(Slab) + num * sizeCell));
+   Slab * pSlab = new (pBlock) Slab;
+   pSlab->numLive = 0;
+
+   Node <T> * pHead = nullptr;
+   Node <T> * pTail = nullptr;
+   try
+   {
+      for (char * pCell = pBlock + sizeof(Slab); num > 0; num--, pCell += sizeCell)
+      {
+         assert(pSource);
+         Header * pHeader = new (pCell) Header;
+         pHeader->pSlab = pSlab;
+         Node <T> * pNew = ::new (static_cast<void *>(pHeader + 1)) Node <T>(pSource->data);
+         pSlab->numLive++;
+
+         pNew->pPrev = pTail;
+         if (pTail)
+            pTail->pNext = pNew;
+         else
+            pHead = pNew;
+         pTail = pNew;
+         pSource = pSource->pNext;
+      }
+   }
+   catch (...)
+   {
+      // a copy threw: destroy what was built and drop the whole slab
+      while (pHead)
+      {
+         Node <T> * pNext = pHead->pNext;
+         pHead->~Node();
+         pHead = pNext;
+      }
+      ::operator delete(pBlock);
+      throw;
+   }
+   return pHead;
+}
+
 /***********************************************
  * COPY
  * Copy the list from the pSource and return
- * the new list
+ * the new list. The copies share one slab so
+ * walking them touches consecutive memory
  *   INPUT  : the list to be copied
  *   OUTPUT : return the new list
  *   COST   : O(n)
@@ -72,7 +197,10 @@ public:
 template <class T>
 inline Node <T> * copy(const Node <T> * pSource) 
 {
-   return new Node<T>;
+   size_t num = size(pSource);
+   if (num == 0)
+      return nullptr;
+   return Node <T> ::cloneSlab(pSource, num);
 }
 
 /***********************************************
@@ -86,7 +214,39 @@ inline Node <T> * copy(const Node <T> * pSource)
 template <class T>
 inline void assign(Node <T> * & pDestination, const Node <T> * pSource)
 {
-   
+   const Node <T> * pSrc = pSource;
+   Node <T> * pDes = pDestination;
+   Node <T> * pDesPrevious = nullptr;
+
+   // overwrite the nodes we already have
+   while (pSrc && pDes)
+   {
+      pDes->data = pSrc->data;
+      pDesPrevious = pDes;
+      pDes = pDes->pNext;
+      pSrc = pSrc->pNext;
+   }
+
+   // the source is longer: the rest becomes one slab on the end
+   if (pSrc)
+   {
+      Node <T> * pTail = copy(pSrc);
+      pTail->pPrev = pDesPrevious;
+      if (pDesPrevious)
+         pDesPrevious->pNext = pTail;
+      else
+         pDestination = pTail;
+   }
+
+   // the destination is longer: free what is left over
+   else if (pDes)
+   {
+      if (pDesPrevious)
+         pDesPrevious->pNext = nullptr;
+      else
+         pDestination = nullptr;
+      clear(pDes);
+   }
 }
 
 /***********************************************
@@ -97,7 +257,9 @@ inline void assign(Node <T> * & pDestination, const Node <T> * pSource)
 template <class T>
 inline void swap(Node <T>* &pLHS, Node <T>* &pRHS)
 {
-
+   Node <T> * pTemp = pLHS;
+   pLHS = pRHS;
+   pRHS = pTemp;
 }
 
 /***********************************************
@@ -110,7 +272,17 @@ inline void swap(Node <T>* &pLHS, Node <T>* &pRHS)
 template <class T>
 inline Node <T> * remove(const Node <T> * pRemove) 
 {
-   return new Node <T>;
+   if (nullptr == pRemove)
+      return nullptr;
+
+   if (pRemove->pPrev)
+      pRemove->pPrev->pNext = pRemove->pNext;
+   if (pRemove->pNext)
+      pRemove->pNext->pPrev = pRemove->pPrev;
+
+   Node <T> * pReturn = pRemove->pPrev ? pRemove->pPrev : pRemove->pNext;
+   delete pRemove;
+   return pReturn;
 }
 
 /**********************************************
@@ -129,7 +301,27 @@ inline Node <T> * insert(Node <T> * pCurrent,
                   const T & t,
                   bool after = false)
 {
-   return new Node <T>;
+   Node <T> * pNew = new Node <T>(t);
+   if (nullptr == pCurrent)
+      return pNew;
+
+   if (after)
+   {
+      pNew->pPrev = pCurrent;
+      pNew->pNext = pCurrent->pNext;
+      if (pCurrent->pNext)
+         pCurrent->pNext->pPrev = pNew;
+      pCurrent->pNext = pNew;
+   }
+   else
+   {
+      pNew->pNext = pCurrent;
+      pNew->pPrev = pCurrent->pPrev;
+      if (pCurrent->pPrev)
+         pCurrent->pPrev->pNext = pNew;
+      pCurrent->pPrev = pNew;
+   }
+   return pNew;
 }
 
 /******************************************************
@@ -143,7 +335,10 @@ inline Node <T> * insert(Node <T> * pCurrent,
 template <class T>
 inline size_t size(const Node <T> * pHead)
 {
-   return 99;
+   size_t num = 0;
+   for (const Node <T> * p = pHead; p; p = p->pNext)
+      num++;
+   return num;
 }
 
 /***********************************************
@@ -157,12 +352,20 @@ inline size_t size(const Node <T> * pHead)
 template <class T>
 inline std::ostream & operator << (std::ostream & out, const Node <T> * pHead)
 {
+   for (const Node <T> * p = pHead; p; p = p->pNext)
+   {
+      out << p->data;
+      if (p->pNext)
+         out << ", ";
+   }
    return out;
 }
 
 /*****************************************************
  * CLEAR
- * Free all the data currently in the linked list
+ * Free all the data currently in the linked list.
+ * A loop rather than recursion so long lists cannot
+ * exhaust the stack
  *   INPUT   : pointer to the head of the linked list
  *   OUTPUT  : pHead set to NULL
  *   COST    : O(n)
@@ -170,7 +373,10 @@ inline std::ostream & operator << (std::ostream & out, const Node <T> * pHead)
 template <class T>
 inline void clear(Node <T> * & pHead)
 {
-
+   while (pHead)
+   {
+      Node <T> * pDelete = pHead;
+      pHead = pHead->pNext;
+      delete pDelete;
+   }
 }
-
-
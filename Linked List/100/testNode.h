@@ -30,6 +30,8 @@ public:
       test_copy_nullptr();
       test_copy_one();
       test_copy_standard();
+      test_copy_contiguous();
+      test_copy_deleteAnyOrder();
       
       // Assign
       test_assign_emptyToEmpty();
@@ -37,6 +39,7 @@ public:
       test_assign_emptyToStandard();
       test_assign_smallToBig();
       test_assign_bigToSmall();
+      test_assign_bigToSmallContiguous();
       test_swap_emptyEmpty();
       test_swap_emptyStandard();
       test_swap_standardEmpty();
@@ -60,6 +63,7 @@ public:
       test_clear_nullptr();
       test_clear_one();
       test_clear_standard();
+      test_clear_long();
 
       // Status
       test_size_empty();
@@ -230,6 +234,64 @@ public:
       teardownStandardFixture(pDes);
    }
 
+   // a copy lays its nodes out one after another in traversal order
+   void test_copy_contiguous()
+   {  // setup
+      Node <int>* pSrc = nullptr;
+      for (int i = 99; i >= 0; i--)
+         pSrc = insert(pSrc, i);
+      // exercise
+      Node <int>* pDes = copy(pSrc);
+      // verify
+      assertUnit(size(pDes) == 100);
+      bool inOrder = true;
+      bool evenlySpaced = true;
+      int i = 0;
+      for (Node <int>* p = pDes; p; p = p->pNext, i++)
+      {
+         inOrder = inOrder && p->data == i;
+         if (p->pNext)
+            evenlySpaced = evenlySpaced &&
+               (const char*)p->pNext - (const char*)p == (const char*)pDes->pNext - (const char*)pDes;
+      }
+      assertUnit(inOrder);
+      assertUnit(evenlySpaced);
+      assertUnit((const char*)pDes->pNext > (const char*)pDes);
+      // teardown
+      clear(pSrc);
+      clear(pDes);
+   }
+
+   // nodes from one copy can be deleted one at a time in any order
+   void test_copy_deleteAnyOrder()
+   {  // setup
+      //     p11      p26      p31
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      Node <Spy>* p11, * p26, * p31;
+      setupStandardFixture(p11, p26, p31);
+      Node <Spy>* pDes = copy(p11);
+      Node <Spy>* pMiddle = pDes->pNext;
+      Spy::reset();
+      // exercise
+      Node <Spy>* pReturn = remove(pMiddle);
+      // verify
+      assertUnit(Spy::numDestructor() == 1);   // destroy [26]
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(pReturn == pDes);
+      assertUnit(size(pDes) == 2);
+      assertUnit(pDes->data == Spy(11));
+      assertUnit(pDes->pNext->data == Spy(31));
+      // exercise
+      delete pDes->pNext;
+      delete pDes;                             // the slab goes with its last node
+      // verify
+      assertStandardFixture(p11);
+      // teardown
+      teardownStandardFixture(p11);
+   }
+
    /***************************************
     * ASSIGN
     ***************************************/
@@ -447,6 +509,32 @@ public:
       teardownStandardFixture(p67);
    }
 
+   // the nodes appended by assign are a fresh contiguous copy
+   void test_assign_bigToSmallContiguous()
+   {  // setup
+      Node <int>* pSrc = nullptr;
+      for (int i = 9; i >= 0; i--)
+         pSrc = insert(pSrc, i);
+      Node <int>* pDes = new Node <int>(-1);
+      Node <int>* pFirst = pDes;
+      // exercise
+      assign(pDes, pSrc);
+      // verify
+      assertUnit(pDes == pFirst);              // the existing node is reused
+      assertUnit(size(pDes) == 10);
+      bool inOrder = true;
+      int i = 0;
+      for (Node <int>* p = pDes; p; p = p->pNext, i++)
+         inOrder = inOrder && p->data == i && (p->pNext == nullptr || p->pNext->pPrev == p);
+      assertUnit(inOrder);
+      Node <int>* pSecond = pDes->pNext;
+      assertUnit((const char*)pSecond->pNext->pNext - (const char*)pSecond->pNext ==
+                 (const char*)pSecond->pNext - (const char*)pSecond);
+      // teardown
+      clear(pSrc);
+      clear(pDes);
+   }
+
    /***************************************
     * SWAP
     ***************************************/
@@ -1371,6 +1459,20 @@ public:
       assertUnit(p11 == nullptr);
    }  // teardown
 
+   // clearing a very long list does not recurse
+   void test_clear_long()
+   {  // setup
+      Node <int>* pHead = nullptr;
+      for (int i = 0; i < 1000000; i++)
+         pHead = insert(pHead, i);
+      Node <int>* pCopy = copy(pHead);
+      // exercise
+      clear(pHead);
+      clear(pCopy);
+      // verify
+      assertUnit(pHead == nullptr);
+      assertUnit(pCopy == nullptr);
+   }  // teardown
 
    /*************************************************************
     * SETUP STANDARD FIXTURE
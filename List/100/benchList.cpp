@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Header:
+ *    Bench
+ * Summary:
+ *    Driver to time the lists. It has its own main(), so it is not
+ *    part of the project; build it on its own, with optimization:
+ *        g++ -std=c++14 -O2 -pthread benchList.cpp
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "list.h"            // for the mutex-guarded baseline
+#include "lockfree_list.h"   // for lockfree_list
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**********************************************************************
+ * RANDOM
+ * A xorshift generator per thread, cheap enough not to be timed
+ ***********************************************************************/
+struct Random
+{
+   explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+   uint64_t operator()()
+   {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+   }
+   uint64_t state;
+};
+
+/**********************************************************************
+ * LOCKED LIST
+ * What we had: a sorted custom::list behind one mutex
+ ***********************************************************************/
+class LockedList
+{
+public:
+   bool insert(int t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = l.begin();
+      while (it != l.end() && *it < t)
+         ++it;
+      if (it != l.end() && *it == t)
+         return false;
+      l.insert(it, t);
+      return true;
+   }
+   bool erase(int t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = l.begin();
+      while (it != l.end() && *it < t)
+         ++it;
+      if (it == l.end() || *it != t)
+         return false;
+      l.erase(it);
+      return true;
+   }
+   bool contains(int t)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = l.begin();
+      while (it != l.end() && *it < t)
+         ++it;
+      return it != l.end() && *it == t;
+   }
+private:
+   custom::list<int> l;
+   std::mutex mutex;
+};
+
+/**********************************************************************
+ * MIX
+ * numThreads threads each run numOps operations on keys below
+ * numKeys: percentRead contains(), the rest split between insert()
+ * and erase(). Returns millions of operations per second
+ ***********************************************************************/
+template <class List>
+double mix(List& l, unsigned numThreads, int numOps, int numKeys, int percentRead)
+{
+   for (int i = 0; i < numKeys; i += 2)
+      l.insert(i);
+
+   // every answer is counted, so no call can be optimized away
+   std::atomic<int> numTrue(0);
+   auto start = std::chrono::steady_clock::now();
+   std::vector<std::thread> threads;
+   for (unsigned t = 0; t < numThreads; t++)
+      threads.push_back(std::thread([&l, &numTrue, t, numOps, numKeys, percentRead]()
+      {
+         Random random(t);
+         int num = 0;
+         for (int i = 0; i < numOps; i++)
+         {
+            uint64_t r = random();
+            int key = static_cast<int>(r % numKeys);
+            int percent = static_cast<int>((r >> 32) % 100);
+            if (percent < percentRead)
+               num += l.contains(key);
+            else if (percent % 2)
+               num += l.insert(key);
+            else
+               num += l.erase(key);
+         }
+         numTrue += num;
+      }));
+   for (auto& thread : threads)
+      thread.join();
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   if (numTrue < 0)
+      printf("impossible\n");
+   return numThreads * static_cast<double>(numOps) / seconds / 1e6;
+}
+
+/**********************************************************************
+ * LOCK-FREE LIST
+ * Throughput against the locked list as threads are added, for a
+ * read-heavy and a write-heavy mix over 1K keys
+ ***********************************************************************/
+void benchLockFreeList()
+{
+   const int NUM_KEYS = 1000;
+   const int NUM_OPS = 200000;
+   printf("lockfree_list vs locked custom::list, %d keys, %d ops per thread (%u cores)\n",
+          NUM_KEYS, NUM_OPS, std::thread::hardware_concurrency());
+   printf("%8s %6s %15s %15s\n", "threads", "read%", "locked Mops/s", "lockfree Mops/s");
+   unsigned maxThreads = std::max(8u, 2 * std::thread::hardware_concurrency());
+   for (int percentRead : { 90, 50 })
+      for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+      {
+         LockedList locked;
+         custom::lockfree_list<int> lockfree;
+         double mopsLocked = mix(locked, numThreads, NUM_OPS, NUM_KEYS, percentRead);
+         double mopsLockFree = mix(lockfree, numThreads, NUM_OPS, NUM_KEYS, percentRead);
+         printf("%8u %6d %15.2f %15.2f\n", numThreads, percentRead, mopsLocked, mopsLockFree);
+      }
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   benchLockFreeList();
+   return 0;
+}
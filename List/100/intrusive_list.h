@@ -0,0 +1,318 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list whose links live inside the elements
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        list_hook                : The links embedded in the user's object
+ *        intrusive_list           : A list threaded through those hooks
+ *        intrusive_list::iterator : An iterator through intrusive_list
+ *
+ *    The list never allocates: it only relinks hooks the caller owns. An
+ *    object can sit in several lists at once by having one hook per list.
+ *    In DEBUG builds every hook remembers the list it is in so misuse
+ *    (inserting twice, erasing from the wrong list, destroying a linked
+ *    object) is caught by an assert.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <cstddef>     // for size_t
+#include <utility>     // for std::swap
+
+#ifndef debug
+#ifdef DEBUG
+#define debug(x) x
+#else
+#define debug(x)
+#endif // DEBUG
+#endif // !debug
+
+class TestIntrusiveList;   // forward declaration for unit tests
+
+namespace custom
+{
+
+	/**************************************************
+	 * LIST HOOK
+	 * Embed one of these in T for every list T can be in
+	 **************************************************/
+	class list_hook
+	{
+		friend class ::TestIntrusiveList;
+		template <class T, list_hook T::* Hook>
+		friend class intrusive_list;
+	public:
+		list_hook() : pNext(nullptr), pPrev(nullptr)
+#ifdef DEBUG
+			, pOwner(nullptr)
+#endif // DEBUG
+		{}
+
+		// copying an object does not copy its list membership
+		list_hook(const list_hook&) : list_hook() {}
+		list_hook& operator=(const list_hook&) { return *this; }
+
+#ifdef DEBUG
+		~list_hook() {
+			assert(pOwner == nullptr); // destroyed while still in a list
+		}
+
+		bool is_linked() const { return pOwner != nullptr; }
+#endif // DEBUG
+
+	private:
+		list_hook* pNext;
+		list_hook* pPrev;
+#ifdef DEBUG
+		const void* pOwner;        // the list this hook is in, if any
+#endif // DEBUG
+	};
+
+	/**************************************************
+	 * INTRUSIVE LIST
+	 * Just like list<T*>, but with no Node per element
+	 **************************************************/
+	template <class T, list_hook T::* Hook>
+	class intrusive_list
+	{
+		friend class ::TestIntrusiveList; // give unit tests access to the privates
+	public:
+
+		// Construct. Lists own nothing, so they cannot be copied
+		intrusive_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+		intrusive_list(const intrusive_list&) = delete;
+		intrusive_list& operator=(const intrusive_list&) = delete;
+
+		intrusive_list(intrusive_list&& rhs) : numElements(0), pHead(nullptr), pTail(nullptr) {
+			swap(rhs);
+		}
+
+		// Destructor. The elements are unlinked, not destroyed
+		~intrusive_list() {
+			clear();
+		}
+
+		void swap(intrusive_list& rhs) {
+			std::swap(numElements, rhs.numElements);
+			std::swap(pHead, rhs.pHead);
+			std::swap(pTail, rhs.pTail);
+#ifdef DEBUG
+			for (list_hook* p = pHead; p; p = p->pNext) {
+				p->pOwner = this;
+			}
+			for (list_hook* p = rhs.pHead; p; p = p->pNext) {
+				p->pOwner = &rhs;
+			}
+#endif // DEBUG
+		}
+
+		// Iterator methods
+		class iterator;
+		iterator begin() { return iterator(pHead); }
+		iterator end() { return iterator(nullptr); }
+
+		// Find the position of an element already in this list. O(1)
+		iterator iterator_to(T& t) {
+			debug(assert((t.*Hook).pOwner == this));
+			return iterator(&(t.*Hook));
+		}
+
+		// Accessors
+		T& front() {
+			if (pHead) {
+				return *owner(pHead);
+			}
+			throw "ERROR: unable to access data from an empty list";
+		}
+
+		T& back() {
+			if (pTail) {
+				return *owner(pTail);
+			}
+			throw "ERROR: unable to access data from an empty list";
+		}
+
+		// Modifiers. All are O(1) and none allocate
+		void push_front(T& t) {
+			insert(begin(), t);
+		}
+
+		void push_back(T& t) {
+			insert(end(), t);
+		}
+
+		iterator insert(iterator it, T& t) {
+			list_hook* pNew = &(t.*Hook);
+			debug(assert(pNew->pOwner == nullptr)); // already in a list
+			list_hook* pBefore = (it.p ? it.p->pPrev : pTail);
+			pNew->pNext = it.p;
+			pNew->pPrev = pBefore;
+			if (pBefore) {
+				pBefore->pNext = pNew;
+			}
+			else {
+				pHead = pNew;
+			}
+			if (it.p) {
+				it.p->pPrev = pNew;
+			}
+			else {
+				pTail = pNew;
+			}
+#ifdef DEBUG
+			pNew->pOwner = this;
+#endif // DEBUG
+			++numElements;
+			return iterator(pNew);
+		}
+
+		void pop_front() {
+			if (pHead) {
+				unlink(pHead);
+			}
+		}
+
+		void pop_back() {
+			if (pTail) {
+				unlink(pTail);
+			}
+		}
+
+		iterator erase(const iterator& it) {
+			if (it.p == nullptr) {
+				return end();
+			}
+			list_hook* pNext = it.p->pNext;
+			unlink(it.p);
+			return iterator(pNext);
+		}
+
+		// Unlink an element from wherever it sits in this list. O(1)
+		void erase(T& t) {
+			unlink(&(t.*Hook));
+		}
+
+		void clear() {
+			while (pHead) {
+				unlink(pHead);
+			}
+		}
+
+		// Capacity
+		bool empty() const { return numElements == 0; }
+
+		size_t size() const { return numElements; }
+
+	private:
+
+		// Remove one hook from the list and reset its links
+		void unlink(list_hook* pHook) {
+			debug(assert(pHook->pOwner == this)); // not in this list
+			if (pHook->pPrev) {
+				pHook->pPrev->pNext = pHook->pNext;
+			}
+			else {
+				pHead = pHook->pNext;
+			}
+			if (pHook->pNext) {
+				pHook->pNext->pPrev = pHook->pPrev;
+			}
+			else {
+				pTail = pHook->pPrev;
+			}
+			pHook->pNext = nullptr;
+			pHook->pPrev = nullptr;
+#ifdef DEBUG
+			pHook->pOwner = nullptr;
+#endif // DEBUG
+			--numElements;
+		}
+
+		// Find the object containing a hook from the hook's offset in T
+		static T* owner(list_hook* pHook) {
+			return reinterpret_cast<T*>(reinterpret_cast<char*>(pHook) - offset());
+		}
+
+		static size_t offset() {
+			alignas(T) char buffer[sizeof(T)];
+			T* p = reinterpret_cast<T*>(buffer);
+			return reinterpret_cast<char*>(&(p->*Hook)) - buffer;
+		}
+
+		size_t numElements;
+		list_hook* pHead;
+		list_hook* pTail;
+	};
+
+	/*************************************************
+	 * INTRUSIVE LIST ITERATOR
+	 * Iterate through an intrusive list
+	 ************************************************/
+	template <class T, list_hook T::* Hook>
+	class intrusive_list <T, Hook> ::iterator
+	{
+		friend class ::TestIntrusiveList; // give unit tests access to the privates
+		friend class intrusive_list <T, Hook>;
+	public:
+		// CONSTRUCTORS
+		iterator() : p(nullptr) {}
+		iterator(list_hook* p) : p(p) {}
+
+		// Equals, not equals operator
+		bool operator == (const iterator& rhs) const { return p == rhs.p; }
+		bool operator != (const iterator& rhs) const { return p != rhs.p; }
+
+		// Dereference operator, fetch the object holding the hook
+		T& operator * () { return *intrusive_list::owner(p); }
+		T* operator->() { return intrusive_list::owner(p); }
+
+		// Prefix increment
+		iterator& operator++()
+		{
+			if (p) {
+				p = p->pNext;
+			}
+			return *this;
+		}
+
+		// Postfix increment
+		iterator operator++(int)
+		{
+			iterator temp = *this;
+			++(*this);
+			return temp;
+		}
+
+		// Prefix decrement
+		iterator& operator--()
+		{
+			if (p) {
+				p = p->pPrev;
+			}
+			return *this;
+		}
+
+		// Postfix decrement
+		iterator operator--(int)
+		{
+			iterator temp = *this;
+			--(*this);
+			return temp;
+		}
+
+	private:
+		list_hook* p;
+	};
+
+}; // namespace custom
@@ -23,6 +23,7 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <functional>  // for std::less
 
 class TestList;        // forward declaration for unit tests
 class TestHash;        // to be used later
@@ -326,6 +327,145 @@ namespace custom
 			return nextIterator;
 		}
 
+		// Operations
+		//
+		// None of these allocate or free a node (except unique, which only
+		// frees the duplicates): the nodes are relinked where they are.
+
+		// Move every node of rhs in front of pos. O(1)
+		void splice(iterator pos, list<T>& rhs) {
+			if (this == &rhs || rhs.pHead == nullptr) {
+				return;
+			}
+			Node* pFirst = rhs.pHead;
+			Node* pLast = rhs.pTail;
+			size_t num = rhs.numElements;
+			rhs.unlinkRange(pFirst, pLast);
+			rhs.numElements = 0;
+			linkRange(pos.p, pFirst, pLast);
+			numElements += num;
+		}
+
+		// Move the single node at it from rhs in front of pos. O(1)
+		void splice(iterator pos, list<T>& rhs, iterator it) {
+			Node* pNode = it.p;
+			if (pNode == nullptr || (this == &rhs && (pNode == pos.p || pNode->pNext == pos.p))) {
+				return;
+			}
+			rhs.unlinkRange(pNode, pNode);
+			--rhs.numElements;
+			linkRange(pos.p, pNode, pNode);
+			++numElements;
+		}
+
+		// Move the nodes [first, last) from rhs in front of pos. O(1) when
+		// rhs is this list, otherwise O(distance) to keep size() constant time
+		void splice(iterator pos, list<T>& rhs, iterator first, iterator last) {
+			if (first.p == last.p) {
+				return;
+			}
+			Node* pFirst = first.p;
+			Node* pLast = (last.p ? last.p->pPrev : rhs.pTail);
+			if (this != &rhs) {
+				size_t num = 1;
+				for (Node* p = pFirst; p != pLast; p = p->pNext) {
+					++num;
+				}
+				rhs.numElements -= num;
+				numElements += num;
+			}
+			else if (pos.p == last.p) {
+				return;
+			}
+			rhs.unlinkRange(pFirst, pLast);
+			linkRange(pos.p, pFirst, pLast);
+		}
+
+		// Merge the sorted rhs into this sorted list. Stable, O(n + m)
+		void merge(list<T>& rhs) {
+			merge(rhs, std::less<T>());
+		}
+
+		template <class Compare>
+		void merge(list<T>& rhs, Compare comp) {
+			if (this == &rhs || rhs.pHead == nullptr) {
+				return;
+			}
+			pHead = mergeChains(pHead, rhs.pHead, comp);
+			numElements += rhs.numElements;
+			rhs.numElements = 0;
+			rhs.pHead = nullptr;
+			rhs.pTail = nullptr;
+			relinkPrev();
+		}
+
+		// Stable bottom-up merge sort. O(n log n), no allocation
+		void sort() {
+			sort(std::less<T>());
+		}
+
+		template <class Compare>
+		void sort(Compare comp) {
+			if (numElements < 2) {
+				return;
+			}
+
+			// bins[i] holds a sorted chain of 2^i nodes, or nothing. This is
+			// enough bins for any list that fits in memory
+			Node* bins[64] = {};
+			size_t numBins = 0;
+			Node* pNext = pHead;
+			while (pNext) {
+				Node* pCarry = pNext;
+				pNext = pNext->pNext;
+				pCarry->pNext = nullptr;
+
+				size_t i = 0;
+				for (; i < numBins && bins[i]; ++i) {
+					pCarry = mergeChains(bins[i], pCarry, comp);
+					bins[i] = nullptr;
+				}
+				bins[i] = pCarry;
+				if (i == numBins) {
+					++numBins;
+				}
+			}
+
+			// the higher bins hold the older nodes, so they go first
+			Node* pSorted = nullptr;
+			for (size_t i = 0; i < numBins; ++i) {
+				if (bins[i]) {
+					pSorted = mergeChains(bins[i], pSorted, comp);
+				}
+			}
+			pHead = pSorted;
+			relinkPrev();
+		}
+
+		// Remove consecutive duplicate elements. O(n)
+		void unique() {
+			if (pHead == nullptr) {
+				return;
+			}
+			Node* p = pHead;
+			while (p->pNext) {
+				if (p->pNext->data == p->data) {
+					erase(iterator(p->pNext));
+				}
+				else {
+					p = p->pNext;
+				}
+			}
+		}
+
+		// Reverse the order of the nodes. O(n)
+		void reverse() {
+			for (Node* p = pHead; p; p = p->pPrev) {
+				std::swap(p->pNext, p->pPrev);
+			}
+			std::swap(pHead, pTail);
+		}
+
 		// Capacity
 		bool empty() const { return numElements == 0; }
 
@@ -337,6 +477,76 @@ namespace custom
 		// nested linked list class
 		class Node;
 
+		// Detach the nodes [pFirst, pLast] from this list, leaving the
+		// detached range linked to itself
+		void unlinkRange(Node* pFirst, Node* pLast) {
+			if (pFirst->pPrev) {
+				pFirst->pPrev->pNext = pLast->pNext;
+			}
+			else {
+				pHead = pLast->pNext;
+			}
+			if (pLast->pNext) {
+				pLast->pNext->pPrev = pFirst->pPrev;
+			}
+			else {
+				pTail = pFirst->pPrev;
+			}
+			pFirst->pPrev = nullptr;
+			pLast->pNext = nullptr;
+		}
+
+		// Attach the detached nodes [pFirst, pLast] in front of pPos, where
+		// a pPos of nullptr means the end of the list
+		void linkRange(Node* pPos, Node* pFirst, Node* pLast) {
+			Node* pBefore = (pPos ? pPos->pPrev : pTail);
+			pFirst->pPrev = pBefore;
+			pLast->pNext = pPos;
+			if (pBefore) {
+				pBefore->pNext = pFirst;
+			}
+			else {
+				pHead = pFirst;
+			}
+			if (pPos) {
+				pPos->pPrev = pLast;
+			}
+			else {
+				pTail = pLast;
+			}
+		}
+
+		// Merge two sorted chains linked only through pNext. On ties the
+		// node from pLHS goes first, which keeps the merge stable
+		template <class Compare>
+		static Node* mergeChains(Node* pLHS, Node* pRHS, Compare& comp) {
+			Node* pResult = nullptr;
+			Node** ppTail = &pResult;
+			while (pLHS && pRHS) {
+				if (comp(pRHS->data, pLHS->data)) {
+					*ppTail = pRHS;
+					pRHS = pRHS->pNext;
+				}
+				else {
+					*ppTail = pLHS;
+					pLHS = pLHS->pNext;
+				}
+				ppTail = &(*ppTail)->pNext;
+			}
+			*ppTail = (pLHS ? pLHS : pRHS);
+			return pResult;
+		}
+
+		// Rebuild pPrev and pTail after the list was relinked through pNext
+		void relinkPrev() {
+			Node* pPrevious = nullptr;
+			for (Node* p = pHead; p; p = p->pNext) {
+				p->pPrev = pPrevious;
+				pPrevious = p;
+			}
+			pTail = pPrevious;
+		}
+
 		size_t numElements;
 		Node* pHead;
 		Node* pTail;
@@ -393,8 +603,8 @@ namespace custom
 		}
 
 		// Equals, not equals operator
-		bool operator == (const iterator& rhs) const { return true; }
-		bool operator != (const iterator& rhs) const { return true; }
+		bool operator == (const iterator& rhs) const { return p == rhs.p; }
+		bool operator != (const iterator& rhs) const { return p != rhs.p; }
 
 		T& operator * ()
 		{
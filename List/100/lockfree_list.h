@@ -0,0 +1,196 @@
+/***********************************************************************
+ * Header:
+ *    LOCK-FREE LIST
+ * Summary:
+ *    A sorted set that many threads can use at once without a mutex
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        lockfree_list        : A Harris-Michael ordered linked list
+ *
+ *    Erase happens in two steps. First the low bit of the victim's pNext
+ *    is set, which logically deletes it and stops anyone from inserting
+ *    after it. Then the node is unlinked from its predecessor, either by
+ *    the eraser or by whichever traversal trips over it first. Unlinked
+ *    nodes are handed to custom::epoch so readers never touch freed memory.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <atomic>      // for std::atomic
+#include <cstdint>     // for uintptr_t
+#include <functional>  // for std::less
+#include "epoch.h"     // for epoch::guard and epoch::retire
+
+class TestLockFreeList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+	/**************************************************
+	 * LOCK-FREE LIST
+	 * A sorted set of unique elements. insert, erase
+	 * and contains are lock-free and linearizable
+	 **************************************************/
+	template <typename T, typename Compare = std::less<T>>
+	class lockfree_list
+	{
+		friend class ::TestLockFreeList; // give unit tests access to the privates
+	public:
+
+		lockfree_list(const Compare& compare = Compare()) : pHead(0), numElements(0), compare(compare) {}
+		lockfree_list(const lockfree_list&) = delete;
+		lockfree_list& operator=(const lockfree_list&) = delete;
+
+		// Destructor. No other thread may be using the list any more
+		~lockfree_list() {
+			Node* p = pointer(pHead.load());
+			while (p) {
+				Node* pNext = pointer(p->pNext.load());
+				delete p;
+				p = pNext;
+			}
+		}
+
+		// Add t if it is not already there. Returns false on a duplicate
+		bool insert(const T& t) {
+			epoch::guard g;
+			Node* pNew = new Node(t);
+			while (true) {
+				Position pos;
+				if (find(t, pos)) {
+					delete pNew;
+					return false;
+				}
+				pNew->pNext.store(reinterpret_cast<uintptr_t>(pos.pCurr), std::memory_order_relaxed);
+				uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+				if (pos.pPrev->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pNew))) {
+					numElements.fetch_add(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+		}
+
+		// Remove t. Returns false if it was not there
+		bool erase(const T& t) {
+			epoch::guard g;
+			while (true) {
+				Position pos;
+				if (!find(t, pos)) {
+					return false;
+				}
+
+				// logical delete: whoever sets the mark owns the erase
+				uintptr_t next = pos.pCurr->pNext.load();
+				if (isMarked(next)) {
+					continue;
+				}
+				if (!pos.pCurr->pNext.compare_exchange_strong(next, next | MARK)) {
+					continue;
+				}
+				numElements.fetch_sub(1, std::memory_order_relaxed);
+
+				// physical delete: if we lose the race, find() cleans up
+				uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+				if (pos.pPrev->compare_exchange_strong(expected, next)) {
+					epoch::retire(pos.pCurr);
+				}
+				else {
+					find(t, pos);
+				}
+				return true;
+			}
+		}
+
+		// Is t in the set? Never writes to shared memory
+		bool contains(const T& t) const {
+			epoch::guard g;
+			Node* p = pointer(pHead.load());
+			while (p && compare(p->data, t)) {
+				p = pointer(p->pNext.load());
+			}
+			return p && !compare(t, p->data) && !isMarked(p->pNext.load());
+		}
+
+		// A snapshot; exact only when no other thread is writing
+		size_t size() const { return numElements.load(std::memory_order_relaxed); }
+		bool empty() const { return size() == 0; }
+
+		// Visit every element in order. Only meaningful when quiescent
+		template <class Function>
+		void for_each(Function f) const {
+			epoch::guard g;
+			for (Node* p = pointer(pHead.load()); p; p = pointer(p->pNext.load())) {
+				if (!isMarked(p->pNext.load())) {
+					f(p->data);
+				}
+			}
+		}
+
+	private:
+		// the low bit of pNext marks the owning node as logically deleted
+		static const uintptr_t MARK = 1;
+
+		class Node
+		{
+		public:
+			Node(const T& data) : data(data), pNext(0) {}
+			T data;
+			std::atomic<uintptr_t> pNext;
+		};
+
+		// where a key belongs: *pPrev held pCurr, the first node >= key
+		struct Position
+		{
+			std::atomic<uintptr_t>* pPrev;
+			Node* pCurr;
+		};
+
+		static bool isMarked(uintptr_t p) { return (p & MARK) != 0; }
+		static Node* pointer(uintptr_t p) { return reinterpret_cast<Node*>(p & ~MARK); }
+
+		// Michael's search: walk to the first node not less than t,
+		// unlinking and retiring any marked nodes along the way
+		bool find(const T& t, Position& pos) {
+		retry:
+			pos.pPrev = &pHead;
+			pos.pCurr = pointer(pos.pPrev->load());
+			while (true) {
+				if (pos.pCurr == nullptr) {
+					return false;
+				}
+				uintptr_t next = pos.pCurr->pNext.load();
+				if (pos.pPrev->load() != reinterpret_cast<uintptr_t>(pos.pCurr)) {
+					goto retry;
+				}
+				if (!isMarked(next)) {
+					if (!compare(pos.pCurr->data, t)) {
+						return !compare(t, pos.pCurr->data);
+					}
+					pos.pPrev = &pos.pCurr->pNext;
+				}
+				else {
+					uintptr_t expected = reinterpret_cast<uintptr_t>(pos.pCurr);
+					if (!pos.pPrev->compare_exchange_strong(expected, next & ~MARK)) {
+						goto retry;
+					}
+					epoch::retire(pos.pCurr);
+				}
+				pos.pCurr = pointer(next);
+			}
+		}
+
+		std::atomic<uintptr_t> pHead;
+		std::atomic<size_t> numElements;
+		Compare compare;
+	};
+
+}; // namespace custom
@@ -0,0 +1,462 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE LIST
+ * Summary:
+ *    Unit tests for intrusive_list
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusive_list.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <memory>
+#include <iostream>
+
+/***************************************
+ * ITEM
+ * An object that can be in two lists at once
+ ***************************************/
+struct Item
+{
+   Item(int value = 0) : value(value) {}
+   int value;
+   custom::list_hook hookA;
+   custom::list_hook hookB;
+};
+
+typedef custom::intrusive_list<Item, &Item::hookA> ListA;
+typedef custom::intrusive_list<Item, &Item::hookB> ListB;
+
+class TestIntrusiveList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_pushback_empty();
+      test_pushback_standard();
+      test_pushfront_standard();
+      test_insert_standardMiddle();
+
+      // Remove
+      test_popfront_standard();
+      test_popback_standard();
+      test_erase_iteratorMiddle();
+      test_erase_objectMiddle();
+      test_erase_objectFront();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_standard();
+      test_iteratorTo_standard();
+
+      // Membership
+      test_twoLists_independent();
+      test_swap_standard();
+
+      report("IntrusiveList");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing linked
+   void test_construct_default()
+   {  // setup
+      // exercise
+      ListA l;
+      // verify
+      assertEmptyFixture(l);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // add one object to an empty list
+   void test_pushback_empty()
+   {  // setup
+      Item i11(11);
+      ListA l;
+      // exercise
+      l.push_back(i11);
+      // verify
+      assertUnit(l.numElements == 1);
+      assertUnit(l.pHead == &i11.hookA);
+      assertUnit(l.pTail == &i11.hookA);
+      assertUnit(i11.hookA.pNext == nullptr);
+      assertUnit(i11.hookA.pPrev == nullptr);
+      assertUnit(i11.hookA.pOwner == &l);
+      assertUnit(i11.hookB.pOwner == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // add an object onto the end of the standard fixture
+   void test_pushback_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      Item i99(99);
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.push_back(i99);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 99 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(l.numElements == 4);
+      assertUnit(l.pTail == &i99.hookA);
+      assertUnit(i99.hookA.pPrev == &items[2].hookA);
+      assertUnit(items[2].hookA.pNext == &i99.hookA);
+      assertUnit(i99.hookA.pNext == nullptr);
+      assertUnit(l.back().value == 99);
+      // teardown
+      l.clear();
+   }
+
+   // add an object onto the front of the standard fixture
+   void test_pushfront_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      Item i99(99);
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.push_front(i99);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 99 | - | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(l.numElements == 4);
+      assertUnit(l.pHead == &i99.hookA);
+      assertUnit(i99.hookA.pPrev == nullptr);
+      assertUnit(i99.hookA.pNext == &items[0].hookA);
+      assertUnit(items[0].hookA.pPrev == &i99.hookA);
+      assertUnit(l.front().value == 99);
+      // teardown
+      l.clear();
+   }
+
+   // insert an object in front of 26
+   void test_insert_standardMiddle()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      Item items[3] = { 11, 26, 31 };
+      Item i99(99);
+      ListA l;
+      setupStandardFixture(l, items);
+      ListA::iterator it(&items[1].hookA);
+      // exercise
+      it = l.insert(it, i99);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 99 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+
+      //                  it
+      assertUnit(it.p == &i99.hookA);
+      assertUnit(l.numElements == 4);
+      assertUnit(items[0].hookA.pNext == &i99.hookA);
+      assertUnit(i99.hookA.pPrev == &items[0].hookA);
+      assertUnit(i99.hookA.pNext == &items[1].hookA);
+      assertUnit(items[1].hookA.pPrev == &i99.hookA);
+      // teardown
+      l.clear();
+   }
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // remove the first object
+   void test_popfront_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.pop_front();
+      // verify
+      //       +----+   +----+
+      //       | 26 | - | 31 |
+      //       +----+   +----+
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead == &items[1].hookA);
+      assertUnit(items[1].hookA.pPrev == nullptr);
+      assertUnit(items[0].hookA.pNext == nullptr);
+      assertUnit(items[0].hookA.pOwner == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // remove the last object
+   void test_popback_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.pop_back();
+      // verify
+      //       +----+   +----+
+      //       | 11 | - | 26 |
+      //       +----+   +----+
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pTail == &items[1].hookA);
+      assertUnit(items[1].hookA.pNext == nullptr);
+      assertUnit(items[2].hookA.pPrev == nullptr);
+      assertUnit(items[2].hookA.pOwner == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // erase 26 through an iterator
+   void test_erase_iteratorMiddle()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      ListA::iterator it(&items[1].hookA);
+      // exercise
+      it = l.erase(it);
+      // verify
+      //       +----+   +----+
+      //       | 11 | - | 31 |
+      //       +----+   +----+
+      //                  it
+      assertUnit(it.p == &items[2].hookA);
+      assertUnit(l.numElements == 2);
+      assertUnit(items[0].hookA.pNext == &items[2].hookA);
+      assertUnit(items[2].hookA.pPrev == &items[0].hookA);
+      assertUnit(items[1].hookA.pOwner == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // erase 26 knowing only the object
+   void test_erase_objectMiddle()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.erase(items[1]);
+      // verify
+      //       +----+   +----+
+      //       | 11 | - | 31 |
+      //       +----+   +----+
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead == &items[0].hookA);
+      assertUnit(l.pTail == &items[2].hookA);
+      assertUnit(items[0].hookA.pNext == &items[2].hookA);
+      assertUnit(items[2].hookA.pPrev == &items[0].hookA);
+      assertUnit(items[1].hookA.pNext == nullptr);
+      assertUnit(items[1].hookA.pPrev == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // erase 11 knowing only the object
+   void test_erase_objectFront()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.erase(items[0]);
+      // verify
+      //       +----+   +----+
+      //       | 26 | - | 31 |
+      //       +----+   +----+
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead == &items[1].hookA);
+      assertUnit(items[1].hookA.pPrev == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // clear unlinks everything but destroys nothing
+   void test_clear_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      l.clear();
+      // verify
+      assertEmptyFixture(l);
+      for (int i = 0; i < 3; i++)
+      {
+         assertUnit(items[i].hookA.pNext == nullptr);
+         assertUnit(items[i].hookA.pPrev == nullptr);
+         assertUnit(items[i].hookA.pOwner == nullptr);
+      }
+      assertUnit(items[1].value == 26);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the standard fixture forward and back
+   void test_iterator_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      int sum = 0;
+      // exercise
+      for (ListA::iterator it = l.begin(); it != l.end(); ++it)
+         sum = sum * 100 + it->value;
+      ListA::iterator it(l.pTail);
+      --it;
+      // verify
+      assertUnit(sum == 112631);
+      assertUnit(&*it == &items[1]);
+      // teardown
+      l.clear();
+   }
+
+   // find the iterator of an object without searching
+   void test_iteratorTo_standard()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      setupStandardFixture(l, items);
+      // exercise
+      ListA::iterator it = l.iterator_to(items[2]);
+      // verify
+      assertUnit(it.p == &items[2].hookA);
+      assertUnit((*it).value == 31);
+      // teardown
+      l.clear();
+   }
+
+   /***************************************
+    * MEMBERSHIP
+    ***************************************/
+
+   // the same objects in two lists, in different orders
+   void test_twoLists_independent()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA lA;
+      ListB lB;
+      setupStandardFixture(lA, items);
+      // exercise
+      lB.push_front(items[0]);
+      lB.push_front(items[2]);
+      lA.erase(items[0]);
+      // verify
+      //   A:  26 - 31
+      //   B:  31 - 11
+      assertUnit(lA.size() == 2);
+      assertUnit(lB.size() == 2);
+      assertUnit(lA.front().value == 26);
+      assertUnit(lB.front().value == 31);
+      assertUnit(lB.back().value == 11);
+      assertUnit(&lB.back() == &items[0]);
+      assertUnit(items[0].hookA.pOwner == nullptr);
+      assertUnit(items[0].hookB.pOwner == &lB);
+      // teardown
+      lA.clear();
+      lB.clear();
+   }
+
+   // swap two lists, ownership follows the nodes
+   void test_swap_standard()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA lLHS;
+      ListA lRHS;
+      setupStandardFixture(lLHS, items);
+      // exercise
+      lLHS.swap(lRHS);
+      // verify
+      assertEmptyFixture(lLHS);
+      assertUnit(lRHS.numElements == 3);
+      assertUnit(lRHS.pHead == &items[0].hookA);
+      assertUnit(items[1].hookA.pOwner == &lRHS);
+      // teardown
+      lRHS.clear();
+   }
+
+   /****************************************************************
+    * Setup Standard Fixture
+    *        pHead             pTail
+    *       +----+   +----+   +----+
+    *       | 11 | - | 26 | - | 31 |
+    *       +----+   +----+   +----+
+    ****************************************************************/
+   void setupStandardFixture(ListA& l, Item items[3])
+   {
+      for (int i = 0; i < 3; i++)
+      {
+         items[i].hookA.pPrev = (i > 0 ? &items[i - 1].hookA : nullptr);
+         items[i].hookA.pNext = (i < 2 ? &items[i + 1].hookA : nullptr);
+         items[i].hookA.pOwner = &l;
+      }
+      l.pHead = &items[0].hookA;
+      l.pTail = &items[2].hookA;
+      l.numElements = 3;
+   }
+
+   /****************************************************************
+    * Verify Empty Fixture
+    ****************************************************************/
+   template <class L>
+   void assertEmptyFixtureParameters(const L& l, int line, const char* function)
+   {
+      assertIndirect(l.numElements == 0);
+      assertIndirect(l.pHead == nullptr);
+      assertIndirect(l.pTail == nullptr);
+   }
+};
+
+#endif // DEBUG
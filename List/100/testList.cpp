@@ -13,6 +13,8 @@
  //#undef DEBUG  // Remove this comment to disable unit tests
 
 #include "testList.h"       // for the spy unit tests
+#include "testIntrusiveList.h"  // for the intrusive list unit tests
+#include "testLockFreeList.h"   // for the lock-free list unit tests
 
 
 /**********************************************************************
@@ -24,6 +26,8 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestList().run();
+   TestIntrusiveList().run();
+   TestLockFreeList().run();
 #endif // DEBUG
    
    return 0;
@@ -120,6 +120,16 @@ public:
       test_empty_empty();
       test_empty_three();
 
+      // Operations
+      test_splice_all();
+      test_splice_single();
+      test_splice_range();
+      test_merge_standard();
+      test_sort_standard();
+      test_sort_stable();
+      test_unique_standard();
+      test_reverse_standard();
+
       report("List");
    }
 
@@ -2348,6 +2358,261 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * OPERATIONS
+    ***************************************/
+
+   // splice an entire list onto the end of the standard fixture
+   void test_splice_all()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> lDes;
+      setupStandardFixture(lDes);
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<int>::Node* p4 = lSrc.pHead;
+      custom::list<int>::Node* p6 = lSrc.pTail;
+      custom::list<int>::Node* p3 = lDes.pTail;
+      // exercise
+      lDes.splice(lDes.end(), lSrc);
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+   +----+
+      assertEmptyFixture(lSrc);
+      assertUnit(lDes.numElements == 6);
+      assertUnit(lDes.pTail == p6);
+      assertUnit(p3->pNext == p4);
+      assertUnit(p4->pPrev == p3);
+      assertUnit(p6->pNext == nullptr);
+      // teardown
+      lDes.clear();
+   }
+
+   // move the middle element of one list to the front of another
+   void test_splice_single()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      custom::list<int> lDes;
+      setupStandardFixture(lDes);
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<int>::Node* p = lSrc.pHead->pNext;
+      custom::list<int>::Node* pOldHead = lDes.pHead;
+      // exercise
+      lDes.splice(lDes.begin(), lSrc, custom::list<int>::iterator(p));
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 26 | - | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(lDes.numElements == 4);
+      assertUnit(lDes.pHead == p);
+      assertUnit(p->pPrev == nullptr);
+      assertUnit(p->pNext == pOldHead);
+      assertUnit(pOldHead->pPrev == p);
+      assertUnit(lSrc.numElements == 2);
+      assertUnit(lSrc.pHead->pNext == lSrc.pTail);
+      assertUnit(lSrc.pTail->pPrev == lSrc.pHead);
+      assertUnit(lSrc.pHead->data == 11);
+      assertUnit(lSrc.pTail->data == 31);
+      // teardown
+      lDes.clear();
+      lSrc.clear();
+   }
+
+   // move the last two elements of one list into the middle of another
+   void test_splice_range()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  first          last = end
+      custom::list<int> lDes;
+      setupStandardFixture(lDes);
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<int>::iterator itPos(lDes.pHead->pNext);
+      custom::list<int>::iterator itFirst(lSrc.pHead->pNext);
+      // exercise
+      lDes.splice(itPos, lSrc, itFirst, lSrc.end());
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+
+      assertUnit(lDes.numElements == 5);
+      assertUnit(lSrc.numElements == 1);
+      assertUnit(lSrc.pHead == lSrc.pTail);
+      assertUnit(lSrc.pHead->pNext == nullptr);
+      int expected[] = { 11, 26, 31, 26, 31 };
+      int i = 0;
+      for (custom::list<int>::Node* p = lDes.pHead; p; p = p->pNext, i++)
+      {
+         assertUnit(i < 5 && p->data == expected[i]);
+         assertUnit(p->pNext != nullptr || p == lDes.pTail);
+         assertUnit(p->pNext == nullptr || p->pNext->pPrev == p);
+      }
+      assertUnit(i == 5);
+      // teardown
+      lDes.clear();
+      lSrc.clear();
+   }
+
+   // merge two sorted lists, keeping the original nodes
+   void test_merge_standard()
+   {  // setup
+      //       +----+   +----+   +----+        +----+   +----+
+      //       | 11 | - | 26 | - | 31 |   +    | 20 | - | 40 |
+      //       +----+   +----+   +----+        +----+   +----+
+      custom::list<int> lDes;
+      setupStandardFixture(lDes);
+      custom::list<int> lSrc;
+      lSrc.push_back(20);
+      lSrc.push_back(40);
+      custom::list<int>::Node* p20 = lSrc.pHead;
+      custom::list<int>::Node* p40 = lSrc.pTail;
+      // exercise
+      lDes.merge(lSrc);
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 20 | - | 26 | - | 31 | - | 40 |
+      //       +----+   +----+   +----+   +----+   +----+
+      assertEmptyFixture(lSrc);
+      assertUnit(lDes.numElements == 5);
+      assertUnit(lDes.pHead->pNext == p20);
+      assertUnit(lDes.pTail == p40);
+      int expected[] = { 11, 20, 26, 31, 40 };
+      int i = 0;
+      for (custom::list<int>::Node* p = lDes.pHead; p; p = p->pNext, i++)
+      {
+         assertUnit(i < 5 && p->data == expected[i]);
+         assertUnit(p->pNext == nullptr || p->pNext->pPrev == p);
+      }
+      assertUnit(i == 5);
+      // teardown
+      lDes.clear();
+   }
+
+   // sort a list in reverse order, relinking the nodes
+   void test_sort_standard()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 31 | - | 26 | - | 11 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      l.pHead->data = 31;
+      l.pTail->data = 11;
+      custom::list<int>::Node* p31 = l.pHead;
+      custom::list<int>::Node* p26 = l.pHead->pNext;
+      custom::list<int>::Node* p11 = l.pTail;
+      // exercise
+      l.sort();
+      // verify
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertStandardFixture(l);
+      assertUnit(l.pHead == p11);
+      assertUnit(l.pHead->pNext == p26);
+      assertUnit(l.pTail == p31);
+      assertUnit(l.pTail->pPrev == p26);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // sort a large list and make sure equal elements keep their order
+   void test_sort_stable()
+   {  // setup
+      custom::list<int> l;
+      std::list<int> lExpected;
+      for (int i = 0; i < 1000; i++)
+      {
+         l.push_back((i * 37) % 101);
+         lExpected.push_back((i * 37) % 101);
+      }
+      custom::list<int>::Node* pFirst = l.pHead;  // the first of the 0s
+      lExpected.sort();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(l.numElements == 1000);
+      assertUnit(l.pHead == pFirst);
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.pTail->pNext == nullptr);
+      bool same = true;
+      custom::list<int>::Node* p = l.pHead;
+      for (auto it = lExpected.begin(); it != lExpected.end(); ++it, p = p->pNext)
+         if (p == nullptr || p->data != *it || (p->pNext && p->pNext->pPrev != p))
+            same = false;
+      assertUnit(same);
+      // teardown
+      l.clear();
+   }
+
+   // remove consecutive duplicates
+   void test_unique_standard()
+   {  // setup
+      //       +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 11 | - | 26 | - | 31 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      l.push_front(11);
+      l.push_back(31);
+      // exercise
+      l.unique();
+      // verify
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // reverse the standard fixture
+   void test_reverse_standard()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p11 = l.pHead;
+      custom::list<int>::Node* p26 = l.pHead->pNext;
+      custom::list<int>::Node* p31 = l.pTail;
+      // exercise
+      l.reverse();
+      // verify
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 31 | - | 26 | - | 11 |
+      //       +----+   +----+   +----+
+      assertUnit(l.numElements == 3);
+      assertUnit(l.pHead == p31);
+      assertUnit(l.pTail == p11);
+      assertUnit(p31->pPrev == nullptr);
+      assertUnit(p31->pNext == p26);
+      assertUnit(p26->pPrev == p31);
+      assertUnit(p26->pNext == p11);
+      assertUnit(p11->pPrev == p26);
+      assertUnit(p11->pNext == nullptr);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
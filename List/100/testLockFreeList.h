@@ -0,0 +1,501 @@
+/***********************************************************************
+ * Header:
+ *    TEST LOCK-FREE LIST
+ * Summary:
+ *    Unit tests for lockfree_list and epoch
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lockfree_list.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <memory>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#undef assertSorted
+#define assertSorted(x) assertSortedParameters(x, __LINE__, __FUNCTION__)
+
+class TestLockFreeList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_insert_empty();
+      test_insert_sorted();
+      test_insert_duplicate();
+
+      // Remove
+      test_erase_empty();
+      test_erase_middle();
+      test_erase_missing();
+      test_erase_markedNodeUnlinked();
+
+      // Access
+      test_contains_standard();
+      test_contains_logicallyDeleted();
+
+      // Epoch
+      test_epoch_guardNests();
+      test_epoch_retireThenCollect();
+      test_epoch_pinnedBlocksAdvance();
+
+      // Concurrency
+      test_stress_disjointKeys();
+      test_stress_sameKeys();
+      test_stress_readersSeeStableKeys();
+
+      report("LockFreeList");
+   }
+
+   typedef custom::lockfree_list<int> List;
+   typedef List::Node Node;
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor
+   void test_construct_default()
+   {  // setup
+      // exercise
+      List l;
+      // verify
+      assertUnit(l.pHead.load() == 0);
+      assertUnit(l.size() == 0);
+      assertUnit(l.empty());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // insert into an empty list
+   void test_insert_empty()
+   {  // setup
+      List l;
+      // exercise
+      bool inserted = l.insert(26);
+      // verify
+      //    +----+
+      //    | 26 |
+      //    +----+
+      assertUnit(inserted);
+      assertUnit(l.size() == 1);
+      Node* p = List::pointer(l.pHead.load());
+      assertUnit(p != nullptr);
+      if (p)
+      {
+         assertUnit(p->data == 26);
+         assertUnit(p->pNext.load() == 0);
+      }
+   }  // teardown
+
+   // insert out of order, the list stays sorted
+   void test_insert_sorted()
+   {  // setup
+      List l;
+      // exercise
+      l.insert(31);
+      l.insert(11);
+      l.insert(26);
+      // verify
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      assertStandardFixture(l);
+   }  // teardown
+
+   // a duplicate is rejected
+   void test_insert_duplicate()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      // exercise
+      bool inserted = l.insert(26);
+      // verify
+      assertUnit(!inserted);
+      assertStandardFixture(l);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase from an empty list
+   void test_erase_empty()
+   {  // setup
+      List l;
+      // exercise
+      bool erased = l.erase(26);
+      // verify
+      assertUnit(!erased);
+      assertUnit(l.pHead.load() == 0);
+   }  // teardown
+
+   // erase the middle element
+   void test_erase_middle()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      // exercise
+      bool erased = l.erase(26);
+      // verify
+      //    +----+   +----+
+      //    | 11 | - | 31 |
+      //    +----+   +----+
+      assertUnit(erased);
+      assertUnit(l.size() == 2);
+      Node* p11 = List::pointer(l.pHead.load());
+      assertUnit(p11 && p11->data == 11);
+      if (p11)
+      {
+         Node* p31 = List::pointer(p11->pNext.load());
+         assertUnit(!List::isMarked(p11->pNext.load()));
+         assertUnit(p31 && p31->data == 31);
+      }
+   }  // teardown
+
+   // erase something that is not there
+   void test_erase_missing()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      // exercise
+      bool erased = l.erase(20);
+      // verify
+      assertUnit(!erased);
+      assertStandardFixture(l);
+   }  // teardown
+
+   // a node marked by a stalled eraser is unlinked by the next traversal
+   void test_erase_markedNodeUnlinked()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      Node* p11 = List::pointer(l.pHead.load());
+      Node* p26 = List::pointer(p11->pNext.load());
+      p26->pNext.fetch_or(List::MARK);  // logically deleted, still linked
+      l.numElements--;
+      uint64_t pendingBefore = custom::epoch::pending();
+      // exercise
+      bool inserted = l.insert(30);
+      // verify
+      //    +----+   +----+   +----+
+      //    | 11 | - | 30 | - | 31 |
+      //    +----+   +----+   +----+
+      assertUnit(inserted);
+      assertUnit(custom::epoch::pending() == pendingBefore + 1);
+      std::vector<int> values;
+      l.for_each([&values](int i) { values.push_back(i); });
+      assertUnit(values == std::vector<int>({ 11, 30, 31 }));
+      assertUnit(List::pointer(p11->pNext.load())->data == 30);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // contains finds the members and nothing else
+   void test_contains_standard()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      // exercise
+      // verify
+      assertUnit(l.contains(11));
+      assertUnit(l.contains(26));
+      assertUnit(l.contains(31));
+      assertUnit(!l.contains(10));
+      assertUnit(!l.contains(27));
+      assertUnit(!l.contains(99));
+      assertStandardFixture(l);
+   }  // teardown
+
+   // a marked node is already gone as far as contains is concerned
+   void test_contains_logicallyDeleted()
+   {  // setup
+      List l;
+      setupStandardFixture(l);
+      Node* p26 = List::pointer(List::pointer(l.pHead.load())->pNext.load());
+      p26->pNext.fetch_or(List::MARK);
+      // exercise
+      bool found = l.contains(26);
+      // verify
+      assertUnit(!found);
+      assertUnit(l.contains(31));
+   }  // teardown
+
+   /***************************************
+    * EPOCH
+    ***************************************/
+
+   // nested guards pin once and unpin once
+   void test_epoch_guardNests()
+   {  // setup
+      custom::epoch::Record* pRecord = custom::epoch::self();
+      // exercise
+      {
+         custom::epoch::guard g1;
+         assertUnit(pRecord->nesting == 1);
+         assertUnit((pRecord->state.load() & 1) == 1);
+         {
+            custom::epoch::guard g2;
+            assertUnit(pRecord->nesting == 2);
+         }
+         assertUnit((pRecord->state.load() & 1) == 1);
+      }
+      // verify
+      assertUnit(pRecord->nesting == 0);
+      assertUnit(pRecord->state.load() == 0);
+   }  // teardown
+
+   // retired memory is freed once the epoch has moved on twice
+   void test_epoch_retireThenCollect()
+   {  // setup
+      drain();
+      uint64_t pendingBefore = custom::epoch::pending();
+      // exercise
+      {
+         custom::epoch::guard g;
+         custom::epoch::retire(new int(26));
+         custom::epoch::retire(new int(31));
+      }
+      // verify
+      assertUnit(custom::epoch::pending() == pendingBefore + 2);
+      drain();
+      assertUnit(custom::epoch::pending() == pendingBefore);
+   }  // teardown
+
+   // a thread that stays pinned holds the epoch back
+   void test_epoch_pinnedBlocksAdvance()
+   {  // setup
+      drain();
+      uint64_t pendingBefore = custom::epoch::pending();
+      std::atomic<int> stage(0);
+      std::thread reader([&stage]()
+      {
+         custom::epoch::guard g;
+         stage = 1;
+         while (stage != 2)
+            std::this_thread::yield();
+      });
+      while (stage != 1)
+         std::this_thread::yield();
+      // exercise
+      {
+         custom::epoch::guard g;
+         custom::epoch::retire(new int(26));
+      }
+      for (int i = 0; i < 10; i++)
+         custom::epoch::collect();
+      uint64_t pendingWhilePinned = custom::epoch::pending();
+      stage = 2;
+      reader.join();
+      drain();
+      // verify
+      assertUnit(pendingWhilePinned == pendingBefore + 1);
+      assertUnit(custom::epoch::pending() == pendingBefore);
+   }  // teardown
+
+   /***************************************
+    * CONCURRENCY
+    ***************************************/
+
+   // each thread owns a range of keys, so every result is predictable
+   void test_stress_disjointKeys()
+   {  // setup
+      List l;
+      const int numThreads = 8;
+      const int numKeys = 500;
+      std::vector<std::thread> threads;
+      std::atomic<int> numWrong(0);
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&l, &numWrong, t, numKeys]()
+         {
+            int base = t * numKeys;
+            for (int round = 0; round < 4; round++)
+            {
+               for (int i = 0; i < numKeys; i++)
+                  if (!l.insert(base + i))
+                     numWrong++;
+               for (int i = 0; i < numKeys; i += 2)
+                  if (!l.erase(base + i))
+                     numWrong++;
+               for (int i = 0; i < numKeys; i++)
+                  if (l.contains(base + i) != (i % 2 == 1))
+                     numWrong++;
+               for (int i = 1; i < numKeys; i += 2)
+                  if (!l.erase(base + i))
+                     numWrong++;
+            }
+            l.insert(base);
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      // verify
+      assertUnit(numWrong == 0);
+      assertUnit(l.size() == numThreads);
+      assertSorted(l);
+   }  // teardown
+
+   // every thread fights over the same keys: exactly one insert and one
+   // erase of each key may succeed
+   void test_stress_sameKeys()
+   {  // setup
+      List l;
+      const int numThreads = 8;
+      const int numKeys = 2000;
+      std::vector<std::thread> threads;
+      std::atomic<int> numInserted(0);
+      std::atomic<int> numErased(0);
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&, t]()
+         {
+            for (int i = 0; i < numKeys; i++)
+               if (l.insert((i * 7 + t) % numKeys))
+                  numInserted++;
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      size_t sizeFull = l.size();
+      threads.clear();
+      for (int t = 0; t < numThreads; t++)
+         threads.push_back(std::thread([&, t]()
+         {
+            for (int i = 0; i < numKeys; i++)
+               if (l.erase((i * 13 + t) % numKeys))
+                  numErased++;
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      // verify
+      assertUnit(numInserted == numKeys);
+      assertUnit(sizeFull == numKeys);
+      assertUnit(numErased == numKeys);
+      assertUnit(l.empty());
+      assertUnit(List::pointer(l.pHead.load()) == nullptr);
+   }  // teardown
+
+   // writers churn the odd keys while readers check the even keys,
+   // which are never removed, are always visible
+   void test_stress_readersSeeStableKeys()
+   {  // setup
+      List l;
+      const int numKeys = 1000;
+      for (int i = 0; i < numKeys; i += 2)
+         l.insert(i);
+      std::atomic<bool> done(false);
+      std::atomic<int> numMissing(0);
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&, t]()
+         {
+            for (int round = 0; round < 20; round++)
+               for (int i = 1 + 2 * t; i < numKeys; i += 8)
+               {
+                  l.insert(i);
+                  l.erase(i);
+               }
+         }));
+      for (int t = 0; t < 4; t++)
+         threads.push_back(std::thread([&]()
+         {
+            while (!done)
+               for (int i = 0; i < numKeys; i += 2)
+                  if (!l.contains(i))
+                     numMissing++;
+         }));
+      for (int t = 0; t < 4; t++)
+         threads[t].join();
+      done = true;
+      for (size_t t = 4; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(numMissing == 0);
+      assertUnit(l.size() == numKeys / 2);
+      assertSorted(l);
+   }  // teardown
+
+   /****************************************************************
+    * Setup Standard Fixture
+    *    +----+   +----+   +----+
+    *    | 11 | - | 26 | - | 31 |
+    *    +----+   +----+   +----+
+    ****************************************************************/
+   void setupStandardFixture(List& l)
+   {
+      Node* p31 = new Node(31);
+      Node* p26 = new Node(26);
+      Node* p11 = new Node(11);
+      p26->pNext.store(reinterpret_cast<uintptr_t>(p31));
+      p11->pNext.store(reinterpret_cast<uintptr_t>(p26));
+      l.pHead.store(reinterpret_cast<uintptr_t>(p11));
+      l.numElements = 3;
+   }
+
+   /****************************************************************
+    * Verify Standard Fixture
+    ****************************************************************/
+   void assertStandardFixtureParameters(const List& l, int line, const char* function)
+   {
+      assertIndirect(l.size() == 3);
+      Node* p = List::pointer(l.pHead.load());
+      int expected[] = { 11, 26, 31 };
+      for (int i = 0; i < 3; i++)
+      {
+         assertIndirect(p != nullptr);
+         if (p == nullptr)
+            return;
+         assertIndirect(p->data == expected[i]);
+         assertIndirect(!List::isMarked(p->pNext.load()));
+         p = List::pointer(p->pNext.load());
+      }
+      assertIndirect(p == nullptr);
+   }
+
+   /****************************************************************
+    * Verify the list is strictly increasing and has no marked nodes
+    ****************************************************************/
+   void assertSortedParameters(const List& l, int line, const char* function)
+   {
+      size_t num = 0;
+      Node* pPrev = nullptr;
+      for (Node* p = List::pointer(l.pHead.load()); p; p = List::pointer(p->pNext.load()))
+      {
+         assertIndirect(!List::isMarked(p->pNext.load()));
+         assertIndirect(pPrev == nullptr || pPrev->data < p->data);
+         pPrev = p;
+         num++;
+      }
+      assertIndirect(num == l.size());
+   }
+
+   /****************************************************************
+    * Free everything this thread has retired
+    ****************************************************************/
+   void drain()
+   {
+      for (int i = 0; i < 4; i++)
+         custom::epoch::collect();
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,297 @@
+/***********************************************************************
+ * Header:
+ *    Bench
+ * Summary:
+ *    Driver to time the ordered containers behind map. It has its own
+ *    main(), so it is not part of the project; build it on its own,
+ *    with optimization:
+ *        g++ -std=c++14 -O2 benchMap.cpp
+ *    Name sections to run only those:
+ *        ./a.out btree
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "map.h"         // for map on a BST or a skiplist
+#include "btree_map.h"   // for btree_map
+#include <algorithm>     // for std::shuffle
+#include <chrono>
+#include <cstddef>       // for std::max_align_t
+#include <cstdio>
+#include <cstdlib>       // for std::malloc
+#include <cstring>
+#include <map>
+#include <new>
+#include <random>
+#include <vector>
+
+/**********************************************************************
+ * OPERATOR NEW
+ * Every allocation keeps its size just in front of it, so liveBytes
+ * is what the containers hold at any moment
+ ***********************************************************************/
+size_t liveBytes = 0;
+const size_t HEADER = sizeof(std::max_align_t);
+
+// malloc() and free() behind calls the optimizer cannot see through.
+// Inlined, GCC would find free() on memory from a new-expression and
+// warn with -Wmismatched-new-delete, though the two do match here
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+void* rawAlloc(size_t size)
+{
+   return std::malloc(size);
+}
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+void rawFree(void* p)
+{
+   std::free(p);
+}
+
+void* operator new(size_t size)
+{
+   char* p = static_cast<char*>(rawAlloc(size + HEADER));
+   if (p == nullptr)
+      throw std::bad_alloc();
+   *reinterpret_cast<size_t*>(p) = size;
+   liveBytes += size;
+   return p + HEADER;
+}
+void operator delete(void* p) noexcept
+{
+   if (p == nullptr)
+      return;
+   char* pRaw = static_cast<char*>(p) - HEADER;
+   liveBytes -= *reinterpret_cast<size_t*>(pRaw);
+   rawFree(pRaw);
+}
+void operator delete(void* p, size_t) noexcept
+{
+   operator delete(p);
+}
+
+/**********************************************************************
+ * MILLISECONDS SINCE
+ ***********************************************************************/
+double msSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// what the timed loops add up, printed so none of them is optimized away
+long long sink = 0;
+
+/**********************************************************************
+ * KEYS
+ * 0 .. num-1, in order or shuffled
+ ***********************************************************************/
+std::vector<int> keys(int num, bool isShuffled)
+{
+   std::vector<int> v;
+   for (int i = 0; i < num; i++)
+      v.push_back(i);
+   if (isShuffled)
+      std::shuffle(v.begin(), v.end(), std::mt19937(42));
+   return v;
+}
+
+/**********************************************************************
+ * TIME MAP
+ * Insert the keys in order and shuffled, then time finding each
+ * once, walking numScans windows of scanLength pairs from a found
+ * key, and one walk over everything. Also what the shuffled map
+ * holds on the heap, per pair
+ ***********************************************************************/
+template <class Map>
+void timeMap(const char* name, int num, int numScans, int scanLength)
+{
+   std::vector<int> ordered = keys(num, false);
+   std::vector<int> shuffled = keys(num, true);
+
+   auto start = std::chrono::steady_clock::now();
+   {
+      Map m;
+      for (int k : ordered)
+         m.insert(custom::pair<int, int>(k, k));
+      sink += static_cast<long long>(m.size());
+   }
+   double msOrdered = msSince(start);
+
+   size_t liveBefore = liveBytes;
+   Map m;
+   start = std::chrono::steady_clock::now();
+   for (int k : shuffled)
+      m.insert(custom::pair<int, int>(k, k));
+   double msShuffled = msSince(start);
+   double bytesPerPair = static_cast<double>(liveBytes - liveBefore) / num;
+
+   start = std::chrono::steady_clock::now();
+   for (int k : shuffled)
+      sink += (*m.find(k)).second;
+   double msFind = msSince(start);
+
+   start = std::chrono::steady_clock::now();
+   for (int i = 0; i < numScans; i++)
+   {
+      auto it = m.find(shuffled[i]);
+      for (int j = 0; j < scanLength && it != m.end(); j++, ++it)
+         sink += (*it).second;
+   }
+   double msScan = msSince(start);
+
+   start = std::chrono::steady_clock::now();
+   for (auto it = m.begin(); it != m.end(); ++it)
+      sink += (*it).second;
+   double msWalk = msSince(start);
+
+   printf("%-10s %12.0f %12.0f %10.0f %10.0f %10.0f %10.1f\n",
+          name, msOrdered, msShuffled, msFind, msScan, msWalk, bytesPerPair);
+}
+
+/**********************************************************************
+ * SKIP LIST
+ * map on the skiplist against map on the BST
+ ***********************************************************************/
+void benchSkipList()
+{
+   const int NUM = 1000000;
+   const int NUM_SCANS = 10000;
+   const int SCAN_LENGTH = 100;
+   printf("map backends, %d keys, %d scans of %d, times in ms\n", NUM, NUM_SCANS, SCAN_LENGTH);
+   printf("%-10s %12s %12s %10s %10s %10s %10s\n",
+          "backend", "insert asc", "insert rand", "find", "scans", "walk all", "bytes/pair");
+   timeMap<custom::map<int, int>>("BST", NUM, NUM_SCANS, SCAN_LENGTH);
+   timeMap<custom::map<int, int, custom::skiplist<custom::pair<int, int>>>>("skiplist", NUM, NUM_SCANS, SCAN_LENGTH);
+}
+
+/**********************************************************************
+ * B-TREE
+ * btree_map with two, four (the default) and eight cache lines a
+ * node, against map on the BST
+ ***********************************************************************/
+void benchBTree()
+{
+   const int NUM = 1000000;
+   const int NUM_SCANS = 10000;
+   const int SCAN_LENGTH = 100;
+   printf("btree_map vs map, %d keys, %d scans of %d, times in ms\n", NUM, NUM_SCANS, SCAN_LENGTH);
+   printf("%-10s %12s %12s %10s %10s %10s %10s\n",
+          "map", "insert asc", "insert rand", "find", "scans", "walk all", "bytes/pair");
+   timeMap<custom::map<int, int>>("BST", NUM, NUM_SCANS, SCAN_LENGTH);
+   timeMap<custom::btree_map<int, int, std::less<int>, 128>>("btree 128", NUM, NUM_SCANS, SCAN_LENGTH);
+   timeMap<custom::btree_map<int, int>>("btree 256", NUM, NUM_SCANS, SCAN_LENGTH);
+   timeMap<custom::btree_map<int, int, std::less<int>, 512>>("btree 512", NUM, NUM_SCANS, SCAN_LENGTH);
+}
+
+/**********************************************************************
+ * TIME WINDOW
+ * 10M pairs keyed by timestamps 10 apart, inserted in order as a log
+ * would, then again shuffled. Each query sums the pairs in [t0, t1)
+ * for a window of 10, 1K or 100K pairs: from begin() as before
+ * lower_bound(), with lower_bound() and the iterator, with the
+ * range() view, and with std::map::lower_bound() for scale
+ ***********************************************************************/
+void benchRange()
+{
+   const int NUM = 10000000;
+   const int STEP = 10;
+   printf("time-window queries, %d pairs, us per query\n", NUM);
+   printf("%-9s %8s %8s %12s %12s %12s %12s\n",
+          "insert", "window", "queries", "from begin", "lower_bound", "range", "std::map");
+   for (bool isShuffled : { false, true })
+   {
+      custom::map<int, int> m;
+      std::map<int, int> mStd;
+      for (int k : keys(NUM, isShuffled))
+      {
+         m.insert(custom::pair<int, int>(k * STEP, k));
+         mStd.insert(std::pair<int, int>(k * STEP, k));
+      }
+
+      std::mt19937 random(7);
+      for (int width : { 10, 1000, 100000 })
+      {
+         int numQueries = 1000000 / width;
+         std::vector<int> starts;
+         for (int i = 0; i < numQueries; i++)
+            starts.push_back(static_cast<int>(random() % (NUM - width)) * STEP + STEP / 2);
+
+         // from begin() only for the first few: each walks half the map
+         int numFromBegin = std::min(numQueries, 3);
+         auto start = std::chrono::steady_clock::now();
+         for (int i = 0; i < numFromBegin; i++)
+         {
+            int lo = starts[i];
+            int hi = lo + width * STEP;
+            auto it = m.begin();
+            while (it != m.end() && (*it).first < lo)
+               ++it;
+            for (; it != m.end() && (*it).first < hi; ++it)
+               sink += (*it).second;
+         }
+         double usFromBegin = msSince(start) * 1e3 / numFromBegin;
+
+         start = std::chrono::steady_clock::now();
+         for (int lo : starts)
+         {
+            int hi = lo + width * STEP;
+            for (auto it = m.lower_bound(lo); it != m.end() && (*it).first < hi; ++it)
+               sink += (*it).second;
+         }
+         double usBound = msSince(start) * 1e3 / numQueries;
+
+         start = std::chrono::steady_clock::now();
+         for (int lo : starts)
+            for (const custom::pair<int, int>& p : m.range(lo, lo + width * STEP))
+               sink += p.second;
+         double usRange = msSince(start) * 1e3 / numQueries;
+
+         start = std::chrono::steady_clock::now();
+         for (int lo : starts)
+         {
+            int hi = lo + width * STEP;
+            for (auto it = mStd.lower_bound(lo); it != mStd.end() && it->first < hi; ++it)
+               sink += it->second;
+         }
+         double usStd = msSince(start) * 1e3 / numQueries;
+
+         printf("%-9s %8d %8d %12.1f %12.2f %12.2f %12.2f\n", isShuffled ? "shuffled" : "ascending",
+                width, numQueries, usFromBegin, usBound, usRange, usStd);
+      }
+   }
+}
+
+/**********************************************************************
+ * MAIN
+ * Every section, or just the ones named on the command line
+ ***********************************************************************/
+int main(int argc, const char* argv[])
+{
+   struct Section
+   {
+      const char* name;
+      void (*bench)();
+   } sections[] =
+   {
+      { "skiplist",      benchSkipList      },
+      { "btree",         benchBTree         },
+      { "range",         benchRange         },
+   };
+
+   for (const Section& section : sections)
+   {
+      bool isNamed = argc == 1;
+      for (int i = 1; i < argc; i++)
+         isNamed = isNamed || strcmp(argv[i], section.name) == 0;
+      if (isNamed)
+      {
+         section.bench();
+         printf("\n");
+      }
+   }
+   printf("(%lld)\n", sink);
+   return 0;
+}
@@ -25,11 +25,29 @@
 #define debug(x)
 #endif // !DEBUG
 
+// Define BST_ORDER_STATISTICS before including bst.h to have every node
+// keep the size of its subtree, which select(), rank() and iterator
+// += and -= need. statement only runs when it is defined
+#ifdef BST_ORDER_STATISTICS
+#define BST_ORDER(statement) statement
+#else
+#define BST_ORDER(statement) ((void)0)
+#endif // BST_ORDER_STATISTICS
+
 #include <cassert>
+#include <cstddef>    // for ptrdiff_t and std::max_align_t
 #include <utility>
 #include <memory>     // for std::allocator
+#include <new>        // for std::align_val_t
+#include <atomic>     // for the count of live nodes in a block
 #include <functional> // for std::less
+#include <iterator>   // for std::iterator_traits and std::make_move_iterator
 #include <utility>    // for std::pair
+#include <vector>     // for the range_view iterator's stack and assign's buffer
+#include <algorithm>  // for std::reverse and std::max
+#include <future>     // for std::async in the parallel set operations
+#include <system_error> // for std::system_error when no thread can be had
+#include <thread>     // for std::thread::hardware_concurrency
 
 class TestBST; // forward declaration for unit tests
 class TestMap;
@@ -40,7 +58,7 @@ namespace custom
 
 	template <class TT>
 	class set;
-	template <class KK, class VV>
+	template <class KK, class VV, class CC>
 	class map;
 
 	/*****************************************************************
@@ -54,7 +72,7 @@ namespace custom
 		friend class ::TestMap;
 		friend class ::TestSet;
 
-		template <class KK, class VV>
+		template <class KK, class VV, class CC>
 		friend class map;
 
 		template <class TT>
@@ -71,6 +89,8 @@ namespace custom
 		BST(const BST& rhs);
 		BST(BST&& rhs) noexcept;
 		BST(const std::initializer_list<T>& il);
+		template <class Iterator>
+		BST(Iterator first, Iterator last);
 		~BST();
 
 		//
@@ -82,6 +102,17 @@ namespace custom
 		BST& operator = (const std::initializer_list<T>& il);
 		void swap(BST& rhs);
 
+		// replace everything with [first, last): O(n) when it is already
+		// in order (and, with keepUnique, without duplicates), with the
+		// nodes in one block, and one insert() at a time when it is not
+		template <class Iterator>
+		void assign(Iterator first, Iterator last) { assign(first, last, std::less<T>(), false); }
+		template <class Iterator, class Less>
+		void assign(Iterator first, Iterator last, Less less, bool keepUnique)
+		{
+			assign(first, last, less, keepUnique, typename std::iterator_traits<Iterator>::iterator_category());
+		}
+
 		//
 		// Iterator
 		//
@@ -95,6 +126,44 @@ namespace custom
 		//
 
 		iterator find(const T& t);
+		template <class Key, class KeyLess>
+		iterator find(const Key& k, KeyLess less);
+
+		//
+		// Bounds: the first element not less than t, the first
+		// greater than t, and the run between them
+		//
+		iterator lower_bound(const T& t) const { return lower_bound(t, std::less<T>()); }
+		iterator upper_bound(const T& t) const { return upper_bound(t, std::less<T>()); }
+		std::pair<iterator, iterator> equal_range(const T& t) const { return equal_range(t, std::less<T>()); }
+		template <class Key, class KeyLess>
+		iterator lower_bound(const Key& k, KeyLess less) const { return iterator(lowerBound(k, less)); }
+		template <class Key, class KeyLess>
+		iterator upper_bound(const Key& k, KeyLess less) const { return iterator(upperBound(k, less)); }
+		template <class Key, class KeyLess>
+		std::pair<iterator, iterator> equal_range(const Key& k, KeyLess less) const
+		{
+			return std::pair<iterator, iterator>(lower_bound(k, less), upper_bound(k, less));
+		}
+
+		//
+		// Range: the elements in [lo, hi), walked in place
+		//
+		class range_view;
+		range_view range(const T& lo, const T& hi) const { return range(lo, hi, std::less<T>()); }
+		template <class Key, class KeyLess>
+		range_view range(const Key& lo, const Key& hi, KeyLess less) const;
+
+#ifdef BST_ORDER_STATISTICS
+		//
+		// Order statistics: the element at a position, and the
+		// position of an element, both O(log n)
+		//
+		iterator select(size_t k) const;
+		size_t rank(const T& t) const;
+		template <class Key, class KeyLess>
+		size_t rank(const Key& k, KeyLess less) const;
+#endif // BST_ORDER_STATISTICS
 
 		// 
 		// Insert
@@ -103,6 +172,14 @@ namespace custom
 		std::pair<iterator, bool> insert(const T& t, bool keepUnique = false);
 		std::pair<iterator, bool> insert(T&& t, bool keepUnique = false);
 
+		// find k, or put make() where the search for it ended: one
+		// descent, and nothing is made when k is already there
+		template <class Key, class KeyLess, class Make>
+		std::pair<iterator, bool> find_or_insert(const Key& k, KeyLess less, Make make);
+		// the same, but first try right before hint
+		template <class Key, class KeyLess, class Make>
+		std::pair<iterator, bool> find_or_insert(iterator hint, const Key& k, KeyLess less, Make make);
+
 		//
 		// Remove
 		// 
@@ -110,21 +187,103 @@ namespace custom
 		iterator erase(iterator& it);
 		void clear() noexcept;
 
+		//
+		// Split and join, moving nodes rather than copying: join is
+		// O(log n), and so is split with BST_ORDER_STATISTICS. Without
+		// it split has to count what it moved, which is O(n)
+		//
+
+		BST split(const T& t);      // keep what is less than t, return the rest
+		void join(BST&& rhs);       // rhs has nothing less than anything here
+
+		//
+		// Set algebra: O(m log(n/m + 1)) for sizes m <= n. Elements that
+		// are equal count once, and it is ours that stays. rhs is left
+		// empty. isParallel forks the two halves of the top few levels
+		//
+
+		void unite(BST&& rhs, bool isParallel = false);
+		void intersect(BST&& rhs, bool isParallel = false);
+		void subtract(BST&& rhs, bool isParallel = false);
+
 		// 
 		// Status
 		//
 
 	bool empty() const noexcept { return size() == 0; }
 	size_t size() const noexcept { return numElements; }
+	// the most nodes on any path down from the root. O(n)
+	size_t height() const noexcept { return heightOf(root); }
 
+#ifdef DEBUG
+		// 
+		// Validate: every red-black and ordering invariant holds
+		//
+		bool validate() const;
+#endif // DEBUG
 
 	private:
 
 		class BNode;
+		struct Block;
+
+		// the nodes behind lower_bound() and upper_bound()
+		template <class Key, class KeyLess>
+		BNode* lowerBound(const Key& k, KeyLess less) const;
+		template <class Key, class KeyLess>
+		BNode* upperBound(const Key& k, KeyLess less) const;
+
+		// red-black balancing
+
+		void rotateLeft(BNode* pNode);
+		void rotateRight(BNode* pNode);
+		void balanceInsert(BNode* pNode);
+		void balanceErase(BNode* pNode, BNode* pParent);
+		void replace(BNode* pOld, BNode* pNew);
+		iterator attach(BNode* pParent, bool isLeft, BNode* pNew);
+#ifdef BST_ORDER_STATISTICS
+		static size_t sizeOf(const BNode* pNode) { return pNode ? pNode->numSubtree : 0; }
+#endif // BST_ORDER_STATISTICS
+
+		// split and join on detached subtrees: no parent, black root
+		BNode* joinNodes(BNode* pLeft, BNode* pMid, BNode* pRight);
+		BNode* joinNodes(BNode* pLeft, BNode* pRight);
+		BNode* splitLast(BNode* pNode, BNode*& pLast);
+		template <class IsLeft>
+		void splitNodes(BNode* pNode, IsLeft isLeft, BNode*& pLeft, BNode*& pRight);
+		void splitNodes(BNode* pNode, const T& t, BNode*& pLess, BNode*& pEqual, BNode*& pGreater);
+		BNode* uniteNodes(BNode* pLhs, BNode* pRhs, size_t& numRemoved, int forks);
+		BNode* intersectNodes(BNode* pLhs, BNode* pRhs, size_t& numKept, int forks);
+		BNode* subtractNodes(BNode* pLhs, BNode* pRhs, size_t& numRemoved, int forks);
+		// a subtree with fewer black nodes down it is merged inline: at least
+		// 2^10 - 1 nodes are worth a thread
+		static const size_t FORK_MIN_BLACK_HEIGHT = 10;
+		template <class Left, class Right>
+		static void forkJoin(Left left, Right right, int forks, const BNode* pLhs, const BNode* pRhs);
+		static int forksFor(bool isParallel);
+		static BNode* detach(BNode* pNode);
+		static size_t blackHeightOf(const BNode* pNode);
+		static size_t numNodes(const BNode* pNode);
+		static size_t heightOf(const BNode* pNode) noexcept;
 
-		void deleteNode(BNode*& pDelete, bool toRight);
 		void deleteBinaryTree(BNode*& pDelete) noexcept;
 		void copyBinaryTree(const BNode* pSrc, BNode*& pDest);
+		// assign() reads a forward range twice, to check its order and to
+		// build; a single-pass range is moved into a buffer first
+		template <class Iterator, class Less>
+		void assign(Iterator first, Iterator last, Less less, bool keepUnique, std::forward_iterator_tag);
+		template <class Iterator, class Less>
+		void assign(Iterator first, Iterator last, Less less, bool keepUnique, std::input_iterator_tag)
+		{
+			std::vector<T> buffer(first, last);
+			assign(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()),
+			       less, keepUnique, std::forward_iterator_tag());
+		}
+		template <class Iterator>
+		BNode* buildSorted(Iterator& it, size_t num, size_t depth, size_t redDepth, Block* pBlock, char*& pCell);
+#ifdef DEBUG
+		int blackHeight(const BNode* pNode, size_t& num) const;
+#endif // DEBUG
 
 		BNode* root;              // root node of the binary search tree
 		size_t numElements;        // number of elements currently in the tree
@@ -147,6 +306,12 @@ namespace custom
 		BNode(const T& t) : data(t), pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true) {}
 		BNode(T&& t) : data(std::move(t)), pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true) {}
 
+		//
+		// Allocate
+		//
+		static void* operator new(size_t size);
+		static void operator delete(void* p) noexcept;
+
 		//
 		// Insert
 		//
@@ -178,6 +343,40 @@ namespace custom
 		BNode* pRight;         // Right child - larger
 		BNode* pParent;        // Parent
 		bool isRed;              // Red-black balancing stuff
+#ifdef BST_ORDER_STATISTICS
+		size_t numSubtree = 1;   // this node and everything below it
+#endif // BST_ORDER_STATISTICS
+	};
+
+	/*****************************************************************
+	 * BST :: BLOCK
+	 * Room for many nodes side by side, each cell a Header and then a
+	 * BNode. A bulk build fills one. The block is freed when the last
+	 * of its nodes is deleted, from whichever tree it ended up in
+	 *****************************************************************/
+	template <typename T>
+	struct alignas(alignof(typename BST <T> ::BNode)) BST <T> ::Block
+	{
+		/*************************************************************
+		 * HEADER
+		 * Sits immediately before every node. pBlock is nullptr for a
+		 * node that was allocated alone
+		 *************************************************************/
+		struct alignas(alignof(BNode)) Header
+		{
+			Block* pBlock;
+		};
+		static const size_t CELL = sizeof(Header) + sizeof(BNode);
+
+		Block(size_t num) : numLive(num) {}
+		char* cells() { return reinterpret_cast<char*>(this + 1); }
+
+		static void* allocate(size_t size);
+		static void deallocate(void* p) noexcept;
+		static Block* create(size_t num);
+		static void release(Block* pBlock, size_t num) noexcept;
+
+		std::atomic<size_t> numLive;   // nodes not yet deleted, and any hold on the block
 	};
 
 	/**********************************************************
@@ -191,7 +390,7 @@ namespace custom
 		friend class ::TestMap;
 		friend class ::TestSet;
 
-		template <class KK, class VV>
+		template <class KK, class VV, class CC>
 		friend class map;
 
 		template <class TT>
@@ -238,8 +437,16 @@ namespace custom
 			return tmp;
 		}
 
-		// must give friend status to remove so it can call getNode() from it
-		friend BST <T> ::iterator BST <T> ::erase(iterator& it);
+#ifdef BST_ORDER_STATISTICS
+		// jump n elements in O(log n). Past either end is end(),
+		// and end() cannot jump back because it has no tree
+		iterator& operator += (ptrdiff_t n);
+		iterator& operator -= (ptrdiff_t n) { return *this += -n; }
+#endif // BST_ORDER_STATISTICS
+
+		// must give friend status to the BST so erase() and the inserts
+		// that start from a hint can get at the node
+		friend class BST <T>;
 
 	private:
 
@@ -248,6 +455,70 @@ namespace custom
 	};
 
 
+	/**********************************************************
+	 * BST RANGE VIEW
+	 * The elements in [lo, hi) as something to use in a
+	 * range-based for. Its iterator keeps the nodes still to
+	 * visit on a stack, so ++ pops one and pushes the left
+	 * spine of its right subtree: no climbing back up through
+	 * parents, and no comparisons once the view is made.
+	 * Changing the tree invalidates the view
+	 *********************************************************/
+	template <typename T>
+	class BST <T> ::range_view
+	{
+		friend class ::TestBST; // give unit tests access to the privates
+		friend class ::TestMap;
+	public:
+		class iterator
+		{
+			friend class range_view;
+		public:
+			iterator() : pEnd(nullptr) {}
+
+			bool operator == (const iterator& rhs) const { return current() == rhs.current(); }
+			bool operator != (const iterator& rhs) const { return current() != rhs.current(); }
+
+			const T& operator * () const { return stack.back()->data; }
+
+			iterator& operator ++ ()
+			{
+				BNode* p = stack.back();
+				stack.pop_back();
+				for (p = p->pRight; p; p = p->pLeft)
+					stack.push_back(p);
+				return *this;
+			}
+			iterator operator ++ (int)
+			{
+				iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+		private:
+			// the node we are on, or nullptr once at hi or out of nodes
+			const BNode* current() const
+			{
+				return (stack.empty() || stack.back() == pEnd) ? nullptr : stack.back();
+			}
+
+			std::vector<BNode*> stack;   // the back is the current node
+			const BNode* pEnd;           // the first node not in the range
+		};
+
+		range_view(BNode* pFirst, BNode* pEnd) : pFirst(pFirst), pEnd(pEnd) {}
+
+		iterator begin() const;
+		iterator end() const { return iterator(); }
+		bool empty() const { return pFirst == pEnd; }
+
+	private:
+		BNode* pFirst;    // the first node in the range
+		BNode* pEnd;      // the first node after it, nullptr past the last
+	};
+
+
 	/*********************************************
 	 *********************************************
 	 *********************************************
@@ -296,10 +567,18 @@ namespace custom
 	template <typename T>
 	BST <T> ::BST(const std::initializer_list<T>& il) : root(nullptr), numElements(0)
 	{
-		for (const T& element : il)
-		{
-			insert(element);
-		}
+		assign(il.begin(), il.end());
+	}
+
+	/*********************************************
+	 * BST :: RANGE CONSTRUCTOR
+	 * Create a BST from [first, last)
+	 ********************************************/
+	template <typename T>
+	template <class Iterator>
+	BST <T> ::BST(Iterator first, Iterator last) : root(nullptr), numElements(0)
+	{
+		assign(first, last);
 	}
 
 	/*********************************************
@@ -333,13 +612,60 @@ namespace custom
 	template <typename T>
 	BST <T>& BST <T> :: operator = (const std::initializer_list<T>& il)
 	{
-		deleteBinaryTree(root);
-		numElements = 0;
+		assign(il.begin(), il.end());
+		return *this;
+	}
+
+	/*********************************************
+	 * BST :: ASSIGN
+	 * One pass to count and to see whether the input
+	 * is already in order. If it is, build the tree
+	 * straight from it; if not, insert one at a time
+	 ********************************************/
+	template <typename T>
+	template <class Iterator, class Less>
+	void BST <T> ::assign(Iterator first, Iterator last, Less less, bool keepUnique, std::forward_iterator_tag)
+	{
+		clear();
 
-		for (auto&& element : il)
-			insert(element);
+		size_t num = 0;
+		bool isSorted = true;
+		for (Iterator it = first, itPrev = first; it != last; itPrev = it, ++it, num++)
+			if (num != 0 && isSorted)
+				isSorted = keepUnique ? less(*itPrev, *it) : !less(*it, *itPrev);
 
-		return *this;
+		if (!isSorted)
+		{
+			for (; first != last; ++first)
+				insert(*first, keepUnique);
+			return;
+		}
+
+		// the levels that will be full are black, and the partial
+		// one under them (if any) is red
+		size_t redDepth = 0;
+		while ((size_t(2) << redDepth) - 1 <= num)
+			redDepth++;
+
+		if (num == 0)
+			return;
+
+		// every cell counts as live, plus our hold while we build
+		Block* pBlock = Block::create(num + 1);
+		char* pCell = pBlock->cells();
+		try
+		{
+			root = buildSorted(first, num, 0, redDepth, pBlock, pCell);
+		}
+		catch (...)
+		{
+			// what was built has been deleted; the rest never will be
+			size_t numBuilt = (pCell - pBlock->cells()) / Block::CELL;
+			Block::release(pBlock, num - numBuilt + 1);
+			throw;
+		}
+		Block::release(pBlock, 1);
+		numElements = num;
 	}
 
 	/*********************************************
@@ -380,6 +706,7 @@ namespace custom
 			{
 				assert(numElements == 0);
 				root = new BNode(t);
+				root->isRed = false;
 				numElements = 1;
 				pairReturn.first = iterator(root);
 				pairReturn.second = true;
@@ -388,6 +715,7 @@ namespace custom
 
 			// otherwise, go a searching for the correct spot
 			BNode* node = root;
+			BNode* pNew = nullptr;
 			bool done = false;
 			while (!done)
 			{
@@ -409,7 +737,8 @@ namespace custom
 					{
 						node->addLeft(t);
 						done = true;
-						pairReturn.first = iterator(node->pLeft);
+						pNew = node->pLeft;
+						pairReturn.first = iterator(pNew);
 						pairReturn.second = true;
 					}
 				}
@@ -424,7 +753,8 @@ namespace custom
 					{
 						node->addRight(t);
 						done = true;
-						pairReturn.first = iterator(node->pRight);
+						pNew = node->pRight;
+						pairReturn.first = iterator(pNew);
 						pairReturn.second = true;
 					}
 				}
@@ -432,9 +762,10 @@ namespace custom
 
 			assert(root != nullptr);
 			numElements++;
+			BST_ORDER(for (BNode* p = pNew->pParent; p; p = p->pParent) p->numSubtree++);
 
-			while (root->pParent != nullptr)
-				root = root->pParent;
+			// the rotations keep root current as they go
+			balanceInsert(pNew);
 			assert(root->pParent == nullptr);
 		}
 		catch (...)
@@ -455,6 +786,7 @@ namespace custom
 			{
 				assert(numElements == 0);
 				root = new BNode(std::move(t));
+				root->isRed = false;
 				numElements = 1;
 				pairReturn.first = iterator(root);
 				pairReturn.second = true;
@@ -463,6 +795,7 @@ namespace custom
 
 			// otherwise, go a searching for the correct spot
 			BNode* node = root;
+			BNode* pNew = nullptr;
 			bool done = false;
 			while (!done)
 			{
@@ -484,7 +817,8 @@ namespace custom
 					{
 						node->addLeft(std::move(t));
 						done = true;
-						pairReturn.first = iterator(node->pLeft);
+						pNew = node->pLeft;
+						pairReturn.first = iterator(pNew);
 						pairReturn.second = true;
 					}
 				}
@@ -499,7 +833,8 @@ namespace custom
 					{
 						node->addRight(std::move(t));
 						done = true;
-						pairReturn.first = iterator(node->pRight);
+						pNew = node->pRight;
+						pairReturn.first = iterator(pNew);
 						pairReturn.second = true;
 					}
 				}
@@ -507,9 +842,10 @@ namespace custom
 
 			assert(root != nullptr);
 			numElements++;
+			BST_ORDER(for (BNode* p = pNew->pParent; p; p = p->pParent) p->numSubtree++);
 
-			while (root->pParent != nullptr)
-				root = root->pParent;
+			// the rotations keep root current as they go
+			balanceInsert(pNew);
 			assert(root->pParent == nullptr);
 		}
 		catch (...)
@@ -519,9 +855,83 @@ namespace custom
 		return pairReturn;
 	}
 
+	/*****************************************************
+	 * BST :: FIND OR INSERT
+	 * Walk down as find() does. A miss ends at the empty
+	 * child where k belongs, so the new node goes right
+	 * there rather than being searched for again
+	 ****************************************************/
+	template <typename T>
+	template <class Key, class KeyLess, class Make>
+	std::pair<typename BST <T> ::iterator, bool> BST <T> ::find_or_insert(const Key& k, KeyLess less, Make make)
+	{
+		BNode* pParent = nullptr;
+		bool isLeft = false;
+		for (BNode* p = root; p != nullptr; )
+		{
+			pParent = p;
+			isLeft = less(k, p->data);
+			if (isLeft)
+				p = p->pLeft;
+			else if (less(p->data, k))
+				p = p->pRight;
+			else
+				return std::pair<iterator, bool>(iterator(p), false);
+		}
+		return std::pair<iterator, bool>(attach(pParent, isLeft, new BNode(make())), true);
+	}
+
+	/*****************************************************
+	 * BST :: FIND OR INSERT with a hint
+	 * If k goes between hint and the element before it,
+	 * one of those two has an empty child on the side
+	 * that faces the other, and k goes there. Otherwise
+	 * search from the root
+	 ****************************************************/
+	template <typename T>
+	template <class Key, class KeyLess, class Make>
+	std::pair<typename BST <T> ::iterator, bool> BST <T> ::find_or_insert(iterator hint, const Key& k, KeyLess less, Make make)
+	{
+		BNode* pNext = hint.pNode;
+		if (pNext != nullptr && !less(k, pNext->data))
+		{
+			if (!less(pNext->data, k))
+				return std::pair<iterator, bool>(hint, false);
+			return find_or_insert(k, less, make);
+		}
+
+		// the element before hint, where end() comes after the last
+		BNode* pPrev = nullptr;
+		if (pNext == nullptr)
+		{
+			for (pPrev = root; pPrev && pPrev->pRight; )
+				pPrev = pPrev->pRight;
+		}
+		else
+		{
+			iterator it = hint;
+			if (it != begin())
+				pPrev = (--it).pNode;
+		}
+		if (pPrev != nullptr && !less(pPrev->data, k))
+		{
+			if (!less(k, pPrev->data))
+				return std::pair<iterator, bool>(iterator(pPrev), false);
+			return find_or_insert(k, less, make);
+		}
+
+		if (pNext != nullptr && pNext->pLeft == nullptr)
+			return std::pair<iterator, bool>(attach(pNext, true /*isLeft*/, new BNode(make())), true);
+		return std::pair<iterator, bool>(attach(pPrev, false /*isLeft*/, new BNode(make())), true);
+	}
+
 	/*************************************************
 	 * BST :: ERASE
-	 * Remove a given node as specified by the iterator
+	 * Remove a given node as specified by the iterator.
+	 * With two children, the in-order successor takes the
+	 * node's place and color, so what actually leaves the
+	 * tree is the successor's old spot. If that spot was
+	 * black, one path is now short a black node
 	 ************************************************/
 	template <typename T>
 	typename BST <T> ::iterator BST <T> ::erase(iterator& it)
@@ -531,17 +941,18 @@ namespace custom
 
 		iterator itNext = it;
 		BNode* pDelete = it.pNode;
+		BNode* pChild;           // what moves up into the vacated spot
+		BNode* pParent;          // its new parent, since pChild may be null
+		bool isRemovedRed;
 
-		if (pDelete->pLeft == nullptr)
-		{
-			++itNext;
-			deleteNode(pDelete, true);
-		}
-
-		else if (pDelete->pRight == nullptr)
+		if (pDelete->pLeft == nullptr || pDelete->pRight == nullptr)
 		{
 			++itNext;
-			deleteNode(pDelete, false);
+			pChild = (pDelete->pLeft ? pDelete->pLeft : pDelete->pRight);
+			pParent = pDelete->pParent;
+			isRemovedRed = pDelete->isRed;
+			BST_ORDER(for (BNode* p = pParent; p; p = p->pParent) p->numSubtree--);
+			replace(pDelete, pChild);
 		}
 
 		else
@@ -550,35 +961,30 @@ namespace custom
 			while (pIOS->pLeft != nullptr)
 				pIOS = pIOS->pLeft;
 
-			assert(pIOS->pLeft == nullptr);
-			pIOS->pLeft = pDelete->pLeft;
-			if (pDelete->pLeft)
-				pDelete->pLeft->pParent = pIOS;
+			pChild = pIOS->pRight;
+			isRemovedRed = pIOS->isRed;
+			BST_ORDER(for (BNode* p = pIOS->pParent; p; p = p->pParent) p->numSubtree--);
 
 			if (pDelete->pRight != pIOS)
 			{
-				if (pIOS->pRight)
-					pIOS->pRight->pParent = pIOS->pParent;
-				pIOS->pParent->pLeft = pIOS->pRight;
-
-				assert(pDelete->pRight != nullptr);
-				pIOS->pRight = pDelete->pRight;
-				pDelete->pRight->pParent = pIOS;
+				pParent = pIOS->pParent;
+				replace(pIOS, pIOS->pRight);
+				pIOS->addRight(pDelete->pRight);
 			}
+			else
+				pParent = pIOS;
 
-			pIOS->pParent = pDelete->pParent;
-			if (pDelete->pParent && pDelete->pParent->pLeft == pDelete)
-				pDelete->pParent->pLeft = pIOS;
-			if (pDelete->pParent && pDelete->pParent->pRight == pDelete)
-				pDelete->pParent->pRight = pIOS;
-
-			if (root == pDelete)
-				root = pIOS;
+			replace(pDelete, pIOS);
+			pIOS->addLeft(pDelete->pLeft);
+			pIOS->isRed = pDelete->isRed;
+			BST_ORDER(pIOS->numSubtree = pDelete->numSubtree);
 
 			itNext = iterator(pIOS);
-
 		}
 
+		if (!isRemovedRed)
+			balanceErase(pChild, pParent);
+
 		numElements--;
 		delete pDelete;
 		return itNext;
@@ -626,116 +1032,1103 @@ namespace custom
 		return end();
 	}
 
-	/*****************************************************
-	 * DELETE BINARY TREE
-	 * Delete all the nodes below pThis including pThis
-	 * using the postfix traverse: LRV
+	/****************************************************
+	 * BST :: FIND BY KEY
+	 * Search with anything the elements can be ordered
+	 * against, so the caller never has to build a T.
+	 * less() must take an element and a key in either order
 	 ****************************************************/
-	template<typename T>
-	inline void BST<T>::deleteNode(BNode*& pDelete, bool toRight)
+	template <typename T>
+	template <class Key, class KeyLess>
+	typename BST <T> ::iterator BST<T> ::find(const Key& k, KeyLess less)
 	{
-		BNode* pNext = (toRight ? pDelete->pRight : pDelete->pLeft);
+		BNode* p = root;
+		while (p != nullptr)
+		{
+			if (less(k, p->data))
+				p = p->pLeft;
+			else if (less(p->data, k))
+				p = p->pRight;
+			else
+				return iterator(p);
+		}
+		return end();
+	}
 
-		if (pDelete != root)
+	/****************************************************
+	 * BST :: LOWER BOUND
+	 * The first element that is not less than k. Every
+	 * node passed on the left might be it
+	 ****************************************************/
+	template <typename T>
+	template <class Key, class KeyLess>
+	typename BST <T> ::BNode* BST<T> ::lowerBound(const Key& k, KeyLess less) const
+	{
+		BNode* pBound = nullptr;
+		for (BNode* p = root; p != nullptr; )
 		{
-			if (pDelete->pParent->pLeft == pDelete)
-			{
-				pDelete->pParent->pLeft = nullptr;
-				pDelete->pParent->addLeft(pNext);
-			}
+			if (less(p->data, k))
+				p = p->pRight;
 			else
 			{
-				pDelete->pParent->pRight = nullptr;
-				pDelete->pParent->addRight(pNext);
+				pBound = p;
+				p = p->pLeft;
 			}
 		}
+		return pBound;
+	}
 
-		else
+	/****************************************************
+	 * BST :: UPPER BOUND
+	 * The first element that is greater than k
+	 ****************************************************/
+	template <typename T>
+	template <class Key, class KeyLess>
+	typename BST <T> ::BNode* BST<T> ::upperBound(const Key& k, KeyLess less) const
+	{
+		BNode* pBound = nullptr;
+		for (BNode* p = root; p != nullptr; )
 		{
-			root = pNext;
-			pNext->pParent = nullptr;
+			if (less(k, p->data))
+			{
+				pBound = p;
+				p = p->pLeft;
+			}
+			else
+				p = p->pRight;
 		}
+		return pBound;
 	}
 
-	/*****************************************************
-	 * DELETE BINARY TREE
-	 * Delete all the nodes below pThis including pThis
-	 * using the postfix traverse: LRV
+	/****************************************************
+	 * BST :: RANGE
+	 * Find both ends once, up front. hi before lo is
+	 * an empty range
 	 ****************************************************/
-	template<typename T>
-	inline void BST<T>::deleteBinaryTree(BNode*& pDelete) noexcept
+	template <typename T>
+	template <class Key, class KeyLess>
+	typename BST <T> ::range_view BST<T> ::range(const Key& lo, const Key& hi, KeyLess less) const
 	{
-		if (pDelete == nullptr)
-			return;
-		deleteBinaryTree(pDelete->pLeft);
-		deleteBinaryTree(pDelete->pRight);
-
-		delete pDelete;
-		pDelete = nullptr;
+		BNode* pEnd = lowerBound(hi, less);
+		if (less(hi, lo))
+			return range_view(pEnd, pEnd);
+		return range_view(lowerBound(lo, less), pEnd);
 	}
 
-	/*****************************************************
-	 * COPY BINARY TREE
-	 * Copy pSrc->pRight to pDest->pRight and pSrc-pLeft
-	 * onto pDest->pLeft
+#ifdef BST_ORDER_STATISTICS
+	/****************************************************
+	 * BST :: SELECT
+	 * The element with k elements before it, found by
+	 * steering with the left subtree sizes. end() when
+	 * there are not that many
 	 ****************************************************/
-	template<typename T>
-	inline void BST<T>::copyBinaryTree(const BNode* pSrc, BNode*& pDest)
+	template <typename T>
+	typename BST <T> ::iterator BST <T> ::select(size_t k) const
 	{
-		if (nullptr == pSrc)
+		BNode* p = root;
+		while (p != nullptr)
 		{
-			deleteBinaryTree(pDest);
-			return;
+			size_t numLeft = sizeOf(p->pLeft);
+			if (k < numLeft)
+				p = p->pLeft;
+			else if (k == numLeft)
+				return iterator(p);
+			else
+			{
+				k -= numLeft + 1;
+				p = p->pRight;
+			}
 		}
+		return end();
+	}
 
-		assert(pSrc);
-		try
+	/****************************************************
+	 * BST :: RANK
+	 * How many elements are less than t, whether or not
+	 * t itself is there. Each step right counts the left
+	 * subtree and the node passed over
+	 ****************************************************/
+	template <typename T>
+	size_t BST <T> ::rank(const T& t) const
+	{
+		size_t num = 0;
+		for (BNode* p = root; p != nullptr; )
 		{
-			if (nullptr == pDest)
-				pDest = new BST::BNode(pSrc->data);
+			if (p->data < t)
+			{
+				num += sizeOf(p->pLeft) + 1;
+				p = p->pRight;
+			}
 			else
-				pDest->data = pSrc->data;
+				p = p->pLeft;
 		}
-		catch (...)
+		return num;
+	}
+
+	template <typename T>
+	template <class Key, class KeyLess>
+	size_t BST <T> ::rank(const Key& k, KeyLess less) const
+	{
+		size_t num = 0;
+		for (BNode* p = root; p != nullptr; )
 		{
-			throw "ERROR: Unable to allocate a node";
+			if (less(p->data, k))
+			{
+				num += sizeOf(p->pLeft) + 1;
+				p = p->pRight;
+			}
+			else
+				p = p->pLeft;
 		}
-		assert(pDest != nullptr);
-
-		copyBinaryTree(pSrc->pLeft, pDest->pLeft);
-		if (pSrc->pLeft)
-			pDest->pLeft->pParent = pDest;
-
-		copyBinaryTree(pSrc->pRight, pDest->pRight);
-		if (pSrc->pRight)
-			pDest->pRight->pParent = pDest;
+		return num;
 	}
+#endif // BST_ORDER_STATISTICS
 
-	/******************************************************
-	 ******************************************************
-	 ******************************************************
-	 *********************** B NODE ***********************
-	 ******************************************************
-	 ******************************************************
-	 ******************************************************/
+	/*****************************************************
+	 * BST :: REPLACE
+	 * Hang pNew (possibly null) where pOld hangs now.
+	 * pOld's own children are left alone
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::replace(BNode* pOld, BNode* pNew)
+	{
+		if (pOld->pParent == nullptr)
+			root = pNew;
+		else if (pOld->pParent->pLeft == pOld)
+			pOld->pParent->pLeft = pNew;
+		else
+			pOld->pParent->pRight = pNew;
 
+		if (pNew)
+			pNew->pParent = pOld->pParent;
+	}
 
-	 /******************************************************
-	  * BINARY NODE :: ADD LEFT
-	  * Add a node to the left of the current node
-	  ******************************************************/
+	/*****************************************************
+	 * BST :: SPLIT
+	 * Everything not less than t moves to the returned
+	 * tree. Without BST_ORDER_STATISTICS the sizes have
+	 * to be counted, which makes it O(n)
+	 ****************************************************/
 	template <typename T>
-	void BST <T> ::BNode::addLeft(BNode* pNode)
+	BST <T> BST <T> ::split(const T& t)
 	{
-		pLeft = pNode;
-		if (pNode)
-			pNode->pParent = this;
+		BST rhs;
+		splitNodes(root, [&t](const T& data) { return data < t; }, root, rhs.root);
+		rhs.numElements = numNodes(rhs.root);
+		numElements -= rhs.numElements;
+		return rhs;
 	}
 
-	/******************************************************
-	 * BINARY NODE :: ADD RIGHT
-	 * Add a node to the right of the current node
-	 ******************************************************/
+	/*****************************************************
+	 * BST :: JOIN
+	 * Put rhs after our last element
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::join(BST&& rhs)
+	{
+		if (this == &rhs)
+			return;
+		root = joinNodes(root, rhs.root);
+		numElements += rhs.numElements;
+		rhs.root = nullptr;
+		rhs.numElements = 0;
+	}
+
+	/*****************************************************
+	 * BST :: UNITE
+	 * Everything in either tree
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::unite(BST&& rhs, bool isParallel)
+	{
+		if (this == &rhs)
+			return;
+		size_t numRemoved = 0;
+		root = uniteNodes(root, rhs.root, numRemoved, forksFor(isParallel));
+		numElements += rhs.numElements - numRemoved;
+		rhs.root = nullptr;
+		rhs.numElements = 0;
+	}
+
+	/*****************************************************
+	 * BST :: INTERSECT
+	 * Only what is in both trees
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::intersect(BST&& rhs, bool isParallel)
+	{
+		if (this == &rhs)
+			return;
+		size_t numKept = 0;
+		root = intersectNodes(root, rhs.root, numKept, forksFor(isParallel));
+		numElements = numKept;
+		rhs.root = nullptr;
+		rhs.numElements = 0;
+	}
+
+	/*****************************************************
+	 * BST :: SUBTRACT
+	 * What is here but not in rhs
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::subtract(BST&& rhs, bool isParallel)
+	{
+		if (this == &rhs)
+		{
+			clear();
+			return;
+		}
+		size_t numRemoved = 0;
+		root = subtractNodes(root, rhs.root, numRemoved, forksFor(isParallel));
+		numElements -= numRemoved;
+		rhs.root = nullptr;
+		rhs.numElements = 0;
+	}
+
+	/*****************************************************
+	 * BST :: ROTATE LEFT
+	 * pNode's right child takes its place, and pNode
+	 * becomes that child's left
+	 *
+	 *        (P)                 (R)
+	 *       /   \               /   \
+	 *     (a)   (R)     =>     (P)   (c)
+	 *          /   \          /   \
+	 *        (b)   (c)      (a)   (b)
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::rotateLeft(BNode* pNode)
+	{
+		BNode* pRight = pNode->pRight;
+		assert(pRight != nullptr);
+
+		pNode->addRight(pRight->pLeft);
+		replace(pNode, pRight);
+		pRight->addLeft(pNode);
+
+		// pRight now has pNode's old subtree; pNode lost pRight and (c)
+		BST_ORDER(pRight->numSubtree = pNode->numSubtree);
+		BST_ORDER(pNode->numSubtree = 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight));
+	}
+
+	/*****************************************************
+	 * BST :: ROTATE RIGHT
+	 * The mirror image of rotateLeft()
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::rotateRight(BNode* pNode)
+	{
+		BNode* pLeft = pNode->pLeft;
+		assert(pLeft != nullptr);
+
+		pNode->addLeft(pLeft->pRight);
+		replace(pNode, pLeft);
+		pLeft->addRight(pNode);
+
+		BST_ORDER(pLeft->numSubtree = pNode->numSubtree);
+		BST_ORDER(pNode->numSubtree = 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight));
+	}
+
+	/*****************************************************
+	 * BST :: JOIN NODES
+	 * Everything in pLeft, then pMid, then everything in
+	 * pRight, as one tree. pMid goes down the spine of
+	 * the taller tree to the first black node as tall as
+	 * the other tree, takes that node and the other tree
+	 * as its children, and is colored red. The only rule
+	 * that can break is red under red, which is just what
+	 * balanceInsert() fixes. O(difference in heights)
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::joinNodes(BNode* pLeft, BNode* pMid, BNode* pRight)
+	{
+		size_t heightLeft = blackHeightOf(pLeft);
+		size_t heightRight = blackHeightOf(pRight);
+		pMid->pParent = nullptr;
+
+		// as tall as each other: pMid on top
+		if (heightLeft == heightRight)
+		{
+			pMid->addLeft(pLeft);
+			pMid->addRight(pRight);
+			pMid->isRed = false;
+			BST_ORDER(pMid->numSubtree = 1 + sizeOf(pLeft) + sizeOf(pRight));
+			return pMid;
+		}
+
+		// find where pMid goes in the taller tree
+		bool isLeftTaller = heightLeft > heightRight;
+		BNode* pTall = isLeftTaller ? pLeft : pRight;
+		BNode* pShort = isLeftTaller ? pRight : pLeft;
+		size_t heightShort = isLeftTaller ? heightRight : heightLeft;
+		size_t height = isLeftTaller ? heightLeft : heightRight;
+		BNode* pParent = nullptr;
+		BNode* pNode = pTall;
+		while (pNode && (pNode->isRed || height != heightShort))
+		{
+			if (!pNode->isRed)
+				height--;
+			pParent = pNode;
+			pNode = isLeftTaller ? pNode->pRight : pNode->pLeft;
+		}
+		assert(pParent != nullptr);
+
+		// pMid takes pNode's place
+		if (isLeftTaller)
+		{
+			pMid->addLeft(pNode);
+			pMid->addRight(pShort);
+			pParent->addRight(pMid);
+		}
+		else
+		{
+			pMid->addLeft(pShort);
+			pMid->addRight(pNode);
+			pParent->addLeft(pMid);
+		}
+		pMid->isRed = true;
+#ifdef BST_ORDER_STATISTICS
+		pMid->numSubtree = 1 + sizeOf(pMid->pLeft) + sizeOf(pMid->pRight);
+		for (BNode* p = pParent; p; p = p->pParent)
+			p->numSubtree += 1 + sizeOf(pShort);
+#endif // BST_ORDER_STATISTICS
+
+		// balance as a tree of its own, so forks never share a root
+		BST tree;
+		tree.root = pTall;
+		tree.balanceInsert(pMid);
+		BNode* pRoot = tree.root;
+		tree.root = nullptr;
+		return pRoot;
+	}
+
+	/*****************************************************
+	 * BST :: JOIN NODES without a middle
+	 * The last of pLeft makes a middle
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::joinNodes(BNode* pLeft, BNode* pRight)
+	{
+		if (pLeft == nullptr)
+			return pRight;
+		BNode* pLast = nullptr;
+		BNode* pRest = splitLast(pLeft, pLast);
+		return joinNodes(pRest, pLast, pRight);
+	}
+
+	/*****************************************************
+	 * BST :: SPLIT LAST
+	 * Take the last node off the non-empty pNode. What
+	 * remains is returned, and the last is in pLast
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::splitLast(BNode* pNode, BNode*& pLast)
+	{
+		BNode* pLeft = detach(pNode->pLeft);
+		if (pNode->pRight == nullptr)
+		{
+			pLast = pNode;
+			pNode->pLeft = nullptr;
+			return pLeft;
+		}
+		BNode* pRest = splitLast(detach(pNode->pRight), pLast);
+		return joinNodes(pLeft, pNode, pRest);
+	}
+
+	/*****************************************************
+	 * BST :: SPLIT NODES
+	 * pLeft gets the elements isLeft() is true of and
+	 * pRight the others. isLeft() has to hold for a
+	 * prefix, such as everything less than a key. Each
+	 * node on the way down is joined back onto its own
+	 * side; the joins add up to O(log n)
+	 ****************************************************/
+	template <typename T>
+	template <class IsLeft>
+	void BST <T> ::splitNodes(BNode* pNode, IsLeft isLeft, BNode*& pLeft, BNode*& pRight)
+	{
+		if (pNode == nullptr)
+		{
+			pLeft = pRight = nullptr;
+			return;
+		}
+
+		BNode* pChildLeft = detach(pNode->pLeft);
+		BNode* pChildRight = detach(pNode->pRight);
+		BNode* pMiddle = nullptr;
+		if (isLeft(pNode->data))
+		{
+			splitNodes(pChildRight, isLeft, pMiddle, pRight);
+			pLeft = joinNodes(pChildLeft, pNode, pMiddle);
+		}
+		else
+		{
+			splitNodes(pChildLeft, isLeft, pLeft, pMiddle);
+			pRight = joinNodes(pMiddle, pNode, pChildRight);
+		}
+	}
+
+	/*****************************************************
+	 * BST :: SPLIT NODES three ways
+	 * Less than t, equal to it, and greater
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::splitNodes(BNode* pNode, const T& t, BNode*& pLess, BNode*& pEqual, BNode*& pGreater)
+	{
+		BNode* pNotLess = nullptr;
+		splitNodes(pNode, [&t](const T& data) { return data < t; }, pLess, pNotLess);
+		splitNodes(pNotLess, [&t](const T& data) { return !(t < data); }, pEqual, pGreater);
+	}
+
+	/*****************************************************
+	 * BST :: UNITE NODES
+	 * Our root splits the other tree, the halves unite
+	 * with our subtrees, and the root joins them again.
+	 * The other tree's copies of our root are deleted
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::uniteNodes(BNode* pLhs, BNode* pRhs, size_t& numRemoved, int forks)
+	{
+		if (pLhs == nullptr)
+			return pRhs;
+		if (pRhs == nullptr)
+			return pLhs;
+
+		BNode* pLhsLeft = detach(pLhs->pLeft);
+		BNode* pLhsRight = detach(pLhs->pRight);
+		BNode* pLess = nullptr;
+		BNode* pEqual = nullptr;
+		BNode* pGreater = nullptr;
+		splitNodes(pRhs, pLhs->data, pLess, pEqual, pGreater);
+		numRemoved += numNodes(pEqual);
+		deleteBinaryTree(pEqual);
+
+		BNode* pLeft = nullptr;
+		BNode* pRight = nullptr;
+		size_t numRemovedRight = 0;
+		forkJoin([&]() { pLeft = uniteNodes(pLhsLeft, pLess, numRemoved, forks - 1); },
+		         [&]() { pRight = uniteNodes(pLhsRight, pGreater, numRemovedRight, forks - 1); },
+		         forks, pLhsRight, pGreater);
+		numRemoved += numRemovedRight;
+		return joinNodes(pLeft, pLhs, pRight);
+	}
+
+	/*****************************************************
+	 * BST :: INTERSECT NODES
+	 * As uniteNodes(), but our root only stays if the
+	 * other tree had it too
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::intersectNodes(BNode* pLhs, BNode* pRhs, size_t& numKept, int forks)
+	{
+		if (pLhs == nullptr || pRhs == nullptr)
+		{
+			deleteBinaryTree(pLhs);
+			deleteBinaryTree(pRhs);
+			return nullptr;
+		}
+
+		BNode* pLhsLeft = detach(pLhs->pLeft);
+		BNode* pLhsRight = detach(pLhs->pRight);
+		BNode* pLess = nullptr;
+		BNode* pEqual = nullptr;
+		BNode* pGreater = nullptr;
+		splitNodes(pRhs, pLhs->data, pLess, pEqual, pGreater);
+		bool isFound = (pEqual != nullptr);
+		deleteBinaryTree(pEqual);
+
+		BNode* pLeft = nullptr;
+		BNode* pRight = nullptr;
+		size_t numKeptRight = 0;
+		forkJoin([&]() { pLeft = intersectNodes(pLhsLeft, pLess, numKept, forks - 1); },
+		         [&]() { pRight = intersectNodes(pLhsRight, pGreater, numKeptRight, forks - 1); },
+		         forks, pLhsRight, pGreater);
+		numKept += numKeptRight;
+
+		if (isFound)
+		{
+			numKept++;
+			return joinNodes(pLeft, pLhs, pRight);
+		}
+		delete pLhs;
+		return joinNodes(pLeft, pRight);
+	}
+
+	/*****************************************************
+	 * BST :: SUBTRACT NODES
+	 * As intersectNodes(), but our root only stays if
+	 * the other tree did not have it
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::subtractNodes(BNode* pLhs, BNode* pRhs, size_t& numRemoved, int forks)
+	{
+		if (pLhs == nullptr)
+		{
+			deleteBinaryTree(pRhs);
+			return nullptr;
+		}
+		if (pRhs == nullptr)
+			return pLhs;
+
+		BNode* pLhsLeft = detach(pLhs->pLeft);
+		BNode* pLhsRight = detach(pLhs->pRight);
+		BNode* pLess = nullptr;
+		BNode* pEqual = nullptr;
+		BNode* pGreater = nullptr;
+		splitNodes(pRhs, pLhs->data, pLess, pEqual, pGreater);
+		bool isFound = (pEqual != nullptr);
+		deleteBinaryTree(pEqual);
+
+		BNode* pLeft = nullptr;
+		BNode* pRight = nullptr;
+		size_t numRemovedRight = 0;
+		forkJoin([&]() { pLeft = subtractNodes(pLhsLeft, pLess, numRemoved, forks - 1); },
+		         [&]() { pRight = subtractNodes(pLhsRight, pGreater, numRemovedRight, forks - 1); },
+		         forks, pLhsRight, pGreater);
+		numRemoved += numRemovedRight;
+
+		if (isFound)
+		{
+			numRemoved++;
+			delete pLhs;
+			return joinNodes(pLeft, pRight);
+		}
+		return joinNodes(pLeft, pLhs, pRight);
+	}
+
+	/*****************************************************
+	 * BST :: FORK JOIN
+	 * With forks to spare, run right() on another thread
+	 * while left() runs here. The two never share a node.
+	 * right() merges pLhs with pRhs, which is no more work
+	 * than the smaller of them; a black height under
+	 * FORK_MIN_BLACK_HEIGHT is too little to pay for a
+	 * thread. If no thread can be had, right() runs here
+	 ****************************************************/
+	template <typename T>
+	template <class Left, class Right>
+	void BST <T> ::forkJoin(Left left, Right right, int forks, const BNode* pLhs, const BNode* pRhs)
+	{
+		std::future<void> future;
+		if (forks > 0 && blackHeightOf(pLhs) >= FORK_MIN_BLACK_HEIGHT && blackHeightOf(pRhs) >= FORK_MIN_BLACK_HEIGHT)
+		{
+			try
+			{
+				future = std::async(std::launch::async, right);
+			}
+			catch (const std::system_error&)
+			{
+				// out of threads: do it ourselves below
+			}
+		}
+
+		left();
+		if (future.valid())
+			future.get();
+		else
+			right();
+	}
+
+	/*****************************************************
+	 * BST :: FORKS FOR
+	 * Enough levels of forking to give every hardware
+	 * thread a subtree
+	 ****************************************************/
+	template <typename T>
+	int BST <T> ::forksFor(bool isParallel)
+	{
+		if (!isParallel)
+			return 0;
+		int forks = 1;
+		while ((1u << forks) < std::thread::hardware_concurrency())
+			forks++;
+		return forks;
+	}
+
+	/*****************************************************
+	 * BST :: DETACH
+	 * Make a subtree a tree of its own. A red root can
+	 * always be made black
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::BNode* BST <T> ::detach(BNode* pNode)
+	{
+		if (pNode)
+		{
+			pNode->pParent = nullptr;
+			pNode->isRed = false;
+		}
+		return pNode;
+	}
+
+	/*****************************************************
+	 * BST :: BLACK HEIGHT OF
+	 * Black nodes on the way down the left spine, which
+	 * is as many as on any other way down
+	 ****************************************************/
+	template <typename T>
+	size_t BST <T> ::blackHeightOf(const BNode* pNode)
+	{
+		size_t height = 0;
+		for (; pNode; pNode = pNode->pLeft)
+			if (!pNode->isRed)
+				height++;
+		return height;
+	}
+
+	/*****************************************************
+	 * BST :: NUM NODES
+	 * The size of a subtree: kept with the node when
+	 * order statistics are on, counted when not
+	 ****************************************************/
+	template <typename T>
+	size_t BST <T> ::numNodes(const BNode* pNode)
+	{
+#ifdef BST_ORDER_STATISTICS
+		return sizeOf(pNode);
+#else
+		return pNode ? 1 + numNodes(pNode->pLeft) + numNodes(pNode->pRight) : 0;
+#endif // BST_ORDER_STATISTICS
+	}
+
+	/*****************************************************
+	 * BST :: HEIGHT OF
+	 * Nodes on the longest way down from pNode
+	 ****************************************************/
+	template <typename T>
+	size_t BST <T> ::heightOf(const BNode* pNode) noexcept
+	{
+		return pNode ? 1 + std::max(heightOf(pNode->pLeft), heightOf(pNode->pRight)) : 0;
+	}
+
+	/*****************************************************
+	 * BST :: ATTACH
+	 * Hang a new node off pParent, or make it the root,
+	 * and balance
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::iterator BST <T> ::attach(BNode* pParent, bool isLeft, BNode* pNew)
+	{
+		numElements++;
+		if (pParent == nullptr)
+		{
+			assert(root == nullptr);
+			root = pNew;
+			root->isRed = false;
+			return iterator(pNew);
+		}
+
+		if (isLeft)
+			pParent->addLeft(pNew);
+		else
+			pParent->addRight(pNew);
+		BST_ORDER(for (BNode* p = pParent; p; p = p->pParent) p->numSubtree++);
+		balanceInsert(pNew);
+		return iterator(pNew);
+	}
+
+	/*****************************************************
+	 * BST :: BALANCE INSERT
+	 * pNode was just added as a red leaf. The only rule it
+	 * can break is a red node with a red parent:
+	 *    1. parent black, or no grandparent: done
+	 *    2. aunt red: recolor and look again two levels up
+	 *    3. aunt black: one or two rotations and done
+	 * The root is always black afterwards
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::balanceInsert(BNode* pNode)
+	{
+		while (pNode->pParent && pNode->pParent->isRed && pNode->pParent->pParent)
+		{
+			BNode* pParent = pNode->pParent;
+			BNode* pGranny = pParent->pParent;
+			bool isLeft = (pGranny->pLeft == pParent);
+			BNode* pAunt = (isLeft ? pGranny->pRight : pGranny->pLeft);
+
+			// case 2: push the red up to the grandparent
+			if (pAunt && pAunt->isRed)
+			{
+				pParent->isRed = false;
+				pAunt->isRed = false;
+				pGranny->isRed = true;
+				pNode = pGranny;
+				continue;
+			}
+
+			// case 3: an inside grandchild first turns into an outside one
+			if (isLeft && pParent->pRight == pNode)
+			{
+				rotateLeft(pParent);
+				pParent = pNode;
+			}
+			else if (!isLeft && pParent->pLeft == pNode)
+			{
+				rotateRight(pParent);
+				pParent = pNode;
+			}
+
+			pParent->isRed = false;
+			pGranny->isRed = true;
+			if (isLeft)
+				rotateRight(pGranny);
+			else
+				rotateLeft(pGranny);
+			break;
+		}
+
+		root->isRed = false;
+	}
+
+	/*****************************************************
+	 * BST :: BALANCE ERASE
+	 * A black node left the tree above pNode (which may be
+	 * null), so every path through pNode is one black
+	 * short. Either paint pNode black, borrow a black from
+	 * the sibling's side with rotations, or push the
+	 * shortage up to the parent and try again
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::balanceErase(BNode* pNode, BNode* pParent)
+	{
+		while (pNode != root && (pNode == nullptr || !pNode->isRed))
+		{
+			assert(pParent != nullptr);
+			bool isLeft = (pParent->pLeft == pNode);
+			BNode* pSibling = (isLeft ? pParent->pRight : pParent->pLeft);
+			assert(pSibling != nullptr);
+
+			// a red sibling: rotate so that the sibling is black
+			if (pSibling->isRed)
+			{
+				pSibling->isRed = false;
+				pParent->isRed = true;
+				if (isLeft)
+					rotateLeft(pParent);
+				else
+					rotateRight(pParent);
+				pSibling = (isLeft ? pParent->pRight : pParent->pLeft);
+			}
+
+			BNode* pNear = (isLeft ? pSibling->pLeft : pSibling->pRight);
+			BNode* pFar = (isLeft ? pSibling->pRight : pSibling->pLeft);
+
+			// both nephews black: the sibling gives up its black too
+			if ((pNear == nullptr || !pNear->isRed) && (pFar == nullptr || !pFar->isRed))
+			{
+				pSibling->isRed = true;
+				pNode = pParent;
+				pParent = pNode->pParent;
+				continue;
+			}
+
+			// the far nephew must be the red one for the last rotation
+			if (pFar == nullptr || !pFar->isRed)
+			{
+				pNear->isRed = false;
+				pSibling->isRed = true;
+				if (isLeft)
+					rotateRight(pSibling);
+				else
+					rotateLeft(pSibling);
+				pFar = pSibling;
+				pSibling = pNear;
+			}
+
+			pSibling->isRed = pParent->isRed;
+			pParent->isRed = false;
+			pFar->isRed = false;
+			if (isLeft)
+				rotateLeft(pParent);
+			else
+				rotateRight(pParent);
+			pNode = root;
+		}
+
+		if (pNode)
+			pNode->isRed = false;
+	}
+
+	/*****************************************************
+	 * DELETE BINARY TREE
+	 * Delete all the nodes below pThis including pThis
+	 * using the postfix traverse: LRV
+	 ****************************************************/
+	template<typename T>
+	inline void BST<T>::deleteBinaryTree(BNode*& pDelete) noexcept
+	{
+		if (pDelete == nullptr)
+			return;
+		deleteBinaryTree(pDelete->pLeft);
+		deleteBinaryTree(pDelete->pRight);
+
+		delete pDelete;
+		pDelete = nullptr;
+	}
+
+	/*****************************************************
+	 * COPY BINARY TREE
+	 * Copy pSrc->pRight to pDest->pRight and pSrc-pLeft
+	 * onto pDest->pLeft
+	 ****************************************************/
+	template<typename T>
+	inline void BST<T>::copyBinaryTree(const BNode* pSrc, BNode*& pDest)
+	{
+		if (nullptr == pSrc)
+		{
+			deleteBinaryTree(pDest);
+			return;
+		}
+
+		assert(pSrc);
+		try
+		{
+			if (nullptr == pDest)
+				pDest = new BST::BNode(pSrc->data);
+			else
+				pDest->data = pSrc->data;
+		}
+		catch (...)
+		{
+			throw "ERROR: Unable to allocate a node";
+		}
+		assert(pDest != nullptr);
+		pDest->isRed = pSrc->isRed;
+		BST_ORDER(pDest->numSubtree = pSrc->numSubtree);
+
+		copyBinaryTree(pSrc->pLeft, pDest->pLeft);
+		if (pSrc->pLeft)
+			pDest->pLeft->pParent = pDest;
+
+		copyBinaryTree(pSrc->pRight, pDest->pRight);
+		if (pSrc->pRight)
+			pDest->pRight->pParent = pDest;
+	}
+
+	/*****************************************************
+	 * BUILD SORTED
+	 * Make a tree of the next num elements from it: the
+	 * smaller half on the left, then the middle, then the
+	 * rest on the right. Each node's subtrees differ in
+	 * size by at most one, so every level but the last is
+	 * full. Those are black and the last is red. Nodes go
+	 * in order into pBlock, pCell being the next free cell
+	 ****************************************************/
+	template <typename T>
+	template <class Iterator>
+	typename BST <T> ::BNode* BST <T> ::buildSorted(Iterator& it, size_t num, size_t depth, size_t redDepth, Block* pBlock, char*& pCell)
+	{
+		if (num == 0)
+			return nullptr;
+
+		BNode* pLeft = buildSorted(it, num / 2, depth + 1, redDepth, pBlock, pCell);
+		BNode* pNode = nullptr;
+		try
+		{
+			typename Block::Header* pHeader = ::new (static_cast<void*>(pCell)) typename Block::Header;
+			pHeader->pBlock = pBlock;
+			pNode = ::new (static_cast<void*>(pHeader + 1)) BNode(*it);
+			pCell += Block::CELL;
+		}
+		catch (...)
+		{
+			deleteBinaryTree(pLeft);
+			throw "ERROR: Unable to allocate a node";
+		}
+		++it;
+		pNode->isRed = (depth >= redDepth);
+		BST_ORDER(pNode->numSubtree = num);
+		pNode->pLeft = pLeft;
+		if (pLeft)
+			pLeft->pParent = pNode;
+
+		try
+		{
+			pNode->pRight = buildSorted(it, num - num / 2 - 1, depth + 1, redDepth, pBlock, pCell);
+		}
+		catch (...)
+		{
+			deleteBinaryTree(pNode);
+			throw;
+		}
+		if (pNode->pRight)
+			pNode->pRight->pParent = pNode;
+		return pNode;
+	}
+
+	/*****************************************************
+	 * BST :: BLOCK :: ALLOCATE
+	 * Raw memory aligned for a node, even an over-aligned
+	 * one where the language can say so
+	 ****************************************************/
+	template <typename T>
+	void* BST <T> ::Block::allocate(size_t size)
+	{
+#ifdef __cpp_aligned_new
+		if (alignof(BNode) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			return ::operator new(size, std::align_val_t(alignof(BNode)));
+#endif // __cpp_aligned_new
+		return ::operator new(size);
+	}
+
+	/*****************************************************
+	 * BST :: BLOCK :: DEALLOCATE
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::Block::deallocate(void* p) noexcept
+	{
+#ifdef __cpp_aligned_new
+		if (alignof(BNode) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			::operator delete(p, std::align_val_t(alignof(BNode)));
+			return;
+		}
+#endif // __cpp_aligned_new
+		::operator delete(p);
+	}
+
+	/*****************************************************
+	 * BST :: BLOCK :: CREATE
+	 * A block with room for num nodes, every one of
+	 * which counts as live until it is released
+	 ****************************************************/
+	template <typename T>
+	typename BST <T> ::Block* BST <T> ::Block::create(size_t num)
+	{
+		return ::new (allocate(sizeof(Block) + num * CELL)) Block(num);
+	}
+
+	/*****************************************************
+	 * BST :: BLOCK :: RELEASE
+	 * num of the block's nodes or holds are gone. The
+	 * one that brings the count to zero frees the block.
+	 * The parallel set operations delete nodes on more
+	 * than one thread, so the count is atomic
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::Block::release(Block* pBlock, size_t num) noexcept
+	{
+		if (pBlock->numLive.fetch_sub(num, std::memory_order_acq_rel) == num)
+		{
+			pBlock->~Block();
+			deallocate(pBlock);
+		}
+	}
+
+	/*****************************************************
+	 * BST :: BNODE :: OPERATOR NEW
+	 * A lone node: one allocation holding a header and
+	 * the node
+	 ****************************************************/
+	template <typename T>
+	void* BST <T> ::BNode::operator new(size_t size)
+	{
+		typename Block::Header* pHeader = static_cast<typename Block::Header*>(Block::allocate(sizeof(typename Block::Header) + size));
+		pHeader->pBlock = nullptr;
+		return pHeader + 1;
+	}
+
+	/*****************************************************
+	 * BST :: BNODE :: OPERATOR DELETE
+	 * Free a lone node now, or give a node back to its
+	 * block and free the block with its last node
+	 ****************************************************/
+	template <typename T>
+	void BST <T> ::BNode::operator delete(void* p) noexcept
+	{
+		if (p == nullptr)
+			return;
+		typename Block::Header* pHeader = static_cast<typename Block::Header*>(p) - 1;
+		if (pHeader->pBlock == nullptr)
+			Block::deallocate(pHeader);
+		else
+			Block::release(pHeader->pBlock, 1);
+	}
+
+#ifdef DEBUG
+	/*****************************************************
+	 * BST :: VALIDATE
+	 * Walk the whole tree checking that the root is black,
+	 * no red node has a red child, every path down has the
+	 * same number of black nodes, the parent pointers
+	 * agree with the child pointers, the elements are in
+	 * order, and numElements is the count. O(n), for tests
+	 ****************************************************/
+	template <typename T>
+	bool BST <T> ::validate() const
+	{
+		if (root == nullptr)
+			return numElements == 0;
+		if (root->isRed || root->pParent != nullptr)
+			return false;
+
+		size_t num = 0;
+		if (blackHeight(root, num) < 0 || num != numElements)
+			return false;
+
+		// in-order, no element may be less than the one before it
+		iterator it = begin();
+		iterator itPrev = it;
+		for (++it; it != end(); itPrev = it, ++it)
+			if (*it < *itPrev)
+				return false;
+		return true;
+	}
+
+	/*****************************************************
+	 * BST :: BLACK HEIGHT
+	 * Black nodes on every path from pNode down to a leaf,
+	 * or -1 when some invariant below pNode is broken.
+	 * Adds the nodes it visits to num
+	 ****************************************************/
+	template <typename T>
+	int BST <T> ::blackHeight(const BNode* pNode, size_t& num) const
+	{
+		if (pNode == nullptr)
+			return 1;
+		num++;
+
+		for (const BNode* pChild : { pNode->pLeft, pNode->pRight })
+			if (pChild && (pChild->pParent != pNode || (pNode->isRed && pChild->isRed)))
+				return -1;
+
+		int heightLeft = blackHeight(pNode->pLeft, num);
+		int heightRight = blackHeight(pNode->pRight, num);
+		if (heightLeft < 0 || heightLeft != heightRight)
+			return -1;
+#ifdef BST_ORDER_STATISTICS
+		if (pNode->numSubtree != 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight))
+			return -1;
+#endif // BST_ORDER_STATISTICS
+		return heightLeft + (pNode->isRed ? 0 : 1);
+	}
+#endif // DEBUG
+
+	/******************************************************
+	 ******************************************************
+	 ******************************************************
+	 *********************** B NODE ***********************
+	 ******************************************************
+	 ******************************************************
+	 ******************************************************/
+
+
+	 /******************************************************
+	  * BINARY NODE :: ADD LEFT
+	  * Add a node to the left of the current node
+	  ******************************************************/
+	template <typename T>
+	void BST <T> ::BNode::addLeft(BNode* pNode)
+	{
+		pLeft = pNode;
+		if (pNode)
+			pNode->pParent = this;
+	}
+
+	/******************************************************
+	 * BINARY NODE :: ADD RIGHT
+	 * Add a node to the right of the current node
+	 ******************************************************/
 	template <typename T>
 	void BST <T> ::BNode::addRight(BNode* pNode)
 	{
@@ -915,5 +2308,74 @@ namespace custom
 
 	}
 
+	/**************************************************
+	 * BST RANGE VIEW :: BEGIN
+	 * The stack is the first node and every ancestor it
+	 * sits to the left of, the nearest on top: exactly
+	 * the nodes an in-order walk has yet to visit. One
+	 * climb, here, instead of one per ++
+	 *************************************************/
+	template <typename T>
+	typename BST <T> ::range_view::iterator BST <T> ::range_view::begin() const
+	{
+		iterator it;
+		it.pEnd = pEnd;
+		if (pFirst == pEnd)
+			return it;
+
+		// the climb finds the nearest first, but the walk wants it on top
+		for (BNode* p = pFirst; p->pParent; p = p->pParent)
+			if (p->pParent->pLeft == p)
+				it.stack.push_back(p->pParent);
+		std::reverse(it.stack.begin(), it.stack.end());
+		it.stack.push_back(pFirst);
+		return it;
+	}
+
+#ifdef BST_ORDER_STATISTICS
+	/**************************************************
+	 * BST ITERATOR :: ADVANCE
+	 * Climb to the root adding up this node's position,
+	 * then select the one n away on the way back down
+	 *************************************************/
+	template <typename T>
+	typename BST <T> ::iterator& BST <T> ::iterator :: operator += (ptrdiff_t n)
+	{
+		if (pNode == nullptr || n == 0)
+			return *this;
+
+		size_t k = sizeOf(pNode->pLeft);
+		BNode* pRoot = pNode;
+		for (; pRoot->pParent; pRoot = pRoot->pParent)
+			if (pRoot->pParent->pRight == pRoot)
+				k += sizeOf(pRoot->pParent->pLeft) + 1;
+
+		if (n < 0 && static_cast<size_t>(-n) > k)
+		{
+			pNode = nullptr;
+			return *this;
+		}
+		k += n;
+
+		// the same walk as BST::select(), from the root we climbed to
+		BNode* p = pRoot;
+		while (p != nullptr)
+		{
+			size_t numLeft = sizeOf(p->pLeft);
+			if (k < numLeft)
+				p = p->pLeft;
+			else if (k == numLeft)
+				break;
+			else
+			{
+				k -= numLeft + 1;
+				p = p->pRight;
+			}
+		}
+		pNode = p;
+		return *this;
+	}
+#endif // BST_ORDER_STATISTICS
+
 
 } // namespace custom
\ No newline at end of file
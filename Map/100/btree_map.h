@@ -0,0 +1,1122 @@
+/***********************************************************************
+ * Header:
+ *    BTREE MAP
+ * Summary:
+ *    A map kept in a B+-tree of cache-line sized nodes
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        btree_map           : A class that represents a map in a B+-tree
+ *        btree_map::iterator : An iterator through a btree_map
+ *
+ *    The pairs all live in the leaves, as many to a node as fit in
+ *    NodeBytes, and the leaves are linked in order so iterating is a
+ *    walk along arrays. The inner nodes hold only keys and child
+ *    pointers. Every node comes from a pool of cache-line aligned
+ *    chunks, so a 256-byte node is exactly four lines.
+ *
+ *    The interface and the iterator follow map. Unlike map, inserting
+ *    or erasing moves pairs within and between leaves, so it
+ *    invalidates every other iterator. erase() returns a valid one.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for pair
+#include <cassert>
+#include <cstdint>    // for uintptr_t
+#include <new>        // for placement new
+#include <vector>     // for the chunks of the node pool
+#include <utility>    // for std::swap, std::move
+#include <functional> // for std::less
+#include <stdexcept>  // for std::out_of_range
+#include <type_traits> // for std::aligned_storage
+#include <initializer_list>
+
+class TestBTreeMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+	/*****************************************************************
+	 * BTREE MAP
+	 * Unique keys, ordered by Compare, in a B+-tree whose nodes
+	 * are NodeBytes long
+	 *****************************************************************/
+	template <class K, class V, class Compare = std::less<K>, size_t NodeBytes = 256>
+	class btree_map
+	{
+		friend class ::TestBTreeMap; // give unit tests access to the privates
+
+		static_assert(NodeBytes % 64 == 0 && NodeBytes >= 128, "NodeBytes must be whole cache lines");
+	public:
+		using Pairs = custom::pair<K, V>;
+		using value_type = custom::pair<K, V>;
+
+		//
+		// Construct
+		//
+		btree_map(const Compare& compare = Compare()) :
+			root(nullptr), pFirst(nullptr), pLast(nullptr), numElements(0), compare(compare),
+			pFree(nullptr), pCursor(nullptr), pChunkEnd(nullptr), numBytes(0) {}
+		btree_map(const btree_map& rhs) : btree_map(rhs.compare)
+		{
+			build(rhs.begin(), rhs.end());
+		}
+		btree_map(btree_map&& rhs) noexcept : btree_map(rhs.compare)
+		{
+			swap(rhs);
+		}
+
+		// Sorted input is bulk loaded, leaf by leaf, into full nodes.
+		// Whatever follows the first key out of order is inserted
+		template <class Iterator>
+		btree_map(Iterator first, Iterator last) : btree_map()
+		{
+			build(first, last);
+		}
+		btree_map(const std::initializer_list<value_type>& il) : btree_map()
+		{
+			build(il.begin(), il.end());
+		}
+		~btree_map()
+		{
+			clear();
+		}
+
+		//
+		// Assign
+		//
+		btree_map& operator = (const btree_map& rhs)
+		{
+			if (this != &rhs)
+			{
+				btree_map tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+		btree_map& operator = (btree_map&& rhs) noexcept
+		{
+			clear();
+			swap(rhs);
+			return *this;
+		}
+		btree_map& operator = (const std::initializer_list<value_type>& il)
+		{
+			clear();
+			build(il.begin(), il.end());
+			return *this;
+		}
+		void swap(btree_map& rhs);
+
+		//
+		// Iterator
+		//
+		class iterator;
+		iterator begin() const { return iterator(pFirst, 0); }
+		iterator end()   const { return iterator(nullptr, 0); }
+
+		//
+		// Access
+		//
+		V& operator[](const K& k);
+		const V& at(const K& k) const;
+		V& at(const K& k);
+		iterator find(const K& k) const;
+		size_t count(const K& k) const   { return find(k) == end() ? 0 : 1; }
+		bool contains(const K& k) const  { return find(k) != end(); }
+
+		//
+		// Insert
+		//
+		custom::pair<iterator, bool> insert(const value_type& rhs) { return insertPair(rhs); }
+		custom::pair<iterator, bool> insert(value_type&& rhs)      { return insertPair(std::move(rhs)); }
+		template <class Iterator>
+		void insert(Iterator first, Iterator last)
+		{
+			for (; first != last; ++first)
+				insertPair(*first);
+		}
+		void insert(const std::initializer_list<value_type>& il)
+		{
+			insert(il.begin(), il.end());
+		}
+
+		//
+		// Remove
+		//
+		void clear() noexcept;
+		size_t erase(const K& k);
+		iterator erase(iterator it);
+		iterator erase(iterator first, iterator last);
+
+		//
+		// Status
+		//
+		bool empty() const noexcept { return numElements == 0; }
+		size_t size() const noexcept { return numElements; }
+		size_t height() const;
+		size_t bytes_used() const noexcept { return numBytes; }
+
+	private:
+
+		struct Node;
+		struct Leaf;
+		struct Inner;
+
+		// how many pairs fit after the leaf's header, and how many
+		// keys and one more child pointer after the inner node's
+		static const int LEAF_SLOTS =
+			(NodeBytes - 4 * sizeof(void*)) / sizeof(Pairs) < 4 ? 4 :
+			(NodeBytes - 4 * sizeof(void*)) / sizeof(Pairs);
+		static const int INNER_SLOTS =
+			(NodeBytes - 3 * sizeof(void*)) / (sizeof(K) + sizeof(void*)) < 4 ? 4 :
+			(NodeBytes - 3 * sizeof(void*)) / (sizeof(K) + sizeof(void*));
+		// what a split leaves in the smaller half, the least a node may hold
+		static const int LEAF_MIN = LEAF_SLOTS / 2;
+		static const int INNER_MIN = (INNER_SLOTS - 1) / 2;
+
+		template <class U>
+		custom::pair<iterator, bool> insertPair(U&& rhs);
+		template <class Iterator>
+		void build(Iterator first, Iterator last);
+
+		Leaf* findLeaf(const K& k) const;
+		int lowerBound(const Leaf* pLeaf, const K& k) const;
+		int upperBound(const Inner* pInner, const K& k) const;
+		static int childIndex(const Inner* pParent, const Node* pChild);
+		static const K& minKey(const Node* pNode);
+
+		template <class U>
+		iterator insertInLeaf(Leaf* pLeaf, int i, U&& rhs);
+		void insertInParent(Node* pLeft, const K& key, Node* pRight);
+		void rebalanceLeaf(Leaf* pLeaf, Leaf*& pNext, int& iNext);
+		void rebalanceInner(Inner* pInner);
+		void removeChild(Inner* pParent, int i);
+		void destroyNode(Node* pNode) noexcept;
+
+		// the node pool
+		void* allocateNode();
+		void freeNode(Node* pNode) noexcept;
+		Leaf* newLeaf();
+		Inner* newInner();
+
+		// move-construct into pDest and destroy pSrc
+		template <class U>
+		static void relocate(U* pDest, U* pSrc)
+		{
+			new (pDest) U(std::move(*pSrc));
+			pSrc->~U();
+		}
+		// relocate num elements, front to back or back to front as the overlap needs
+		template <class U>
+		static void relocate(U* pDest, U* pSrc, int num)
+		{
+			if (pDest < pSrc)
+				for (int i = 0; i < num; i++)
+					relocate(pDest + i, pSrc + i);
+			else
+				for (int i = num - 1; i >= 0; i--)
+					relocate(pDest + i, pSrc + i);
+		}
+
+		Node* root;
+		Leaf* pFirst;              // the leftmost leaf, where begin() is
+		Leaf* pLast;               // the rightmost leaf, where appends go
+		size_t numElements;
+		Compare compare;
+
+		std::vector<void*> chunks; // what ::operator new gave the pool
+		void* pFree;               // freed nodes, linked through their first word
+		char* pCursor;             // the next never-used node in the newest chunk
+		char* pChunkEnd;
+		size_t numBytes;           // total size of the chunks
+	};
+
+
+	/*****************************************************************
+	 * BTREE MAP NODES
+	 * num is the number of pairs in a leaf, or of keys in an inner
+	 * node, which then has num + 1 children. Leaf and Inner start
+	 * with the same header so either can be reached through a Node*
+	 *****************************************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	struct btree_map <K, V, Compare, NodeBytes> ::Node
+	{
+		Inner* pParent;
+		unsigned short num;
+		bool isLeaf;
+	};
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	struct btree_map <K, V, Compare, NodeBytes> ::Leaf : Node
+	{
+		Pairs* pairs() { return reinterpret_cast<Pairs*>(slots); }
+		const Pairs* pairs() const { return reinterpret_cast<const Pairs*>(slots); }
+
+		Leaf* pPrev;
+		Leaf* pNext;
+		typename std::aligned_storage<sizeof(Pairs), alignof(Pairs)>::type slots[LEAF_SLOTS];
+	};
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	struct btree_map <K, V, Compare, NodeBytes> ::Inner : Node
+	{
+		K* keys() { return reinterpret_cast<K*>(slots); }
+		const K* keys() const { return reinterpret_cast<const K*>(slots); }
+
+		// every key in children[i] is < keys[i] <= every key in children[i + 1]
+		Node* children[INNER_SLOTS + 1];
+		typename std::aligned_storage<sizeof(K), alignof(K)>::type slots[INNER_SLOTS];
+	};
+
+
+	/**********************************************************
+	 * BTREE MAP ITERATOR
+	 * A leaf and a position in it. Forward and reverse
+	 *********************************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	class btree_map <K, V, Compare, NodeBytes> ::iterator
+	{
+		friend class ::TestBTreeMap; // give unit tests access to the privates
+		friend class btree_map;
+	public:
+		//
+		// Construct
+		//
+		iterator() : pLeaf(nullptr), index(0) {}
+		iterator(Leaf* pLeaf, int index) : pLeaf(pLeaf), index(index) {}
+
+		//
+		// Compare
+		//
+		bool operator == (const iterator& rhs) const { return pLeaf == rhs.pLeaf && index == rhs.index; }
+		bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+		//
+		// Access
+		//
+		const Pairs& operator * () const { return pLeaf->pairs()[index]; }
+
+		//
+		// Increment
+		//
+		iterator& operator ++ ()
+		{
+			if (pLeaf && ++index == pLeaf->num)
+			{
+				pLeaf = pLeaf->pNext;
+				index = 0;
+			}
+			return *this;
+		}
+		iterator operator ++ (int)
+		{
+			iterator tmp = *this;
+			++(*this);
+			return tmp;
+		}
+		iterator& operator -- ()
+		{
+			if (pLeaf == nullptr)
+				return *this;
+			if (index > 0)
+				index--;
+			else
+			{
+				// before the first pair is end(), as it is for map
+				pLeaf = pLeaf->pPrev;
+				index = pLeaf ? pLeaf->num - 1 : 0;
+			}
+			return *this;
+		}
+		iterator operator -- (int)
+		{
+			iterator tmp = *this;
+			--(*this);
+			return tmp;
+		}
+
+	private:
+		Leaf* pLeaf;
+		int index;
+	};
+
+
+	/*********************************************
+	 * BTREE MAP :: SWAP
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::swap(btree_map& rhs)
+	{
+		std::swap(root, rhs.root);
+		std::swap(pFirst, rhs.pFirst);
+		std::swap(pLast, rhs.pLast);
+		std::swap(numElements, rhs.numElements);
+		std::swap(compare, rhs.compare);
+		chunks.swap(rhs.chunks);
+		std::swap(pFree, rhs.pFree);
+		std::swap(pCursor, rhs.pCursor);
+		std::swap(pChunkEnd, rhs.pChunkEnd);
+		std::swap(numBytes, rhs.numBytes);
+	}
+
+	/*********************************************
+	 * BTREE MAP :: SQUARE BRACKET
+	 * Add a default V when k is not there yet
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	V& btree_map <K, V, Compare, NodeBytes> ::operator[](const K& k)
+	{
+		iterator it = find(k);
+		if (it == end())
+			it = insertPair(Pairs(k, V())).first;
+		return it.pLeaf->pairs()[it.index].second;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: AT
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	const V& btree_map <K, V, Compare, NodeBytes> ::at(const K& k) const
+	{
+		iterator it = find(k);
+		if (it == end())
+			throw std::out_of_range("invalid map<K, T> key");
+		return it.pLeaf->pairs()[it.index].second;
+	}
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	V& btree_map <K, V, Compare, NodeBytes> ::at(const K& k)
+	{
+		iterator it = find(k);
+		if (it == end())
+			throw std::out_of_range("invalid map<K, T> key");
+		return it.pLeaf->pairs()[it.index].second;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: FIND
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::iterator btree_map <K, V, Compare, NodeBytes> ::find(const K& k) const
+	{
+		if (root == nullptr)
+			return end();
+		Leaf* pLeaf = findLeaf(k);
+		int i = lowerBound(pLeaf, k);
+		if (i < pLeaf->num && !compare(k, pLeaf->pairs()[i].first))
+			return iterator(pLeaf, i);
+		return end();
+	}
+
+	/*********************************************
+	 * BTREE MAP :: HEIGHT
+	 * Levels from the root to the leaves, all equal
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	size_t btree_map <K, V, Compare, NodeBytes> ::height() const
+	{
+		size_t num = 0;
+		for (const Node* p = root; p; p = p->isLeaf ? nullptr : static_cast<const Inner*>(p)->children[0])
+			num++;
+		return num;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: INSERT PAIR
+	 * Keys are unique, so an existing key wins
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	template <class U>
+	custom::pair<typename btree_map <K, V, Compare, NodeBytes> ::iterator, bool> btree_map <K, V, Compare, NodeBytes> ::insertPair(U&& rhs)
+	{
+		if (root == nullptr)
+			root = pFirst = pLast = newLeaf();
+
+		Leaf* pLeaf = findLeaf(rhs.first);
+		int i = lowerBound(pLeaf, rhs.first);
+		if (i < pLeaf->num && !compare(rhs.first, pLeaf->pairs()[i].first))
+			return custom::pair<iterator, bool>(iterator(pLeaf, i), false);
+
+		iterator it = insertInLeaf(pLeaf, i, std::forward<U>(rhs));
+		numElements++;
+		return custom::pair<iterator, bool>(it, true);
+	}
+
+	/*********************************************
+	 * BTREE MAP :: INSERT IN LEAF
+	 * Put rhs at position i. A full leaf is split
+	 * first: in half, or, when appending past the
+	 * last pair of the last leaf, not at all, so
+	 * ascending inserts leave every leaf full
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	template <class U>
+	typename btree_map <K, V, Compare, NodeBytes> ::iterator btree_map <K, V, Compare, NodeBytes> ::insertInLeaf(Leaf* pLeaf, int i, U&& rhs)
+	{
+		if (pLeaf->num < LEAF_SLOTS)
+		{
+			relocate(pLeaf->pairs() + i + 1, pLeaf->pairs() + i, pLeaf->num - i);
+			new (pLeaf->pairs() + i) Pairs(std::forward<U>(rhs));
+			pLeaf->num++;
+			return iterator(pLeaf, i);
+		}
+
+		// split: pairs from mid on move to a new leaf to the right
+		bool isAppend = (pLeaf == pLast && i == pLeaf->num);
+		int mid = isAppend ? pLeaf->num : pLeaf->num / 2;
+		Leaf* pRight = newLeaf();
+		relocate(pRight->pairs(), pLeaf->pairs() + mid, pLeaf->num - mid);
+		pRight->num = pLeaf->num - mid;
+		pLeaf->num = mid;
+
+		pRight->pNext = pLeaf->pNext;
+		pRight->pPrev = pLeaf;
+		if (pLeaf->pNext)
+			pLeaf->pNext->pPrev = pRight;
+		else
+			pLast = pRight;
+		pLeaf->pNext = pRight;
+
+		iterator it = (i < mid || (i == mid && !isAppend)) ?
+			insertInLeaf(pLeaf, i, std::forward<U>(rhs)) :
+			insertInLeaf(pRight, i - mid, std::forward<U>(rhs));
+
+		insertInParent(pLeaf, pRight->pairs()[0].first, pRight);
+		return it;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: INSERT IN PARENT
+	 * pRight was just split off pLeft, and key is
+	 * the smallest key under it. A full parent
+	 * splits in half, sending its middle key up
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::insertInParent(Node* pLeft, const K& key, Node* pRight)
+	{
+		// a new root
+		if (pLeft == root)
+		{
+			Inner* pRoot = newInner();
+			new (pRoot->keys()) K(key);
+			pRoot->children[0] = pLeft;
+			pRoot->children[1] = pRight;
+			pRoot->num = 1;
+			pLeft->pParent = pRight->pParent = pRoot;
+			root = pRoot;
+			return;
+		}
+
+		Inner* pParent = pLeft->pParent;
+		int i = childIndex(pParent, pLeft);     // key goes at i, pRight at i + 1
+
+		if (pParent->num == INNER_SLOTS)
+		{
+			// keys after mid and the children after them go right, mid goes up
+			int mid = INNER_SLOTS / 2;
+			Inner* pSplit = newInner();
+			relocate(pSplit->keys(), pParent->keys() + mid + 1, INNER_SLOTS - mid - 1);
+			for (int j = mid + 1; j <= INNER_SLOTS; j++)
+			{
+				pSplit->children[j - mid - 1] = pParent->children[j];
+				pParent->children[j]->pParent = pSplit;
+			}
+			pSplit->num = INNER_SLOTS - mid - 1;
+			pParent->num = mid;
+
+			// keep the middle key out of the node while the new one goes in
+			K keyUp(std::move(pParent->keys()[mid]));
+			pParent->keys()[mid].~K();
+
+			if (i <= mid)
+				insertInParent(pLeft, key, pRight);
+			else
+			{
+				Inner* pInto = pSplit;
+				int j = i - mid - 1;
+				relocate(pInto->keys() + j + 1, pInto->keys() + j, pInto->num - j);
+				new (pInto->keys() + j) K(key);
+				for (int c = pInto->num + 1; c > j + 1; c--)
+					pInto->children[c] = pInto->children[c - 1];
+				pInto->children[j + 1] = pRight;
+				pRight->pParent = pInto;
+				pInto->num++;
+			}
+
+			insertInParent(pParent, keyUp, pSplit);
+			return;
+		}
+
+		relocate(pParent->keys() + i + 1, pParent->keys() + i, pParent->num - i);
+		new (pParent->keys() + i) K(key);
+		for (int c = pParent->num + 1; c > i + 1; c--)
+			pParent->children[c] = pParent->children[c - 1];
+		pParent->children[i + 1] = pRight;
+		pRight->pParent = pParent;
+		pParent->num++;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: ERASE BY KEY
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	size_t btree_map <K, V, Compare, NodeBytes> ::erase(const K& k)
+	{
+		iterator it = find(k);
+		if (it == end())
+			return 0;
+		erase(it);
+		return 1;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: ERASE
+	 * Take the pair out of its leaf. A leaf left
+	 * under half full borrows from or merges with
+	 * a sibling, and that may ripple upwards. The
+	 * pair after the erased one is followed through
+	 * all of it, so the returned iterator is good
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::iterator btree_map <K, V, Compare, NodeBytes> ::erase(iterator it)
+	{
+		Leaf* pLeaf = it.pLeaf;
+		if (pLeaf == nullptr)
+			return end();
+		int i = it.index;
+
+		pLeaf->pairs()[i].~Pairs();
+		relocate(pLeaf->pairs() + i, pLeaf->pairs() + i + 1, pLeaf->num - i - 1);
+		pLeaf->num--;
+		numElements--;
+
+		// where the next pair is now
+		Leaf* pNext = pLeaf;
+		int iNext = i;
+		if (iNext == pLeaf->num)
+		{
+			pNext = pLeaf->pNext;
+			iNext = 0;
+		}
+
+		if (pLeaf == root)
+		{
+			if (pLeaf->num == 0)
+			{
+				freeNode(pLeaf);
+				root = pFirst = pLast = nullptr;
+			}
+		}
+		else if (pLeaf->num < LEAF_MIN)
+			rebalanceLeaf(pLeaf, pNext, iNext);
+
+		return iterator(pNext, iNext);
+	}
+
+	/*********************************************
+	 * BTREE MAP :: ERASE RANGE
+	 * Erasing moves pairs, so last would not stay
+	 * put. Count first and erase that many
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::iterator btree_map <K, V, Compare, NodeBytes> ::erase(iterator first, iterator last)
+	{
+		size_t num = 0;
+		for (iterator it = first; it != last; ++it)
+			num++;
+		while (num--)
+			first = erase(first);
+		return first;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: REBALANCE LEAF
+	 * Merge with a sibling when both fit in one
+	 * leaf, otherwise borrow a single pair from it.
+	 * Prefer the left sibling. (pNext, iNext) is
+	 * moved along with its pair
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::rebalanceLeaf(Leaf* pLeaf, Leaf*& pNext, int& iNext)
+	{
+		Inner* pParent = pLeaf->pParent;
+		int i = childIndex(pParent, pLeaf);
+
+		if (i > 0)
+		{
+			Leaf* pLeft = static_cast<Leaf*>(pParent->children[i - 1]);
+			assert(pLeft == pLeaf->pPrev);
+			if (pLeft->num + pLeaf->num <= LEAF_SLOTS)
+			{
+				// merge pLeaf onto the end of pLeft
+				if (pNext == pLeaf)
+				{
+					pNext = pLeft;
+					iNext += pLeft->num;
+				}
+				relocate(pLeft->pairs() + pLeft->num, pLeaf->pairs(), pLeaf->num);
+				pLeft->num += pLeaf->num;
+				pLeft->pNext = pLeaf->pNext;
+				if (pLeaf->pNext)
+					pLeaf->pNext->pPrev = pLeft;
+				else
+					pLast = pLeft;
+				removeChild(pParent, i);
+				freeNode(pLeaf);
+				rebalanceInner(pParent);
+			}
+			else
+			{
+				// pLeft's last pair becomes pLeaf's first
+				relocate(pLeaf->pairs() + 1, pLeaf->pairs(), pLeaf->num);
+				relocate(pLeaf->pairs(), pLeft->pairs() + pLeft->num - 1);
+				pLeft->num--;
+				pLeaf->num++;
+				if (pNext == pLeaf)
+					iNext++;
+				pParent->keys()[i - 1] = pLeaf->pairs()[0].first;
+			}
+		}
+		else
+		{
+			Leaf* pRight = static_cast<Leaf*>(pParent->children[1]);
+			assert(pRight == pLeaf->pNext);
+			if (pLeaf->num + pRight->num <= LEAF_SLOTS)
+			{
+				// merge pRight onto the end of pLeaf
+				if (pNext == pRight)
+				{
+					pNext = pLeaf;
+					iNext += pLeaf->num;
+				}
+				relocate(pLeaf->pairs() + pLeaf->num, pRight->pairs(), pRight->num);
+				pLeaf->num += pRight->num;
+				pLeaf->pNext = pRight->pNext;
+				if (pRight->pNext)
+					pRight->pNext->pPrev = pLeaf;
+				else
+					pLast = pLeaf;
+				removeChild(pParent, 1);
+				freeNode(pRight);
+				rebalanceInner(pParent);
+			}
+			else
+			{
+				// pRight's first pair becomes pLeaf's last
+				relocate(pLeaf->pairs() + pLeaf->num, pRight->pairs());
+				relocate(pRight->pairs(), pRight->pairs() + 1, pRight->num - 1);
+				pLeaf->num++;
+				pRight->num--;
+				if (pNext == pRight)
+				{
+					if (iNext == 0)
+					{
+						pNext = pLeaf;
+						iNext = pLeaf->num - 1;
+					}
+					else
+						iNext--;
+				}
+				pParent->keys()[0] = pRight->pairs()[0].first;
+			}
+		}
+	}
+
+	/*********************************************
+	 * BTREE MAP :: REBALANCE INNER
+	 * The same for an inner node that just lost a
+	 * child, except the parent's key between the
+	 * two siblings comes down into the result. A
+	 * root with a single child hands it the root
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::rebalanceInner(Inner* pInner)
+	{
+		if (pInner == root)
+		{
+			if (pInner->num == 0)
+			{
+				root = pInner->children[0];
+				root->pParent = nullptr;
+				freeNode(pInner);
+			}
+			return;
+		}
+		if (pInner->num >= INNER_MIN)
+			return;
+
+		Inner* pParent = pInner->pParent;
+		int i = childIndex(pParent, pInner);
+
+		if (i > 0)
+		{
+			Inner* pLeft = static_cast<Inner*>(pParent->children[i - 1]);
+			if (pLeft->num + pInner->num + 1 <= INNER_SLOTS)
+			{
+				// merge pInner onto the end of pLeft, the key between them first
+				new (pLeft->keys() + pLeft->num) K(std::move(pParent->keys()[i - 1]));
+				relocate(pLeft->keys() + pLeft->num + 1, pInner->keys(), pInner->num);
+				for (int c = 0; c <= pInner->num; c++)
+				{
+					pLeft->children[pLeft->num + 1 + c] = pInner->children[c];
+					pInner->children[c]->pParent = pLeft;
+				}
+				pLeft->num += pInner->num + 1;
+				removeChild(pParent, i);
+				freeNode(pInner);
+				rebalanceInner(pParent);
+			}
+			else
+			{
+				// rotate right: pLeft's last child moves over, its key goes up
+				relocate(pInner->keys() + 1, pInner->keys(), pInner->num);
+				new (pInner->keys()) K(std::move(pParent->keys()[i - 1]));
+				for (int c = pInner->num + 1; c > 0; c--)
+					pInner->children[c] = pInner->children[c - 1];
+				pInner->children[0] = pLeft->children[pLeft->num];
+				pInner->children[0]->pParent = pInner;
+				pInner->num++;
+
+				pParent->keys()[i - 1] = std::move(pLeft->keys()[pLeft->num - 1]);
+				pLeft->keys()[pLeft->num - 1].~K();
+				pLeft->num--;
+			}
+		}
+		else
+		{
+			Inner* pRight = static_cast<Inner*>(pParent->children[1]);
+			if (pInner->num + pRight->num + 1 <= INNER_SLOTS)
+			{
+				// merge pRight onto the end of pInner
+				new (pInner->keys() + pInner->num) K(std::move(pParent->keys()[0]));
+				relocate(pInner->keys() + pInner->num + 1, pRight->keys(), pRight->num);
+				for (int c = 0; c <= pRight->num; c++)
+				{
+					pInner->children[pInner->num + 1 + c] = pRight->children[c];
+					pRight->children[c]->pParent = pInner;
+				}
+				pInner->num += pRight->num + 1;
+				removeChild(pParent, 1);
+				freeNode(pRight);
+				rebalanceInner(pParent);
+			}
+			else
+			{
+				// rotate left: pRight's first child moves over, its key goes up
+				new (pInner->keys() + pInner->num) K(std::move(pParent->keys()[0]));
+				pInner->children[pInner->num + 1] = pRight->children[0];
+				pRight->children[0]->pParent = pInner;
+				pInner->num++;
+
+				pParent->keys()[0] = std::move(pRight->keys()[0]);
+				pRight->keys()[0].~K();
+				relocate(pRight->keys(), pRight->keys() + 1, pRight->num - 1);
+				for (int c = 0; c < pRight->num; c++)
+					pRight->children[c] = pRight->children[c + 1];
+				pRight->num--;
+			}
+		}
+	}
+
+	/*********************************************
+	 * BTREE MAP :: REMOVE CHILD
+	 * Drop children[i] and the key to its left
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::removeChild(Inner* pParent, int i)
+	{
+		assert(i > 0);
+		pParent->keys()[i - 1].~K();
+		relocate(pParent->keys() + i - 1, pParent->keys() + i, pParent->num - i);
+		for (int c = i; c < pParent->num; c++)
+			pParent->children[c] = pParent->children[c + 1];
+		pParent->num--;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: CLEAR
+	 * Destroy every pair and key, then give the
+	 * pool back all at once
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::clear() noexcept
+	{
+		if (root)
+			destroyNode(root);
+		for (void* p : chunks)
+			::operator delete(p);
+		chunks.clear();
+		root = nullptr;
+		pFirst = pLast = nullptr;
+		numElements = 0;
+		pFree = nullptr;
+		pCursor = pChunkEnd = nullptr;
+		numBytes = 0;
+	}
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::destroyNode(Node* pNode) noexcept
+	{
+		if (pNode->isLeaf)
+		{
+			Leaf* pLeaf = static_cast<Leaf*>(pNode);
+			for (int i = 0; i < pLeaf->num; i++)
+				pLeaf->pairs()[i].~Pairs();
+			pLeaf->~Leaf();
+		}
+		else
+		{
+			Inner* pInner = static_cast<Inner*>(pNode);
+			for (int i = 0; i < pInner->num; i++)
+				pInner->keys()[i].~K();
+			for (int i = 0; i <= pInner->num; i++)
+				destroyNode(pInner->children[i]);
+			pInner->~Inner();
+		}
+	}
+
+	/*********************************************
+	 * BTREE MAP :: BUILD
+	 * Bulk load from the front of the range while it
+	 * is strictly ascending: fill leaves one after
+	 * the other, then each level of inner nodes from
+	 * the one below. The last node of a level takes
+	 * enough from the one before it to be half full.
+	 * Anything after that is inserted one at a time
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	template <class Iterator>
+	void btree_map <K, V, Compare, NodeBytes> ::build(Iterator first, Iterator last)
+	{
+		assert(root == nullptr);
+
+		// the leaves
+		std::vector<Node*> level;
+		Leaf* pLeaf = nullptr;
+		for (; first != last; ++first)
+		{
+			if (pLeaf && !compare(pLeaf->pairs()[pLeaf->num - 1].first, (*first).first))
+				break;
+			if (pLeaf == nullptr || pLeaf->num == LEAF_SLOTS)
+			{
+				Leaf* pNew = newLeaf();
+				pNew->pPrev = pLeaf;
+				if (pLeaf)
+					pLeaf->pNext = pNew;
+				else
+					pFirst = pNew;
+				pLeaf = pNew;
+				level.push_back(pLeaf);
+			}
+			new (pLeaf->pairs() + pLeaf->num) Pairs(*first);
+			pLeaf->num++;
+			numElements++;
+		}
+		pLast = pLeaf;
+
+		if (level.size() > 1 && pLast->num < LEAF_MIN)
+		{
+			Leaf* pPrev = pLast->pPrev;
+			int num = LEAF_MIN - pLast->num;
+			relocate(pLast->pairs() + num, pLast->pairs(), pLast->num);
+			relocate(pLast->pairs(), pPrev->pairs() + pPrev->num - num, num);
+			pLast->num += num;
+			pPrev->num -= num;
+		}
+
+		// the inner levels
+		while (level.size() > 1)
+		{
+			std::vector<Node*> above;
+			size_t per = INNER_SLOTS + 1;
+			size_t numGroups = (level.size() + per - 1) / per;
+			for (size_t g = 0, c = 0; g < numGroups; g++)
+			{
+				// the last two groups share what is left when it is too little for one
+				size_t num = per;
+				size_t numLeft = level.size() - c;
+				if (g + 2 == numGroups && numLeft - per < INNER_MIN + 1)
+					num = numLeft / 2;
+				else if (g + 1 == numGroups)
+					num = numLeft;
+
+				Inner* pInner = newInner();
+				for (size_t j = 0; j < num; j++, c++)
+				{
+					if (j > 0)
+						new (pInner->keys() + j - 1) K(minKey(level[c]));
+					pInner->children[j] = level[c];
+					level[c]->pParent = pInner;
+				}
+				pInner->num = static_cast<unsigned short>(num - 1);
+				above.push_back(pInner);
+			}
+			level.swap(above);
+		}
+		root = level.empty() ? nullptr : level[0];
+
+		for (; first != last; ++first)
+			insertPair(*first);
+	}
+
+	/*********************************************
+	 * BTREE MAP :: FIND LEAF
+	 * The only leaf where k can be
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::Leaf* btree_map <K, V, Compare, NodeBytes> ::findLeaf(const K& k) const
+	{
+		Node* p = root;
+		while (!p->isLeaf)
+		{
+			const Inner* pInner = static_cast<const Inner*>(p);
+			p = pInner->children[upperBound(pInner, k)];
+		}
+		return static_cast<Leaf*>(p);
+	}
+
+	/*********************************************
+	 * BTREE MAP :: LOWER BOUND
+	 * The first pair in the leaf not less than k
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	int btree_map <K, V, Compare, NodeBytes> ::lowerBound(const Leaf* pLeaf, const K& k) const
+	{
+		const Pairs* pairs = pLeaf->pairs();
+		int lo = 0;
+		int hi = pLeaf->num;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (compare(pairs[mid].first, k))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: UPPER BOUND
+	 * The first key in the inner node greater than
+	 * k, which is also the child to follow
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	int btree_map <K, V, Compare, NodeBytes> ::upperBound(const Inner* pInner, const K& k) const
+	{
+		const K* keys = pInner->keys();
+		int lo = 0;
+		int hi = pInner->num;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (compare(k, keys[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: CHILD INDEX
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	int btree_map <K, V, Compare, NodeBytes> ::childIndex(const Inner* pParent, const Node* pChild)
+	{
+		int i = 0;
+		while (pParent->children[i] != pChild)
+			i++;
+		assert(i <= pParent->num);
+		return i;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: MIN KEY
+	 * The smallest key under pNode
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	const K& btree_map <K, V, Compare, NodeBytes> ::minKey(const Node* pNode)
+	{
+		while (!pNode->isLeaf)
+			pNode = static_cast<const Inner*>(pNode)->children[0];
+		return static_cast<const Leaf*>(pNode)->pairs()[0].first;
+	}
+
+	/*********************************************
+	 * BTREE MAP :: ALLOCATE NODE
+	 * From the free list, else the newest chunk.
+	 * Chunks double from one node up to 64, and
+	 * each is slid up to a cache line
+	 ********************************************/
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void* btree_map <K, V, Compare, NodeBytes> ::allocateNode()
+	{
+		const size_t NODE_BYTES = ((sizeof(Leaf) > sizeof(Inner) ? sizeof(Leaf) : sizeof(Inner)) + 63) / 64 * 64;
+
+		if (pFree)
+		{
+			void* p = pFree;
+			pFree = *static_cast<void**>(p);
+			return p;
+		}
+
+		if (pCursor == pChunkEnd)
+		{
+			size_t numNodes = chunks.size() < 6 ? size_t(1) << chunks.size() : 64;
+			size_t size = numNodes * NODE_BYTES + 63;
+			chunks.reserve(chunks.size() + 1);
+			void* pRaw = ::operator new(size);
+			chunks.push_back(pRaw);
+			numBytes += size;
+
+			uintptr_t address = reinterpret_cast<uintptr_t>(pRaw);
+			address = (address + 63) & ~static_cast<uintptr_t>(63);
+			pCursor = reinterpret_cast<char*>(address);
+			pChunkEnd = pCursor + numNodes * NODE_BYTES;
+		}
+
+		void* p = pCursor;
+		pCursor += NODE_BYTES;
+		return p;
+	}
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	void btree_map <K, V, Compare, NodeBytes> ::freeNode(Node* pNode) noexcept
+	{
+		*reinterpret_cast<void**>(pNode) = pFree;
+		pFree = pNode;
+	}
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::Leaf* btree_map <K, V, Compare, NodeBytes> ::newLeaf()
+	{
+		Leaf* p = new (allocateNode()) Leaf;
+		p->pParent = nullptr;
+		p->num = 0;
+		p->isLeaf = true;
+		p->pPrev = p->pNext = nullptr;
+		return p;
+	}
+
+	template <class K, class V, class Compare, size_t NodeBytes>
+	typename btree_map <K, V, Compare, NodeBytes> ::Inner* btree_map <K, V, Compare, NodeBytes> ::newInner()
+	{
+		Inner* p = new (allocateNode()) Inner;
+		p->pParent = nullptr;
+		p->num = 0;
+		p->isLeaf = false;
+		return p;
+	}
+
+}; //  namespace custom
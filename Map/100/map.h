@@ -13,6 +13,10 @@
  *    This will contain the class definition of:
  *        map                 : A class that represents a map
  *        map::iterator       : An iterator through a map
+ *
+ *    The third template parameter picks the ordered container holding
+ *    the pairs. It defaults to the BST; skiplist offers the same
+ *    interface and can be used instead.
  * Author
  *    <your names here>
  ************************************************************************/
@@ -21,6 +25,8 @@
 
 #include "pair.h"     // for pair
 #include "bst.h"      // no nested class necessary for this assignment
+#include "skiplist.h" // the other container map can be built on
+#include <utility>    // for std::declval
 
 #ifndef debug
 #ifdef DEBUG
@@ -39,7 +45,7 @@ namespace custom
 	 * MAP
 	 * Create a Map, similar to a Binary Search Tree
 	 *****************************************************************/
-	template <class K, class V>
+	template <class K, class V, class Container = BST<custom::pair<K, V>>>
 	class map
 	{
 		friend ::TestMap; // give unit tests access to the privates
@@ -49,6 +55,24 @@ namespace custom
 		using Pairs = custom::pair<K, V>;
 		using value_type = custom::pair<K, V>;
 
+	private:
+		// orders a pair against a bare key, so lookups never build a V
+		struct KeyLess
+		{
+			template <class KK>
+			bool operator()(const Pairs& p, const KK& k) const { return p.first < k; }
+			template <class KK>
+			bool operator()(const KK& k, const Pairs& p) const { return k < p.first; }
+			bool operator()(const K& lhs, const K& rhs) const { return lhs < rhs; }
+		};
+
+		// enabled when KK and K can be compared with < both ways
+		template <class KK>
+		using IfComparable = decltype(std::declval<const KK&>() < std::declval<const K&>(),
+		                              std::declval<const K&>() < std::declval<const KK&>(),
+		                              void());
+	public:
+
 		// 
 		// Construct
 		//
@@ -64,22 +88,16 @@ namespace custom
 		{
 		}
 
+		// input already in key order is built in O(n)
 		template <class Iterator>
 		map(Iterator first, Iterator last)
 		{
-			while (first != last)
-			{
-				bst.insert(*first);
-				++first;
-			}
+			bst.assign(first, last);
 		}
 
 		map(const std::initializer_list<value_type>& il) : bst()
 		{
-			for (auto it = il.begin(); it != il.end(); ++it)
-			{
-				bst.insert(*it);
-			}
+			bst.assign(il.begin(), il.end());
 		}
 
 		~map()
@@ -110,11 +128,7 @@ namespace custom
 
 		map& operator = (const std::initializer_list<value_type>& il)
 		{
-			clear();
-			for (auto it = il.begin(); it != il.end(); ++it)
-			{
-				bst.insert(*it);
-			}
+			bst.assign(il.begin(), il.end());
 			return *this;
 		}
 
@@ -139,7 +153,7 @@ namespace custom
 		//
 		const V& operator[](const K& k) const
 		{
-			typename BST<value_type>::iterator it = bst.find(custom::make_pair(k, V()));
+			typename Container::iterator it = bst.find(k, KeyLess());
 			if (it == bst.end())
 			{
 				throw std::out_of_range("Key not found");
@@ -149,25 +163,13 @@ namespace custom
 
 		V& operator[](const K& k)
 		{
-			// Create default pair for lookup
-			Pairs pair = k, Value();
-			typename BST<Pairs>::iterator it = bst.find(pair);
-
-			// If node exists, return the value
-			if (it.pNode)
-				return it.pNode->data.second;
-
-			// Add the node
-			bst.insert(pair);
-
-			// Re-find the node and return the value
-			return bst.find(pair).pNode->data.second;
+			// one walk down, and V() only when k is new
+			return bst.find_or_insert(k, KeyLess(), [&k]() { return Pairs(k, V()); }).first.pNode->data.second;
 		}
 
 		const V& at(const K& k) const
 		{
-			Pairs pair = k, Value();
-			typename BST<Pairs>::iterator it = bst.find(pair);
+			typename Container::iterator it = bst.find(k, KeyLess());
 
 			// If node exists, return the value
 			if (it.pNode)
@@ -179,9 +181,7 @@ namespace custom
 
 		V& at(const K& k)
 		{
-			// Create default pair for lookup
-			Pairs pair = k, Value();
-			typename BST<Pairs>::iterator it = bst.find(pair);
+			typename Container::iterator it = bst.find(k, KeyLess());
 
 			// If node exists, return the value
 			if (it.pNode)
@@ -193,9 +193,70 @@ namespace custom
 
 		iterator find(const K& k)
 		{
-			return iterator(bst.find(custom::make_pair(k, V())));
+			return iterator(bst.find(k, KeyLess()));
+		}
+		size_t count(const K& k)
+		{
+			return find(k) == end() ? 0 : 1;
+		}
+		bool contains(const K& k)
+		{
+			return find(k) != end();
+		}
+
+		// Any key that orders against K with < is looked up as-is,
+		// so find("abc") on a map of std::string makes no string
+		template <class KK, class = IfComparable<KK>>
+		iterator find(const KK& k)
+		{
+			return iterator(bst.find(k, KeyLess()));
+		}
+		template <class KK, class = IfComparable<KK>>
+		size_t count(const KK& k)
+		{
+			return find(k) == end() ? 0 : 1;
+		}
+		template <class KK, class = IfComparable<KK>>
+		bool contains(const KK& k)
+		{
+			return find(k) != end();
+		}
+
+		// the first pair whose key is not less than k, the first greater
+		// than k, and the (at most one) pair between them
+		iterator lower_bound(const K& k)
+		{
+			return iterator(bst.lower_bound(k, KeyLess()));
+		}
+		iterator upper_bound(const K& k)
+		{
+			return iterator(bst.upper_bound(k, KeyLess()));
+		}
+		custom::pair<iterator, iterator> equal_range(const K& k)
+		{
+			return custom::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
 		}
 
+		// the pairs with keys in [lo, hi), for a range-based for. Only
+		// for a Container that has a view, so only looked up when used
+		template <class C = Container>
+		typename C::range_view range(const K& lo, const K& hi) const
+		{
+			return bst.range(lo, hi, KeyLess());
+		}
+
+#ifdef BST_ORDER_STATISTICS
+		// the pair with k pairs before it, and how many keys are less than k
+		iterator select(size_t k)
+		{
+			return iterator(bst.select(k));
+		}
+		size_t rank(const K& k) const
+		{
+			return bst.rank(k, KeyLess());
+		}
+#endif // BST_ORDER_STATISTICS
+
 		// 
 		// Insert
 		//
@@ -211,6 +272,50 @@ namespace custom
 			return custom::make_pair(iterator(result.first), result.second);
 		}
 
+		// insert k with V(args...) unless k is already there, in which
+		// case the args are left alone. One walk down either way
+		template <class... Args>
+		custom::pair<iterator, bool> try_emplace(const K& k, Args&&... args)
+		{
+			auto result = bst.find_or_insert(k, KeyLess(),
+				[&]() { return Pairs(k, V(std::forward<Args>(args)...)); });
+			return custom::make_pair(iterator(result.first), result.second);
+		}
+		template <class... Args>
+		custom::pair<iterator, bool> try_emplace(K&& k, Args&&... args)
+		{
+			auto result = bst.find_or_insert(k, KeyLess(),
+				[&]() { return Pairs(std::move(k), V(std::forward<Args>(args)...)); });
+			return custom::make_pair(iterator(result.first), result.second);
+		}
+		template <class... Args>
+		iterator try_emplace(iterator hint, const K& k, Args&&... args)
+		{
+			return iterator(bst.find_or_insert(hint.it, k, KeyLess(),
+				[&]() { return Pairs(k, V(std::forward<Args>(args)...)); }).first);
+		}
+
+		// insert k with obj, or give obj to the V already there
+		template <class M>
+		custom::pair<iterator, bool> insert_or_assign(const K& k, M&& obj)
+		{
+			auto result = bst.find_or_insert(k, KeyLess(),
+				[&]() { return Pairs(k, V(std::forward<M>(obj))); });
+			if (!result.second)
+				result.first.pNode->data.second = std::forward<M>(obj);
+			return custom::make_pair(iterator(result.first), result.second);
+		}
+
+		// the pair has to be made to know its key, but the search for
+		// where it goes starts at hint
+		template <class... Args>
+		iterator emplace_hint(iterator hint, Args&&... args)
+		{
+			Pairs pair(std::forward<Args>(args)...);
+			return iterator(bst.find_or_insert(hint.it, pair.first, KeyLess(),
+				[&pair]() { return std::move(pair); }).first);
+		}
+
 		template <class Iterator>
 		void insert(Iterator first, Iterator last)
 		{
@@ -239,7 +344,7 @@ namespace custom
 
 		size_t erase(const K& k)
 		{
-			auto it = bst.find(custom::make_pair(k, V()));
+			auto it = bst.find(k, KeyLess());
 			if (it == bst.end())
 			{
 				return 0;
@@ -272,20 +377,20 @@ namespace custom
 	private:
 
 		// the students DO NOT need to use a nested class
-		BST < custom::pair<K, V >> bst;
+		Container bst;
 	};
 
 
 	/**********************************************************
 	 * MAP ITERATOR
 	 * Forward and reverse iterator through a Map, just call
-	 * through to BSTIterator
+	 * through to the container's iterator
 	 *********************************************************/
-	template <typename K, typename V>
-	class map <K, V> ::iterator
+	template <typename K, typename V, typename Container>
+	class map <K, V, Container> ::iterator
 	{
 		friend class ::TestMap; // give unit tests access to the privates
-		template <class KK, class VV>
+		template <class KK, class VV, class CC>
 		friend class custom::map;
 	public:
 		//
@@ -293,7 +398,7 @@ namespace custom
 		//
 		iterator() : it() {}
 
-		iterator(const typename BST<custom::pair<K, V>>::iterator& rhs) : it(rhs) {}
+		iterator(const typename Container::iterator& rhs) : it(rhs) {}
 
 		iterator(const iterator& rhs) : it(rhs.it) {}
 
@@ -352,8 +457,21 @@ namespace custom
 			return tmp;
 		}
 
+#ifdef BST_ORDER_STATISTICS
+		iterator& operator+=(ptrdiff_t n)
+		{
+			it += n;
+			return *this;
+		}
+		iterator& operator-=(ptrdiff_t n)
+		{
+			it -= n;
+			return *this;
+		}
+#endif // BST_ORDER_STATISTICS
+
 	private:
-		typename BST<custom::pair<K, V>>::iterator it;
+		typename Container::iterator it;
 	};
 
 }; //  namespace custom
@@ -0,0 +1,636 @@
+/***********************************************************************
+ * Header:
+ *    SKIP LIST
+ * Summary:
+ *    An ordered container with expected O(log n) search, usable by
+ *    map in place of the BST
+ *      __       ____       ____         __
+ *     /  |    .'    '.   .'    '.   _  / /
+ *     `| |   |  .--.  | |  .--.  | (_)/ /
+ *      | |   | |    | | | |    | |   / / _
+ *     _| |_  |  `--'  | |  `--'  |  / / (_)
+ *    |_____|  '.____.'   '.____.'  /_/
+ *
+ *    This will contain the class definition of:
+ *        skiplist            : A class that represents a skip list
+ *        skiplist::iterator  : An iterator through a skip list
+ *
+ *    Each node is one allocation: the data, a back pointer, and a tower
+ *    of forward pointers sized to the node's level. The list keeps a
+ *    "finger", the predecessors at every level from the last insert, so
+ *    inserting keys in ascending order costs O(1) expected per key.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>    // for uint64_t
+#include <new>        // for placement new
+#include <utility>    // for std::pair
+#include <functional> // for std::less
+#include <initializer_list>
+
+class TestSkipList; // forward declaration for unit tests
+class TestMap;
+
+namespace custom
+{
+
+	template <class KK, class VV, class CC>
+	class map;
+
+	/*****************************************************************
+	 * SKIP LIST
+	 * Offers the same interface as BST so map can use either
+	 *****************************************************************/
+	template <typename T, typename Compare = std::less<T>>
+	class skiplist
+	{
+		friend class ::TestSkipList; // give unit tests access to the privates
+		friend class ::TestMap;
+
+		template <class KK, class VV, class CC>
+		friend class map;
+	public:
+		//
+		// Construct
+		//
+
+		skiplist(const Compare& compare = Compare());
+		skiplist(const skiplist& rhs);
+		skiplist(skiplist&& rhs) noexcept;
+		skiplist(const std::initializer_list<T>& il);
+		~skiplist();
+
+		//
+		// Assign
+		//
+
+		skiplist& operator = (const skiplist& rhs);
+		skiplist& operator = (skiplist&& rhs);
+		skiplist& operator = (const std::initializer_list<T>& il);
+		void swap(skiplist& rhs);
+
+		// replace everything with [first, last), in one pass: input in
+		// order lands on the finger, O(1) expected per element
+		template <class Iterator>
+		void assign(Iterator first, Iterator last);
+
+		//
+		// Iterator
+		//
+
+		class iterator;
+		iterator   begin() const noexcept { return iterator(pHeads[0]); }
+		iterator   end()   const noexcept { return iterator(nullptr); }
+
+		//
+		// Access
+		//
+
+		iterator find(const T& t) { return find(t, compare); }
+		template <class Key, class KeyLess>
+		iterator find(const Key& k, KeyLess less);
+
+		//
+		// Insert
+		//
+
+		std::pair<iterator, bool> insert(const T& t, bool keepUnique = false);
+		std::pair<iterator, bool> insert(T&& t, bool keepUnique = false);
+
+		// find k, or insert make() when it is missing. Nothing is
+		// made on a hit; a miss searches twice, since search() works
+		// on whole elements rather than keys
+		template <class Key, class KeyLess, class Make>
+		std::pair<iterator, bool> find_or_insert(const Key& k, KeyLess less, Make make)
+		{
+			iterator it = find(k, less);
+			if (it != end())
+				return std::pair<iterator, bool>(it, false);
+			return insert(make());
+		}
+		// the same, but when k belongs right next to hint, search down
+		// from hint's tower rather than from the head
+		template <class Key, class KeyLess, class Make>
+		std::pair<iterator, bool> find_or_insert(iterator hint, const Key& k, KeyLess less, Make make);
+
+		//
+		// Remove
+		//
+
+		iterator erase(iterator& it);
+		void clear() noexcept;
+
+		//
+		// Status
+		//
+
+		bool empty() const noexcept { return size() == 0; }
+		size_t size() const noexcept { return numElements; }
+
+	private:
+
+		class Node;
+
+		// enough levels for 4^32 elements at a branching factor of 4
+		static const int MAX_LEVEL = 32;
+
+		int randomLevel();
+		void search(const T& t, Node* update[], bool upper);
+		Node** links(Node* p) { return p ? p->pNext : pHeads; }
+		template <class U>
+		std::pair<iterator, bool> insertNode(U&& t, bool keepUnique);
+		template <class U>
+		Node* link(Node* update[], int height, U&& t);
+		void resetFinger();
+
+		Node* pHeads[MAX_LEVEL];   // the head tower: first node at each level
+		Node* finger[MAX_LEVEL];   // predecessors from the last insert, nullptr is the head
+		int level;                 // number of levels currently in use
+		size_t numElements;        // number of elements currently in the list
+		uint64_t seed;             // state of the level generator
+		Compare compare;
+	};
+
+
+	/*****************************************************************
+	 * SKIP LIST NODE
+	 * The tower of forward pointers is the last member and is allocated
+	 * in the same block as the node, so pNext[i] is valid for i < height
+	 *****************************************************************/
+	template <typename T, typename Compare>
+	class skiplist <T, Compare> ::Node
+	{
+	public:
+		Node(const T& t, int height) : data(t), pPrev(nullptr), height(height) {}
+		Node(T&& t, int height) : data(std::move(t)), pPrev(nullptr), height(height) {}
+
+		// one block holding the node and its tower
+		template <class U>
+		static Node* create(U&& t, int height)
+		{
+			void* p = ::operator new(sizeof(Node) + (height - 1) * sizeof(Node*));
+			try
+			{
+				return new (p) Node(std::forward<U>(t), height);
+			}
+			catch (...)
+			{
+				::operator delete(p);
+				throw;
+			}
+		}
+
+		static void destroy(Node* p)
+		{
+			p->~Node();
+			::operator delete(p);
+		}
+
+		T data;
+		Node* pPrev;           // previous node on level 0
+		int height;            // number of levels in the tower
+		Node* pNext[1];        // forward pointers, really pNext[height]
+	};
+
+
+	/**********************************************************
+	 * SKIP LIST ITERATOR
+	 * Forward and reverse iterator along level 0
+	 *********************************************************/
+	template <typename T, typename Compare>
+	class skiplist <T, Compare> ::iterator
+	{
+		friend class ::TestSkipList; // give unit tests access to the privates
+		friend class ::TestMap;
+		friend class skiplist <T, Compare>;
+
+		template <class KK, class VV, class CC>
+		friend class map;
+	public:
+		iterator(Node* p = nullptr) : pNode(p) {}
+
+		bool operator == (const iterator& rhs) const { return rhs.pNode == pNode; }
+		bool operator != (const iterator& rhs) const { return rhs.pNode != pNode; }
+
+		// de-reference. Cannot change because it will invalidate the order
+		const T& operator * () const { return pNode->data; }
+
+		iterator& operator ++ ()
+		{
+			if (pNode)
+				pNode = pNode->pNext[0];
+			return *this;
+		}
+		iterator operator ++ (int)
+		{
+			iterator tmp = *this;
+			++(*this);
+			return tmp;
+		}
+		iterator& operator -- ()
+		{
+			if (pNode)
+				pNode = pNode->pPrev;
+			return *this;
+		}
+		iterator operator -- (int)
+		{
+			iterator tmp = *this;
+			--(*this);
+			return tmp;
+		}
+
+	private:
+		Node* pNode;
+	};
+
+
+	/*********************************************
+	 * SKIP LIST :: DEFAULT CONSTRUCTOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare> ::skiplist(const Compare& compare) :
+		level(1), numElements(0), seed(0x9E3779B97F4A7C15ull), compare(compare)
+	{
+		for (int i = 0; i < MAX_LEVEL; i++)
+			pHeads[i] = nullptr;
+		resetFinger();
+	}
+
+	/*********************************************
+	 * SKIP LIST :: COPY CONSTRUCTOR
+	 * The source is already sorted so every insert
+	 * lands on the finger
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare> ::skiplist(const skiplist& rhs) : skiplist(rhs.compare)
+	{
+		for (Node* p = rhs.pHeads[0]; p; p = p->pNext[0])
+			insert(p->data);
+	}
+
+	/*********************************************
+	 * SKIP LIST :: MOVE CONSTRUCTOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare> ::skiplist(skiplist&& rhs) noexcept : skiplist(rhs.compare)
+	{
+		swap(rhs);
+	}
+
+	/*********************************************
+	 * SKIP LIST :: INITIALIZER LIST CONSTRUCTOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare> ::skiplist(const std::initializer_list<T>& il) : skiplist()
+	{
+		assign(il.begin(), il.end());
+	}
+
+	/*********************************************
+	 * SKIP LIST :: DESTRUCTOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare> :: ~skiplist()
+	{
+		clear();
+	}
+
+	/*********************************************
+	 * SKIP LIST :: ASSIGNMENT OPERATOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare>& skiplist <T, Compare> :: operator = (const skiplist& rhs)
+	{
+		if (this != &rhs)
+		{
+			skiplist tmp(rhs);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/*********************************************
+	 * SKIP LIST :: ASSIGN-MOVE OPERATOR
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare>& skiplist <T, Compare> :: operator = (skiplist&& rhs)
+	{
+		clear();
+		swap(rhs);
+		return *this;
+	}
+
+	/*********************************************
+	 * SKIP LIST :: ASSIGNMENT with INITIALIZATION LIST
+	 ********************************************/
+	template <typename T, typename Compare>
+	skiplist <T, Compare>& skiplist <T, Compare> :: operator = (const std::initializer_list<T>& il)
+	{
+		assign(il.begin(), il.end());
+		return *this;
+	}
+
+	/*********************************************
+	 * SKIP LIST :: ASSIGN
+	 * Every insert after the first searches from the
+	 * finger, so sorted input never walks from the head
+	 ********************************************/
+	template <typename T, typename Compare>
+	template <class Iterator>
+	void skiplist <T, Compare> ::assign(Iterator first, Iterator last)
+	{
+		clear();
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	/*********************************************
+	 * SKIP LIST :: SWAP
+	 * The head towers live in the object, so they are
+	 * exchanged element by element
+	 ********************************************/
+	template <typename T, typename Compare>
+	void skiplist <T, Compare> ::swap(skiplist& rhs)
+	{
+		for (int i = 0; i < MAX_LEVEL; i++)
+		{
+			std::swap(pHeads[i], rhs.pHeads[i]);
+			std::swap(finger[i], rhs.finger[i]);
+		}
+		std::swap(level, rhs.level);
+		std::swap(numElements, rhs.numElements);
+		std::swap(seed, rhs.seed);
+		std::swap(compare, rhs.compare);
+	}
+
+	/****************************************************
+	 * SKIP LIST :: FIND
+	 * Return the first element equivalent to k. The key
+	 * need not be a T as long as less() orders it against
+	 * the elements in either order
+	 ****************************************************/
+	template <typename T, typename Compare>
+	template <class Key, class KeyLess>
+	typename skiplist <T, Compare> ::iterator skiplist <T, Compare> ::find(const Key& k, KeyLess less)
+	{
+		Node* const* pLinks = pHeads;
+		for (int i = level - 1; i >= 0; i--)
+			while (pLinks[i] && less(pLinks[i]->data, k))
+				pLinks = pLinks[i]->pNext;
+
+		Node* p = pLinks[0];
+		if (p && !less(k, p->data))
+			return iterator(p);
+		return end();
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: INSERT
+	 * Insert after any equivalent elements
+	 ****************************************************/
+	template <typename T, typename Compare>
+	std::pair<typename skiplist <T, Compare> ::iterator, bool> skiplist <T, Compare> ::insert(const T& t, bool keepUnique)
+	{
+		return insertNode(t, keepUnique);
+	}
+
+	template <typename T, typename Compare>
+	std::pair<typename skiplist <T, Compare> ::iterator, bool> skiplist <T, Compare> ::insert(T&& t, bool keepUnique)
+	{
+		return insertNode(std::move(t), keepUnique);
+	}
+
+	template <typename T, typename Compare>
+	template <class U>
+	std::pair<typename skiplist <T, Compare> ::iterator, bool> skiplist <T, Compare> ::insertNode(U&& t, bool keepUnique)
+	{
+		Node* update[MAX_LEVEL];
+		search(t, update, true /*upper*/);
+
+		// update[0] is the last node <= t
+		if (keepUnique && update[0] && !compare(update[0]->data, t))
+			return std::pair<iterator, bool>(iterator(update[0]), false);
+
+		return std::pair<iterator, bool>(iterator(link(update, randomLevel(), std::forward<U>(t))), true);
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: LINK
+	 * Put a new node of the given height right after
+	 * update[i] on each level i below it. The finger
+	 * becomes the new node and, above it, update
+	 ****************************************************/
+	template <typename T, typename Compare>
+	template <class U>
+	typename skiplist <T, Compare> ::Node* skiplist <T, Compare> ::link(Node* update[], int height, U&& t)
+	{
+		for (int i = level; i < height; i++)
+			update[i] = nullptr;
+		if (height > level)
+			level = height;
+
+		Node* pNew = Node::create(std::forward<U>(t), height);
+		for (int i = 0; i < height; i++)
+		{
+			pNew->pNext[i] = links(update[i])[i];
+			links(update[i])[i] = pNew;
+			finger[i] = pNew;
+		}
+		for (int i = height; i < level; i++)
+			finger[i] = update[i];
+
+		pNew->pPrev = update[0];
+		if (pNew->pNext[0])
+			pNew->pNext[0]->pPrev = pNew;
+
+		numElements++;
+		return pNew;
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: FIND OR INSERT with a hint
+	 * hint may be just after k, as std::map's is, or just
+	 * before it. Either way the node before k is the
+	 * anchor, and a search from its tower fills update on
+	 * every level the tower reaches. That is all a new
+	 * node needs unless it is taller than the anchor.
+	 * Anything else, and an end() hint, which the finger
+	 * already serves, searches as usual
+	 ****************************************************/
+	template <typename T, typename Compare>
+	template <class Key, class KeyLess, class Make>
+	std::pair<typename skiplist <T, Compare> ::iterator, bool> skiplist <T, Compare> ::find_or_insert(iterator hint, const Key& k, KeyLess less, Make make)
+	{
+		Node* pAnchor = hint.pNode;
+		if (pAnchor == nullptr)
+			return find_or_insert(k, less, make);
+		if (less(k, pAnchor->data))
+			pAnchor = pAnchor->pPrev;
+		if (pAnchor == nullptr || less(k, pAnchor->data))
+			return find_or_insert(k, less, make);
+		if (!less(pAnchor->data, k))
+			return std::pair<iterator, bool>(iterator(pAnchor), false);
+
+		// pAnchor < k: walk forward from it on each level of its tower
+		Node* update[MAX_LEVEL];
+		Node* p = pAnchor;
+		for (int i = pAnchor->height - 1; i >= 0; i--)
+		{
+			while (p->pNext[i] && less(p->pNext[i]->data, k))
+				p = p->pNext[i];
+			update[i] = p;
+		}
+		if (p->pNext[0] && !less(k, p->pNext[0]->data))
+			return std::pair<iterator, bool>(iterator(p->pNext[0]), false);
+
+		int height = randomLevel();
+		if (height > pAnchor->height)
+		{
+			T t = make();
+			search(t, update, true /*upper*/);
+			return std::pair<iterator, bool>(iterator(link(update, height, std::move(t))), true);
+		}
+
+		// above the anchor's tower the predecessors are unknown; the head
+		// is behind everything, so it is a safe finger there
+		for (int i = pAnchor->height; i < level; i++)
+			update[i] = nullptr;
+		return std::pair<iterator, bool>(iterator(link(update, height, make())), true);
+	}
+
+	/*************************************************
+	 * SKIP LIST :: ERASE
+	 * Unlink the node at every level of its tower
+	 ************************************************/
+	template <typename T, typename Compare>
+	typename skiplist <T, Compare> ::iterator skiplist <T, Compare> ::erase(iterator& it)
+	{
+		Node* pDelete = it.pNode;
+		if (pDelete == nullptr)
+			return end();
+
+		// predecessors of the first node equivalent to the victim, then
+		// walk across any equivalent nodes to the victim itself
+		Node* update[MAX_LEVEL];
+		search(pDelete->data, update, false /*upper*/);
+		for (int i = 0; i < pDelete->height; i++)
+		{
+			while (links(update[i])[i] != pDelete)
+				update[i] = links(update[i])[i];
+			links(update[i])[i] = pDelete->pNext[i];
+		}
+		if (pDelete->pNext[0])
+			pDelete->pNext[0]->pPrev = pDelete->pPrev;
+
+		while (level > 1 && pHeads[level - 1] == nullptr)
+			level--;
+
+		iterator itNext(pDelete->pNext[0]);
+		Node::destroy(pDelete);
+		numElements--;
+		resetFinger();
+		return itNext;
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: CLEAR
+	 * Level 0 threads through every node
+	 ****************************************************/
+	template <typename T, typename Compare>
+	void skiplist <T, Compare> ::clear() noexcept
+	{
+		Node* p = pHeads[0];
+		while (p)
+		{
+			Node* pNext = p->pNext[0];
+			Node::destroy(p);
+			p = pNext;
+		}
+		for (int i = 0; i < MAX_LEVEL; i++)
+			pHeads[i] = nullptr;
+		level = 1;
+		numElements = 0;
+		resetFinger();
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: RANDOM LEVEL
+	 * Each level is kept with probability 1/4. xorshift64*
+	 * keeps this cheap and deterministic
+	 ****************************************************/
+	template <typename T, typename Compare>
+	int skiplist <T, Compare> ::randomLevel()
+	{
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		uint64_t bits = seed * 0x2545F4914F6CDD1Dull;
+
+		int height = 1;
+		while (height < MAX_LEVEL && (bits & 3) == 0)
+		{
+			height++;
+			bits >>= 2;
+		}
+		return height;
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: SEARCH
+	 * Fill update[i] with the last node at level i that is
+	 * < t (or <= t when upper), nullptr meaning the head.
+	 * When t is past the last insert, start from the finger
+	 ****************************************************/
+	template <typename T, typename Compare>
+	void skiplist <T, Compare> ::search(const T& t, Node* update[], bool upper)
+	{
+		// the finger is usable if its level-0 node comes before t
+		bool useFinger = finger[0] &&
+			(upper ? !compare(t, finger[0]->data) : compare(finger[0]->data, t));
+
+		Node* p = nullptr;
+		bool onFinger = useFinger;   // p is the finger of the level above
+		for (int i = level - 1; i >= 0; i--)
+		{
+			// start from whichever is further: the finger or where the level
+			// above stopped. finger[i] is never behind finger[i + 1]
+			if (useFinger)
+			{
+				if (onFinger || p == nullptr || (finger[i] && compare(p->data, finger[i]->data)))
+					p = finger[i];
+				onFinger = (p == finger[i]);
+			}
+
+			if (upper)
+				while (links(p)[i] && !compare(t, links(p)[i]->data))
+				{
+					p = links(p)[i];
+					onFinger = false;
+				}
+			else
+				while (links(p)[i] && compare(links(p)[i]->data, t))
+				{
+					p = links(p)[i];
+					onFinger = false;
+				}
+			update[i] = p;
+		}
+	}
+
+	/*****************************************************
+	 * SKIP LIST :: RESET FINGER
+	 * Point the finger back at the head
+	 ****************************************************/
+	template <typename T, typename Compare>
+	void skiplist <T, Compare> ::resetFinger()
+	{
+		for (int i = 0; i < MAX_LEVEL; i++)
+			finger[i] = nullptr;
+	}
+
+} // namespace custom
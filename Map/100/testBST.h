@@ -20,6 +20,11 @@
 #include <iostream>
 #include <string>
 #include <functional> // for std::less and std::greater
+#include <vector>
+#include <algorithm>  // for std::max and the std::set_ algorithms
+#include <iterator>   // for std::back_inserter and std::istream_iterator
+#include <sstream>    // for std::istringstream
+#include <thread>     // for std::this_thread::get_id
 
  /***********************************************
   * TEST BST
@@ -91,6 +96,8 @@ public:
       test_insertMove_oneRight();
       test_insertMove_duplicate();
       test_insertMove_keepUnique();
+      test_findOrInsert_standard();
+      test_findOrInsert_hint();
 
       // Remove
       test_erase_empty();
@@ -106,6 +113,46 @@ public:
       test_empty_standard();
       test_size_empty();
       test_size_standard();
+      test_height_empty();
+      test_height_standard();
+
+      // Balance
+      test_balance_rotate();
+      test_balance_sortedDepth();
+      test_balance_randomErase();
+      test_balance_copyKeepsColors();
+
+      // Bulk
+      test_bulk_sorted();
+      test_bulk_sortedCompares();
+      test_bulk_everySize();
+      test_bulk_unsorted();
+      test_bulk_inputIterator();
+      test_bulk_oneBlock();
+      test_bulk_blockErase();
+      test_bulk_blockShared();
+
+      // Bounds
+      test_bounds_duplicates();
+      test_range_standard();
+      test_range_noCompares();
+
+      // Set algebra
+      test_split_standard();
+      test_join_unequalHeights();
+      test_unite_naive();
+      test_intersect_naive();
+      test_subtract_naive();
+      test_setAlgebra_parallel();
+      test_setAlgebra_forkSmallInline();
+
+#ifdef BST_ORDER_STATISTICS
+      // Order
+      test_select_standard();
+      test_rank_standard();
+      test_select_afterErase();
+      test_iterator_advance();
+#endif // BST_ORDER_STATISTICS
 
       report("BST");
    }
@@ -405,7 +452,7 @@ public:
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numLessthan() == 10);
+      assertUnit(Spy::numLessthan() == 11); // 1 to see it is out of order, 10 to insert
       assertStandardFixture(bstDest);
       // teardown
       teardownStandardFixture(bstDest);
@@ -519,6 +566,41 @@ public:
       teardownStandardFixture(bst);
    }
 
+   // how tall is an empty tree?
+   void test_height_empty()
+   {  // setup
+      custom::BST <Spy> bst;
+      Spy::reset();
+      // exercise
+      size_t height = bst.height();
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(height == 0);
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // how tall is the standard fixture?
+   void test_height_standard()
+   {  // setup
+      //                (50)
+      //          +-------+-------+
+      //        (30)            (70)
+      //     +----+----+     +----+----+
+      //   (20)       (40) (60)       (80)
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy::reset();
+      // exercise
+      size_t height = bst.height();
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(height == 3);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
    /***************************************
     * Assignment
     *    BST::operator=(const BST &)
@@ -1041,7 +1123,7 @@ public:
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numLessthan() == 10);
+      assertUnit(Spy::numLessthan() == 11); // 1 to see it is out of order, 10 to insert
       //                (50) = bstDest
       //          +-------+-------+
       //        (30)            (70)
@@ -2239,6 +2321,39 @@ public:
       teardownStandardFixture(bst);
    }
 
+   // found, nothing is made; missing, it is made once and put where the search ended
+   void test_findOrInsert_standard()
+   {  // setup
+      custom::BST <int> bst{ 50, 30, 70 };
+      int numMade = 0;
+      auto make = [&numMade]() { numMade++; return 60; };
+      // exercise
+      auto pairOld = bst.find_or_insert(30, std::less<int>(), make);
+      auto pairNew = bst.find_or_insert(60, std::less<int>(), make);
+      // verify
+      assertUnit(numMade == 1);
+      assertUnit(pairOld.second == false && *pairOld.first == 30);
+      assertUnit(pairNew.second == true && *pairNew.first == 60);
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.validate());
+   }  // teardown
+
+   // right hints go straight in, wrong hints still land in order
+   void test_findOrInsert_hint()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      for (int i = 0; i < 200; i++)
+         bst.find_or_insert(bst.end(), i * 2, std::less<int>(), [i]() { return i * 2; });
+      for (int i = 0; i < 200; i += 7)
+         bst.find_or_insert(bst.begin(), i * 2 + 1, std::less<int>(), [i]() { return i * 2 + 1; });
+      auto pairOld = bst.find_or_insert(bst.find(100), 100, std::less<int>(), []() { return -1; });
+      // verify
+      assertUnit(pairOld.second == false);
+      assertUnit(bst.size() == 229);
+      assertUnit(bst.validate());
+   }  // teardown
+
 
    /***************************************
     * Erase
@@ -2475,6 +2590,650 @@ public:
       bst.root = nullptr;
    }
 
+   /***************************************
+    * BALANCE
+    *    BST::insert() and BST::erase() keep
+    *    the red-black invariants
+    ***************************************/
+
+   // three in a row rotate into a black parent over two red children
+   void test_balance_rotate()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      bst.insert(10);
+      bst.insert(20);
+      bst.insert(30);
+      // verify
+      //           (20b)
+      //        +----+----+
+      //      (10r)     (30r)
+      assertUnit(bst.validate());
+      assertUnit(bst.root != nullptr);
+      if (bst.root && bst.root->pLeft && bst.root->pRight)
+      {
+         assertUnit(bst.root->data == 20);
+         assertUnit(bst.root->isRed == false);
+         assertUnit(bst.root->pLeft->data == 10);
+         assertUnit(bst.root->pLeft->isRed == true);
+         assertUnit(bst.root->pRight->data == 30);
+         assertUnit(bst.root->pRight->isRed == true);
+      }
+   }  // teardown
+
+   // sorted and reverse-sorted input stay within 2 log(n+1) deep
+   void test_balance_sortedDepth()
+   {  // setup
+      custom::BST <int> bstUp;
+      custom::BST <int> bstDown;
+      // exercise
+      for (int i = 0; i < 4095; i++)
+      {
+         bstUp.insert(i);
+         bstDown.insert(4094 - i);
+      }
+      // verify
+      assertUnit(bstUp.validate());
+      assertUnit(bstDown.validate());
+      assertUnit(depth(bstUp.root) <= 24);    // 2 log(4096)
+      assertUnit(depth(bstDown.root) <= 24);
+   }  // teardown
+
+   // the invariants hold after every one of a random run of erases
+   void test_balance_randomErase()
+   {  // setup
+      std::vector<int> values;
+      unsigned int seed = 12345;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
+      for (size_t i = values.size() - 1; i > 0; i--)
+      {
+         seed = seed * 1103515245 + 12345;
+         std::swap(values[i], values[(seed >> 8) % (i + 1)]);
+      }
+      custom::BST <int> bst;
+      for (int value : values)
+         bst.insert(value);
+      bool isValid = bst.validate();
+      // exercise
+      for (size_t i = 0; i < values.size(); i += 2)
+      {
+         auto it = bst.find(values[i]);
+         bst.erase(it);
+         isValid = isValid && bst.validate();
+      }
+      // verify
+      assertUnit(isValid);
+      assertUnit(bst.size() == 500);
+      for (size_t i = 0; i < values.size(); i++)
+         assertUnit((bst.find(values[i]) != bst.end()) == (i % 2 == 1));
+      assertUnit(depth(bst.root) <= 18);      // 2 log(512)
+   }  // teardown
+
+   // a copy keeps the colors, so it is just as valid
+   void test_balance_copyKeepsColors()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      // exercise
+      custom::BST <int> bstCopy(bst);
+      // verify
+      assertUnit(bstCopy.validate());
+      assertUnit(bstCopy.size() == 100);
+   }  // teardown
+
+   /***************************************
+    * BULK
+    *    BST::BST(first, last) and BST::assign()
+    ***************************************/
+
+   // in-order input becomes a tree of minimum height, already colored
+   void test_bulk_sorted()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
+      // exercise
+      custom::BST <int> bst(values.begin(), values.end());
+      // verify
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.validate());
+      assertUnit(depth(bst.root) == 10);
+      int expected = 0;
+      bool isInOrder = true;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         isInOrder = isInOrder && *it == expected++;
+      assertUnit(isInOrder);
+   }  // teardown
+
+   // n - 1 compares to see it is in order, and none to build
+   void test_bulk_sortedCompares()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 100; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst;
+      Spy::reset();
+      // exercise
+      bst.assign(values.begin(), values.end());
+      // verify
+      assertUnit(Spy::numLessthan() == 99);
+      assertUnit(Spy::numCopy() == 100);
+      assertUnit(bst.size() == 100);
+      assertUnit(bst.validate());
+   }  // teardown
+
+   // every size from empty up comes out a valid red-black tree
+   void test_bulk_everySize()
+   {  // setup
+      std::vector<int> values;
+      bool isValid = true;
+      for (int num = 0; num < 70; num++)
+      {
+         // exercise
+         custom::BST <int> bst(values.begin(), values.end());
+         // verify
+         isValid = isValid && bst.validate() && bst.size() == values.size();
+         values.push_back(num);
+      }
+      assertUnit(isValid);
+   }  // teardown
+
+   // out of order input falls back to insert, and duplicates are kept
+   void test_bulk_unsorted()
+   {  // setup
+      custom::BST <int> bst{ 99, 98 };
+      // exercise
+      bst = { 5, 3, 8, 3, 1 };
+      // verify
+      assertUnit(bst.size() == 5);
+      assertUnit(bst.validate());
+      std::vector<int> values;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == std::vector<int>({ 1, 3, 3, 5, 8 }));
+      bst.assign(values.begin(), values.end(), std::less<int>(), true /*keepUnique*/);
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.validate());
+   }  // teardown
+
+   // a single-pass range is read once, sorted or not
+   void test_bulk_inputIterator()
+   {  // setup
+      std::istringstream sorted("1 2 3 4 5");
+      std::istringstream unsorted("5 3 8 3 1");
+      // exercise
+      custom::BST <int> bstSorted((std::istream_iterator<int>(sorted)), std::istream_iterator<int>());
+      custom::BST <int> bstUnsorted((std::istream_iterator<int>(unsorted)), std::istream_iterator<int>());
+      // verify
+      assertUnit(bstSorted.size() == 5);
+      assertUnit(bstSorted.validate());
+      assertUnit(bstUnsorted.size() == 5);
+      assertUnit(bstUnsorted.validate());
+      std::vector<int> values;
+      for (auto it = bstSorted.begin(); it != bstSorted.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == std::vector<int>({ 1, 2, 3, 4, 5 }));
+      values.clear();
+      for (auto it = bstUnsorted.begin(); it != bstUnsorted.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == std::vector<int>({ 1, 3, 3, 5, 8 }));
+   }  // teardown
+
+   // the block a node was built in, or nullptr for a node allocated alone
+   template <class T>
+   static typename custom::BST <T> ::Block* blockOf(const typename custom::BST <T> ::BNode* pNode)
+   {
+      return (reinterpret_cast<const typename custom::BST <T> ::Block::Header*>(pNode) - 1)->pBlock;
+   }
+
+   // a sorted build puts every node, in order, into one block
+   void test_bulk_oneBlock()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 100; i++)
+         values.push_back(i);
+      // exercise
+      custom::BST <int> bst(values.begin(), values.end());
+      // verify
+      auto pBlock = blockOf<int>(bst.begin().pNode);
+      assertUnit(pBlock != nullptr);
+      bool isInBlock = pBlock != nullptr;
+      size_t i = 0;
+      for (auto it = bst.begin(); isInBlock && it != bst.end(); ++it, i++)
+         isInBlock = blockOf<int>(it.pNode) == pBlock &&
+            reinterpret_cast<const char*>(it.pNode) ==
+               pBlock->cells() + i * custom::BST <int> ::Block::CELL + sizeof(custom::BST <int> ::Block::Header);
+      assertUnit(isInBlock);
+      if (pBlock)
+         assertUnit(pBlock->numLive == 100);
+   }  // teardown
+
+   // erase() gives block nodes back one at a time; the last one frees the block
+   void test_bulk_blockErase()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 20; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst(values.begin(), values.end());
+      bst.insert(Spy(20));
+      auto pBlock = blockOf<Spy>(bst.begin().pNode);
+      assertUnit(blockOf<Spy>(bst.find(Spy(20)).pNode) == nullptr);
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 10; i++)
+      {
+         auto it = bst.find(Spy(i * 2));
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 11);
+      assertUnit(bst.validate());
+      assertUnit(pBlock->numLive == 10);
+      // exercise
+      for (int i = 0; i < 10; i++)
+      {
+         auto it = bst.find(Spy(i * 2 + 1));
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 1);
+      assertUnit(bst.validate());
+      assertUnit(Spy::numDestructor() == 40);   // 20 keys to find, 20 erased
+      assertUnit(Spy::numDelete() == 40);
+      assertUnit(*bst.begin() == Spy(20));
+   }  // teardown
+
+   // a block stays while any tree still has nodes in it
+   void test_bulk_blockShared()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 100; i++)
+         values.push_back(i);
+      custom::BST <int> bstRight;
+      custom::BST <int> ::Block* pBlock = nullptr;
+      {
+         custom::BST <int> bst(values.begin(), values.end());
+         pBlock = blockOf<int>(bst.begin().pNode);
+         // exercise
+         bstRight = bst.split(50);
+         assertUnit(pBlock->numLive == 100);
+      }
+      // verify
+      assertUnit(pBlock->numLive == 50);
+      assertUnit(bstRight.size() == 50);
+      assertUnit(bstRight.validate());
+      assertUnit(*bstRight.begin() == 50);
+      assertUnit(blockOf<int>(bstRight.begin().pNode) == pBlock);
+      // exercise
+      custom::BST <int> bstLeft(values.begin(), values.begin() + 50);
+      custom::BST <int> bstHalf = bstRight.split(75);
+      bstRight.join(std::move(bstHalf));
+      bstLeft.join(std::move(bstRight));
+      // verify
+      assertUnit(bstLeft.size() == 100);
+      assertUnit(bstLeft.validate());
+      assertUnit(pBlock->numLive == 50);
+   }  // teardown
+
+   /***************************************
+    * BOUNDS
+    *    BST::lower_bound(), BST::upper_bound(),
+    *    BST::equal_range() and BST::range()
+    ***************************************/
+
+   // a run of duplicates sits between the two bounds
+   void test_bounds_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 10; i++)
+         for (int copy = 0; copy < 3; copy++)
+            bst.insert(i * 10);
+      // exercise
+      auto itLower = bst.lower_bound(40);
+      auto itUpper = bst.upper_bound(40);
+      auto itBetween = bst.lower_bound(45);
+      auto range = bst.equal_range(40);
+      // verify
+      assertUnit(itLower != bst.end() && *itLower == 40);
+      assertUnit(itUpper != bst.end() && *itUpper == 50);
+      int num = 0;
+      for (auto it = itLower; it != itUpper; ++it, num++)
+         assertUnit(*it == 40);
+      assertUnit(num == 3);
+      assertUnit(itBetween == itUpper);
+      assertUnit(range.first == itLower && range.second == itUpper);
+      assertUnit(bst.lower_bound(-1) == bst.begin());
+      assertUnit(bst.lower_bound(91) == bst.end());
+      assertUnit(bst.upper_bound(90) == bst.end());
+   }  // teardown
+
+   // [lo, hi), whichever nodes the ends fall on
+   void test_range_standard()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 200; i++)
+         bst.insert(i * 73 % 200);
+      // exercise
+      std::vector<int> inside;
+      for (int value : bst.range(57, 143))
+         inside.push_back(value);
+      // verify
+      assertUnit(inside.size() == 86);
+      bool isInOrder = true;
+      for (size_t i = 0; i < inside.size(); i++)
+         isInOrder = isInOrder && inside[i] == 57 + (int)i;
+      assertUnit(isInOrder);
+      assertUnit(bst.range(10, 10).empty());
+      assertUnit(bst.range(50, 10).empty());
+      assertUnit(bst.range(50, 10).begin() == bst.range(50, 10).end());
+      int numTail = 0;
+      for (int value : bst.range(190, 1000))
+         numTail += value >= 190 ? 1 : 100;
+      assertUnit(numTail == 10);
+   }  // teardown
+
+   // finding the ends compares; walking between them does not
+   void test_range_noCompares()
+   {  // setup
+      custom::BST <Spy> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(Spy(i * 37 % 100));
+      auto range = bst.range(Spy(20), Spy(80));
+      Spy::reset();
+      // exercise
+      int num = 0;
+      for (auto it = range.begin(); it != range.end(); ++it)
+         num++;
+      // verify
+      assertUnit(num == 60);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   /***************************************
+    * SET ALGEBRA
+    *    BST::split(), BST::join(), BST::unite(),
+    *    BST::intersect() and BST::subtract()
+    ***************************************/
+
+   // everything less than the key stays, the rest moves
+   void test_split_standard()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
+      custom::BST <int> bst(values.begin(), values.end());
+      // exercise
+      custom::BST <int> bstRight = bst.split(600);
+      // verify
+      assertUnit(bst.validate());
+      assertUnit(bstRight.validate());
+      assertUnit(bst.size() == 600);
+      assertUnit(bstRight.size() == 400);
+      assertUnit(contents(bst) == std::vector<int>(values.begin(), values.begin() + 600));
+      assertUnit(contents(bstRight) == std::vector<int>(values.begin() + 600, values.end()));
+   }  // teardown
+
+   // a short tree and a tall one become one
+   void test_join_unequalHeights()
+   {  // setup
+      custom::BST <int> bstLeft{ 0, 1, 2 };
+      std::vector<int> values;
+      for (int i = 3; i < 2000; i++)
+         values.push_back(i);
+      custom::BST <int> bstRight(values.begin(), values.end());
+      // exercise
+      bstLeft.join(std::move(bstRight));
+      // verify
+      assertUnit(bstLeft.validate());
+      assertUnit(bstLeft.size() == 2000);
+      assertUnit(bstRight.empty());
+      std::vector<int> all = contents(bstLeft);
+      bool isInOrder = true;
+      for (int i = 0; i < 2000; i++)
+         isInOrder = isInOrder && all[i] == i;
+      assertUnit(isInOrder);
+   }  // teardown
+
+   // the same answers as merging two sorted vectors, large and small
+   void test_unite_naive()
+   {
+      for (auto sizes : setSizes())
+      {  // setup
+         std::vector<int> lhs = randomSet(sizes.first, 1);
+         std::vector<int> rhs = randomSet(sizes.second, 2);
+         std::vector<int> expect;
+         std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expect));
+         custom::BST <int> bstLhs(lhs.begin(), lhs.end());
+         custom::BST <int> bstRhs(rhs.begin(), rhs.end());
+         // exercise
+         bstLhs.unite(std::move(bstRhs));
+         // verify
+         assertUnit(bstLhs.validate());
+         assertUnit(bstLhs.size() == expect.size());
+         assertUnit(contents(bstLhs) == expect);
+         assertUnit(bstRhs.empty());
+      }  // teardown
+   }
+
+   void test_intersect_naive()
+   {
+      for (auto sizes : setSizes())
+      {  // setup
+         std::vector<int> lhs = randomSet(sizes.first, 3);
+         std::vector<int> rhs = randomSet(sizes.second, 4);
+         std::vector<int> expect;
+         std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expect));
+         custom::BST <int> bstLhs(lhs.begin(), lhs.end());
+         custom::BST <int> bstRhs(rhs.begin(), rhs.end());
+         // exercise
+         bstLhs.intersect(std::move(bstRhs));
+         // verify
+         assertUnit(bstLhs.validate());
+         assertUnit(bstLhs.size() == expect.size());
+         assertUnit(contents(bstLhs) == expect);
+         assertUnit(bstRhs.empty());
+      }  // teardown
+   }
+
+   void test_subtract_naive()
+   {
+      for (auto sizes : setSizes())
+      {  // setup
+         std::vector<int> lhs = randomSet(sizes.first, 5);
+         std::vector<int> rhs = randomSet(sizes.second, 6);
+         std::vector<int> expect;
+         std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expect));
+         custom::BST <int> bstLhs(lhs.begin(), lhs.end());
+         custom::BST <int> bstRhs(rhs.begin(), rhs.end());
+         // exercise
+         bstLhs.subtract(std::move(bstRhs));
+         // verify
+         assertUnit(bstLhs.validate());
+         assertUnit(bstLhs.size() == expect.size());
+         assertUnit(contents(bstLhs) == expect);
+         assertUnit(bstRhs.empty());
+      }  // teardown
+   }
+
+   // forking gives the same trees as not
+   void test_setAlgebra_parallel()
+   {  // setup
+      std::vector<int> lhs = randomSet(20000, 7);
+      std::vector<int> rhs = randomSet(20000, 8);
+      std::vector<int> expectUnion;
+      std::vector<int> expectIntersection;
+      std::vector<int> expectDifference;
+      std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expectUnion));
+      std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expectIntersection));
+      std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expectDifference));
+      custom::BST <int> bstUnion(lhs.begin(), lhs.end());
+      custom::BST <int> bstIntersection(lhs.begin(), lhs.end());
+      custom::BST <int> bstDifference(lhs.begin(), lhs.end());
+      // exercise
+      bstUnion.unite(custom::BST <int>(rhs.begin(), rhs.end()), true /*isParallel*/);
+      bstIntersection.intersect(custom::BST <int>(rhs.begin(), rhs.end()), true /*isParallel*/);
+      bstDifference.subtract(custom::BST <int>(rhs.begin(), rhs.end()), true /*isParallel*/);
+      // verify
+      assertUnit(bstUnion.validate());
+      assertUnit(bstIntersection.validate());
+      assertUnit(bstDifference.validate());
+      assertUnit(contents(bstUnion) == expectUnion);
+      assertUnit(contents(bstIntersection) == expectIntersection);
+      assertUnit(contents(bstDifference) == expectDifference);
+   }  // teardown
+
+   // a merge of small subtrees is not worth a thread, a big one is
+   void test_setAlgebra_forkSmallInline()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 5000; i++)
+         values.push_back(i);
+      custom::BST <int> bstSmall(values.begin(), values.begin() + 100);
+      custom::BST <int> bstBig(values.begin(), values.end());
+      std::thread::id idHere = std::this_thread::get_id();
+      std::thread::id idSmall;
+      std::thread::id idBig;
+      // exercise
+      custom::BST <int> ::forkJoin([]() {}, [&]() { idSmall = std::this_thread::get_id(); },
+                                   3, bstSmall.root, bstBig.root);
+      custom::BST <int> ::forkJoin([]() {}, [&]() { idBig = std::this_thread::get_id(); },
+                                   3, bstBig.root, bstBig.root);
+      // verify
+      assertUnit(idSmall == idHere);
+      assertUnit(idBig != idHere);
+   }  // teardown
+
+#ifdef BST_ORDER_STATISTICS
+   /***************************************
+    * ORDER
+    *    BST::select(), BST::rank() and
+    *    iterator += and -=
+    ***************************************/
+
+   // the k-th smallest, whatever order they went in
+   void test_select_standard()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i * 37 % 100);
+      // exercise
+      bool isSelected = true;
+      for (size_t k = 0; k < 100; k++)
+      {
+         auto it = bst.select(k);
+         isSelected = isSelected && it != bst.end() && *it == (int)k;
+      }
+      // verify
+      assertUnit(isSelected);
+      assertUnit(bst.select(100) == bst.end());
+      assertUnit(bst.validate());
+   }  // teardown
+
+   // the number less than t, whether or not t is there
+   void test_rank_standard()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 50; i++)
+         bst.insert(i * 2);
+      // exercise
+      // verify
+      assertUnit(bst.rank(0) == 0);
+      assertUnit(bst.rank(40) == 20);
+      assertUnit(bst.rank(41) == 21);
+      assertUnit(bst.rank(-1) == 0);
+      assertUnit(bst.rank(1000) == 50);
+   }  // teardown
+
+   // erase and its rotations keep the sizes right
+   void test_select_afterErase()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 200; i++)
+         bst.insert(i);
+      // exercise
+      for (int i = 0; i < 200; i += 3)
+      {
+         auto it = bst.find(i);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.validate());
+      bool isSelected = true;
+      size_t k = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, k++)
+         isSelected = isSelected && bst.select(k) == it && bst.rank(*it) == k;
+      assertUnit(isSelected);
+      assertUnit(k == bst.size());
+   }  // teardown
+
+   // jump forward and back, and off either end to end()
+   void test_iterator_advance()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i);
+      auto it = bst.begin();
+      // exercise
+      it += 50;
+      int forward = *it;
+      it -= 20;
+      int back = *it;
+      auto itPast = it;
+      itPast += 70;
+      auto itBefore = it;
+      itBefore -= 31;
+      // verify
+      assertUnit(forward == 50);
+      assertUnit(back == 30);
+      assertUnit(itPast == bst.end());
+      assertUnit(itBefore == bst.end());
+   }  // teardown
+#endif // BST_ORDER_STATISTICS
+
+   // num different values from [0, 4 * num), in order
+   std::vector<int> randomSet(size_t num, unsigned int seed)
+   {
+      std::vector<int> values;
+      for (int i = 0; i < (int)num * 4; i++)
+         values.push_back(i);
+      for (size_t i = values.size(); i > 1; i--)
+      {
+         seed = seed * 1103515245 + 12345;
+         std::swap(values[i - 1], values[(seed >> 8) % i]);
+      }
+      values.resize(num);
+      std::sort(values.begin(), values.end());
+      return values;
+   }
+
+   // empty, tiny against large, and large against large
+   std::vector<std::pair<size_t, size_t>> setSizes()
+   {
+      return { { 0, 50 }, { 50, 0 }, { 1, 1000 }, { 1000, 1 }, { 20, 5000 }, { 5000, 20 }, { 1000, 1000 } };
+   }
+
+   // everything in the tree, in order
+   std::vector<int> contents(const custom::BST <int>& bst)
+   {
+      std::vector<int> values;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+
+   // the longest path from pNode down to a leaf
+   int depth(const custom::BST <int> ::BNode* pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+      return 1 + std::max(depth(pNode->pLeft), depth(pNode->pRight));
+   }
+
+
    /**************************************************************
     * SETUP STANDARD FIXTURE
     *                (50) 
@@ -0,0 +1,521 @@
+/***********************************************************************
+ * Header:
+ *    TEST BTREE MAP
+ * Summary:
+ *    Unit tests for btree_map
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "btree_map.h"
+#include "map.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional> // for std::greater
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef assertValid
+#define assertValid(x) assertValidParameters(x, __LINE__, __FUNCTION__)
+
+/***********************************************
+ * TEST BTREE MAP
+ * Unit tests for the btree_map class
+ ***********************************************/
+class TestBTreeMap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+      test_constructRange_bulkLoad();
+      test_constructRange_unsortedTail();
+
+      // Layout
+      test_node_cacheLines();
+
+      // Insert
+      test_insert_duplicate();
+      test_insert_ascendingFillsLeaves();
+      test_insert_random();
+      test_insert_strings();
+
+      // Access
+      test_square_addAndUpdate();
+      test_at_missingThrows();
+
+      // Remove
+      test_erase_key();
+      test_erase_returnsNext();
+      test_erase_randomHalf();
+      test_erase_range();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_decrement();
+      test_iterator_sameAsMap();
+      test_compare_greater();
+
+      report("BTreeMap");
+   }
+
+   typedef custom::btree_map<int, int> Map;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing is allocated until the first insert
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Map m;
+      // verify
+      assertUnit(m.empty());
+      assertUnit(m.root == nullptr);
+      assertUnit(m.bytes_used() == 0);
+      assertUnit(m.begin() == m.end());
+      assertUnit(m.height() == 0);
+   }  // teardown
+
+   void test_constructCopy_standard()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 1000; i++)
+         m[i * 7 % 1000] = i;
+      // exercise
+      Map copy(m);
+      m.clear();
+      // verify
+      assertUnit(copy.size() == 1000);
+      for (int i = 0; i < 1000; i++)
+         assertUnit(copy.at(i * 7 % 1000) == i);
+      assertValid(copy);
+   }  // teardown
+
+   void test_constructMove_standard()
+   {  // setup
+      Map m{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+      // exercise
+      Map moved(std::move(m));
+      // verify
+      assertUnit(moved.size() == 3);
+      assertUnit(moved.at(2) == 20);
+      assertUnit(m.empty());
+      assertUnit(m.bytes_used() == 0);
+   }  // teardown
+
+   // sorted input fills every leaf and still leaves the last one half full
+   void test_constructRange_bulkLoad()
+   {  // setup
+      std::vector<custom::pair<int, int>> v;
+      for (int i = 0; i < 10000; i++)
+         v.push_back(custom::pair<int, int>(i, -i));
+      // exercise
+      Map m(v.begin(), v.end());
+      // verify
+      assertUnit(m.size() == 10000);
+      assertValid(m);
+      int numLeaves = 0;
+      for (Map::Leaf* p = m.pFirst; p; p = p->pNext)
+      {
+         numLeaves++;
+         assertUnit(p->num == Map::LEAF_SLOTS || p->pNext == nullptr || p->pNext->pNext == nullptr);
+      }
+      assertUnit(numLeaves == (10000 + Map::LEAF_SLOTS - 1) / Map::LEAF_SLOTS);
+      for (int i = 0; i < 10000; i++)
+         assertUnit(m.at(i) == -i);
+   }  // teardown
+
+   // a key out of order ends the bulk load and the rest are inserted
+   void test_constructRange_unsortedTail()
+   {  // setup
+      std::vector<custom::pair<int, int>> v;
+      for (int i = 0; i < 500; i++)
+         v.push_back(custom::pair<int, int>(i * 2, i));
+      v.push_back(custom::pair<int, int>(7, 0));
+      v.push_back(custom::pair<int, int>(40, 0));     // already there
+      v.push_back(custom::pair<int, int>(-5, 0));
+      // exercise
+      Map m(v.begin(), v.end());
+      // verify
+      assertUnit(m.size() == 502);
+      assertUnit(m.contains(7));
+      assertUnit(m.contains(-5));
+      assertUnit(m.at(40) == 20);
+      assertUnit((*m.begin()).first == -5);
+      assertValid(m);
+   }  // teardown
+
+   /***************************************
+    * LAYOUT
+    ***************************************/
+
+   // a node is whole cache lines and starts on one
+   void test_node_cacheLines()
+   {  // setup
+      Map m;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         m[i] = i;
+      // verify
+      assertUnit(sizeof(Map::Leaf) <= 256);
+      assertUnit(sizeof(Map::Inner) <= 256);
+      assertUnit(Map::LEAF_SLOTS >= 16);
+      assertUnit(Map::INNER_SLOTS >= 16);
+      assertUnit(reinterpret_cast<uintptr_t>(m.pFirst) % 64 == 0);
+      assertUnit(reinterpret_cast<uintptr_t>(m.root) % 64 == 0);
+      for (Map::Leaf* p = m.pFirst; p; p = p->pNext)
+         assertUnit(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the existing pair stays
+   void test_insert_duplicate()
+   {  // setup
+      Map m;
+      m.insert(custom::pair<int, int>(5, 50));
+      // exercise
+      auto result = m.insert(custom::pair<int, int>(5, 99));
+      // verify
+      assertUnit(!result.second);
+      assertUnit((*result.first).first == 5);
+      assertUnit((*result.first).second == 50);
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   // appending never splits in half, so bytes per pair stay close to the pair
+   void test_insert_ascendingFillsLeaves()
+   {  // setup
+      Map m;
+      // exercise
+      for (int i = 0; i < 100000; i++)
+      {
+         auto result = m.insert(custom::pair<int, int>(i, i));
+         assertUnit(result.second);
+         assertUnit((*result.first).first == i);
+      }
+      // verify
+      assertValid(m);
+      for (Map::Leaf* p = m.pFirst; p != m.pLast; p = p->pNext)
+         assertUnit(p->num == Map::LEAF_SLOTS);
+      assertUnit(m.bytes_used() < 100000 * (sizeof(custom::pair<int, int>) + 4));
+      assertUnit(m.height() <= 5);
+   }  // teardown
+
+   void test_insert_random()
+   {  // setup
+      Map m;
+      uint64_t seed = 42;
+      std::vector<int> keys;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+      {
+         seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+         int key = static_cast<int>(seed >> 40);
+         if (m.insert(custom::pair<int, int>(key, i)).second)
+            keys.push_back(key);
+      }
+      // verify
+      assertUnit(m.size() == keys.size());
+      assertValid(m);
+      for (int key : keys)
+         assertUnit(m.contains(key));
+   }  // teardown
+
+   void test_insert_strings()
+   {  // setup
+      custom::btree_map<std::string, int> m;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+         m[std::to_string(i)] = i;
+      // verify
+      assertUnit(m.size() == 2000);
+      assertValid(m);
+      assertUnit(m.at("1999") == 1999);
+      assertUnit(!m.contains("2000"));
+      assertUnit((*m.begin()).first == "0");
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   void test_square_addAndUpdate()
+   {  // setup
+      Map m;
+      // exercise
+      m[3] = 30;
+      m[3] += 3;
+      int missing = m[4];
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m.at(3) == 33);
+      assertUnit(missing == 0);
+   }  // teardown
+
+   void test_at_missingThrows()
+   {  // setup
+      Map m{ { 1, 10 } };
+      bool isThrown = false;
+      // exercise
+      try
+      {
+         m.at(2);
+      }
+      catch (const std::out_of_range&)
+      {
+         isThrown = true;
+      }
+      // verify
+      assertUnit(isThrown);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   void test_erase_key()
+   {  // setup
+      Map m{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+      // exercise
+      size_t numErased = m.erase(2);
+      size_t numMissing = m.erase(4);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(numMissing == 0);
+      assertUnit(m.size() == 2);
+      assertUnit(!m.contains(2));
+   }  // teardown
+
+   // pairs move between leaves as they merge, and the iterator follows
+   void test_erase_returnsNext()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 3000; i++)
+         m[i] = i;
+      Map::iterator it = m.begin();
+      bool isNext = true;
+      // exercise: every other pair, front to back
+      for (int i = 0; i < 3000; i += 2)
+      {
+         isNext = isNext && (*it).first == i;
+         it = m.erase(it);
+         isNext = isNext && (it == m.end() ? i == 2999 : (*it).first == i + 1);
+         ++it;
+      }
+      // verify
+      assertUnit(isNext);
+      assertUnit(it == m.end());
+      assertUnit(m.size() == 1500);
+      assertValid(m);
+      // exercise: the rest, always the first
+      for (it = m.begin(); it != m.end(); it = m.erase(it))
+         ;
+      assertUnit(m.empty());
+      assertUnit(m.root == nullptr);
+   }  // teardown
+
+   void test_erase_randomHalf()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 10000; i++)
+         m[i] = i;
+      uint64_t seed = 7;
+      std::vector<int> order;
+      for (int i = 0; i < 10000; i++)
+         order.push_back(i);
+      for (size_t i = order.size() - 1; i > 0; i--)
+      {
+         seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+         std::swap(order[i], order[(seed >> 33) % (i + 1)]);
+      }
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         m.erase(order[i]);
+      // verify
+      assertUnit(m.size() == 5000);
+      assertValid(m);
+      for (int i = 0; i < 10000; i++)
+         assertUnit(m.contains(order[i]) == (i >= 5000));
+   }  // teardown
+
+   void test_erase_range()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 1000; i++)
+         m[i] = i;
+      // exercise
+      Map::iterator it = m.erase(m.find(100), m.find(900));
+      // verify
+      assertUnit(m.size() == 200);
+      assertUnit(it != m.end());
+      assertUnit((*it).first == 900);
+      assertUnit(m.contains(99));
+      assertUnit(!m.contains(100));
+      assertUnit(!m.contains(899));
+      assertValid(m);
+   }  // teardown
+
+   // clear gives all the nodes back
+   void test_clear_standard()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 1000; i++)
+         m[i] = i;
+      // exercise
+      m.clear();
+      // verify
+      assertUnit(m.empty());
+      assertUnit(m.bytes_used() == 0);
+      assertUnit(m.begin() == m.end());
+      m[5] = 5;
+      assertUnit(m.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // backwards across leaves, and before the first is end()
+   void test_iterator_decrement()
+   {  // setup
+      Map m;
+      for (int i = 0; i < 200; i++)
+         m[i] = i;
+      Map::iterator it = m.find(199);
+      // exercise
+      int expect = 199;
+      bool isOrdered = true;
+      for (; it != m.end(); --it)
+         isOrdered = isOrdered && (*it).first == expect--;
+      // verify
+      assertUnit(isOrdered);
+      assertUnit(expect == -1);
+   }  // teardown
+
+   // same pairs in the same order as map
+   void test_iterator_sameAsMap()
+   {  // setup
+      custom::map<int, int> mBST;
+      Map mBTree;
+      for (int i = 0; i < 500; i++)
+      {
+         mBST[i * 37 % 500] = i;
+         mBTree[i * 37 % 500] = i;
+      }
+      // exercise
+      auto itBST = mBST.begin();
+      auto itBTree = mBTree.begin();
+      bool isSame = true;
+      for (; itBST != mBST.end() && itBTree != mBTree.end(); ++itBST, ++itBTree)
+         isSame = isSame && (*itBST).first == (*itBTree).first && (*itBST).second == (*itBTree).second;
+      // verify
+      assertUnit(isSame);
+      assertUnit(itBST == mBST.end());
+      assertUnit(itBTree == mBTree.end());
+   }  // teardown
+
+   void test_compare_greater()
+   {  // setup
+      custom::btree_map<int, int, std::greater<int>> m;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         m[i] = i;
+      // verify
+      assertUnit((*m.begin()).first == 99);
+      assertUnit(m.contains(0));
+      assertValid(m);
+   }  // teardown
+
+   /*************************************************************
+    * VERIFY VALID
+    * Every leaf is at the same depth, the keys are in order and
+    * between the separators above them, parent pointers match,
+    * inner nodes other than the root are at least half full, and
+    * the leaf chain visits every pair
+    *************************************************************/
+   template <class K, class V, class C, size_t B>
+   void assertValidParameters(const custom::btree_map<K, V, C, B>& m, int line, const char* function)
+   {
+      typedef custom::btree_map<K, V, C, B> BTree;
+      if (m.root == nullptr)
+      {
+         assertIndirect(m.numElements == 0);
+         assertIndirect(m.pFirst == nullptr && m.pLast == nullptr);
+         return;
+      }
+      assertIndirect(m.root->pParent == nullptr);
+
+      size_t num = 0;
+      int depthLeaf = -1;
+      std::vector<const typename BTree::Leaf*> leaves;
+      assertNodeParameters(m, m.root, static_cast<const K*>(nullptr), static_cast<const K*>(nullptr), 0, depthLeaf, num, leaves, line, function);
+      assertIndirect(num == m.numElements);
+
+      // the chain is the leaves in order
+      assertIndirect(!leaves.empty() && m.pFirst == leaves.front() && m.pLast == leaves.back());
+      for (size_t i = 0; i < leaves.size(); i++)
+      {
+         assertIndirect(leaves[i]->pPrev == (i ? leaves[i - 1] : nullptr));
+         assertIndirect(leaves[i]->pNext == (i + 1 < leaves.size() ? leaves[i + 1] : nullptr));
+      }
+   }
+
+   template <class K, class V, class C, size_t B, class Node, class Leaf>
+   void assertNodeParameters(const custom::btree_map<K, V, C, B>& m, const Node* p, const K* pLo, const K* pHi,
+                             int depth, int& depthLeaf, size_t& num, std::vector<const Leaf*>& leaves,
+                             int line, const char* function)
+   {
+      typedef custom::btree_map<K, V, C, B> BTree;
+      C compare;
+      if (p->isLeaf)
+      {
+         const typename BTree::Leaf* pLeaf = static_cast<const typename BTree::Leaf*>(p);
+         if (depthLeaf < 0)
+            depthLeaf = depth;
+         assertIndirect(depth == depthLeaf);
+         assertIndirect(p == m.root || pLeaf->num > 0);
+         for (int i = 0; i < pLeaf->num; i++)
+         {
+            const K& k = pLeaf->pairs()[i].first;
+            assertIndirect(i == 0 || compare(pLeaf->pairs()[i - 1].first, k));
+            assertIndirect(pLo == nullptr || !compare(k, *pLo));
+            assertIndirect(pHi == nullptr || compare(k, *pHi));
+         }
+         num += pLeaf->num;
+         leaves.push_back(pLeaf);
+         return;
+      }
+
+      const typename BTree::Inner* pInner = static_cast<const typename BTree::Inner*>(p);
+      assertIndirect(p == m.root ? pInner->num >= 1 : pInner->num >= BTree::INNER_MIN);
+      for (int i = 1; i < pInner->num; i++)
+         assertIndirect(compare(pInner->keys()[i - 1], pInner->keys()[i]));
+      for (int i = 0; i <= pInner->num; i++)
+      {
+         assertIndirect(pInner->children[i]->pParent == pInner);
+         assertNodeParameters(m, pInner->children[i],
+                              i ? pInner->keys() + i - 1 : pLo,
+                              i < pInner->num ? pInner->keys() + i : pHi,
+                              depth + 1, depthLeaf, num, leaves, line, function);
+      }
+   }
+};
+
+#endif // DEBUG
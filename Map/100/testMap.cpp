@@ -12,10 +12,16 @@
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
 
+#ifndef BST_ORDER_STATISTICS
+#define BST_ORDER_STATISTICS   // so the unit tests can check select and rank
+#endif
+
 #include "testSpy.h"       // for the spy unit tests
 #include "testPair.h"      // for the pair unit tests
 #include "testBST.h"       // for the BST unit tests
 #include "testMap.h"       // for the map unit tests
+#include "testSkipList.h"  // for the skip list unit tests
+#include "testBTreeMap.h"  // for the B+-tree map unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +36,8 @@ int main()
    TestPair().run();
    TestBST().run();
    TestMap().run();
+   TestSkipList().run();
+   TestBTreeMap().run();
 #endif // DEBUG
    
    return 0;
@@ -12,6 +12,7 @@
 
 #include "map.h"        // class under test
 #include "unitTest.h"   // unit test baseclass
+#include "spy.h"        // for the Spy
 
 
 #include <map>
@@ -42,6 +43,7 @@ public:
       test_constructRange_empty();
       test_constructRange_one();
       test_constructRange_standard();
+      test_constructRange_sorted();
       test_destructor_empty();
       test_destructor_standard();
 
@@ -94,6 +96,9 @@ public:
       test_find_standardLeft();
       test_find_standardRight();
       test_find_standardMissing();
+      test_find_charPointer();
+      test_find_noDefaultValue();
+      test_contains_standard();
 
       // Insert
       test_insertCopy_empty();
@@ -101,6 +106,10 @@ public:
       test_insertCopy_standardMiddle();
       test_insertMove_empty();
       test_insertMove_standard();
+      test_subscript_oneDescent();
+      test_tryEmplace_standard();
+      test_insertOrAssign_standard();
+      test_emplaceHint_standard();
 
       // Remove
       test_clear_empty();
@@ -120,6 +129,15 @@ public:
       test_size_empty();
       test_size_standard();
 
+      // Bounds
+      test_bounds_standard();
+      test_range_standard();
+
+#ifdef BST_ORDER_STATISTICS
+      // Order
+      test_select_percentile();
+#endif // BST_ORDER_STATISTICS
+
       report("Map");
    }
 
@@ -448,6 +466,22 @@ public:
       teardownStandardFixture(m);
    }
 
+   // a sorted reload is built directly rather than inserted pair by pair
+   void test_constructRange_sorted()
+   {  // setup
+      std::vector<custom::pair<int, int>> pairs;
+      for (int i = 0; i < 1000; i++)
+         pairs.push_back(custom::pair<int, int>(i * 2, i));
+      // exercise
+      custom::map<int, int> m(pairs.begin(), pairs.end());
+      // verify
+      assertUnit(m.size() == 1000);
+      assertUnit(m.bst.validate());
+      assertUnit(m[0] == 0);
+      assertUnit(m[1998] == 999);
+      assertUnit(m.find(999) == m.end());
+   }  // teardown
+
    /***************************************
     * DESTRUCTOR
     ***************************************/
@@ -545,6 +579,169 @@ public:
       teardownStandardFixture(m);
    }
 
+   /***************************************
+    * EMPLACE
+    *    map::operator[], map::try_emplace(),
+    *    map::insert_or_assign() and map::emplace_hint()
+    ***************************************/
+
+   // a new key costs what a find() costs, and a present one makes no V
+   void test_subscript_oneDescent()
+   {  // setup
+      custom::map<Spy, Spy> m;
+      for (int i = 0; i < 100; i++)
+         m.insert(custom::pair<Spy, Spy>(Spy(i * 2), Spy(i)));
+      Spy key(101);
+      Spy::reset();
+      m.find(key);
+      int numFind = Spy::numLessthan();
+      Spy::reset();
+      // exercise
+      m[key];
+      int numNew = Spy::numLessthan();
+      Spy::reset();
+      m[key];
+      // verify
+      assertUnit(numNew == numFind);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(m.size() == 101);
+      assertUnit(m.bst.validate());
+   }  // teardown
+
+   // the value is built from the args only when the key is new
+   void test_tryEmplace_standard()
+   {  // setup
+      custom::map<int, std::string> m;
+      m[5] = "five";
+      std::string text("fifty");
+      // exercise
+      auto resultOld = m.try_emplace(5, std::move(text));
+      auto resultNew = m.try_emplace(50, std::move(text));
+      auto itHint = m.try_emplace(m.end(), 60, 3, 'x');
+      // verify
+      assertUnit(resultOld.second == false);
+      assertUnit((*resultOld.first).second == "five");
+      assertUnit(resultNew.second == true);
+      assertUnit((*resultNew.first).second == "fifty");
+      assertUnit((*itHint).second == "xxx");
+      assertUnit(m.size() == 3);
+   }  // teardown
+
+   // assign over a value that is there, insert one that is not
+   void test_insertOrAssign_standard()
+   {  // setup
+      custom::map<int, std::string> m;
+      m[5] = "five";
+      // exercise
+      auto resultOld = m.insert_or_assign(5, std::string("FIVE"));
+      auto resultNew = m.insert_or_assign(6, "six");
+      // verify
+      assertUnit(resultOld.second == false);
+      assertUnit(resultNew.second == true);
+      assertUnit(m[5] == "FIVE");
+      assertUnit(m[6] == "six");
+      assertUnit(m.size() == 2);
+   }  // teardown
+
+   // good hints, bad hints, and a key that is already there
+   void test_emplaceHint_standard()
+   {  // setup
+      custom::map<int, int> m;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         m.emplace_hint(m.end(), i * 2, i);
+      for (int i = 0; i < 50; i++)
+         m.emplace_hint(m.find(i * 2 + 2), i * 2 + 1, -i);
+      for (int i = 0; i < 10; i++)
+         m.emplace_hint(m.begin(), 1000 + i, i);
+      auto itOld = m.emplace_hint(m.begin(), 40, 999);
+      // verify
+      assertUnit(m.size() == 160);
+      assertUnit(m.bst.validate());
+      assertUnit((*itOld).first == 40 && (*itOld).second == 20);
+      int previous = -1;
+      bool isInOrder = true;
+      for (auto it = m.begin(); it != m.end(); ++it)
+      {
+         isInOrder = isInOrder && (*it).first > previous;
+         previous = (*it).first;
+      }
+      assertUnit(isInOrder);
+   }  // teardown
+
+   /***************************************
+    * BOUNDS
+    *    map::lower_bound(), map::upper_bound(),
+    *    map::equal_range() and map::range()
+    ***************************************/
+
+   // the bounds of a key that is there and one that is not
+   void test_bounds_standard()
+   {  // setup
+      custom::map<int, std::string> m;
+      for (int i = 0; i < 10; i++)
+         m[i * 10] = std::to_string(i);
+      // exercise
+      auto itLower = m.lower_bound(30);
+      auto itUpper = m.upper_bound(30);
+      auto range = m.equal_range(35);
+      // verify
+      assertUnit((*itLower).first == 30);
+      assertUnit((*itUpper).first == 40);
+      assertUnit(range.first == range.second);
+      assertUnit((*range.first).first == 40);
+      assertUnit(m.lower_bound(100) == m.end());
+   }  // teardown
+
+   // every pair with a key in [lo, hi), in order
+   void test_range_standard()
+   {  // setup
+      custom::map<int, int> m;
+      for (int i = 0; i < 100; i++)
+         m[(i * 37) % 100] = i;
+      // exercise
+      int sum = 0;
+      int previous = 24;
+      bool isInOrder = true;
+      for (const auto& pair : m.range(25, 75))
+      {
+         isInOrder = isInOrder && pair.first == previous + 1;
+         previous = pair.first;
+         sum += pair.first;
+      }
+      // verify
+      assertUnit(isInOrder);
+      assertUnit(previous == 74);
+      assertUnit(sum == (25 + 74) * 50 / 2);
+   }  // teardown
+
+#ifdef BST_ORDER_STATISTICS
+   /***************************************
+    * ORDER
+    *    map::select() and map::rank()
+    ***************************************/
+
+   // the 90th percentile key, and how many keys fall below a value
+   void test_select_percentile()
+   {  // setup
+      custom::map<int, int> m;
+      for (int i = 0; i < 1000; i++)
+         m[(i * 389) % 1000 * 10] = i;
+      // exercise
+      auto it = m.select(m.size() * 9 / 10);
+      size_t num = m.rank(5005);
+      // verify
+      assertUnit(it != m.end());
+      assertUnit((*it).first == 9000);
+      assertUnit(num == 501);
+      it += 10;
+      assertUnit((*it).first == 9100);
+      it -= 900;
+      assertUnit((*it).first == 100);
+   }  // teardown
+#endif // BST_ORDER_STATISTICS
+
    /***************************************
     * ASSIGNMENT
     *    map::operator=(const map &)
@@ -1287,6 +1484,68 @@ public:
       teardownStandardFixture(m);
    }
 
+   // look up a string key with a const char*: no std::string is made
+   void test_find_charPointer()
+   {  // setup
+      custom::map<std::string, int>::iterator it;
+      //    "30"     "50"     "70"   = m
+      //   +----+   +----+   +----+
+      //   | 30 | - | 50 | - | 70 |
+      //   +----+   +----+   +----+
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+
+      // exercise
+      it = m.find("70");
+      // verify
+      assertUnit(it.it.pNode != nullptr);
+      if (it.it.pNode)
+         assertUnit((*it).second == 70);
+      assertUnit(m.find("99") == m.end());
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
+   // searching never builds a value just to compare keys
+   void test_find_noDefaultValue()
+   {  // setup
+      custom::map<int, Spy> m;
+      m.insert(custom::pair<int, Spy>(50, Spy(50)));
+      m.insert(custom::pair<int, Spy>(30, Spy(30)));
+      Spy::reset();
+      // exercise
+      bool found = m.find(30) != m.end();
+      bool missing = m.find(99) == m.end();
+      size_t num = m.count(50);
+      // verify
+      assertUnit(found);
+      assertUnit(missing);
+      assertUnit(num == 1);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   void test_contains_standard()
+   {  // setup
+      //    "30"     "50"     "70"   = m
+      //   +----+   +----+   +----+
+      //   | 30 | - | 50 | - | 70 |
+      //   +----+   +----+   +----+
+      custom::map<std::string, int> m;
+      setupStandardFixture(m);
+
+      // exercise
+      // verify
+      assertUnit(m.contains(std::string("50")));
+      assertUnit(m.contains("30"));
+      assertUnit(!m.contains("40"));
+      assertUnit(m.count("70") == 1);
+      assertStandardFixture(m);
+      // teardown
+      teardownStandardFixture(m);
+   }
+
    /***************************************
     * INSERT
     *    map::insert(const T &)
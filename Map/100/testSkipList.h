@@ -0,0 +1,660 @@
+/***********************************************************************
+ * Header:
+ *    TEST SKIP LIST
+ * Summary:
+ *    Unit tests for skiplist and for map built on a skiplist
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "skiplist.h"
+#include "map.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef assertValid
+#define assertValid(x) assertValidParameters(x, __LINE__, __FUNCTION__)
+
+/***********************************************
+ * COUNTING LESS
+ * std::less that counts how often it is called
+ ***********************************************/
+struct CountingLess
+{
+   static int count;
+   bool operator()(int lhs, int rhs) const
+   {
+      count++;
+      return lhs < rhs;
+   }
+};
+int CountingLess::count = 0;
+
+/***********************************************
+ * TEST SKIP LIST
+ * Unit tests for the skiplist class
+ ***********************************************/
+class TestSkipList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_standard();
+      test_constructInit_standard();
+
+      // Insert
+      test_insert_empty();
+      test_insert_standard();
+      test_insert_duplicate();
+      test_insert_keepUnique();
+      test_insert_many();
+      test_insert_sequentialUsesFinger();
+      test_insert_fingerAfterSwap();
+      test_insert_hintNeighbors();
+      test_insert_hintUsesTower();
+
+      // Find
+      test_find_empty();
+      test_find_standard();
+      test_find_missing();
+
+      // Remove
+      test_erase_middle();
+      test_erase_duplicate();
+      test_erase_all();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_increment();
+      test_iterator_decrement();
+
+      // Map
+      test_map_insertFind();
+      test_map_access();
+      test_map_erase();
+      test_map_constructRange();
+      test_map_constructInit();
+      test_map_assignInit();
+      test_map_emplaceHint();
+
+      report("SkipList");
+   }
+
+   typedef custom::skiplist<int> SkipList;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, no allocations
+   void test_construct_default()
+   {  // setup
+      // exercise
+      SkipList sl;
+      // verify
+      assertUnit(sl.numElements == 0);
+      assertUnit(sl.level == 1);
+      assertUnit(sl.pHeads[0] == nullptr);
+      assertUnit(sl.empty());
+      assertUnit(sl.begin() == sl.end());
+   }  // teardown
+
+   // copy a list, the copy has its own nodes
+   void test_constructCopy_standard()
+   {  // setup
+      SkipList slSrc;
+      setupStandardFixture(slSrc);
+      // exercise
+      SkipList slDes(slSrc);
+      // verify
+      assertStandardFixture(slDes);
+      assertStandardFixture(slSrc);
+      assertUnit(slDes.pHeads[0] != slSrc.pHeads[0]);
+   }  // teardown
+
+   // build from an initializer list
+   void test_constructInit_standard()
+   {  // setup
+      // exercise
+      SkipList sl{ 70, 30, 50, 20, 60, 40, 80 };
+      // verify
+      assertStandardFixture(sl);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // insert into an empty list
+   void test_insert_empty()
+   {  // setup
+      SkipList sl;
+      // exercise
+      auto result = sl.insert(50);
+      // verify
+      assertUnit(result.second);
+      assertUnit(result.first.pNode != nullptr);
+      assertUnit(sl.pHeads[0] == result.first.pNode);
+      assertUnit(sl.numElements == 1);
+      if (result.first.pNode)
+      {
+         assertUnit(result.first.pNode->data == 50);
+         assertUnit(result.first.pNode->pPrev == nullptr);
+         assertUnit(result.first.pNode->height <= sl.level);
+      }
+      assertValid(sl);
+   }  // teardown
+
+   // insert into the middle of the standard fixture
+   void test_insert_standard()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      // exercise
+      auto result = sl.insert(45);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 45);
+      assertUnit(sl.numElements == 8);
+      assertUnit(result.first.pNode->pPrev->data == 40);
+      assertUnit(result.first.pNode->pNext[0]->data == 50);
+      assertValid(sl);
+   }  // teardown
+
+   // duplicates go after the existing equivalent element
+   void test_insert_duplicate()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      SkipList::Node* p50 = sl.find(50).pNode;
+      // exercise
+      auto result = sl.insert(50);
+      // verify
+      assertUnit(result.second);
+      assertUnit(result.first.pNode != p50);
+      assertUnit(result.first.pNode->pPrev == p50);
+      assertUnit(sl.numElements == 8);
+      assertValid(sl);
+   }  // teardown
+
+   // keepUnique refuses a duplicate and returns the original
+   void test_insert_keepUnique()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      SkipList::Node* p50 = sl.find(50).pNode;
+      // exercise
+      auto result = sl.insert(50, true /*keepUnique*/);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(result.first.pNode == p50);
+      assertStandardFixture(sl);
+   }  // teardown
+
+   // lots of keys in a scrambled order build a valid list
+   void test_insert_many()
+   {  // setup
+      SkipList sl;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         sl.insert((i * 7919) % 5000);
+      // verify
+      assertUnit(sl.size() == 5000);
+      assertUnit(sl.level > 2);
+      assertValid(sl);
+      int expected = 0;
+      bool inOrder = true;
+      for (auto it = sl.begin(); it != sl.end(); ++it)
+         inOrder = inOrder && (*it == expected++);
+      assertUnit(inOrder);
+   }  // teardown
+
+   // ascending keys start at the finger and barely compare at all
+   void test_insert_sequentialUsesFinger()
+   {  // setup
+      custom::skiplist<int, CountingLess> sl;
+      for (int i = 0; i < 1000; i++)
+         sl.insert(i);
+      CountingLess::count = 0;
+      // exercise
+      for (int i = 1000; i < 2000; i++)
+         sl.insert(i);
+      // verify
+      assertUnit(sl.size() == 2000);
+      assertUnit(CountingLess::count <= 2000); // a search from the head takes ~20
+      assertValid(sl);
+   }  // teardown
+
+   // the finger follows the nodes when two lists are swapped
+   void test_insert_fingerAfterSwap()
+   {  // setup
+      SkipList slLHS;
+      SkipList slRHS;
+      setupStandardFixture(slLHS);
+      slRHS.insert(5);
+      slRHS.insert(6);
+      // exercise
+      slLHS.swap(slRHS);
+      slLHS.insert(7);
+      slRHS.insert(90);
+      // verify
+      assertUnit(slLHS.size() == 3);
+      assertUnit(slRHS.size() == 8);
+      assertValid(slLHS);
+      assertValid(slRHS);
+   }  // teardown
+
+   // a hint on either side of the key, far from it, at end(), or on it
+   void test_insert_hintNeighbors()
+   {  // setup
+      SkipList sl;
+      for (int i = 0; i < 100; i += 10)
+         sl.insert(i);
+      auto less = [](int lhs, int rhs) { return lhs < rhs; };
+      // exercise
+      auto after = sl.find_or_insert(sl.find(50), 45, less, []() { return 45; });
+      auto before = sl.find_or_insert(sl.find(50), 55, less, []() { return 55; });
+      auto far = sl.find_or_insert(sl.find(90), 5, less, []() { return 5; });
+      auto atEnd = sl.find_or_insert(sl.end(), 95, less, []() { return 95; });
+      auto on = sl.find_or_insert(sl.find(30), 30, less, []() { return -1; });
+      auto next = sl.find_or_insert(sl.find(20), 30, less, []() { return -1; });
+      // verify
+      assertUnit(after.second && *after.first == 45);
+      assertUnit(before.second && *before.first == 55);
+      assertUnit(far.second && *far.first == 5);
+      assertUnit(atEnd.second && *atEnd.first == 95);
+      assertUnit(!on.second && *on.first == 30);
+      assertUnit(!next.second && *next.first == 30);
+      assertUnit(sl.size() == 14);
+      assertValid(sl);
+      std::vector<int> values;
+      for (auto it = sl.begin(); it != sl.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == std::vector<int>({ 0, 5, 10, 20, 30, 40, 45, 50, 55, 60, 70, 80, 90, 95 }));
+   }  // teardown
+
+   // descending keys, each hinted with its successor, never search from
+   // the head, which the finger cannot help with
+   void test_insert_hintUsesTower()
+   {  // setup
+      custom::skiplist<int, CountingLess> sl;
+      for (int i = 0; i < 2000; i += 2)
+         sl.insert(i);
+      std::vector<custom::skiplist<int, CountingLess>::iterator> hints;
+      for (auto it = sl.begin(); it != sl.end(); ++it)
+         hints.push_back(it);
+      CountingLess less;
+      CountingLess::count = 0;
+      // exercise
+      for (int i = 999; i >= 1; i--)
+         sl.find_or_insert(hints[i], 2 * i - 1, less, [i]() { return 2 * i - 1; });
+      // verify
+      assertUnit(sl.size() == 1999);
+      assertUnit(CountingLess::count <= 12000); // ~35 each without the hint
+      assertValid(sl);
+      int expected = 0;
+      bool inOrder = true;
+      for (auto it = sl.begin(); it != sl.end(); ++it)
+         inOrder = inOrder && (*it == expected++);
+      assertUnit(inOrder);
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // nothing to find in an empty list
+   void test_find_empty()
+   {  // setup
+      SkipList sl;
+      // exercise
+      SkipList::iterator it = sl.find(50);
+      // verify
+      assertUnit(it == sl.end());
+   }  // teardown
+
+   // find every element of the standard fixture
+   void test_find_standard()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      // exercise
+      // verify
+      for (int i = 20; i <= 80; i += 10)
+      {
+         SkipList::iterator it = sl.find(i);
+         assertUnit(it != sl.end());
+         assertUnit(it.pNode && *it == i);
+      }
+      assertStandardFixture(sl);
+   }  // teardown
+
+   // a missing element is not found
+   void test_find_missing()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      // exercise
+      // verify
+      assertUnit(sl.find(10) == sl.end());
+      assertUnit(sl.find(45) == sl.end());
+      assertUnit(sl.find(90) == sl.end());
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase 50 from the middle
+   void test_erase_middle()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      SkipList::iterator it = sl.find(50);
+      // exercise
+      SkipList::iterator itNext = sl.erase(it);
+      // verify
+      assertUnit(itNext != sl.end() && *itNext == 60);
+      assertUnit(sl.numElements == 6);
+      assertUnit(sl.find(50) == sl.end());
+      assertUnit(itNext.pNode->pPrev->data == 40);
+      assertValid(sl);
+   }  // teardown
+
+   // erase the second of two equivalent elements, not the first
+   void test_erase_duplicate()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      SkipList::Node* p50 = sl.find(50).pNode;
+      SkipList::iterator it = sl.insert(50).first;
+      // exercise
+      sl.erase(it);
+      // verify
+      assertUnit(sl.find(50).pNode == p50);
+      assertStandardFixture(sl);
+   }  // teardown
+
+   // erase everything, the levels collapse
+   void test_erase_all()
+   {  // setup
+      SkipList sl;
+      for (int i = 0; i < 500; i++)
+         sl.insert(i);
+      // exercise
+      for (int i = 499; i >= 0; i -= 2)
+      {
+         SkipList::iterator it = sl.find(i);
+         sl.erase(it);
+      }
+      assertValid(sl);
+      while (!sl.empty())
+      {
+         SkipList::iterator it = sl.begin();
+         sl.erase(it);
+      }
+      // verify
+      assertUnit(sl.numElements == 0);
+      assertUnit(sl.level == 1);
+      assertUnit(sl.pHeads[0] == nullptr);
+   }  // teardown
+
+   // clear the standard fixture
+   void test_clear_standard()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      // exercise
+      sl.clear();
+      // verify
+      assertUnit(sl.numElements == 0);
+      assertUnit(sl.level == 1);
+      for (int i = 0; i < SkipList::MAX_LEVEL; i++)
+         assertUnit(sl.pHeads[i] == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward through the fixture
+   void test_iterator_increment()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      std::vector<int> v;
+      // exercise
+      for (SkipList::iterator it = sl.begin(); it != sl.end(); it++)
+         v.push_back(*it);
+      // verify
+      assertUnit(v == std::vector<int>({ 20, 30, 40, 50, 60, 70, 80 }));
+   }  // teardown
+
+   // walk backward from the last element
+   void test_iterator_decrement()
+   {  // setup
+      SkipList sl;
+      setupStandardFixture(sl);
+      SkipList::iterator it = sl.find(80);
+      std::vector<int> v;
+      // exercise
+      for (; it != sl.end(); --it)
+         v.push_back(*it);
+      // verify
+      assertUnit(v == std::vector<int>({ 80, 70, 60, 50, 40, 30, 20 }));
+   }  // teardown
+
+   /***************************************
+    * MAP
+    ***************************************/
+
+   typedef custom::map<int, std::string,
+                       custom::skiplist<custom::pair<int, std::string>>> SkipMap;
+
+   // a map on a skiplist inserts and finds
+   void test_map_insertFind()
+   {  // setup
+      SkipMap m;
+      // exercise
+      m.insert(custom::pair<int, std::string>(50, std::string("fifty")));
+      m.insert(custom::pair<int, std::string>(30, std::string("thirty")));
+      m.insert(custom::pair<int, std::string>(70, std::string("seventy")));
+      // verify
+      assertUnit(m.size() == 3);
+      SkipMap::iterator it = m.find(30);
+      assertUnit(it != m.end());
+      if (it != m.end())
+         assertUnit((*it).second == std::string("thirty"));
+      assertUnit(m.find(40) == m.end());
+      std::vector<int> keys;
+      for (it = m.begin(); it != m.end(); ++it)
+         keys.push_back((*it).first);
+      assertUnit(keys == std::vector<int>({ 30, 50, 70 }));
+   }  // teardown
+
+   // operator[] reads, writes, and adds
+   void test_map_access()
+   {  // setup
+      SkipMap m;
+      m.insert(custom::pair<int, std::string>(50, std::string("fifty")));
+      // exercise
+      m[50] = std::string("FIFTY");
+      m[60] = std::string("sixty");
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m[50] == std::string("FIFTY"));
+      assertUnit(m.at(60) == std::string("sixty"));
+   }  // teardown
+
+   // erase by key
+   void test_map_erase()
+   {  // setup
+      SkipMap m;
+      for (int i = 1; i <= 10; i++)
+         m.insert(custom::pair<int, std::string>(i, std::to_string(i)));
+      // exercise
+      size_t numErased = m.erase(5);
+      size_t numMissing = m.erase(50);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(numMissing == 0);
+      assertUnit(m.size() == 9);
+      assertUnit(m.find(5) == m.end());
+      assertUnit(m.find(4) != m.end());
+      assertUnit(m.find(6) != m.end());
+   }  // teardown
+
+   // emplace_hint() with the usual end() and with a neighbor
+   void test_map_emplaceHint()
+   {  // setup
+      SkipMap m;
+      for (int i = 10; i <= 50; i += 10)
+         m.insert(custom::pair<int, std::string>(i, std::to_string(i)));
+      // exercise
+      auto it35 = m.emplace_hint(m.find(40), 35, std::string("35"));
+      auto it60 = m.emplace_hint(m.end(), 60, std::string("60"));
+      auto it20 = m.emplace_hint(m.find(30), 20, std::string("twenty"));
+      // verify
+      assertUnit(m.size() == 7);
+      assertUnit((*it35).first == 35);
+      assertUnit((*it60).first == 60);
+      assertUnit((*it20).second == std::string("20"));
+      std::vector<int> keys;
+      for (auto it = m.begin(); it != m.end(); ++it)
+         keys.push_back((*it).first);
+      assertUnit(keys == std::vector<int>({ 10, 20, 30, 35, 40, 50, 60 }));
+   }  // teardown
+
+   // build a map on a skiplist from a range, in order and not
+   void test_map_constructRange()
+   {  // setup
+      std::vector<custom::pair<int, std::string>> sorted;
+      for (int i = 1; i <= 10; i++)
+         sorted.push_back(custom::pair<int, std::string>(i, std::to_string(i)));
+      std::vector<custom::pair<int, std::string>> unsorted(sorted.rbegin(), sorted.rend());
+      // exercise
+      SkipMap mSorted(sorted.begin(), sorted.end());
+      SkipMap mUnsorted(unsorted.begin(), unsorted.end());
+      // verify
+      assertUnit(mSorted.size() == 10);
+      assertUnit(mUnsorted.size() == 10);
+      std::vector<int> keysSorted;
+      std::vector<int> keysUnsorted;
+      for (SkipMap::iterator it = mSorted.begin(); it != mSorted.end(); ++it)
+         keysSorted.push_back((*it).first);
+      for (SkipMap::iterator it = mUnsorted.begin(); it != mUnsorted.end(); ++it)
+         keysUnsorted.push_back((*it).first);
+      assertUnit(keysSorted == std::vector<int>({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+      assertUnit(keysUnsorted == keysSorted);
+      assertUnit(mUnsorted.at(7) == std::string("7"));
+   }  // teardown
+
+   // build a map on a skiplist from an initializer list
+   void test_map_constructInit()
+   {  // setup
+      // exercise
+      SkipMap m{ custom::pair<int, std::string>(50, std::string("fifty")),
+                 custom::pair<int, std::string>(30, std::string("thirty")) };
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m.at(30) == std::string("thirty"));
+      assertUnit(m.at(50) == std::string("fifty"));
+   }  // teardown
+
+   // assign an initializer list over a map on a skiplist
+   void test_map_assignInit()
+   {  // setup
+      SkipMap m;
+      m[10] = std::string("ten");
+      // exercise
+      m = { custom::pair<int, std::string>(20, std::string("twenty")),
+            custom::pair<int, std::string>(30, std::string("thirty")) };
+      // verify
+      assertUnit(m.size() == 2);
+      assertUnit(m.find(10) == m.end());
+      assertUnit(m.at(20) == std::string("twenty"));
+      assertUnit(m.at(30) == std::string("thirty"));
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *   20 - 30 - 40 - 50 - 60 - 70 - 80
+    *************************************************************/
+   void setupStandardFixture(SkipList& sl)
+   {
+      int values[] = { 50, 30, 70, 20, 40, 60, 80 };
+      for (int v : values)
+         sl.insert(v);
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE
+    *   20 - 30 - 40 - 50 - 60 - 70 - 80
+    *************************************************************/
+   void assertStandardFixtureParameters(const SkipList& sl, int line, const char* function)
+   {
+      assertIndirect(sl.numElements == 7);
+      std::vector<int> v;
+      for (SkipList::iterator it = sl.begin(); it != sl.end(); ++it)
+         v.push_back(*it);
+      assertIndirect(v == std::vector<int>({ 20, 30, 40, 50, 60, 70, 80 }));
+      assertValidParameters(sl, line, function);
+   }
+
+   /*************************************************************
+    * VERIFY VALID
+    * Every level is sorted and contains exactly the nodes whose
+    * tower reaches it, and level 0 is correctly doubly linked
+    *************************************************************/
+   template <class T, class C>
+   void assertValidParameters(const custom::skiplist<T, C>& sl, int line, const char* function)
+   {
+      typedef typename custom::skiplist<T, C>::Node Node;
+      C compare;
+      size_t num = 0;
+      Node* pPrev = nullptr;
+      for (Node* p = sl.pHeads[0]; p; p = p->pNext[0])
+      {
+         assertIndirect(p->pPrev == pPrev);
+         assertIndirect(p->height >= 1 && p->height <= sl.level);
+         assertIndirect(pPrev == nullptr || !compare(p->data, pPrev->data));
+         pPrev = p;
+         num++;
+      }
+      assertIndirect(num == sl.numElements);
+
+      for (int i = 1; i < sl.level; i++)
+      {
+         // level i is level 0 filtered by height
+         Node* pExpected = sl.pHeads[0];
+         for (Node* p = sl.pHeads[i]; p; p = p->pNext[i])
+         {
+            while (pExpected && pExpected->height <= i)
+               pExpected = pExpected->pNext[0];
+            assertIndirect(p == pExpected);
+            if (p != pExpected)
+               return;
+            pExpected = pExpected->pNext[0];
+         }
+         while (pExpected && pExpected->height <= i)
+            pExpected = pExpected->pNext[0];
+         assertIndirect(pExpected == nullptr);
+      }
+      assertIndirect(sl.level == 1 || sl.pHeads[sl.level - 1] != nullptr);
+   }
+};
+
+#endif // DEBUG